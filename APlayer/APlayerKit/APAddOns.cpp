@@ -140,7 +140,8 @@ APAddOnPlayer::APAddOnPlayer(APGlobalData *global) : APAddOnBase(global)
 	serverLooper = NULL;
 
 	// Initialize private variables
-	totalSize = 0;
+	totalSize    = 0;
+	nextInfoSlot = 0;
 }
 
 
@@ -325,7 +326,9 @@ void APAddOnPlayer::SetSongPosition(int16 pos)
 
 /******************************************************************************/
 /* GetTimeTable() will calculate the position time for each position and      */
-/*      store them in the list given.                                         */
+/*      store them in the list given. The server asks for the other sub songs */
+/*      in the background while playing, so the calculation can be postponed  */
+/*      from InitPlayer() until a sub song is asked for the first time.       */
 /*                                                                            */
 /* Input:  "songNum" is the subsong number to get the time table for.         */
 /*         "posTimes" is a reference to the list where you should store the   */
@@ -542,35 +545,44 @@ int32 APAddOnPlayer::GetExtraFilesSize(void)
 
 /******************************************************************************/
 /* ChangePosition() will tell APlayer that your module has changed the        */
-/*      position.                                                             */
+/*      position. Nothing is sent if the player has no looper, which is the   */
+/*      case when it is only used to scan the durations.                      */
 /******************************************************************************/
 void APAddOnPlayer::ChangePosition(void)
 {
-	ASSERT(serverLooper != NULL);
-	serverLooper->PostMessage(AP_POSITION_CHANGED);
+	if (serverLooper == NULL)
+		return;
+
+	// If the queue is full, the server will not see this change,
+	// but it reads the position again at the next one
+	serverLooper->PostEvent(AP_POSITION_CHANGED);
 }
 
 
 
 /******************************************************************************/
-/* ChangeModuleInfo() will change the module info you give.                   */
+/* ChangeModuleInfo() will change the module info you give. Nothing is sent  */
+/*      if the player has no looper.                                          */
 /*                                                                            */
 /* Input:  "line" is the line starting from 0.                                */
 /*         "newValue" is the new value string.                                */
 /******************************************************************************/
 void APAddOnPlayer::ChangeModuleInfo(uint32 line, PString newValue)
 {
-	BMessage msg(AP_MODULEINFO_CHANGED);
-	char *valStr;
+	PString *value;
+
+	if (serverLooper == NULL)
+		return;
 
-	// Add the information to the message
-	msg.AddInt32("line", line);
-	msg.AddString("value", (valStr = newValue.GetString()));
-	newValue.FreeBuffer(valStr);
+	// This is called from the mixer thread, so the string is stored
+	// in one of the preallocated slots instead of a new allocation.
+	// The slot is only taken when the event is posted
+	value  = &infoSlots[nextInfoSlot];
+	*value = newValue;
 
-	// Send the message
-	ASSERT(serverLooper != NULL);
-	serverLooper->PostMessage(&msg);
+	// Send the event
+	if (serverLooper->PostEvent(AP_MODULEINFO_CHANGED, line, value))
+		nextInfoSlot = (nextInfoSlot + 1) % AP_MODULEINFO_SLOTS;
 }
 
 
@@ -605,9 +617,9 @@ uint16 APAddOnPlayer::GetBPMTempo(void) const
 /* SetLooper() sets the looper which the player uses to communicate with the  */
 /*      server.                                                               */
 /*                                                                            */
-/* Input:  "looper" is a pointer to the server looper.                        */
+/* Input:  "looper" is a pointer to the server event loop.                    */
 /******************************************************************************/
-void APAddOnPlayer::SetLooper(BLooper *looper)
+void APAddOnPlayer::SetLooper(PEventLoop *looper)
 {
 	serverLooper = looper;
 }
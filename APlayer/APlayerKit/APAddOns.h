@@ -19,6 +19,8 @@
 #include "PTime.h"
 #include "PList.h"
 #include "PSettings.h"
+#include "PArena.h"
+#include "PEventLoop.h"
 
 // APlayerKit headers
 #include "Import_Export.h"
@@ -42,6 +44,17 @@
 
 
 
+/******************************************************************************/
+/* Number of module information strings each player keeps. A player posts     */
+/*      a pointer to one of its strings to the server, so the string must     */
+/*      live until the server has handled the event. The server event queue   */
+/*      holds 256 events, so with 258 slots a string is never overwritten     */
+/*      while it is queued or being handled.                                  */
+/******************************************************************************/
+#define AP_MODULEINFO_SLOTS				258
+
+
+
 /******************************************************************************/
 /* Types used in the different functions.                                     */
 /******************************************************************************/
@@ -185,6 +198,7 @@ typedef struct APSampleInfo
 
 // Decruncher agent specific commands
 #define APDA_DECRUNCH_FILE				'DADF'
+#define APDA_LIST_MEMBERS				'DALM'
 
 // Virtual mixer agent specific commands
 #define APMA_INIT_MIXER					'MAIM'
@@ -236,13 +250,26 @@ typedef struct APAgent_DecrunchFile
 {
 	// Read only fields
 	PFile *file;						// The file to decrunch
+	PString archiveMember;				// Name of the member to extract if the file is an archive (empty for the first)
 
 	// If you decrunch the file, fill out these fields.
 	// If you can not recognize the file format, leave these fields untouched
 	PFile *decrunchedFile;				// A pointer to the file where the decrunched file is stored
+	bool fromArchive;					// Set this to true if the file was extracted from an archive
 } APAgent_DecrunchFile;
 
 
+typedef struct APAgent_ListMembers
+{
+	// Read only fields
+	PFile *file;						// The archive to list
+
+	// If the file is an archive you understand, fill out this field.
+	// If not, leave it untouched
+	PList<PString> members;				// The names of the members in archive order. Use them as archiveMember
+} APAgent_ListMembers;
+
+
 
 /******************************************************************************/
 /* Virtual mixer agent command structures                                     */
@@ -429,7 +456,7 @@ public:
 
 	// Private functions. These functions are called from the server.
 	// Do NOT call these functions from your add-on
-	void SetLooper(BLooper *looper);
+	void SetLooper(PEventLoop *looper);
 
 	// Public variables
 	APChannel **virtChannels;	// A pointer to channel objects, one for each channel
@@ -440,11 +467,17 @@ public:
 	bool amigaFilter;			// Set this to true to enable Amiga LED filter, false to disable it
 	bool endReached;			// Set this to true, when your module has reached the end
 
+protected:
+	PArena moduleArena;			// Allocate plain module data here and free it all with FreeAll() in your cleanup
+
 private:
 	void OpenFile(PFile *file, PString fileName);
 
-	BLooper *serverLooper;
+	PEventLoop *serverLooper;
 	int32 totalSize;
+
+	PString infoSlots[AP_MODULEINFO_SLOTS];
+	int32 nextInfoSlot;
 };
 
 
@@ -289,25 +289,24 @@ void APMultiFiles::LoadListFile(PString fileName, FileFunc func, void *userData)
 		//
 		case apAPlayer:
 		{
+			PLineReader reader(&file);
 			PString path;
 			int32 timePos;
 
 			// Skip the header
-			file.ReadLine();
+			reader.ReadLine(line);
 
 			// At the moment, only plain files are supported in the APML list
 			typeStruct.type = apPlain;
 
 			// Start to "compile" the file
-			while (!file.IsEOF())
+			while (reader.ReadLine(line))
 			{
-				line = file.ReadLine();
-
 				if (!line.IsEmpty())
 				{
 					// "Path" command
 					if (line == "@*Path*@")
-						path = file.ReadLine();
+						reader.ReadLine(path);
 					else
 					{
 						// If not the "Names" command, it's a file name
@@ -353,15 +352,15 @@ void APMultiFiles::LoadListFile(PString fileName, FileFunc func, void *userData)
 		case apCL_Amp:
 		case apSoundPlay:
 		{
+			PLineReader reader(&file);
+
 			// Only plain files are supported and no time support
 			typeStruct.type          = apPlain;
 			typeStruct.timeAvailable = false;
 
-			while (!file.IsEOF())
+			// Read one item at the time
+			while (reader.ReadLine(line))
 			{
-				// Read one item
-				line = file.ReadLine();
-
 				// Remove any white spaces
 				line.TrimRight();
 				line.TrimLeft();
@@ -395,6 +394,7 @@ void APMultiFiles::LoadListFile(PString fileName, FileFunc func, void *userData)
 		{
 			int32 timePos = -1;
 			PCharSet_MS_WIN_1252 charSet;
+			PLineReader reader(&file, &charSet);
 
 			// Only plain files are supported
 			typeStruct.type = apPlain;
@@ -402,11 +402,9 @@ void APMultiFiles::LoadListFile(PString fileName, FileFunc func, void *userData)
 			// Reset the time indicator
 			typeStruct.timeAvailable = false;
 
-			while (!file.IsEOF())
+			// Read one item at the time
+			while (reader.ReadLine(line))
 			{
-				// Read one item
-				line = file.ReadLine(&charSet);
-
 				// Remove any white spaces
 				line.TrimRight();
 				line.TrimLeft();
@@ -14,7 +14,10 @@
 
 // PolyKit headers
 #include "POS.h"
+#include "PString.h"
 #include "PBinary.h"
+#include "PFile.h"
+#include "PSkipList.h"
 
 // APlayerKit headers
 #include "APAddOns.h"
@@ -78,4 +81,161 @@ protected:
 	int32 bfexts(uint8 *p, int32 bo, int32 bc);
 };
 
+
+
+/******************************************************************************/
+/* Archive constants                                                          */
+/******************************************************************************/
+#define DEFLATE_MAX_RATIO		1032	// Deflate can't pack better than this
+
+
+
+/******************************************************************************/
+/* ArchiveEntry structure                                                     */
+/******************************************************************************/
+typedef struct ArchiveEntry
+{
+	int64 offset;						// Offset to the member header or data in the archive
+	uint32 packedSize;					// Size of the packed member data
+	uint32 unpackedSize;				// Size of the member when unpacked
+	uint32 method;						// Packing method, the meaning depends on the archive format
+	uint32 crc;							// Checksum of the unpacked data
+} ArchiveEntry;
+
+
+
+/******************************************************************************/
+/* ArchiveIndex class                                                         */
+/******************************************************************************/
+class Unarchiver;
+
+class ArchiveIndex
+{
+public:
+	ArchiveIndex(Unarchiver *archiver, int64 length);
+	virtual ~ArchiveIndex(void);
+
+	void AddEntry(PString name, const ArchiveEntry &entry);
+	bool FindEntry(PString name, ArchiveEntry &entry) const;
+	PString GetEntryName(int32 index) const;
+
+	Unarchiver *GetUnarchiver(void) const;
+	int64 GetArchiveLength(void) const;
+	int32 CountEntries(void) const;
+
+protected:
+	Unarchiver *unarchiver;
+	int64 archiveLength;
+
+	PSkipList<PString, ArchiveEntry> entries;
+	PList<PString> names;				// The member names in archive order
+};
+
+
+
+/******************************************************************************/
+/* Unarchiver class                                                           */
+/******************************************************************************/
+class Unarchiver
+{
+public:
+	Unarchiver(void);
+	virtual ~Unarchiver(void);
+
+	virtual bool Determine(PFile *file) = 0;
+	virtual ap_result BuildIndex(PFile *file, ArchiveIndex *index) = 0;
+	virtual ap_result Extract(PFile *file, const ArchiveEntry *entry, PBinary &destBuf) = 0;
+
+protected:
+	bool Inflate(const uint8 *source, uint32 sourceLen, uint8 *dest, uint32 destLen, int32 windowBits);
+	bool CheckEntry(const ArchiveEntry &entry, int64 dataOffset, int64 archiveLength, uint32 maxRatio) const;
+
+	static uint16 GetL16(const uint8 *p) { return (p[0] | (p[1] << 8)); };
+	static uint32 GetL32(const uint8 *p) { return (p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32)p[3] << 24)); };
+};
+
+
+
+/******************************************************************************/
+/* Unarchive_Zip class                                                        */
+/******************************************************************************/
+class Unarchive_Zip : public Unarchiver
+{
+public:
+	Unarchive_Zip(void) {};
+	virtual ~Unarchive_Zip(void) {};
+
+	virtual bool Determine(PFile *file);
+	virtual ap_result BuildIndex(PFile *file, ArchiveIndex *index);
+	virtual ap_result Extract(PFile *file, const ArchiveEntry *entry, PBinary &destBuf);
+};
+
+
+
+/******************************************************************************/
+/* Unarchive_GZip class                                                       */
+/******************************************************************************/
+class Unarchive_GZip : public Unarchiver
+{
+public:
+	Unarchive_GZip(void) {};
+	virtual ~Unarchive_GZip(void) {};
+
+	virtual bool Determine(PFile *file);
+	virtual ap_result BuildIndex(PFile *file, ArchiveIndex *index);
+	virtual ap_result Extract(PFile *file, const ArchiveEntry *entry, PBinary &destBuf);
+};
+
+
+
+/******************************************************************************/
+/* Unarchive_LHA class                                                        */
+/******************************************************************************/
+#define LHA_NC					510		// Number of literal and length codes
+#define LHA_NT					19		// Number of code length codes
+#define LHA_NPT					19		// Size of the shared code length/position table
+
+class Unarchive_LHA : public Unarchiver
+{
+public:
+	Unarchive_LHA(void);
+	virtual ~Unarchive_LHA(void) {};
+
+	virtual bool Determine(PFile *file);
+	virtual ap_result BuildIndex(PFile *file, ArchiveIndex *index);
+	virtual ap_result Extract(PFile *file, const ArchiveEntry *entry, PBinary &destBuf);
+
+protected:
+	typedef struct HuffTable
+	{
+		uint32 limit[17];				// Left justified end code for each bit length
+		uint32 base[17];				// Left justified first code for each bit length
+		uint16 offset[17];				// Index in the symbol table for each bit length
+		uint16 symbols[LHA_NC];			// Symbols sorted by bit length
+		int32 single;					// Only symbol in the table or -1
+	} HuffTable;
+
+	bool Decode(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 destLen, int32 dicBit);
+	bool ReadPtLen(int32 nn, int32 nBit, int32 iSpecial);
+	bool ReadCLen(void);
+	bool MakeTable(int32 nChar, const uint8 *bitLen, HuffTable &table);
+	int32 DecodeSymbol(const HuffTable &table);
+
+	uint32 GetBits(int32 num);
+	uint16 CalcCRC16(const uint8 *data, uint32 length);
+
+	const uint8 *source;
+	const uint8 *sourceEnd;
+	uint32 bitBuf;
+	int32 bitCount;
+	int32 overrun;
+
+	uint8 cLen[LHA_NC];
+	uint8 ptLen[LHA_NPT];
+	HuffTable cTable;
+	HuffTable ptTable;
+
+	uint16 crcTable[256];
+};
+
 #endif
@@ -33,10 +33,17 @@
 
 
 
+/******************************************************************************/
+/* Number of archive indexes to keep in memory                                */
+/******************************************************************************/
+#define INDEX_CACHE_SIZE	16
+
+
+
 /******************************************************************************/
 /* Constructor                                                                */
 /******************************************************************************/
-DecruncherAgent::DecruncherAgent(APGlobalData *global, PString fileName) : APAddOnAgent(global)
+DecruncherAgent::DecruncherAgent(APGlobalData *global, PString fileName) : APAddOnAgent(global), indexLock(false)
 {
 	// Fill out the version variable
 	aplayerVersion = APLAYER_CURRENT_VERSION;
@@ -133,6 +140,11 @@ bool DecruncherAgent::InitAgent(int32 index)
 	decrunchers.AddTail(new Decrunch_PowerPacker);
 	decrunchers.AddTail(new Decrunch_XPK_SQSH);
 
+	// Add all the archive formats supported
+	unarchivers.AddTail(new Unarchive_Zip);
+	unarchivers.AddTail(new Unarchive_LHA);
+	unarchivers.AddTail(new Unarchive_GZip);
+
 	return (true);
 }
 
@@ -147,6 +159,8 @@ void DecruncherAgent::EndAgent(int32 index)
 {
 	int32 i, count;
 	Decruncher *item;
+	Unarchiver *archiver;
+	ArchiveIndex *archiveIndex;
 
 	// Remove all the converters again
 	count = decrunchers.CountItems();
@@ -156,6 +170,26 @@ void DecruncherAgent::EndAgent(int32 index)
 		item = decrunchers.GetAndRemoveItem(0);
 		delete item;
 	}
+
+	// Flush the archive index cache
+	count = indexCache.CountItems();
+
+	for (i = 0; i < count; i++)
+	{
+		indexCache.GetItem(i, archiveIndex);
+		delete archiveIndex;
+	}
+
+	indexCache.MakeEmpty();
+
+	// And remove the unarchivers
+	count = unarchivers.CountItems();
+
+	for (i = 0; i < count; i++)
+	{
+		archiver = unarchivers.GetAndRemoveItem(0);
+		delete archiver;
+	}
 }
 
 
@@ -179,6 +213,12 @@ ap_result DecruncherAgent::Run(int32 index, uint32 command, void *args)
 		{
 			return (DecrunchFile((APAgent_DecrunchFile *)args));
 		}
+
+		// List the members of an archive
+		case APDA_LIST_MEMBERS:
+		{
+			return (ListMembers((APAgent_ListMembers *)args));
+		}
 	}
 
 	return (AP_UNKNOWN);
@@ -241,19 +281,271 @@ ap_result DecruncherAgent::DecrunchFile(APAgent_DecrunchFile *decrunchInfo)
 			else
 			{
 				// Show error
-				PString title, msg;
-
-				title.LoadString(res, IDS_DECRUNCH_WIN_TITLE);
-				msg.LoadString(res, IDS_DECRUNCH_ERR_CORRUPT);
-
-				PAlert alert(title, msg, PAlert::pStop, PAlert::pOk);
-				alert.Show();
+				ShowError(IDS_DECRUNCH_ERR_CORRUPT);
 			}
 
 			// Stop the loop
+			return (retVal);
+		}
+	}
+
+	// Not crunched, maybe it is an archive
+	return (ExtractMember(decrunchInfo));
+}
+
+
+
+/******************************************************************************/
+/* ExtractMember() will extract a single member if the file is one of the     */
+/*      known archive formats. Only the member is unpacked, the archive is    */
+/*      never extracted to disk.                                              */
+/*                                                                            */
+/* Input:  "decrunchInfo" is a pointer to the decruncher structure.           */
+/*                                                                            */
+/* Output: The result from the extraction.                                    */
+/******************************************************************************/
+ap_result DecruncherAgent::ExtractMember(APAgent_DecrunchFile *decrunchInfo)
+{
+	int32 i, count;
+	Unarchiver *item;
+	ArchiveIndex *archiveIndex = NULL;
+	ArchiveEntry entry;
+	PBinary destBuf;
+	PMemFile *memFile;
+	bool cached, found;
+	ap_result retVal;
+
+	// Find the unarchiver that understand the file
+	count = unarchivers.CountItems();
+
+	for (i = 0; i < count; i++)
+	{
+		item = unarchivers.GetItem(i);
+		if (item->Determine(decrunchInfo->file))
+		{
+			archiveIndex = GetArchiveIndex(item, decrunchInfo->file, cached);
+			break;
+		}
+	}
+
+	if (i == count)
+		return (AP_UNKNOWN);
+
+	if (archiveIndex == NULL)
+	{
+		ShowError(IDS_DECRUNCH_ERR_CORRUPT);
+		return (AP_ERROR);
+	}
+
+	// Look up the member
+	found = archiveIndex->FindEntry(decrunchInfo->archiveMember, entry);
+
+	if (cached)
+		indexLock.Unlock();
+	else
+		delete archiveIndex;
+
+	if (!found)
+	{
+		ShowError(IDS_DECRUNCH_ERR_NO_MEMBER);
+		return (AP_ERROR);
+	}
+
+	// Unpack the member
+	if (item->Extract(decrunchInfo->file, &entry, destBuf) != AP_OK)
+	{
+		ShowError(IDS_DECRUNCH_ERR_CORRUPT);
+		return (AP_ERROR);
+	}
+
+	// Create a memory file to hold the member
+	memFile = new PMemFile();
+	if (memFile == NULL)
+		retVal = AP_ERROR;
+	else
+	{
+		// Attach the allocated buffer to the memory file
+		memFile->Attach(destBuf.Detach(), entry.unpackedSize);
+
+		// Initialize the info structure
+		decrunchInfo->decrunchedFile = memFile;
+		decrunchInfo->fromArchive    = true;
+		retVal = AP_OK;
+	}
+
+	return (retVal);
+}
+
+
+
+/******************************************************************************/
+/* ListMembers() will return the names of all the members in the archive, if  */
+/*      the file is an archive one of the unarchivers understand.             */
+/*                                                                            */
+/* Input:  "listInfo" is a pointer to the list structure.                     */
+/*                                                                            */
+/* Output: The result from the listing.                                       */
+/******************************************************************************/
+ap_result DecruncherAgent::ListMembers(APAgent_ListMembers *listInfo)
+{
+	int32 i, count;
+	Unarchiver *item;
+	ArchiveIndex *archiveIndex = NULL;
+	bool cached;
+	ap_result retVal = AP_OK;
+
+	// Find the unarchiver that understand the file
+	count = unarchivers.CountItems();
+
+	for (i = 0; i < count; i++)
+	{
+		item = unarchivers.GetItem(i);
+		if (item->Determine(listInfo->file))
+		{
+			archiveIndex = GetArchiveIndex(item, listInfo->file, cached);
 			break;
 		}
 	}
 
+	if (i == count)
+		return (AP_UNKNOWN);
+
+	if (archiveIndex == NULL)
+	{
+		ShowError(IDS_DECRUNCH_ERR_CORRUPT);
+		return (AP_ERROR);
+	}
+
+	// Copy the names
+	try
+	{
+		listInfo->members.MakeEmpty();
+
+		count = archiveIndex->CountEntries();
+		for (i = 0; i < count; i++)
+			listInfo->members.AddTail(archiveIndex->GetEntryName(i));
+	}
+	catch(...)
+	{
+		retVal = AP_ERROR;
+	}
+
+	if (cached)
+		indexLock.Unlock();
+	else
+		delete archiveIndex;
+
 	return (retVal);
 }
+
+
+
+/******************************************************************************/
+/* GetArchiveIndex() will return the member index of the archive. Indexes of  */
+/*      archives on disk are cached, so the directory is only read the first  */
+/*      time a member is played from an archive.                              */
+/*                                                                            */
+/* Input:  "archiver" is a pointer to the unarchiver to build the index with. */
+/*         "file" is a pointer to the archive.                                */
+/*         "cached" is a reference where to store if the index is owned by    */
+/*         the cache. If true, the index lock is held and must be unlocked   */
+/*         when done, else the caller must delete the index.                  */
+/*                                                                            */
+/* Output: A pointer to the index or NULL if the archive is corrupt.          */
+/******************************************************************************/
+ArchiveIndex *DecruncherAgent::GetArchiveIndex(Unarchiver *archiver, PFile *file, bool &cached)
+{
+	ArchiveIndex *archiveIndex, *oldIndex;
+	PString name;
+	int32 i, count;
+
+	// Memory files can't be cached, since their names are borrowed
+	// from the file they were decrunched from
+	cached = !is_kind_of(file, PMemFile);
+
+	if (cached)
+	{
+		name = file->GetFullPath();
+
+		indexLock.Lock();
+
+		// Check the cache. The archive length is used to see
+		// if the archive has been changed since it was indexed
+		if (indexCache.GetItem(name, archiveIndex))
+		{
+			if ((archiveIndex->GetUnarchiver() == archiver) && (archiveIndex->GetArchiveLength() == file->GetLength()))
+				return (archiveIndex);
+
+			indexCache.RemoveItem(name);
+			delete archiveIndex;
+		}
+	}
+
+	// Build a new index
+	archiveIndex = new ArchiveIndex(archiver, file->GetLength());
+	if (archiveIndex == NULL)
+	{
+		if (cached)
+			indexLock.Unlock();
+
+		throw PMemoryException();
+	}
+
+	try
+	{
+		if (archiver->BuildIndex(file, archiveIndex) != AP_OK)
+		{
+			delete archiveIndex;
+			archiveIndex = NULL;
+		}
+	}
+	catch(...)
+	{
+		delete archiveIndex;
+		archiveIndex = NULL;
+	}
+
+	if (cached)
+	{
+		if (archiveIndex == NULL)
+			indexLock.Unlock();
+		else
+		{
+			// Flush the cache if it is full
+			if (indexCache.CountItems() >= INDEX_CACHE_SIZE)
+			{
+				count = indexCache.CountItems();
+
+				for (i = 0; i < count; i++)
+				{
+					indexCache.GetItem(i, oldIndex);
+					delete oldIndex;
+				}
+
+				indexCache.MakeEmpty();
+			}
+
+			indexCache.InsertItem(name, archiveIndex);
+		}
+	}
+
+	return (archiveIndex);
+}
+
+
+
+/******************************************************************************/
+/* ShowError() will show an error to the user.                                */
+/*                                                                            */
+/* Input:  "id" is the resource id of the error message.                      */
+/******************************************************************************/
+void DecruncherAgent::ShowError(int32 id)
+{
+	PString title, msg;
+
+	title.LoadString(res, IDS_DECRUNCH_WIN_TITLE);
+	msg.LoadString(res, id);
+
+	PAlert alert(title, msg, PAlert::pStop, PAlert::pOk);
+	alert.Show();
+}
@@ -17,6 +17,8 @@
 #include "PString.h"
 #include "PResource.h"
 #include "PList.h"
+#include "PSkipList.h"
+#include "PSynchronize.h"
 
 // APlayerKit headers
 #include "APAddOns.h"
@@ -46,10 +48,19 @@ public:
 
 protected:
 	ap_result DecrunchFile(APAgent_DecrunchFile *decrunchInfo);
+	ap_result ExtractMember(APAgent_DecrunchFile *decrunchInfo);
+	ap_result ListMembers(APAgent_ListMembers *listInfo);
+	ArchiveIndex *GetArchiveIndex(Unarchiver *archiver, PFile *file, bool &cached);
+
+	void ShowError(int32 id);
 
 	PResource *res;
 
 	PList<Decruncher *> decrunchers;
+	PList<Unarchiver *> unarchivers;
+
+	PMutex indexLock;
+	PSkipList<PString, ArchiveIndex *> indexCache;
 };
 
 #endif
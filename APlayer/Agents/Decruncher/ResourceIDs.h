@@ -17,3 +17,4 @@
 #define IDS_DECRUNCH_WIN_TITLE						100
 
 #define IDS_DECRUNCH_ERR_CORRUPT					1001
+#define IDS_DECRUNCH_ERR_NO_MEMBER					1002
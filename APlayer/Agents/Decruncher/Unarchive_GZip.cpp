@@ -0,0 +1,164 @@
+/******************************************************************************/
+/* Unarchiver for GZIP files class.                                           */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PBinary.h"
+#include "PFile.h"
+
+// APlayerKit headers
+#include "APAddOns.h"
+
+// Agent headers
+#include "Decruncher.h"
+
+// zlib headers
+#include <zlib.h>
+
+
+/******************************************************************************/
+/* GZIP header flags                                                          */
+/******************************************************************************/
+#define GZIP_HEADER_SIZE		10
+#define GZIP_TRAILER_SIZE		8
+
+#define GZIP_FLAG_EXTRA			0x04
+#define GZIP_FLAG_NAME			0x08
+
+
+
+/******************************************************************************/
+/* Determine() will check the file to see if it's a GZIP file.                */
+/*                                                                            */
+/* Input:  "file" is a pointer to the file to check.                          */
+/*                                                                            */
+/* Output: True if it's an archive this unarchiver understand.                */
+/******************************************************************************/
+bool Unarchive_GZip::Determine(PFile *file)
+{
+	uint8 mark[3];
+
+	// Check the file size
+	if (file->GetLength() < (GZIP_HEADER_SIZE + GZIP_TRAILER_SIZE))
+		return (false);
+
+	// Check the mark and the compression method (only deflate exists)
+	file->SeekToBegin();
+	file->Read(mark, 3);
+
+	if ((mark[0] != 0x1f) || (mark[1] != 0x8b) || (mark[2] != 8))
+		return (false);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* BuildIndex() will add the single member to the index. The member name is   */
+/*      taken from the header if stored, else it is the archive name without  */
+/*      the extension. Stored names are always ISO-8859-1.                    */
+/*                                                                            */
+/* Input:  "file" is a pointer to the archive.                                */
+/*         "index" is a pointer to the index to fill out.                     */
+/*                                                                            */
+/* Output: Is an APlayer return code.                                         */
+/******************************************************************************/
+ap_result Unarchive_GZip::BuildIndex(PFile *file, ArchiveIndex *index)
+{
+	PCharSet_ISO_8859_1 charSet;
+	ArchiveEntry entry;
+	PString name;
+	uint8 header[GZIP_HEADER_SIZE];
+	uint8 trailer[GZIP_TRAILER_SIZE];
+	char nameBuf[256];
+	int32 pos;
+
+	// Read the header
+	file->SeekToBegin();
+	file->Read(header, GZIP_HEADER_SIZE);
+
+	// Get the original name if stored
+	if (header[3] & GZIP_FLAG_NAME)
+	{
+		if (header[3] & GZIP_FLAG_EXTRA)
+			file->Seek(file->Read_L_UINT16(), PFile::pSeekCurrent);
+
+		// The name is null terminated
+		for (pos = 0; pos < (int32)sizeof(nameBuf) - 1; pos++)
+		{
+			nameBuf[pos] = file->Read_UINT8();
+			if (nameBuf[pos] == 0x00)
+				break;
+		}
+
+		name.SetString(nameBuf, pos, &charSet);
+	}
+	else
+	{
+		name = file->GetFileName();
+		pos  = name.ReverseFind('.');
+		if (pos > 0)
+			name = name.Left(pos);
+	}
+
+	// The size of the unpacked data is stored in the trailer
+	file->Seek(-GZIP_TRAILER_SIZE, PFile::pSeekEnd);
+	file->Read(trailer, GZIP_TRAILER_SIZE);
+
+	entry.offset       = 0;
+	entry.packedSize   = (uint32)file->GetLength();
+	entry.unpackedSize = GetL32(trailer + 4);
+	entry.method       = header[2];
+	entry.crc          = GetL32(trailer);
+
+	// The unpacked size comes from the file, so check it before it
+	// is used to allocate the buffer
+	if (!CheckEntry(entry, 0, file->GetLength(), DEFLATE_MAX_RATIO))
+		return (AP_ERROR);
+
+	index->AddEntry(name, entry);
+
+	return (AP_OK);
+}
+
+
+
+/******************************************************************************/
+/* Extract() will unpack the member.                                          */
+/*                                                                            */
+/* Input:  "file" is a pointer to the archive.                                */
+/*         "entry" is a pointer to the member to unpack.                      */
+/*         "destBuf" is a reference where to write the unpacked data.         */
+/*                                                                            */
+/* Output: Is an APlayer return code.                                         */
+/******************************************************************************/
+ap_result Unarchive_GZip::Extract(PFile *file, const ArchiveEntry *entry, PBinary &destBuf)
+{
+	PBinary sourceBuf;
+	uint8 *dest;
+
+	// Read the whole file. zlib takes care of the header and trailer
+	sourceBuf.SetLength(entry->packedSize);
+	file->SeekToBegin();
+	if (file->Read(sourceBuf.GetBufferForWriting(), entry->packedSize) != (int32)entry->packedSize)
+		return (AP_ERROR);
+
+	// Allocate the destination buffer and unpack the data
+	destBuf.SetLength(entry->unpackedSize);
+	dest = destBuf.GetBufferForWriting();
+
+	if (!Inflate(sourceBuf.GetBufferForReadOnly(), entry->packedSize, dest, entry->unpackedSize, 16 + MAX_WBITS))
+		return (AP_ERROR);
+
+	return (AP_OK);
+}
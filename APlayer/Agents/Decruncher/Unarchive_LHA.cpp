@@ -0,0 +1,707 @@
+/******************************************************************************/
+/* Unarchiver for LHA/LZH archives class.                                     */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PBinary.h"
+#include "PFile.h"
+
+// APlayerKit headers
+#include "APAddOns.h"
+
+// Agent headers
+#include "Decruncher.h"
+
+
+/******************************************************************************/
+/* LHA header and decoder constants                                           */
+/******************************************************************************/
+#define LHA_MIN_HEADER			22
+#define LHA_MAX_HEADER			4096
+
+#define LHA_EXT_FILENAME		0x01
+#define LHA_EXT_DIRNAME			0x02
+
+#define LHA_THRESHOLD			3		// Minimum match length
+#define LHA_CBIT				9		// Bits used to store the number of literal codes
+#define LHA_TBIT				5		// Bits used to store the number of code length codes
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+Unarchive_LHA::Unarchive_LHA(void)
+{
+	uint16 crc;
+	int32 i, j;
+
+	// Build the CRC-16 table used to check the unpacked data
+	for (i = 0; i < 256; i++)
+	{
+		crc = i;
+		for (j = 0; j < 8; j++)
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xa001) : (crc >> 1);
+
+		crcTable[i] = crc;
+	}
+}
+
+
+
+/******************************************************************************/
+/* Determine() will check the file to see if it's a LHA archive.              */
+/*                                                                            */
+/* Input:  "file" is a pointer to the file to check.                          */
+/*                                                                            */
+/* Output: True if it's an archive this unarchiver understand.                */
+/******************************************************************************/
+bool Unarchive_LHA::Determine(PFile *file)
+{
+	uint8 header[LHA_MIN_HEADER];
+
+	// Check the file size
+	if (file->GetLength() < LHA_MIN_HEADER)
+		return (false);
+
+	// Check the method mark in the first header
+	file->SeekToBegin();
+	file->Read(header, LHA_MIN_HEADER);
+
+	if ((header[2] != '-') || (header[3] != 'l') || (header[6] != '-'))
+		return (false);
+
+	if ((header[4] != 'h') && (header[4] != 'z'))
+		return (false);
+
+	// Check the header level
+	if (header[20] > 2)
+		return (false);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* BuildIndex() will walk all the member headers and add the members to the   */
+/*      index. Only the headers are read, the data is skipped.                */
+/*                                                                            */
+/* Input:  "file" is a pointer to the archive.                                */
+/*         "index" is a pointer to the index to fill out.                     */
+/*                                                                            */
+/* Output: Is an APlayer return code.                                         */
+/******************************************************************************/
+ap_result Unarchive_LHA::BuildIndex(PFile *file, ArchiveIndex *index)
+{
+	PCharSet_Amiga charSet;
+	ArchiveEntry entry;
+	PString name, dirName;
+	uint8 header[LHA_MAX_HEADER];
+	uint8 *ext;
+	int64 pos, length;
+	int32 headerLen, level, extLen, i;
+
+	length = file->GetLength();
+	pos    = 0;
+
+	while ((pos + LHA_MIN_HEADER) <= length)
+	{
+		// Read the fixed part of the header
+		file->Seek(pos, PFile::pSeekBegin);
+		if (file->Read(header, LHA_MIN_HEADER) != LHA_MIN_HEADER)
+			break;
+
+		// A zero header size marks the end of the archive
+		if (header[0] == 0x00)
+			break;
+
+		level = header[20];
+		if (level > 2)
+			return (AP_ERROR);
+
+		if (level == 2)
+			headerLen = GetL16(header);
+		else
+			headerLen = header[0] + 2;
+
+		if ((headerLen < LHA_MIN_HEADER) || (headerLen > LHA_MAX_HEADER))
+			return (AP_ERROR);
+
+		// Read the rest of the base header
+		if (file->Read(header + LHA_MIN_HEADER, headerLen - LHA_MIN_HEADER) != (headerLen - LHA_MIN_HEADER))
+			return (AP_ERROR);
+
+		entry.packedSize   = GetL32(header + 7);
+		entry.unpackedSize = GetL32(header + 11);
+		entry.method       = 0;
+
+		// Find the dictionary size from the method
+		if (header[3] == 'l')
+		{
+			if (header[4] == 'h')
+			{
+				switch (header[5])
+				{
+					case '0':
+						entry.method = 0;
+						break;
+
+					case '4':
+						entry.method = 12;
+						break;
+
+					case '5':
+						entry.method = 13;
+						break;
+
+					case '6':
+						entry.method = 15;
+						break;
+
+					case '7':
+						entry.method = 16;
+						break;
+
+					default:
+						entry.method = 0xffffffff;
+						break;
+				}
+			}
+			else if ((header[4] == 'z') && (header[5] == '4'))
+				entry.method = 0;
+			else
+				entry.method = 0xffffffff;
+		}
+
+		name.MakeEmpty();
+		dirName.MakeEmpty();
+
+		if (level == 2)
+		{
+			// Level 2 headers only have extended headers
+			entry.crc    = GetL16(header + 21);
+			entry.offset = pos + headerLen;
+			ext          = header + 24;
+		}
+		else
+		{
+			// Level 0 and 1 headers holds the name in the base header
+			if ((22 + header[21] + 2) > headerLen)
+				return (AP_ERROR);
+
+			name.SetString((const char *)header + 22, header[21], &charSet);
+			entry.crc    = GetL16(header + 22 + header[21]);
+			entry.offset = pos + headerLen;
+			ext          = (level == 1) ? (header + headerLen - 2) : NULL;
+		}
+
+		// Parse the extended headers. Level 1 extended headers are
+		// counted in the packed size and are read from the file
+		if (ext != NULL)
+		{
+			uint8 extBuf[LHA_MAX_HEADER];
+			uint8 *extData;
+
+			extLen = GetL16(ext);
+
+			while (extLen != 0)
+			{
+				if (level == 1)
+				{
+					if ((extLen < 3) || (extLen > LHA_MAX_HEADER))
+						return (AP_ERROR);
+
+					file->Seek(entry.offset, PFile::pSeekBegin);
+					if (file->Read(extBuf, extLen) != extLen)
+						return (AP_ERROR);
+
+					entry.offset     += extLen;
+					entry.packedSize -= extLen;
+					extData           = extBuf;
+				}
+				else
+				{
+					if ((extLen < 3) || ((ext + 2 + extLen) > (header + headerLen)))
+						return (AP_ERROR);
+
+					extData = ext + 2;
+				}
+
+				// The extended header is a type byte, the data and the
+				// size of the next extended header
+				if (extData[0] == LHA_EXT_FILENAME)
+					name.SetString((const char *)extData + 1, extLen - 3, &charSet);
+				else if (extData[0] == LHA_EXT_DIRNAME)
+				{
+					// Directory names use 0xff as separator
+					for (i = 1; i < extLen - 2; i++)
+					{
+						if (extData[i] == 0xff)
+							extData[i] = '/';
+					}
+
+					dirName.SetString((const char *)extData + 1, extLen - 3, &charSet);
+					if (!dirName.IsEmpty() && (dirName.GetAt(dirName.GetLength() - 1) != '/'))
+						dirName += "/";
+				}
+
+				if (level == 2)
+					ext += extLen;
+
+				extLen = GetL16(extData + extLen - 2);
+			}
+		}
+
+		// Use the same directory separator as in ZIP archives
+		name = dirName + name;
+		name.Replace('\\', '/');
+
+		// Add the member if we can unpack it
+		if ((entry.method != 0xffffffff) && !name.IsEmpty() && (name.GetAt(name.GetLength() - 1) != '/'))
+		{
+			// The packed data has to be inside the archive. Stored
+			// members are read directly with the unpacked size
+			if (!CheckEntry(entry, entry.offset, length, (entry.method == 0) ? 1 : 0))
+				return (AP_ERROR);
+
+			index->AddEntry(name, entry);
+		}
+
+		// Go to the next header
+		pos = entry.offset + entry.packedSize;
+	}
+
+	return (AP_OK);
+}
+
+
+
+/******************************************************************************/
+/* Extract() will unpack a single member.                                     */
+/*                                                                            */
+/* Input:  "file" is a pointer to the archive.                                */
+/*         "entry" is a pointer to the member to unpack.                      */
+/*         "destBuf" is a reference where to write the unpacked data.         */
+/*                                                                            */
+/* Output: Is an APlayer return code.                                         */
+/******************************************************************************/
+ap_result Unarchive_LHA::Extract(PFile *file, const ArchiveEntry *entry, PBinary &destBuf)
+{
+	PBinary sourceBuf;
+	uint8 *dest;
+
+	// Allocate the destination buffer
+	destBuf.SetLength(entry->unpackedSize);
+	dest = destBuf.GetBufferForWriting();
+
+	file->Seek(entry->offset, PFile::pSeekBegin);
+
+	if (entry->method == 0)
+	{
+		// Stored members are read directly into the destination
+		if (file->Read(dest, entry->unpackedSize) != (int32)entry->unpackedSize)
+			return (AP_ERROR);
+	}
+	else
+	{
+		// Read the packed data and decode it
+		sourceBuf.SetLength(entry->packedSize);
+		if (file->Read(sourceBuf.GetBufferForWriting(), entry->packedSize) != (int32)entry->packedSize)
+			return (AP_ERROR);
+
+		if (!Decode(sourceBuf.GetBufferForReadOnly(), entry->packedSize, dest, entry->unpackedSize, entry->method))
+			return (AP_ERROR);
+	}
+
+	// Check the data
+	if (CalcCRC16(dest, entry->unpackedSize) != entry->crc)
+		return (AP_ERROR);
+
+	return (AP_OK);
+}
+
+
+
+/******************************************************************************/
+/* Decode() will unpack data packed with the static Huffman methods, that is  */
+/*      -lh4-, -lh5-, -lh6- and -lh7-.                                        */
+/*                                                                            */
+/* Input:  "src" is a pointer to the packed data.                             */
+/*         "srcLen" is the length of the packed data.                         */
+/*         "dest" is a pointer where to write the unpacked data.              */
+/*         "destLen" is the length of the unpacked data.                      */
+/*         "dicBit" is the number of bits in the dictionary size.             */
+/*                                                                            */
+/* Output: True for success, false if the data is corrupt.                    */
+/******************************************************************************/
+bool Unarchive_LHA::Decode(const uint8 *src, uint32 srcLen, uint8 *dest, uint32 destLen, int32 dicBit)
+{
+	uint32 pos, blockSize, len;
+	int32 np, pBit, c, p, from;
+
+	// Find the number of position codes
+	if (dicBit <= 13)
+	{
+		np   = 14;
+		pBit = 4;
+	}
+	else
+	{
+		np   = (dicBit == 16) ? 17 : 16;
+		pBit = 5;
+	}
+
+	// Initialize the bit reader
+	source    = src;
+	sourceEnd = src + srcLen;
+	bitBuf    = 0;
+	bitCount  = 0;
+	overrun   = 0;
+
+	pos       = 0;
+	blockSize = 0;
+
+	while (pos < destLen)
+	{
+		// Read the Huffman tables at the start of each block
+		if (blockSize == 0)
+		{
+			blockSize = GetBits(16);
+
+			if (!ReadPtLen(LHA_NT, LHA_TBIT, 3) || !ReadCLen() || !ReadPtLen(np, pBit, -1))
+				return (false);
+		}
+
+		blockSize--;
+
+		c = DecodeSymbol(cTable);
+		if (c < 0)
+			return (false);
+
+		if (c < 256)
+		{
+			// Literal byte
+			dest[pos++] = c;
+		}
+		else
+		{
+			// Copy a match from the already unpacked data
+			len = c - 256 + LHA_THRESHOLD;
+
+			p = DecodeSymbol(ptTable);
+			if ((p < 0) || (p >= np))
+				return (false);
+
+			if (p != 0)
+				p = (1 << (p - 1)) + GetBits(p - 1);
+
+			from = (int32)pos - p - 1;
+
+			if (len > (destLen - pos))
+				len = destLen - pos;
+
+			for (; len > 0; len--, from++)
+			{
+				// The dictionary starts filled with spaces
+				dest[pos++] = (from < 0) ? ' ' : dest[from];
+			}
+		}
+
+		if (overrun > 4)
+			return (false);
+	}
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* ReadPtLen() will read the bit lengths of the code length or position       */
+/*      table and build the decode table.                                     */
+/*                                                                            */
+/* Input:  "nn" is the number of codes in the table.                          */
+/*         "nBit" is the number of bits used to store the number of codes.    */
+/*         "iSpecial" is the index after which a run of zeros is stored or    */
+/*         -1 if none.                                                        */
+/*                                                                            */
+/* Output: True for success, false if the data is corrupt.                    */
+/******************************************************************************/
+bool Unarchive_LHA::ReadPtLen(int32 nn, int32 nBit, int32 iSpecial)
+{
+	int32 i, n, c;
+
+	n = GetBits(nBit);
+	if (n == 0)
+	{
+		// Only one code is used
+		c = GetBits(nBit);
+		if (c >= nn)
+			return (false);
+
+		memset(ptLen, 0, sizeof(ptLen));
+		ptTable.single = c;
+		return (true);
+	}
+
+	if (n > nn)
+		return (false);
+
+	i = 0;
+	while (i < n)
+	{
+		// Bit lengths above 6 are stored as a unary number
+		c = GetBits(3);
+		if (c == 7)
+		{
+			while (GetBits(1) != 0)
+			{
+				c++;
+				if (c > 16)
+					return (false);
+			}
+		}
+
+		ptLen[i++] = c;
+
+		if (i == iSpecial)
+		{
+			c = GetBits(2);
+			while ((c-- > 0) && (i < nn))
+				ptLen[i++] = 0;
+		}
+	}
+
+	while (i < nn)
+		ptLen[i++] = 0;
+
+	return (MakeTable(nn, ptLen, ptTable));
+}
+
+
+
+/******************************************************************************/
+/* ReadCLen() will read the bit lengths of the literal/length table and build */
+/*      the decode table.                                                     */
+/*                                                                            */
+/* Output: True for success, false if the data is corrupt.                    */
+/******************************************************************************/
+bool Unarchive_LHA::ReadCLen(void)
+{
+	int32 i, n, c;
+
+	n = GetBits(LHA_CBIT);
+	if (n == 0)
+	{
+		// Only one code is used
+		c = GetBits(LHA_CBIT);
+		if (c >= LHA_NC)
+			return (false);
+
+		memset(cLen, 0, sizeof(cLen));
+		cTable.single = c;
+		return (true);
+	}
+
+	if (n > LHA_NC)
+		return (false);
+
+	i = 0;
+	while (i < n)
+	{
+		c = DecodeSymbol(ptTable);
+		if (c < 0)
+			return (false);
+
+		if (c <= 2)
+		{
+			// Run of zero lengths
+			if (c == 0)
+				c = 1;
+			else if (c == 1)
+				c = GetBits(4) + 3;
+			else
+				c = GetBits(LHA_CBIT) + 20;
+
+			while ((c-- > 0) && (i < LHA_NC))
+				cLen[i++] = 0;
+		}
+		else
+			cLen[i++] = c - 2;
+	}
+
+	while (i < LHA_NC)
+		cLen[i++] = 0;
+
+	return (MakeTable(LHA_NC, cLen, cTable));
+}
+
+
+
+/******************************************************************************/
+/* MakeTable() will build a canonical Huffman decode table from the bit       */
+/*      lengths.                                                              */
+/*                                                                            */
+/* Input:  "nChar" is the number of symbols.                                  */
+/*         "bitLen" is a pointer to the bit length of each symbol.            */
+/*         "table" is a reference to the table to build.                      */
+/*                                                                            */
+/* Output: True for success, false if the lengths are invalid.                */
+/******************************************************************************/
+bool Unarchive_LHA::MakeTable(int32 nChar, const uint8 *bitLen, HuffTable &table)
+{
+	uint16 count[17];
+	uint16 next[17];
+	uint32 code;
+	int32 i;
+
+	// Count the number of codes for each bit length
+	memset(count, 0, sizeof(count));
+
+	for (i = 0; i < nChar; i++)
+	{
+		if (bitLen[i] > 16)
+			return (false);
+
+		count[bitLen[i]]++;
+	}
+
+	// Find the first code and the symbol index for each bit length.
+	// The codes are stored left justified in 16 bits, so a single
+	// compare tells if a peeked code has the current length
+	code = 0;
+	i    = 0;
+
+	for (int32 len = 1; len <= 16; len++)
+	{
+		table.base[len]   = code << (16 - len);
+		code             += count[len];
+		table.limit[len]  = code << (16 - len);
+		table.offset[len] = i;
+		next[len]         = i;
+		i                += count[len];
+
+		if (code > (1UL << len))
+			return (false);
+
+		code <<= 1;
+	}
+
+	// Sort the symbols by bit length
+	for (i = 0; i < nChar; i++)
+	{
+		if (bitLen[i] != 0)
+			table.symbols[next[bitLen[i]]++] = i;
+	}
+
+	table.single = -1;
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* DecodeSymbol() will read a single Huffman code from the packed data.       */
+/*                                                                            */
+/* Input:  "table" is a reference to the table to use.                        */
+/*                                                                            */
+/* Output: The decoded symbol or -1 if the data is corrupt.                   */
+/******************************************************************************/
+int32 Unarchive_LHA::DecodeSymbol(const HuffTable &table)
+{
+	uint32 code;
+	int32 len;
+
+	if (table.single >= 0)
+		return (table.single);
+
+	// Make sure there are at least 16 bits in the buffer
+	while (bitCount <= 24)
+	{
+		if (source < sourceEnd)
+			bitBuf |= (uint32)*source++ << (24 - bitCount);
+		else
+			overrun++;
+
+		bitCount += 8;
+	}
+
+	code = bitBuf >> 16;
+
+	for (len = 1; len <= 16; len++)
+	{
+		if (code < table.limit[len])
+		{
+			bitBuf   <<= len;
+			bitCount  -= len;
+
+			return (table.symbols[table.offset[len] + ((code - table.base[len]) >> (16 - len))]);
+		}
+	}
+
+	return (-1);
+}
+
+
+
+/******************************************************************************/
+/* GetBits() will get a number of bits from the packed data and return it.    */
+/*                                                                            */
+/* Input:  "num" is the number of bits to return (0-16).                      */
+/*                                                                            */
+/* Output: The the retrieved number.                                          */
+/******************************************************************************/
+uint32 Unarchive_LHA::GetBits(int32 num)
+{
+	uint32 result;
+
+	if (num == 0)
+		return (0);
+
+	while (bitCount <= 24)
+	{
+		if (source < sourceEnd)
+			bitBuf |= (uint32)*source++ << (24 - bitCount);
+		else
+			overrun++;
+
+		bitCount += 8;
+	}
+
+	result     = bitBuf >> (32 - num);
+	bitBuf   <<= num;
+	bitCount  -= num;
+
+	return (result);
+}
+
+
+
+/******************************************************************************/
+/* CalcCRC16() will calculate the LHA checksum of a buffer.                   */
+/*                                                                            */
+/* Input:  "data" is a pointer to the data.                                   */
+/*         "length" is the length of the data.                                */
+/*                                                                            */
+/* Output: The checksum.                                                      */
+/******************************************************************************/
+uint16 Unarchive_LHA::CalcCRC16(const uint8 *data, uint32 length)
+{
+	uint16 crc = 0;
+
+	while (length--)
+		crc = crcTable[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+
+	return (crc);
+}
@@ -0,0 +1,237 @@
+/******************************************************************************/
+/* Unarchiver for ZIP archives class.                                         */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PBinary.h"
+#include "PFile.h"
+
+// APlayerKit headers
+#include "APAddOns.h"
+
+// Agent headers
+#include "Decruncher.h"
+
+// zlib headers
+#include <zlib.h>
+
+
+/******************************************************************************/
+/* ZIP structure sizes and signatures                                         */
+/******************************************************************************/
+#define ZIP_LOCAL_SIG			0x04034b50
+#define ZIP_CENTRAL_SIG			0x02014b50
+#define ZIP_END_SIG				0x06054b50
+
+#define ZIP_LOCAL_SIZE			30
+#define ZIP_CENTRAL_SIZE		46
+#define ZIP_END_SIZE			22
+#define ZIP_MAX_COMMENT			65535
+
+#define ZIP_METHOD_STORED		0
+#define ZIP_METHOD_DEFLATED		8
+
+#define ZIP_FLAG_ENCRYPTED		0x0001
+#define ZIP_FLAG_UTF8			0x0800
+
+
+
+/******************************************************************************/
+/* Determine() will check the file to see if it's a ZIP archive.              */
+/*                                                                            */
+/* Input:  "file" is a pointer to the file to check.                          */
+/*                                                                            */
+/* Output: True if it's an archive this unarchiver understand.                */
+/******************************************************************************/
+bool Unarchive_Zip::Determine(PFile *file)
+{
+	uint8 mark[4];
+
+	// Check the file size
+	if (file->GetLength() < ZIP_END_SIZE)
+		return (false);
+
+	// Check the mark of the first local header
+	file->SeekToBegin();
+	file->Read(mark, 4);
+
+	if (GetL32(mark) != ZIP_LOCAL_SIG)
+		return (false);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* BuildIndex() will read the central directory and add all the members to    */
+/*      the index. The whole directory is read with a single file read.       */
+/*                                                                            */
+/* Input:  "file" is a pointer to the archive.                                */
+/*         "index" is a pointer to the index to fill out.                     */
+/*                                                                            */
+/* Output: Is an APlayer return code.                                         */
+/******************************************************************************/
+ap_result Unarchive_Zip::BuildIndex(PFile *file, ArchiveIndex *index)
+{
+	PBinary tailBuf, dirBuf;
+	const uint8 *tail, *dir, *dirEnd;
+	PCharSet_UTF8 utf8CharSet;
+	PCharSet_OEM_850 oemCharSet;
+	ArchiveEntry entry;
+	PString name;
+	int64 length;
+	int32 tailLen, i;
+	uint32 dirSize, dirOffset;
+	uint16 flags, nameLen, extraLen, commentLen;
+
+	// Read the end of the file, where the end of central directory
+	// record is stored together with the archive comment
+	length  = file->GetLength();
+	tailLen = (int32)min(length, (int64)(ZIP_END_SIZE + ZIP_MAX_COMMENT));
+
+	tailBuf.SetLength(tailLen);
+	file->Seek(length - tailLen, PFile::pSeekBegin);
+	if (file->Read(tailBuf.GetBufferForWriting(), tailLen) != tailLen)
+		return (AP_ERROR);
+
+	// Search backwards after the end record
+	tail = tailBuf.GetBufferForReadOnly();
+
+	for (i = tailLen - ZIP_END_SIZE; i >= 0; i--)
+	{
+		if (GetL32(tail + i) == ZIP_END_SIG)
+			break;
+	}
+
+	if (i < 0)
+		return (AP_ERROR);
+
+	// Find the central directory
+	dirSize   = GetL32(tail + i + 12);
+	dirOffset = GetL32(tail + i + 16);
+
+	if (((int64)dirOffset + dirSize) > length)
+		return (AP_ERROR);
+
+	// Read the whole central directory at once
+	dirBuf.SetLength(dirSize);
+	file->Seek(dirOffset, PFile::pSeekBegin);
+	if (file->Read(dirBuf.GetBufferForWriting(), dirSize) != (int32)dirSize)
+		return (AP_ERROR);
+
+	dir    = dirBuf.GetBufferForReadOnly();
+	dirEnd = dir + dirSize;
+
+	// Parse all the file headers
+	while ((dir + ZIP_CENTRAL_SIZE) <= dirEnd)
+	{
+		if (GetL32(dir) != ZIP_CENTRAL_SIG)
+			break;
+
+		flags      = GetL16(dir + 8);
+		nameLen    = GetL16(dir + 28);
+		extraLen   = GetL16(dir + 30);
+		commentLen = GetL16(dir + 32);
+
+		if ((dir + ZIP_CENTRAL_SIZE + nameLen) > dirEnd)
+			return (AP_ERROR);
+
+		entry.method       = GetL16(dir + 10);
+		entry.crc          = GetL32(dir + 16);
+		entry.packedSize   = GetL32(dir + 20);
+		entry.unpackedSize = GetL32(dir + 24);
+		entry.offset       = GetL32(dir + 42);
+
+		// Skip directories and members we can't unpack anyway
+		if ((nameLen != 0) && (dir[ZIP_CENTRAL_SIZE + nameLen - 1] != '/') && !(flags & ZIP_FLAG_ENCRYPTED))
+		{
+			if ((entry.method == ZIP_METHOD_STORED) || (entry.method == ZIP_METHOD_DEFLATED))
+			{
+				// The sizes are used to allocate the buffers when
+				// extracting, so check them against the archive
+				if (!CheckEntry(entry, entry.offset + ZIP_LOCAL_SIZE, length, (entry.method == ZIP_METHOD_STORED) ? 1 : DEFLATE_MAX_RATIO))
+					return (AP_ERROR);
+
+				name.SetString((const char *)dir + ZIP_CENTRAL_SIZE, nameLen, (flags & ZIP_FLAG_UTF8) ? (PCharacterSet *)&utf8CharSet : (PCharacterSet *)&oemCharSet);
+				index->AddEntry(name, entry);
+			}
+		}
+
+		dir += ZIP_CENTRAL_SIZE + nameLen + extraLen + commentLen;
+	}
+
+	return (AP_OK);
+}
+
+
+
+/******************************************************************************/
+/* Extract() will unpack a single member.                                     */
+/*                                                                            */
+/* Input:  "file" is a pointer to the archive.                                */
+/*         "entry" is a pointer to the member to unpack.                      */
+/*         "destBuf" is a reference where to write the unpacked data.         */
+/*                                                                            */
+/* Output: Is an APlayer return code.                                         */
+/******************************************************************************/
+ap_result Unarchive_Zip::Extract(PFile *file, const ArchiveEntry *entry, PBinary &destBuf)
+{
+	PBinary sourceBuf;
+	uint8 header[ZIP_LOCAL_SIZE];
+	uint8 *dest;
+
+	// Read the local header to find the start of the data
+	file->Seek(entry->offset, PFile::pSeekBegin);
+	if (file->Read(header, ZIP_LOCAL_SIZE) != ZIP_LOCAL_SIZE)
+		return (AP_ERROR);
+
+	if (GetL32(header) != ZIP_LOCAL_SIG)
+		return (AP_ERROR);
+
+	file->Seek(GetL16(header + 26) + GetL16(header + 28), PFile::pSeekCurrent);
+
+	// The local header can have other name and extra field lengths
+	// than the central directory, so check the data position again
+	if (!CheckEntry(*entry, file->GetPosition(), file->GetLength(), 0))
+		return (AP_ERROR);
+
+	// Allocate the destination buffer
+	destBuf.SetLength(entry->unpackedSize);
+	dest = destBuf.GetBufferForWriting();
+
+	if (entry->method == ZIP_METHOD_STORED)
+	{
+		// Stored members are read directly into the destination
+		if (entry->packedSize != entry->unpackedSize)
+			return (AP_ERROR);
+
+		if (file->Read(dest, entry->unpackedSize) != (int32)entry->unpackedSize)
+			return (AP_ERROR);
+	}
+	else
+	{
+		// Read the packed data and inflate it
+		sourceBuf.SetLength(entry->packedSize);
+		if (file->Read(sourceBuf.GetBufferForWriting(), entry->packedSize) != (int32)entry->packedSize)
+			return (AP_ERROR);
+
+		if (!Inflate(sourceBuf.GetBufferForReadOnly(), entry->packedSize, dest, entry->unpackedSize, -MAX_WBITS))
+			return (AP_ERROR);
+	}
+
+	// Check the data
+	if (crc32(crc32(0, Z_NULL, 0), dest, entry->unpackedSize) != entry->crc)
+		return (AP_ERROR);
+
+	return (AP_OK);
+}
@@ -0,0 +1,219 @@
+/******************************************************************************/
+/* Unarchiver class.                                                          */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PSkipList.h"
+
+// Agent headers
+#include "Decruncher.h"
+
+// zlib headers
+#include <zlib.h>
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+ArchiveIndex::ArchiveIndex(Unarchiver *archiver, int64 length)
+{
+	// Initialize member variables
+	unarchiver    = archiver;
+	archiveLength = length;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+ArchiveIndex::~ArchiveIndex(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* AddEntry() will add a single member to the index.                          */
+/*                                                                            */
+/* Input:  "name" is the full name of the member inside the archive.          */
+/*         "entry" is a reference to the member information.                  */
+/******************************************************************************/
+void ArchiveIndex::AddEntry(PString name, const ArchiveEntry &entry)
+{
+	// If the archive holds the same name twice, the first one wins.
+	// The names are also kept in archive order, so the first member
+	// can be used when no member name has been given
+	if (entries.InsertItem(name, entry))
+		names.AddTail(name);
+}
+
+
+
+/******************************************************************************/
+/* FindEntry() will look up a member in the index.                            */
+/*                                                                            */
+/* Input:  "name" is the name of the member to find. If empty, the first      */
+/*         member in the archive is returned.                                 */
+/*         "entry" is a reference where the member information is stored.     */
+/*                                                                            */
+/* Output: True if the member was found, false if not.                        */
+/******************************************************************************/
+bool ArchiveIndex::FindEntry(PString name, ArchiveEntry &entry) const
+{
+	if (name.IsEmpty())
+	{
+		if (names.IsEmpty())
+			return (false);
+
+		name = names.GetItem(0);
+	}
+
+	return (entries.GetItem(name, entry));
+}
+
+
+
+/******************************************************************************/
+/* GetEntryName() returns the name of a member in archive order.              */
+/*                                                                            */
+/* Input:  "index" is the member number starting from 0.                      */
+/*                                                                            */
+/* Output: The name of the member.                                            */
+/******************************************************************************/
+PString ArchiveIndex::GetEntryName(int32 index) const
+{
+	return (names.GetItem(index));
+}
+
+
+
+/******************************************************************************/
+/* GetUnarchiver() returns the unarchiver that built the index.               */
+/*                                                                            */
+/* Output: The unarchiver to use when extracting members.                     */
+/******************************************************************************/
+Unarchiver *ArchiveIndex::GetUnarchiver(void) const
+{
+	return (unarchiver);
+}
+
+
+
+/******************************************************************************/
+/* GetArchiveLength() returns the length of the archive the index was built   */
+/*      from.                                                                 */
+/*                                                                            */
+/* Output: The length of the archive.                                         */
+/******************************************************************************/
+int64 ArchiveIndex::GetArchiveLength(void) const
+{
+	return (archiveLength);
+}
+
+
+
+/******************************************************************************/
+/* CountEntries() returns the number of members in the index.                 */
+/*                                                                            */
+/* Output: The number of members.                                             */
+/******************************************************************************/
+int32 ArchiveIndex::CountEntries(void) const
+{
+	return (entries.CountItems());
+}
+
+
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+Unarchiver::Unarchiver(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+Unarchiver::~Unarchiver(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* CheckEntry() will check the sizes read from a member header against the    */
+/*      archive, so no buffers are allocated from sizes that can't be right.  */
+/*                                                                            */
+/* Input:  "entry" is a reference to the member information.                  */
+/*         "dataOffset" is where the packed data starts in the archive.       */
+/*         "archiveLength" is the length of the archive.                      */
+/*         "maxRatio" is the best packing ratio the method can reach or 0 if  */
+/*         the unpacked size should not be checked.                           */
+/*                                                                            */
+/* Output: True if the sizes are possible, false if not.                      */
+/******************************************************************************/
+bool Unarchiver::CheckEntry(const ArchiveEntry &entry, int64 dataOffset, int64 archiveLength, uint32 maxRatio) const
+{
+	// The packed data has to be inside the archive
+	if ((dataOffset < 0) || ((dataOffset + entry.packedSize) > archiveLength))
+		return (false);
+
+	// And the member can't be unpacked to more than the method allows
+	if ((maxRatio != 0) && ((uint64)entry.unpackedSize > ((uint64)entry.packedSize * maxRatio)))
+		return (false);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* Inflate() will unpack a deflate stream from one buffer to another.         */
+/*                                                                            */
+/* Input:  "source" is a pointer to the packed data.                          */
+/*         "sourceLen" is the length of the packed data.                      */
+/*         "dest" is a pointer where to write the unpacked data.              */
+/*         "destLen" is the exact length of the unpacked data.                */
+/*         "windowBits" is the zlib window bits telling which header the      */
+/*         stream has (negative for raw deflate data).                        */
+/*                                                                            */
+/* Output: True for success, false if the data is corrupt.                    */
+/******************************************************************************/
+bool Unarchiver::Inflate(const uint8 *source, uint32 sourceLen, uint8 *dest, uint32 destLen, int32 windowBits)
+{
+	z_stream stream;
+	int result;
+
+	// Initialize the stream. Both buffers are complete, so the
+	// whole member is unpacked in a single call
+	memset(&stream, 0, sizeof(stream));
+	if (inflateInit2(&stream, windowBits) != Z_OK)
+		return (false);
+
+	stream.next_in   = (Bytef *)source;
+	stream.avail_in  = sourceLen;
+	stream.next_out  = dest;
+	stream.avail_out = destLen;
+
+	result = inflate(&stream, Z_FINISH);
+	inflateEnd(&stream);
+
+	if ((result != Z_STREAM_END) || (stream.total_out != destLen))
+		return (false);
+
+	return (true);
+}
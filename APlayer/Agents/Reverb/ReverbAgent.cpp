@@ -67,7 +67,8 @@ ReverbAgent::ReverbAgent(APGlobalData *global, PString fileName) : APAddOnAgent(
 		throw PMemoryException();
 
 	// Initialize reverb variables
-	allocated = false;
+	allocated   = false;
+	reverbLevel = 0;
 
 	rvBufL1   = NULL;
 	rvBufL2   = NULL;
@@ -193,6 +194,10 @@ bool ReverbAgent::InitAgent(int32 index)
 	// Load the settings if not already loaded
 	LoadSettings();
 
+	// Get the reverb value and get told when it is changed
+	reverbLevel = reverbSettings->GetIntEntryValue("General", "Reverb", 0);
+	reverbSettings->AddChangeListener(SettingsChanged, this);
+
 	return (true);
 }
 
@@ -205,6 +210,9 @@ bool ReverbAgent::InitAgent(int32 index)
 /******************************************************************************/
 void ReverbAgent::EndAgent(int32 index)
 {
+	// Stop listening for settings changes
+	reverbSettings->RemoveChangeListener(SettingsChanged, this);
+
 	// Free any allocated buffers
 	FreeReverbBuffers();
 }
@@ -289,6 +297,23 @@ void ReverbAgent::FixSettings(void)
 
 
 
+/******************************************************************************/
+/* SettingsChanged() is called when the reverb settings have been changed.    */
+/*                                                                            */
+/* Input:  "settings" is a pointer to the settings changed.                   */
+/*         "section" is the section changed.                                  */
+/*         "entry" is the entry changed.                                      */
+/*         "userData" is a pointer to the agent.                              */
+/******************************************************************************/
+void ReverbAgent::SettingsChanged(PSettings *settings, PString section, PString entry, void *userData)
+{
+	// Empty names means that everything may have changed
+	if ((section.IsEmpty() && entry.IsEmpty()) || ((section == "General") && (entry == "Reverb")))
+		((ReverbAgent *)userData)->reverbLevel = settings->GetIntEntryValue("General", "Reverb", 0);
+}
+
+
+
 /******************************************************************************/
 /* DSP() do the reverb stuff.                                                 */
 /*                                                                            */
@@ -299,7 +324,7 @@ void ReverbAgent::DSP(APAgent_DSP *dspInfo)
 	uint8 rev;
 
 	// Get the reverb value
-	rev = reverbSettings->GetIntEntryValue("General", "Reverb", 0);
+	rev = reverbLevel;
 
 	// Check to see if we need to make reverb
 	if (rev != 0)
@@ -15,6 +15,7 @@
 // PolyKit headers
 #include "POS.h"
 #include "PString.h"
+#include "PSettings.h"
 
 // APlayerKit headers
 #include "APAddOns.h"
@@ -45,6 +46,8 @@ protected:
 	void LoadSettings(void);
 	void FixSettings(void);
 
+	static void SettingsChanged(PSettings *settings, PString section, PString entry, void *userData);
+
 	void DSP(APAgent_DSP *dspInfo);
 	void Stop(void);
 
@@ -59,6 +62,7 @@ protected:
 
 	// Reverb variables
 	bool allocated;
+	volatile int32 reverbLevel;
 
 	int32 rvc1;
 	int32 rvc2;
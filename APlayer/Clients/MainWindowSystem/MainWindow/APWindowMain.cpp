@@ -1456,8 +1456,11 @@ void APWindowMain::MessageReceived(BMessage *msg)
 				// Update the tape deck buttons
 				UpdateTapeDeck();
 
-				// Get the total time of the playing song
+				// Get the total time of the playing song. If the player
+				// did not know it, use the time table found earlier
 				songTotalTime = windowSystem->playerInfo->GetTotalTime();
+				if (songTotalTime.GetTotalMilliSeconds() == 0)
+					songTotalTime = windowSystem->playerInfo->GetSubSongTime(windowSystem->playerInfo->GetCurrentSong());
 
 				// Change the time to the position time
 				SetPositionTime(windowSystem->playerInfo->GetSongPosition());
@@ -1533,6 +1536,30 @@ void APWindowMain::MessageReceived(BMessage *msg)
 				break;
 			}
 
+			////////////////////////////////////////////////////////////////////
+			// The sub-song times has been found
+			////////////////////////////////////////////////////////////////////
+			case AP_UPDATE_SUBSONG_TIMES:
+			{
+				PTimeSpan songTime;
+
+				if (playItem != NULL)
+				{
+					// Get the time of the playing sub-song
+					songTime = windowSystem->playerInfo->GetSubSongTime(windowSystem->playerInfo->GetCurrentSong());
+
+					if ((songTime.GetTotalMilliSeconds() != 0) && (songTime.GetTotalMilliSeconds() != songTotalTime.GetTotalMilliSeconds()))
+					{
+						songTotalTime = songTime;
+
+						// Update the list item and the time shown
+						SetTimeOnItem(playItem, songTotalTime);
+						PrintInfo();
+					}
+				}
+				break;
+			}
+
 			////////////////////////////////////////////////////////////////////
 			// Reset the play time
 			////////////////////////////////////////////////////////////////////
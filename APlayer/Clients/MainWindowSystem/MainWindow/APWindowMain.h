@@ -49,6 +49,7 @@
 #define AP_UPDATE_SELECTION				'_usl'
 #define AP_RESET_TIME					'_rti'
 #define AP_CHANGE_PLAY_ITEM				'_cpi'
+#define AP_UPDATE_SUBSONG_TIMES			'_ust'
 
 #define AP_MENU_ONLINEHELP				'_olh'
 #define AP_MENU_SETTINGS				'_set'
@@ -1935,6 +1935,10 @@ void MainWindowSystem::ServerMessageReceived(void *userData, PString command, PL
 		winSystem->DoModuleEnded();
 	else if (command == "ClickedFiles")
 		winSystem->DoClickedFiles(arguments);
+	else if (command == "DurationScanned")
+		winSystem->DoDurationScanned(arguments);
+	else if (command == "TimeTableReady")
+		winSystem->DoTimeTableReady(arguments);
 }
 
 
@@ -2199,6 +2203,97 @@ void MainWindowSystem::DoClickedFiles(PList<PString> &arguments)
 
 
 
+/******************************************************************************/
+/* DoDurationScanned() parse and run the "DurationScanned" command.           */
+/*                                                                            */
+/* Input:  "arguments" is the command arguments.                              */
+/******************************************************************************/
+void MainWindowSystem::DoDurationScanned(PList<PString> &arguments)
+{
+	BMessage msg(APMSG_DURATION_SCANNED);
+	PString fileName, timeStr;
+	int32 song, index;
+	int64 totalTime = 0;
+	char *nameStr;
+
+	// Check the arguments
+	ASSERT(arguments.CountItems() == 3);
+
+	if (arguments.CountItems() != 3)
+		return;
+
+	fileName = arguments.GetItem(0);
+	song     = arguments.GetItem(1).GetNumber();
+	timeStr  = arguments.GetItem(2);
+
+	// Find the time of the default sub song in the time list
+	for (; (song > 0) && !timeStr.IsEmpty(); song--)
+	{
+		index = timeStr.Find(',');
+		if (index == -1)
+			timeStr.MakeEmpty();
+		else
+			timeStr.Delete(0, index + 1);
+	}
+
+	if (!timeStr.IsEmpty())
+		totalTime = timeStr.GetNumber64();
+
+	// Tell the file scanner about it
+	msg.AddString("fileName", (nameStr = fileName.GetString()));
+	msg.AddInt64("time", totalTime);
+	fileName.FreeBuffer(nameStr);
+
+	fileScanner.SendMessage(&msg);
+}
+
+
+
+/******************************************************************************/
+/* DoTimeTableReady() parse and run the "TimeTableReady" command.             */
+/*                                                                            */
+/* Input:  "arguments" is the command arguments.                              */
+/******************************************************************************/
+void MainWindowSystem::DoTimeTableReady(PList<PString> &arguments)
+{
+	PList<PTimeSpan> songTimes;
+	PString timeStr;
+	int32 index;
+
+	// Check the arguments
+	ASSERT(arguments.CountItems() == 2);
+
+	if (arguments.CountItems() != 2)
+		return;
+
+	// Check to see if a module is still loaded
+	if (playerInfo->IsPlaying())
+	{
+		BMessage msg(AP_UPDATE_SUBSONG_TIMES);
+
+		// Split the time list into the times of each sub-song
+		timeStr = arguments.GetItem(1);
+
+		while (!timeStr.IsEmpty())
+		{
+			songTimes.AddTail(timeStr.GetNumber64());
+
+			index = timeStr.Find(',');
+			if (index == -1)
+				timeStr.MakeEmpty();
+			else
+				timeStr.Delete(0, index + 1);
+		}
+
+		playerInfo->SetSubSongTimes(songTimes);
+
+		// Tell the window to show the new times
+		mainWin->PostMessage(&msg);
+	}
+}
+
+
+
 /******************************************************************************/
 /* InitMixer() initialize the virtual mixer.                                  */
 /*                                                                            */
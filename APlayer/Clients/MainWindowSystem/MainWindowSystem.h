@@ -178,6 +178,7 @@ public:
 	bool closeWindow;					// Indicator to the window to close or not
 
 	APLoader *loader;					// Object to handle all the module loading
+	BMessenger fileScanner;				// Messenger to the file scanner in the module list
 	APPlayerInfo *playerInfo;			// Holds all the information to the player
 
 	bool channelsEnabled[MAX_NUM_CHANNELS];
@@ -214,6 +215,8 @@ protected:
 	void DoNewInformation(PList<PString> &arguments);
 	void DoModuleEnded(void);
 	void DoClickedFiles(PList<PString> &arguments);
+	void DoDurationScanned(PList<PString> &arguments);
+	void DoTimeTableReady(PList<PString> &arguments);
 
 	void InitMixer(APAgent_InitMixer *initMixer);
 	void EndMixer(void);
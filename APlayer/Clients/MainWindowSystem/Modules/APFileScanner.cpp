@@ -16,6 +16,8 @@
 #include "PSynchronize.h"
 #include "PSystem.h"
 #include "PTime.h"
+#include "PList.h"
+#include "PSkipList.h"
 
 // Client headers
 #include "MainWindowSystem.h"
@@ -29,6 +31,13 @@
 
 
 
+/******************************************************************************/
+/* Number of files sent to the server in each scan command                    */
+/******************************************************************************/
+#define SCAN_BATCH_SIZE			64
+
+
+
 /******************************************************************************/
 /* Constructor                                                                */
 /******************************************************************************/
@@ -37,6 +46,7 @@ APFileScanner::APFileScanner(MainWindowSystem *system) : BLooper("MainWindowSyst
 	// Initialize member variables
 	windowSystem = system;
 	stopEvent    = NULL;
+	serverScan   = true;
 }
 
 
@@ -46,6 +56,9 @@ APFileScanner::APFileScanner(MainWindowSystem *system) : BLooper("MainWindowSyst
 /******************************************************************************/
 APFileScanner::~APFileScanner(void)
 {
+	// Forget the files not scanned yet
+	FreePendingFiles();
+
 	// Delete the stop event
 	delete stopEvent;
 }
@@ -64,6 +77,9 @@ void APFileScanner::Start(void)
 
 	// Start the looper
 	Run();
+
+	// Tell the window system where to send the scanned durations
+	windowSystem->fileScanner = BMessenger(NULL, this);
 }
 
 
@@ -80,6 +96,10 @@ void APFileScanner::Stop(void)
 	// any messages and ignore the rest
 	stopEvent->SetEvent();
 
+	// Tell the server to forget the files not scanned yet
+	if (serverScan)
+		windowSystem->loader->CancelDurationScan();
+
 	// Tell the BLooper to quit and delete itself
 	// This call is synchronous, so we are sure the
 	// object has been deleted when the function
@@ -138,6 +158,23 @@ void APFileScanner::MessageReceived(BMessage *message)
 			break;
 		}
 
+		//
+		// The server has found the time of a file
+		//
+		case APMSG_DURATION_SCANNED:
+		{
+			const char *fileName;
+			int64 totalTime;
+
+			// Get the arguments
+			if (message->FindString("fileName", &fileName) == B_OK)
+			{
+				if (message->FindInt64("time", &totalTime) == B_OK)
+					DurationScanned(fileName, totalTime);
+			}
+			break;
+		}
+
 		//
 		// Unknown message. Call the base class
 		//
@@ -160,6 +197,9 @@ void APFileScanner::MessageReceived(BMessage *message)
 void APFileScanner::ScanFiles(int32 index, int32 count)
 {
 	APWindowMainListItem *workItem;
+	APScanItem scanItem;
+	PList<APScanItem> *items;
+	PList<PString> batch;
 	PString fileName;
 	PTimeSpan totalTime;
 	bool haveTime, setTime;
@@ -195,34 +235,210 @@ void APFileScanner::ScanFiles(int32 index, int32 count)
 		// Did we get the total time?
 		if (totalTime.GetTotalMilliSeconds() == 0)
 		{
-			// Nup, try to load the file and let the player returns the total time
+			// Nup, let the server scan the file in the background.
+			// The result is sent back in a "DurationScanned" command
+			if (serverScan)
+			{
+				scanItem.index   = index;
+				scanItem.setTime = setTime;
+
+				// If the same file is in the list more than once, it is
+				// only scanned one time and all the items get the time
+				if (pendingFiles.GetItem(fileName, items))
+				{
+					items->AddTail(scanItem);
+					continue;
+				}
+
+				items = new PList<APScanItem>;
+				if (items == NULL)
+					throw PMemoryException();
+
+				items->AddTail(scanItem);
+				pendingFiles.InsertItem(fileName, items);
+
+				batch.AddTail(fileName);
+
+				if (batch.CountItems() >= SCAN_BATCH_SIZE)
+				{
+					if (!SendBatch(batch))
+						return;
+				}
+				continue;
+			}
+
+			// The server can't scan, so load the file and let the
+			// player returns the total time
 			totalTime = GetPlayerTime(fileName, setTime);
 		}
 
 		// Update the list item
-		//
-		// Lock the window
-		if (!LockWindow())
+		if (!UpdateItem(index, fileName, totalTime))
 			return;
+	}
 
-		// Get the item to work on
-		workItem = windowSystem->mainWin->GetListItem(index);
-		if (workItem == NULL)
+	// Send the rest of the files
+	SendBatch(batch);
+}
+
+
+
+/******************************************************************************/
+/* SendBatch() will send the files collected to the server for scanning. If   */
+/*      the server can't scan them, the files are scanned one by one here     */
+/*      instead.                                                              */
+/*                                                                            */
+/* Input:  "batch" is a reference to the list with the files. It will be      */
+/*         emptied.                                                           */
+/*                                                                            */
+/* Output: True to continue, false if you have to stop.                       */
+/******************************************************************************/
+bool APFileScanner::SendBatch(PList<PString> &batch)
+{
+	PList<APScanItem> *items;
+	PString fileName;
+	PTimeSpan totalTime;
+	int32 i, count;
+	bool result;
+
+	count = batch.CountItems();
+	if (count == 0)
+		return (true);
+
+	if (!windowSystem->loader->ScanDurations(batch))
+	{
+		// Old server, so do not try again
+		serverScan = false;
+
+		for (i = 0; i < count; i++)
 		{
-			windowSystem->mainWin->Unlock();
-			continue;
+			fileName = batch.GetItem(i);
+
+			if (pendingFiles.GetAndRemoveItem(fileName, items))
+			{
+				totalTime = windowSystem->loader->GetTotalTimeFromFile(fileName);
+
+				result = UpdateItems(fileName, items, totalTime);
+				delete items;
+
+				if (!result)
+				{
+					batch.MakeEmpty();
+					return (false);
+				}
+			}
 		}
+	}
+
+	batch.MakeEmpty();
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* DurationScanned() is called when the server has scanned a file.            */
+/*                                                                            */
+/* Input:  "fileName" is the file name of the scanned file.                   */
+/*         "totalTime" is the time found or 0 if none.                        */
+/******************************************************************************/
+void APFileScanner::DurationScanned(PString fileName, PTimeSpan totalTime)
+{
+	PList<APScanItem> *items;
+
+	// Do we wait for the file?
+	if (!pendingFiles.GetAndRemoveItem(fileName, items))
+		return;
+
+	// Update the list items
+	UpdateItems(fileName, items, totalTime);
+	delete items;
+}
+
+
+
+/******************************************************************************/
+/* UpdateItems() will set the time on all the list items waiting for the file */
+/*      given and write the time attribute if one of them wants it. Nothing   */
+/*      is written if the file could not be scanned.                          */
+/*                                                                            */
+/* Input:  "fileName" is the file name of the items.                          */
+/*         "items" is a pointer to the list with the items.                   */
+/*         "totalTime" is the time to set or 0 if the scan failed.            */
+/*                                                                            */
+/* Output: True to continue, false if you have to stop.                       */
+/******************************************************************************/
+bool APFileScanner::UpdateItems(PString fileName, PList<APScanItem> *items, PTimeSpan totalTime)
+{
+	APScanItem scanItem;
+	int32 i, count;
+	bool setTime = false;
+
+	count = items->CountItems();
+	for (i = 0; i < count; i++)
+	{
+		scanItem = items->GetItem(i);
+		if (scanItem.setTime)
+			setTime = true;
+
+		if (!UpdateItem(scanItem.index, fileName, totalTime))
+			return (false);
+	}
+
+	// Set the total time attribute
+	if (setTime && (totalTime.GetTotalMilliSeconds() != 0))
+		windowSystem->loader->SetTotalTimeOnFile(fileName, totalTime);
+
+	return (true);
+}
+
 
-		// Is the item we got the one we got a total time on?
-		if (workItem->GetFileName() == fileName)
+
+/******************************************************************************/
+/* UpdateItem() will set the time on the list item with the file name given.  */
+/*                                                                            */
+/* Input:  "index" is the index where the item is expected to be.             */
+/*         "fileName" is the file name of the item.                           */
+/*         "totalTime" is the time to set.                                    */
+/*                                                                            */
+/* Output: True to continue, false if you have to stop.                       */
+/******************************************************************************/
+bool APFileScanner::UpdateItem(int32 index, PString fileName, PTimeSpan totalTime)
+{
+	APWindowMainListItem *workItem;
+	int32 i, count;
+
+	// Lock the window
+	if (!LockWindow())
+		return (false);
+
+	// Is the item we got the one we got a total time on?
+	workItem = windowSystem->mainWin->GetListItem(index);
+	if ((workItem == NULL) || (workItem->GetFileName() != fileName))
+	{
+		// Nup, the list has changed in the meantime, so find the
+		// first item with the file name which still needs a time
+		workItem = NULL;
+
+		count = windowSystem->mainWin->GetListCount();
+		for (i = 0; i < count; i++)
 		{
-			// Yip, set the total time
-			windowSystem->mainWin->SetTimeOnItem(workItem, totalTime);
+			if ((windowSystem->mainWin->GetListItem(i)->GetFileName() == fileName) && !windowSystem->mainWin->GetListItem(i)->HaveTime())
+			{
+				workItem = windowSystem->mainWin->GetListItem(i);
+				break;
+			}
 		}
-
-		// Unlock the window
-		windowSystem->mainWin->Unlock();
 	}
+
+	// Yip, set the total time
+	if (workItem != NULL)
+		windowSystem->mainWin->SetTimeOnItem(workItem, totalTime);
+
+	// Unlock the window
+	windowSystem->mainWin->Unlock();
+
+	return (true);
 }
 
 
@@ -308,9 +524,29 @@ PTimeSpan APFileScanner::GetPlayerTime(PString fileName, bool setTime)
 
 	time = windowSystem->loader->GetTotalTimeFromFile(fileName);
 
-	// Set the total time attribute
-	if (setTime)
+	// Set the total time attribute, if the file could be scanned
+	if (setTime && (time.GetTotalMilliSeconds() != 0))
 		windowSystem->loader->SetTotalTimeOnFile(fileName, time);
 
 	return (time);
 }
+
+
+
+/******************************************************************************/
+/* FreePendingFiles() will free the lists of the files not scanned yet.       */
+/******************************************************************************/
+void APFileScanner::FreePendingFiles(void)
+{
+	PList<APScanItem> *items;
+	int32 i, count;
+
+	count = pendingFiles.CountItems();
+	for (i = 0; i < count; i++)
+	{
+		if (pendingFiles.GetItem(i, items))
+			delete items;
+	}
+
+	pendingFiles.MakeEmpty();
+}
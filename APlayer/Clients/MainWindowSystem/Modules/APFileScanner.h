@@ -16,6 +16,15 @@
 #include "POS.h"
 #include "PSynchronize.h"
 #include "PTime.h"
+#include "PList.h"
+#include "PSkipList.h"
+
+
+/******************************************************************************/
+/* Messages                                                                   */
+/******************************************************************************/
+#define APMSG_DURATION_SCANNED		'_dsc'
+
 
 
 /******************************************************************************/
@@ -37,7 +46,18 @@ public:
 protected:
 	virtual void MessageReceived(BMessage *message);
 
+	typedef struct APScanItem
+	{
+		int32 index;				// The list index the item had when added
+		bool setTime;				// True if the time should be written to the file
+	} APScanItem;
+
 	void ScanFiles(int32 index, int32 count);
+	bool SendBatch(PList<PString> &batch);
+	void DurationScanned(PString fileName, PTimeSpan totalTime);
+	bool UpdateItem(int32 index, PString fileName, PTimeSpan totalTime);
+	bool UpdateItems(PString fileName, PList<APScanItem> *items, PTimeSpan totalTime);
+	void FreePendingFiles(void);
 	bool LockWindow(void);
 	PTimeSpan GetAttrTime(PString fileName);
 	PTimeSpan GetPlayerTime(PString fileName, bool setTime);
@@ -45,6 +65,9 @@ protected:
 	MainWindowSystem *windowSystem;
 
 	PEvent *stopEvent;
+
+	PSkipList<PString, PList<APScanItem> *> pendingFiles;	// All the items with the file name
+	bool serverScan;
 };
 
 #endif
@@ -166,6 +166,44 @@ void APLoader::SetTotalTimeOnFile(PString fileName, PTimeSpan totalTime)
 
 
 
+/******************************************************************************/
+/* ScanDurations() will ask the server to find the total time of all the      */
+/*      files given. The server sends a "DurationScanned" command back for    */
+/*      each file when it is done.                                            */
+/*                                                                            */
+/* Input:  "files" is a list with the file names to scan.                     */
+/*                                                                            */
+/* Output: True if the server has accepted the files, false if not.           */
+/******************************************************************************/
+bool APLoader::ScanDurations(const PList<PString> &files)
+{
+	PString cmd, result;
+	int32 i, count;
+
+	// Build the command
+	cmd   = "ScanDurations=";
+	count = files.CountItems();
+	for (i = 0; i < count; i++)
+		cmd = global->communication->AddArgument(cmd, files.GetItem(i));
+
+	result = global->communication->SendCommand(windowSystem->serverHandle, cmd);
+
+	return (result.Left(4) != "ERR=");
+}
+
+
+
+/******************************************************************************/
+/* CancelDurationScan() will tell the server to forget all the files not      */
+/*      scanned yet.                                                          */
+/******************************************************************************/
+void APLoader::CancelDurationScan(void)
+{
+	global->communication->SendCommand(windowSystem->serverHandle, "CancelDurationScan=");
+}
+
+
+
 /******************************************************************************/
 /* MessageReceived() is called when a new module is about to be loaded or     */
 /*      freed.                                                                */
@@ -59,6 +59,9 @@ public:
 	PTimeSpan GetTotalTimeFromFile(PString fileName);
 	void SetTotalTimeOnFile(PString fileName, PTimeSpan totalTime);
 
+	bool ScanDurations(const PList<PString> &files);
+	void CancelDurationScan(void);
+
 protected:
 	typedef struct APModuleItem
 	{
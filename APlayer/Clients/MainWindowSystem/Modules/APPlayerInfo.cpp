@@ -88,6 +88,7 @@ void APPlayerInfo::ResetInfo(void)
 	author.MakeEmpty();
 	totalTime.SetTimeSpan(0);
 	posTimes.MakeEmpty();
+	songTimes.MakeEmpty();
 	fileName.MakeEmpty();
 	moduleFormat.MakeEmpty();
 	playerName.MakeEmpty();
@@ -237,6 +238,21 @@ void APPlayerInfo::SetPositionTimes(const PList<PTimeSpan> &newPosTimes)
 
 
 
+/******************************************************************************/
+/* SetSubSongTimes() sets the total time of each sub-song.                    */
+/*                                                                            */
+/* Input:   "newSongTimes" is the new sub-song times.                         */
+/******************************************************************************/
+void APPlayerInfo::SetSubSongTimes(const PList<PTimeSpan> &newSongTimes)
+{
+	PLock lock(&varLock);
+
+	// Copy the items
+	songTimes = newSongTimes;
+}
+
+
+
 /******************************************************************************/
 /* SetFileName() sets the name of the file.                                   */
 /*                                                                            */
@@ -523,6 +539,25 @@ PTimeSpan APPlayerInfo::GetPositionTime(int16 position)
 
 
 
+/******************************************************************************/
+/* GetSubSongTime() returns the total time of the sub-song given.             */
+/*                                                                            */
+/* Input:   "song" is the sub-song you want the time on.                      */
+/*                                                                            */
+/* Output:  The sub-song time or 0 if it is not known yet.                    */
+/******************************************************************************/
+PTimeSpan APPlayerInfo::GetSubSongTime(uint16 song)
+{
+	PLock lock(&varLock);
+
+	if (song >= songTimes.CountItems())
+		return (0);
+
+	return (songTimes.GetItem(song));
+}
+
+
+
 /******************************************************************************/
 /* GetFileName() returns the name of the file.                                */
 /*                                                                            */
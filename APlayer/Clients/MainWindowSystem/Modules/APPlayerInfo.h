@@ -44,6 +44,7 @@ public:
 	void SetAuthor(PString newName);
 	void SetTotalTime(PTimeSpan newTotalTime);
 	void SetPositionTimes(const PList<PTimeSpan> &newPosTimes);
+	void SetSubSongTimes(const PList<PTimeSpan> &newSongTimes);
 
 	void SetFileName(PString newName);
 	void SetModuleFormat(PString newFormat);
@@ -68,6 +69,7 @@ public:
 	PString GetAuthor(void);
 	PTimeSpan GetTotalTime(void);
 	PTimeSpan GetPositionTime(int16 position);
+	PTimeSpan GetSubSongTime(uint16 song);
 
 	PString GetFileName(void);
 	PString GetModuleFormat(void);
@@ -99,6 +101,7 @@ protected:
 
 	PTimeSpan totalTime;
 	PList<PTimeSpan> posTimes;
+	PList<PTimeSpan> songTimes;
 
 	PString fileName;
 	PString moduleFormat;
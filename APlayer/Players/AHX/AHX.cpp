@@ -20,6 +20,7 @@
 #include "PFile.h"
 #include "PTime.h"
 #include "PList.h"
+#include "PSynchronize.h"
 
 // APlayerKit headers
 #include "APGlobalData.h"
@@ -73,6 +74,9 @@ void AHXOutput::Init(int32 frequency, int32 bits, int32 mixLen, float boost, int
 	this->bits      = bits;
 	this->hz        = hz;
 
+	for (i = 0; i < 4; i++)
+		pos[i] = 0;
+
 	// Generate volume table
 	for (i = 0; i < 65; i++)
 	{
@@ -133,8 +137,6 @@ void AHXOutput::PrepareBuffers(int16 **buffers)
 /******************************************************************************/
 void AHXOutput::GenerateBuffer(int32 nrSamples, int16 **mb, int8 v)
 {
-	static int32 pos[4] = { 0, 0, 0, 0 };
-
 	if (player->voices[v].voiceVolume != 0)
 	{
 		float freq = Period2Freq(player->voices[v].voicePeriod);
@@ -355,6 +357,34 @@ void AHXVoice::CalcADSR(void)
 /* AHXWaves                                                                   */
 /******************************************************************************/
 
+/******************************************************************************/
+/* Static variables                                                           */
+/******************************************************************************/
+PMutex AHXWaves::lock(false);
+AHXWaves *AHXWaves::waves = NULL;
+
+
+
+/******************************************************************************/
+/* AHXWavesCleanup class                                                      */
+/*                                                                            */
+/* A single object of this class is created when the add-on is loaded. It     */
+/* frees the shared tables again when the add-on is unloaded.                 */
+/******************************************************************************/
+class AHXWavesCleanup
+{
+public:
+	~AHXWavesCleanup(void)
+	{
+		delete AHXWaves::waves;
+		AHXWaves::waves = NULL;
+	}
+};
+
+static AHXWavesCleanup wavesCleanup;
+
+
+
 /******************************************************************************/
 /* Constructor                                                                */
 /******************************************************************************/
@@ -374,6 +404,35 @@ AHXWaves::~AHXWaves(void)
 
 
 
+/******************************************************************************/
+/* GetWaves() returns the shared wave tables. They are generated the first    */
+/*      time the function is called.                                          */
+/*                                                                            */
+/* Output: A pointer to the wave tables.                                      */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+AHXWaves *AHXWaves::GetWaves(void)
+{
+	lock.Lock();
+
+	if (waves == NULL)
+	{
+		waves = new AHXWaves();
+		if (waves == NULL)
+		{
+			lock.Unlock();
+			throw PMemoryException();
+		}
+	}
+
+	lock.Unlock();
+
+	return (waves);
+}
+
+
+
 /******************************************************************************/
 /* Generate() generates all the wave tables.                                  */
 /******************************************************************************/
@@ -1005,24 +1064,16 @@ ap_result AHX::LoadModule(int32 index, PFile *file, PString &errorStr)
 /******************************************************************************/
 bool AHX::InitPlayer(int32 index)
 {
-	int32 i, j, k, m;
-	int32 startPos, startRow, posHi, newPos;
-	int32 track, effArg;
+	int32 i;
 	SongTime *songTime;
-	PosInfo posInfo;
-	int32 curSpeed;
-	bool pattBreak, done;
-	float total;
 
 	// Allocate output class
 	output = new AHXOutput();
 	if (output == NULL)
 		throw PMemoryException();
 
-	// Allocate wave class
-	waves = new AHXWaves();
-	if (waves == NULL)
-		throw PMemoryException();
+	// Get the shared wave tables
+	waves = AHXWaves::GetWaves();
 
 	// Allocate channel buffers
 	bufLen = 2 * mixerFreq / 50;
@@ -1041,7 +1092,8 @@ bool AHX::InitPlayer(int32 index)
 	output->player = this;
 	output->Init(mixerFreq, 16, 2, 1.0f, 50);
 
-	// Take each subsong
+	// Take each subsong. The position times are first calculated
+	// when the subsong is used
 	for (i = 0; i <= song->subsongNr; i++)
 	{
 		// Allocate the song time structure
@@ -1054,103 +1106,11 @@ bool AHX::InitPlayer(int32 index)
 
 		// Find the start position
 		if (i == 0)
-			startPos = 0;
+			songTime->startPos = 0;
 		else
-			startPos = song->subsongs[i - 1];
-
-		songTime->startPos = startPos;
-
-		// Initialize other start variables
-		startRow = 0;
-		curSpeed = 6;
-		done     = false;
-		total    = 0.0f;
+			songTime->startPos = song->subsongs[i - 1];
 
-		// Calculate the position times
-		for (j = startPos; j < song->positionNr; j++)
-		{
-			// Add the position information to the list
-			posInfo.speed = curSpeed;
-			posInfo.time.SetTimeSpan(total);
-			songTime->posInfoList.AddTail(posInfo);
-
-			posHi     = 0;
-			newPos    = -1;
-			pattBreak = false;
-
-			for (k = startRow; k < song->trackLength; k++)
-			{
-				startRow = 0;
-
-				for (m = 0; m < 4; m++)
-				{
-					// Get track number
-					track = song->positions[j].track[m];
-
-					// Parse special effects
-					switch (song->tracks[track][k].fx)
-					{
-						// Position jump HI
-						case 0x0:
-						{
-							effArg = song->tracks[track][k].fxParam & 0x0f;
-							if ((effArg > 0) && (effArg <= 9))
-								posHi = effArg;
-							
-							break;
-						}
-
-						// Position jump
-						case 0xb:
-						{
-							effArg    = song->tracks[track][k].fxParam;
-							newPos    = posHi * 100 + (effArg & 0x0f) + (effArg >> 4) * 10;
-							pattBreak = true;
-
-							if (newPos <= j)
-								done = true;
-							break;
-						}
-
-						// Pattern break
-						case 0xd:
-						{
-							effArg   = song->tracks[track][k].fxParam;
-							startRow = (effArg & 0x0f) + (effArg >> 4) * 10;
-							if (startRow > song->trackLength)
-								startRow = 0;
-
-							pattBreak = true;
-							break;
-						}
-
-						// Speed
-						case 0xf:
-						{
-							curSpeed = song->tracks[track][k].fxParam;
-							if (curSpeed == 0)
-								done = true;
-							break;
-						}
-					}
-				}
-
-				// Add the row time
-				total += (1000.0f * curSpeed / 50.0f / song->speedMultiplier);
-
-				if (done || pattBreak)
-					break;
-			}
-
-			if (newPos != -1)
-				j = newPos - 1;
-
-			if (done)
-				break;
-		}
-
-		// Set the total time
-		songTime->totalTime.SetTimeSpan(total);
+		songTime->calculated = false;
 	}
 
 	return (true);
@@ -1183,9 +1143,8 @@ void AHX::EndPlayer(int32 index)
 		output = NULL;
 	}
 
-	// Delete the waves
-	delete waves;
-	waves  = NULL;
+	// The waves are shared, so just forget them
+	waves = NULL;
 
 	// Delete the sample buffers
 	for (int8 i = 0; i < 4; i++)
@@ -1321,7 +1280,7 @@ void AHX::SetSongPosition(int16 pos)
 	getNewPosition = true;
 
 	// Set the tempo
-	songTime = songTimeList.GetItem(currentSong);
+	songTime = GetSongTime(currentSong);
 	if ((pos < songTime->startPos) || (pos >= songTime->posInfoList.CountItems()))
 		tempo = 6;
 	else
@@ -1346,7 +1305,7 @@ PTimeSpan AHX::GetTimeTable(uint16 songNum, PList<PTimeSpan> &posTimes)
 	int32 i, j, count;
 
 	// Find the song time structure
-	songTime = songTimeList.GetItem(songNum);
+	songTime = GetSongTime(songNum);
 
 	// Well, fill the position time list up the empty times until
 	// we reach the subsong position
@@ -1492,6 +1451,127 @@ void AHX::Cleanup(void)
 
 
 
+/******************************************************************************/
+/* GetSongTime() returns the song time structure for the subsong given. The   */
+/*      position times are calculated the first time it is asked for.         */
+/*                                                                            */
+/* Input:  "songNum" is the subsong number.                                   */
+/*                                                                            */
+/* Output: A pointer to the song time structure.                              */
+/******************************************************************************/
+SongTime *AHX::GetSongTime(uint16 songNum)
+{
+	SongTime *songTime;
+	int32 j, k, m;
+	int32 startRow, posHi, newPos;
+	int32 track, effArg;
+	PosInfo posInfo;
+	int32 curSpeed;
+	bool pattBreak, done;
+	float total;
+
+	songTime = songTimeList.GetItem(songNum);
+	if (songTime->calculated)
+		return (songTime);
+
+	// Initialize other start variables
+	startRow = 0;
+	curSpeed = 6;
+	done     = false;
+	total    = 0.0f;
+
+	// Calculate the position times
+	for (j = songTime->startPos; j < song->positionNr; j++)
+	{
+		// Add the position information to the list
+		posInfo.speed = curSpeed;
+		posInfo.time.SetTimeSpan(total);
+		songTime->posInfoList.AddTail(posInfo);
+
+		posHi     = 0;
+		newPos    = -1;
+		pattBreak = false;
+
+		for (k = startRow; k < song->trackLength; k++)
+		{
+			startRow = 0;
+
+			for (m = 0; m < 4; m++)
+			{
+				// Get track number
+				track = song->positions[j].track[m];
+
+				// Parse special effects
+				switch (song->tracks[track][k].fx)
+				{
+					// Position jump HI
+					case 0x0:
+					{
+						effArg = song->tracks[track][k].fxParam & 0x0f;
+						if ((effArg > 0) && (effArg <= 9))
+							posHi = effArg;
+						
+						break;
+					}
+
+					// Position jump
+					case 0xb:
+					{
+						effArg    = song->tracks[track][k].fxParam;
+						newPos    = posHi * 100 + (effArg & 0x0f) + (effArg >> 4) * 10;
+						pattBreak = true;
+
+						if (newPos <= j)
+							done = true;
+						break;
+					}
+
+					// Pattern break
+					case 0xd:
+					{
+						effArg   = song->tracks[track][k].fxParam;
+						startRow = (effArg & 0x0f) + (effArg >> 4) * 10;
+						if (startRow > song->trackLength)
+							startRow = 0;
+
+						pattBreak = true;
+						break;
+					}
+
+					// Speed
+					case 0xf:
+					{
+						curSpeed = song->tracks[track][k].fxParam;
+						if (curSpeed == 0)
+							done = true;
+						break;
+					}
+				}
+			}
+
+			// Add the row time
+			total += (1000.0f * curSpeed / 50.0f / song->speedMultiplier);
+
+			if (done || pattBreak)
+				break;
+		}
+
+		if (newPos != -1)
+			j = newPos - 1;
+
+		if (done)
+			break;
+	}
+
+	// Set the total time
+	songTime->totalTime.SetTimeSpan(total);
+	songTime->calculated = true;
+
+	return (songTime);
+}
+
+
+
 /******************************************************************************/
 /* Init() initialize the player.                                              */
 /******************************************************************************/
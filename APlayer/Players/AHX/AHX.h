@@ -19,6 +19,7 @@
 #include "PFile.h"
 #include "PTime.h"
 #include "PList.h"
+#include "PSynchronize.h"
 
 // APlayerKit headers
 #include "APGlobalData.h"
@@ -49,6 +50,7 @@ typedef struct PosInfo
 typedef struct SongTime
 {
 	int32 startPos;
+	bool calculated;
 	PTimeSpan totalTime;
 	PList<PosInfo> posInfoList;
 } SongTime;
@@ -81,6 +83,7 @@ public:
 
 protected:
 	int32 volumeTable[65][256];
+	int32 pos[4];				// Position in each voice buffer, 16.16 fixed point
 };
 
 
@@ -335,12 +338,14 @@ protected:
 
 /******************************************************************************/
 /* AHXWaves class                                                             */
+/*                                                                            */
+/* The tables are the same for all modules, so only one object is created     */
+/* and it is shared read-only by all the player instances.                    */
 /******************************************************************************/
 class AHXWaves
 {
 public:
-	AHXWaves(void);
-	virtual ~AHXWaves(void);
+	static AHXWaves *GetWaves(void);
 
 	// !!!!DO NOT CHANGE THE ORDER OF THESE TABLES!!!!
 	int8 lowPasses[(0xfc + 0xfc + 0x80 * 0x1f + 0x80 + 3 * 0x280) * 31];
@@ -366,6 +371,11 @@ public:
 	int8 highPasses[(0xfc + 0xfc + 0x80 * 0x1f + 0x80 + 3 * 0x280) * 31];
 
 protected:
+	friend class AHXWavesCleanup;
+
+	AHXWaves(void);
+	virtual ~AHXWaves(void);
+
 	void Generate(void);
 	void GenerateSawtooth(int8 *buffer, int32 len);
 	void GenerateTriangle(int8 *buffer, int32 len);
@@ -374,6 +384,9 @@ protected:
 	void GenerateFilterWaveforms(int8 *buffer, int8 *lowBuf, int8 *highBuf);
 
 	inline void Clip(float *x);
+
+	static PMutex lock;
+	static AHXWaves *waves;
 };
 
 
@@ -418,6 +431,7 @@ public:
 
 protected:
 	void Cleanup(void);
+	SongTime *GetSongTime(uint16 songNum);
 
 	void Init(void);
 	bool InitSubsong(int32 nr);
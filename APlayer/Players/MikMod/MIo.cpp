@@ -203,16 +203,12 @@ void MikMod::FreeAll(void)
 	of.patterns = NULL;
 	of.pattRows = NULL;
 
-	// Free the tracks
-	if (of.tracks != NULL)
-	{
-		for (t = 0; t < of.numTrk; t++)
-			delete[] of.tracks[t];
-	}
-
+	// Free the tracks. The tracks themselves are all in the module arena
 	delete[] of.tracks;
 	of.tracks = NULL;
 
+	moduleArena.FreeAll();
+
 	// Free the instruments
 	delete[] of.instruments;
 	of.instruments = NULL;
@@ -19,6 +19,8 @@
 #include "PFile.h"
 #include "PTime.h"
 #include "PList.h"
+#include "PSynchronize.h"
+#include "PThread.h"
 
 // APlayerKit headers
 #include "APGlobalData.h"
@@ -42,6 +44,7 @@
 /* Other defines                                                              */
 /******************************************************************************/
 #define HIGH_OCTAVE			2		// Number of above-range octaves
+#define MAX_UNPACK_THREADS	4		// Max number of threads unpacking IT samples
 
 
 
@@ -199,7 +202,15 @@ ap_result MikMod::LoadModule(int32 index, PFile *file, PString &errorStr)
 	of.voice       = NULL;
 
 	// Parse the uni module and create structures to use
-	retVal = CreateUniStructs(file, errorStr);
+	try
+	{
+		retVal = CreateUniStructs(file, errorStr);
+	}
+	catch(PMemoryException e)
+	{
+		errorStr.LoadString(res, IDS_MIK_ERR_MEMORY);
+		retVal = AP_ERROR;
+	}
 
 	if (retVal != AP_OK)
 		FreeAll();
@@ -640,6 +651,7 @@ void MikMod::InitSound(int32 index, uint16 songNum)
 
 	// Remember the subsong
 	currentSong     = songNum;
+	randomSeed      = 1;
 
 	of.extSpd       = true;
 	of.panFlag      = true;
@@ -1271,7 +1283,8 @@ ap_result MikMod::CreateUniStructs(PFile *file, PString &errorStr)
 
 
 /******************************************************************************/
-/* TrkRead() allocates and read one track.                                    */
+/* TrkRead() allocates and read one track. The track is allocated in the      */
+/*      module arena, so it is freed together with the other tracks.          */
 /*                                                                            */
 /* Input:  "file" is a pointer to a file object with the file to check.       */
 /*                                                                            */
@@ -1280,12 +1293,11 @@ ap_result MikMod::CreateUniStructs(PFile *file, PString &errorStr)
 uint8 *MikMod::TrkRead(PFile *file)
 {
 	uint8 *t;
-	uint16 len, i;
+	uint16 len;
 
 	len = file->Read_B_UINT16();
-	t   = new uint8[len];
-	for (i = 0; i < len; i++)
-		t[i] = file->Read_UINT8();
+	t   = moduleArena.AllocateArray<uint8>(len);
+	file->ReadArray_UINT8s(t, len);
 
 	return (t);
 }
@@ -1294,36 +1306,45 @@ uint8 *MikMod::TrkRead(PFile *file)
 
 /******************************************************************************/
 /* FindSamples() will find the sample addresses and fix them so all samples   */
-/*      signed.                                                               */
+/*      signed. The IT packed samples are read into memory first and then     */
+/*      unpacked all at once.                                                 */
 /*                                                                            */
 /* Input:  "file" is a pointer to a file object with the file to check.       */
 /*         "errorStr" is a reference where to store the error string.         */
 /*                                                                            */
 /* Output: An APlayer result code.                                            */
 /******************************************************************************/
-#define SLBUFSIZE		2048
-
 ap_result MikMod::FindSamples(PFile *file, PString &errorStr)
 {
-	int32 v, w, length;
+	int32 v, length, done, blockSamples;
+	uint32 packedLength;
+	uint16 blockLength;
+	int64 start;
 	SAMPLE *s;
-	uint8 *samp;
+	ITPackJob *job;
+	ap_result retVal = AP_OK;
 
-	s = of.samples;
-	for (v = 0; v < of.numSmp; v++, s++)
+	// Allocate the unpack jobs, in case all the samples are packed
+	packJobs = new ITPackJob[of.numSmp + 1];
+	if (packJobs == NULL)
 	{
-		// Calculate the length of the sample
-		length = s->length;
+		errorStr.LoadString(res, IDS_MIK_ERR_MEMORY);
+		return (AP_ERROR);
+	}
 
-		if (length != 0)
+	numPackJobs = 0;
+	nextPackJob = 0;
+
+	try
+	{
+		s = of.samples;
+		for (v = 0; v < of.numSmp; v++, s++)
 		{
-			int16 old = 0;
-			int32 toDo;
-			ITPACK status;
-			uint16 inCnt;
-			bool result;
-			int32 cBlock = 0;
-			uint8 *dest;
+			// Calculate the length of the sample
+			length = s->length;
+
+			if (length == 0)
+				continue;
 
 			if (s->flags & SF_16BITS)
 				length *= 2;
@@ -1336,178 +1357,276 @@ ap_result MikMod::FindSamples(PFile *file, PString &errorStr)
 			if (s->handle == NULL)
 			{
 				errorStr.LoadString(res, IDS_MIK_ERR_MEMORY);
-				return (AP_ERROR);
+				retVal = AP_ERROR;
+				break;
 			}
 
-			// Get the length again, because the loop
-			// is based on samples, not bytes
-			length = s->length;
-			dest   = (uint8 *)s->handle;
-
-			while (length)
+			if (s->flags & SF_ITPACKED)
 			{
-				toDo = min(length, SLBUFSIZE);
+				// Find the length of all the packed blocks, so they
+				// can be read into memory in one go
+				start        = file->GetPosition();
+				packedLength = 0;
+				blockSamples = (s->flags & SF_16BITS) ? 0x4000 : 0x8000;
 
-				if (s->flags & SF_ITPACKED)
+				for (done = 0; done < (int32)s->length; done += blockSamples)
 				{
-					// Decompress the sample
-					if (!cBlock)
-					{
-						status.bits = (s->flags & SF_16BITS) ? 17 : 9;
-						status.last = status.bufBits = 0;
-
-						// Read the compressed length
-						inCnt = file->Read_L_UINT16();
+					blockLength = file->Read_L_UINT16();
+					if (file->IsEOF())
+						break;
 
-						cBlock = (s->flags & SF_16BITS) ? 0x4000 : 0x8000;
+					file->Seek(blockLength, PFile::pSeekCurrent);
+					packedLength += 2 + blockLength;
+				}
 
-						if (s->flags & SF_DELTA)
-							old = 0;
-					}
+				if (file->IsEOF() || ((start + packedLength) > file->GetLength()))
+				{
+					errorStr.LoadString(res, IDS_MIK_ERR_LOADING_SAMPLES);
+					retVal = AP_ERROR;
+					break;
+				}
 
-					if (s->flags & SF_16BITS)
-						result = DecompressIT16(&status, file, (int16 *)dest, toDo, &inCnt);
-					else
-						result = DecompressIT8(&status, file, (int8 *)dest, toDo, &inCnt);
+				job         = &packJobs[numPackJobs];
+				job->packed = new uint8[packedLength];
+				if (job->packed == NULL)
+				{
+					errorStr.LoadString(res, IDS_MIK_ERR_MEMORY);
+					retVal = AP_ERROR;
+					break;
+				}
 
-					if (!result)
-					{
-						// Well, some error occurred in the decompressing
-						errorStr.LoadString(res, IDS_MIK_ERR_ITPACKING);
-						return (AP_ERROR);
-					}
+				job->sample       = s;
+				job->packedLength = packedLength;
+				job->result       = true;
+				numPackJobs++;
 
-					cBlock -= toDo;
-				}
-				else
+				file->Seek(start, PFile::pSeekBegin);
+				file->Read(job->packed, packedLength);
+			}
+			else
+			{
+				// Read the sample into the memory
+				if (s->flags & SF_16BITS)
 				{
-					// Read the sample into the memory
-					if (s->flags & SF_16BITS)
-					{
-						if (s->flags & SF_BIG_ENDIAN)
-							file->ReadArray_B_UINT16s((uint16 *)dest, toDo);
-						else
-							file->ReadArray_L_UINT16s((uint16 *)dest, toDo);
-					}
+					if (s->flags & SF_BIG_ENDIAN)
+						file->ReadArray_B_UINT16s((uint16 *)s->handle, s->length);
 					else
-						file->Read(dest, toDo);
+						file->ReadArray_L_UINT16s((uint16 *)s->handle, s->length);
 				}
+				else
+					file->Read(s->handle, s->length);
+
+				ConvertSample(s, s->handle, s->length);
+			}
 
-				// Check for end of file
-				if (file->IsEOF())
+			// Check for end of file
+			if (file->IsEOF())
+			{
+				errorStr.LoadString(res, IDS_MIK_ERR_LOADING_SAMPLES);
+				retVal = AP_ERROR;
+				break;
+			}
+		}
+
+		if (retVal == AP_OK)
+		{
+			// Unpack all the IT packed samples
+			UnpackSamples();
+
+			for (v = 0; v < numPackJobs; v++)
+			{
+				if (!packJobs[v].result)
 				{
-					errorStr.LoadString(res, IDS_MIK_ERR_LOADING_SAMPLES);
-					return (AP_ERROR);
+					// Well, some error occurred in the decompressing
+					errorStr.LoadString(res, IDS_MIK_ERR_ITPACKING);
+					retVal = AP_ERROR;
+					break;
 				}
+			}
+		}
+	}
+	catch(...)
+	{
+		FreePackJobs();
+		throw;
+	}
 
-				// Dedelta the sample
-				if (s->flags & SF_DELTA)
-				{
-					samp = dest;
+	// The packed data is not needed anymore
+	FreePackJobs();
 
-					if (s->flags & SF_16BITS)
-					{
-						for (w = 0; w < toDo; w++)
-						{
-							*((int16 *)samp) += old;
-							old = *((int16 *)samp);
-							samp += 2;
-						}
-					}
-					else
-					{
-						for (w = 0; w < toDo; w++)
-						{
-							*samp += old;
-							old = *samp++;
-						}
-					}
-				}
+	return (retVal);
+}
 
-				// Convert the sample to signed
-				if (!(s->flags & SF_SIGNED))
-				{
-					samp = dest;
 
-					if (s->flags & SF_16BITS)
-					{
-						for (w = 0; w < toDo; w++)
-						{
-							*((int16 *)samp) += (int16)0x8000;
-							samp += 2;
-						}
-					}
-					else
-					{
-						for (w = 0; w < toDo; w++)
-							*samp++ += 0x80;
-					}
-				}
 
-				// Add number of samples to destination buffer
-				dest += toDo;
+/******************************************************************************/
+/* FreePackJobs() frees the unpack jobs and the packed data they hold.        */
+/******************************************************************************/
+void MikMod::FreePackJobs(void)
+{
+	int32 i;
 
-				if (s->flags & SF_16BITS)
-					dest += toDo;
+	for (i = 0; i < numPackJobs; i++)
+		delete[] packJobs[i].packed;
 
-				length -= toDo;
-			}
+	delete[] packJobs;
+	packJobs    = NULL;
+	numPackJobs = 0;
+}
+
+
+
+/******************************************************************************/
+/* UnpackSamples() unpacks all the IT packed samples read. The samples do not */
+/*      depend on each other, so they are unpacked by a thread per CPU.       */
+/******************************************************************************/
+void MikMod::UnpackSamples(void)
+{
+	system_info sysInfo;
+	PThread *threads;
+	int32 i, count;
+
+	// Find out how many threads to start. The calling
+	// thread unpacks samples too, so it is one less
+	get_system_info(&sysInfo);
+	count = min(min((int32)sysInfo.cpu_count, MAX_UNPACK_THREADS), numPackJobs) - 1;
+
+	threads = NULL;
+
+	if (count > 0)
+	{
+		threads = new PThread[count];
+		if (threads == NULL)
+			count = 0;
+
+		for (i = 0; i < count; i++)
+		{
+			threads[i].SetName("MikMod Unpacker");
+			threads[i].SetHookFunc(UnpackThread, this);
+			threads[i].StartThread();
 		}
 	}
 
-	return (AP_OK);
+	UnpackThread(this);
+
+	// Wait for the other threads to finish
+	for (i = 0; i < count; i++)
+		threads[i].WaitOnThread();
+
+	delete[] threads;
+}
+
+
+
+/******************************************************************************/
+/* UnpackThread() will take jobs until all the samples are unpacked.          */
+/*                                                                            */
+/* Input:  "userData" is a pointer to the player object.                      */
+/*                                                                            */
+/* Output: Always 0.                                                          */
+/******************************************************************************/
+int32 MikMod::UnpackThread(void *userData)
+{
+	MikMod *obj = (MikMod *)userData;
+	int32 job;
+
+	while ((job = AtomicIncrement(&obj->nextPackJob) - 1) < obj->numPackJobs)
+		obj->UnpackSample(&obj->packJobs[job]);
+
+	return (0);
+}
+
+
+
+/******************************************************************************/
+/* UnpackSample() unpacks a single IT packed sample.                          */
+/*                                                                            */
+/* Input:  "job" is a pointer to the job with the sample to unpack.           */
+/******************************************************************************/
+void MikMod::UnpackSample(ITPackJob *job)
+{
+	SAMPLE *s = job->sample;
+	const uint8 *src = job->packed;
+	uint8 *dest = s->handle;
+	int32 length = s->length;
+	int32 toDo, blockSamples;
+	uint32 blockLength;
+	bool result;
+
+	blockSamples = (s->flags & SF_16BITS) ? 0x4000 : 0x8000;
+
+	while (length)
+	{
+		toDo = min(length, blockSamples);
+
+		// Each block starts with the packed length. The
+		// blocks has already been checked when read
+		blockLength = src[0] | (src[1] << 8);
+		src += 2;
+
+		if (s->flags & SF_16BITS)
+			result = DecompressIT16(src, blockLength, (int16 *)dest, toDo);
+		else
+			result = DecompressIT8(src, blockLength, (int8 *)dest, toDo);
+
+		if (!result)
+		{
+			job->result = false;
+			return;
+		}
+
+		// The delta values starts over in each block
+		ConvertSample(s, dest, toDo);
+
+		src  += blockLength;
+		dest += toDo;
+
+		if (s->flags & SF_16BITS)
+			dest += toDo;
+
+		length -= toDo;
+	}
 }
 
 
 
 /******************************************************************************/
-/* DecompressIT8() decompress an 8-bit IT packed sample.                      */
+/* DecompressIT8() decompress a block of an 8-bit IT packed sample.           */
 /*                                                                            */
-/* Input:  "status" is a pointer to the ITPACK structure.                     */
-/*         "file" is a pointer to a file object to the file with the sample.  */
+/* Input:  "src" is a pointer to the packed data.                             */
+/*         "srcLength" is the length of the packed data in bytes.             */
 /*         "dest" is a pointer to where to store the unpacked data.           */
 /*         "length" is the size of the destination buffer in samples.         */
-/*         "inCnt" is a pointer the variable with the compressed length.      */
 /*                                                                            */
 /* Output: True for success, false for an error.                              */
 /******************************************************************************/
-bool MikMod::DecompressIT8(ITPACK *status, PFile *file, int8 *dest, uint32 length, uint16 *inCnt)
+bool MikMod::DecompressIT8(const uint8 *src, uint32 srcLength, int8 *dest, uint32 length)
 {
+	const uint8 *srcEnd = src + srcLength;
 	int8 *end = dest + length;
-	uint16 x, y, needBits, haveBits, newCount = 0;
-	uint16 bits = status->bits;
-	uint16 bufBits = status->bufBits;
-	int8 last = (int8)status->last;
-	uint8 buf = status->buf;
+	uint32 bitBuf = 0;
+	uint16 x, y, needBits, bufBits = 0, newCount = 0;
+	uint16 bits = 9;
+	int8 last = 0;
 
 	while (dest < end)
 	{
 		needBits = newCount ? 3 : bits;
-		x        = haveBits = 0;
 
-		while (needBits)
+		// Feed the bit buffer. Zeros are read after the end of the block
+		while (bufBits < needBits)
 		{
-			// Feed buffer
-			if (!bufBits)
-			{
-				if ((*inCnt)--)
-					buf = file->Read_UINT8();
-				else
-					buf = 0;
-
-				bufBits = 8;
-			}
-
-			// Get as many bits as necessary
-			y     = needBits < bufBits ? needBits : bufBits;
-			x    |= (buf & ((1 << y) - 1)) << haveBits;
-			buf >>=y;
+			if (src < srcEnd)
+				bitBuf |= (uint32)(*src++) << bufBits;
 
-			bufBits  -= y;
-			needBits -= y;
-			haveBits += y;
+			bufBits += 8;
 		}
 
+		// Get as many bits as necessary
+		x        = bitBuf & ((1 << needBits) - 1);
+		bitBuf >>= needBits;
+		bufBits -= needBits;
+
 		if (newCount)
 		{
 			newCount = 0;
@@ -1559,64 +1678,48 @@ bool MikMod::DecompressIT8(ITPACK *status, PFile *file, int8 *dest, uint32 lengt
 		*(dest++) = (last += x);
 	}
 
-	status->bits    = bits;
-	status->bufBits = bufBits;
-	status->last    = last;
-	status->buf     = buf;
-
 	return (true);
 }
 
 
 
 /******************************************************************************/
-/* DecompressIT16() decompress an 16-bit IT packed sample.                    */
+/* DecompressIT16() decompress a block of a 16-bit IT packed sample.          */
 /*                                                                            */
-/* Input:  "status" is a pointer to the ITPACK structure.                     */
-/*         "file" is a pointer to a file object to the file with the sample.  */
+/* Input:  "src" is a pointer to the packed data.                             */
+/*         "srcLength" is the length of the packed data in bytes.             */
 /*         "dest" is a pointer to where to store the unpacked data.           */
 /*         "length" is the size of the destination buffer in samples.         */
-/*         "inCnt" is a pointer the variable with the compressed length.      */
 /*                                                                            */
 /* Output: True for success, false for an error.                              */
 /******************************************************************************/
-bool MikMod::DecompressIT16(ITPACK *status, PFile *file, int16 *dest, uint32 length, uint16 *inCnt)
+bool MikMod::DecompressIT16(const uint8 *src, uint32 srcLength, int16 *dest, uint32 length)
 {
+	const uint8 *srcEnd = src + srcLength;
 	int16 *end = dest + length;
-	int32 x, y, needBits, haveBits, newCount = 0;
-	uint16 bits = status->bits;
-	uint16 bufBits = status->bufBits;
-	int16 last = status->last;
-	uint8 buf = status->buf;
+	uint32 bitBuf = 0;
+	int32 x, y, needBits, bufBits = 0, newCount = 0;
+	uint16 bits = 17;
+	int16 last = 0;
 
 	while (dest < end)
 	{
 		needBits = newCount ? 4 : bits;
-		x        = haveBits = 0;
 
-		while (needBits)
+		// Feed the bit buffer. Zeros are read after the end of the block
+		while (bufBits < needBits)
 		{
-			// Feed buffer
-			if (!bufBits)
-			{
-				if ((*inCnt)--)
-					buf = file->Read_UINT8();
-				else
-					buf = 0;
-
-				bufBits = 8;
-			}
-
-			// Get as many bits as necessary
-			y     = needBits < bufBits ? needBits : bufBits;
-			x    |= (buf & ((1 << y) - 1)) << haveBits;
-			buf >>= y;
+			if (src < srcEnd)
+				bitBuf |= (uint32)(*src++) << bufBits;
 
-			bufBits  -= (uint16)y;
-			needBits -= y;
-			haveBits += y;
+			bufBits += 8;
 		}
 
+		// Get as many bits as necessary
+		x        = bitBuf & ((1 << needBits) - 1);
+		bitBuf >>= needBits;
+		bufBits -= needBits;
+
 		if (newCount)
 		{
 			newCount = 0;
@@ -1668,16 +1771,71 @@ bool MikMod::DecompressIT16(ITPACK *status, PFile *file, int16 *dest, uint32 len
 		*(dest++) = (last += (int16)x);
 	}
 
-	status->bits    = bits;
-	status->bufBits = bufBits;
-	status->last    = last;
-	status->buf     = buf;
-
 	return (true);
 }
 
 
 
+/******************************************************************************/
+/* ConvertSample() dedeltas the sample data if needed and makes it signed.    */
+/*                                                                            */
+/* Input:  "s" is a pointer to the sample information.                        */
+/*         "dest" is a pointer to the sample data to convert.                 */
+/*         "count" is the number of samples to convert.                       */
+/******************************************************************************/
+void MikMod::ConvertSample(SAMPLE *s, uint8 *dest, int32 count)
+{
+	int16 old = 0;
+	int32 w;
+	uint8 *samp;
+
+	// Dedelta the sample
+	if (s->flags & SF_DELTA)
+	{
+		samp = dest;
+
+		if (s->flags & SF_16BITS)
+		{
+			for (w = 0; w < count; w++)
+			{
+				*((int16 *)samp) += old;
+				old = *((int16 *)samp);
+				samp += 2;
+			}
+		}
+		else
+		{
+			for (w = 0; w < count; w++)
+			{
+				*samp += old;
+				old = *samp++;
+			}
+		}
+	}
+
+	// Convert the sample to signed
+	if (!(s->flags & SF_SIGNED))
+	{
+		samp = dest;
+
+		if (s->flags & SF_16BITS)
+		{
+			for (w = 0; w < count; w++)
+			{
+				*((int16 *)samp) += (int16)0x8000;
+				samp += 2;
+			}
+		}
+		else
+		{
+			for (w = 0; w < count; w++)
+				*samp++ += 0x80;
+		}
+	}
+}
+
+
+
 /******************************************************************************/
 /* SetTempo() sets APlayer to the right BPM tempo.                            */
 /*                                                                            */
@@ -2573,7 +2731,10 @@ void MikMod::PT_SetupVoices(MODULE *mod)
 /******************************************************************************/
 int32 MikMod::GetRandom(int32 ceil)
 {
-	return ((int32)((rand() * ceil) / (RAND_MAX + 1.0)));
+	// Each instance has its own generator, so the output does not
+	// depend on other modules playing at the same time
+	randomSeed = randomSeed * 1103515245 + 12345;
+	return ((int32)((((randomSeed >> 16) & 0x7fff) * ceil) >> 15));
 }
 
 
@@ -29,15 +29,15 @@
 
 
 /******************************************************************************/
-/* ITPACK structure                                                           */
+/* IT packed sample job structure                                             */
 /******************************************************************************/
-typedef struct ITPACK
+typedef struct ITPackJob
 {
-	uint16 bits;				// Current number of bits
-	uint16 bufBits;				// Bits in buffer
-	int16 last;					// Last output
-	uint8 buf;					// Bit buffer
-} ITPACK;
+	SAMPLE *sample;				// The sample to unpack
+	uint8 *packed;				// All the packed blocks as read from the file
+	uint32 packedLength;		// Length of the packed blocks in bytes
+	bool result;				// False if the packed data is corrupt
+} ITPackJob;
 
 
 
@@ -117,8 +117,13 @@ protected:
 	ap_result CreateUniStructs(PFile *file, PString &errorStr);
 	uint8 *TrkRead(PFile *file);
 	ap_result FindSamples(PFile *file, PString &errorStr);
-	bool DecompressIT8(ITPACK *status, PFile *file, int8 *dest, uint32 length, uint16 *inCnt);
-	bool DecompressIT16(ITPACK *status, PFile *file, int16 *dest, uint32 length, uint16 *inCnt);
+	void FreePackJobs(void);
+	void UnpackSamples(void);
+	void UnpackSample(ITPackJob *job);
+	static int32 UnpackThread(void *userData);
+	static bool DecompressIT8(const uint8 *src, uint32 srcLength, int8 *dest, uint32 length);
+	static bool DecompressIT16(const uint8 *src, uint32 srcLength, int16 *dest, uint32 length);
+	static void ConvertSample(SAMPLE *s, uint8 *dest, int32 count);
 	void SetTempo(uint16 tempo);
 
 	// Player functions
@@ -264,12 +269,18 @@ protected:
 	uint16 currentSong;
 
 	uint16 bpmTempo;
+	uint32 randomSeed;
 
 	effect_func effects[UNI_LAST];
 
 	MODULE of;
 	MUniTrk uniTrk;
 
+	// IT sample unpacking variables
+	ITPackJob *packJobs;
+	int32 numPackJobs;
+	int32 nextPackJob;			// Next job to be taken by an unpack thread
+
 	// Voice variables
 	uint8 md_sngChn;
 };
@@ -28,7 +28,6 @@
 #include "PString.h"
 #include "PResource.h"
 #include "PFile.h"
-#include "PSystem.h"
 
 // APlayerKit headers
 #include "APGlobalData.h"
@@ -534,6 +533,11 @@ void ModTracker::InitSound(int32 index, uint16 songNum)
 	pattDelTime  = 0;
 	pattDelTime2 = 0;
 
+	// Every instance has its own AM waveforms, because the noise is
+	// generated while playing
+	memcpy(amWaves, amWaveforms, sizeof(amWaves));
+	noiseSeed = 1;
+
 	for (i = 0; i < channelNum; i++)
 	{
 		chan = &channels[i];
@@ -1654,6 +1658,8 @@ ap_result ModTracker::LoadMultiTracker(PFile *file, PString &errorStr)
 		for (i = 0; i < mulMod.trackNum; i++)
 		{
 			TrackLine *line;
+			uint8 trackBuf[256 * 3];
+			const uint8 *trackData;
 
 			// Allocate memory to hold the track
 			line = new TrackLine[patternLength];
@@ -1666,13 +1672,20 @@ ap_result ModTracker::LoadMultiTracker(PFile *file, PString &errorStr)
 			tracks[i + 1] = line;
 
 			// Now read the track
+			trackData = file->ReadView(patternLength * 3);
+			if (trackData == NULL)
+			{
+				file->ReadArray_UINT8s(trackBuf, patternLength * 3);
+				trackData = trackBuf;
+			}
+
 			for (j = 0; j < patternLength; j++)
 			{
 				uint8 a, b, c;
 
-				a = file->Read_UINT8();
-				b = file->Read_UINT8();
-				c = file->Read_UINT8();
+				a = *trackData++;
+				b = *trackData++;
+				c = *trackData++;
 
 				line[j].note = a >> 2;
 				if (line[j].note != 0)
@@ -1857,8 +1870,23 @@ ap_result ModTracker::ExtraLoad(PFile *file)
 /******************************************************************************/
 void ModTracker::LoadModTracks(PFile *file, TrackLine **tracks, int32 channels)
 {
+	uint8 *buffer = NULL;
+	const uint8 *data;
 	int32 i, j, n;
 
+	// Get the whole pattern at once. If the file can't give it to us
+	// directly, read it into a temporary buffer
+	data = file->ReadView(64 * channels * 4);
+	if (data == NULL)
+	{
+		buffer = new uint8[64 * channels * 4];
+		if (buffer == NULL)
+			throw PMemoryException();
+
+		file->ReadArray_UINT8s(buffer, 64 * channels * 4);
+		data = buffer;
+	}
+
 	for (i = 0; i < 64; i++)
 	{
 		for (j = 0; j < channels; j++)
@@ -1869,10 +1897,10 @@ void ModTracker::LoadModTracks(PFile *file, TrackLine **tracks, int32 channels)
 
 			workLine = tracks[j];
 
-			a = file->Read_UINT8();
-			b = file->Read_UINT8();
-			c = file->Read_UINT8();
-			d = file->Read_UINT8();
+			a = *data++;
+			b = *data++;
+			c = *data++;
+			d = *data++;
 
 			note = ((a & 0x0f) << 8) | b;
 
@@ -1894,6 +1922,8 @@ void ModTracker::LoadModTracks(PFile *file, TrackLine **tracks, int32 channels)
 			workLine[i].effectArg = d;
 		}
 	}
+
+	delete[] buffer;
 }
 
 
@@ -2156,7 +2186,7 @@ void ModTracker::PlayVoice(TrackLine *trackData, APChannel *apChan, Channel &cha
 				// Setup AM sample
 				amSamp = &amData[chan.sampleNum - 1];
 
-				chan.start       = &amWaveforms[amSamp->waveform][0];
+				chan.start       = &amWaves[amSamp->waveform][0];
 				chan.startOffset = 0;
 				chan.length      = 16;
 				chan.loopStart   = chan.start;
@@ -3619,5 +3649,8 @@ void ModTracker::AMHandler(void)
 
 	// Generate noise waveform
 	for (i = 0; i < 32; i++)
-		amWaveforms[3][i] = (int8)PSystem::Random(255);
+	{
+		noiseSeed     = noiseSeed * 1103515245 + 12345;
+		amWaves[3][i] = (int8)(noiseSeed >> 16);
+	}
 }
@@ -404,6 +404,8 @@ protected:
 	TrackLine **tracks;
 	uint16 *sequences;
 	AMSample *amData;
+	int8 amWaves[4][32];			// The AM waveforms, the last one is noise
+	uint32 noiseSeed;
 
 	Channel *channels;
 
@@ -214,7 +214,7 @@ const uint8 funkTable[16] =
 /******************************************************************************/
 /* AM Waveforms                                                               */
 /******************************************************************************/
-int8 amWaveforms[4][32] =
+const int8 amWaveforms[4][32] =
 {
 	{   0,   25,   49,   71,   90,  106,  117,  125,
 	  127,  125,  117,  106,   90,   71,   49,   25,
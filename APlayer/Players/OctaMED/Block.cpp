@@ -151,8 +151,10 @@ MED_Block::MED_Block(LINE_NUM lines, TRACK_NUM tracks, PAGE_NUM pages)
 	numTracks   = tracks;
 	numCmdPages = pages;
 
-	grid     = NULL;
-	cmdPages = NULL;
+	grid       = NULL;
+	cmdPages   = NULL;
+	events     = NULL;
+	lineEvents = NULL;
 
 	try
 	{
@@ -201,6 +203,8 @@ MED_Block::~MED_Block(void)
 {
 	PAGE_NUM cnt;
 
+	delete[] lineEvents;
+	delete[] events;
 	delete[] grid;
 
 	for (cnt = 0; cnt < numCmdPages; cnt++)
@@ -317,6 +321,102 @@ MED_Cmd &MED_Block::Cmd(LINE_NUM line, TRACK_NUM track, PAGE_NUM page)
 
 
 
+/******************************************************************************/
+/* Compile() builds the event list for the block. The player and the time     */
+/*      calculation only look at the commands actually used, so all the       */
+/*      empty commands are left out. Call this every time the commands have   */
+/*      been changed.                                                         */
+/******************************************************************************/
+void MED_Block::Compile(void)
+{
+	LINE_NUM line;
+	TRACK_NUM trk;
+	PAGE_NUM pg;
+	uint32 i, count;
+
+	// Free any previous event list
+	delete[] lineEvents;
+	delete[] events;
+	events     = NULL;
+	lineEvents = NULL;
+
+	// Count the used commands
+	count = 0;
+
+	for (pg = 0; pg < numCmdPages; pg++)
+	{
+		MED_Cmd *cmd = cmdPages[pg];
+
+		for (i = 0; i < (uint32)(numLines * numTracks); i++, cmd++)
+		{
+			if ((cmd->GetCmd() != 0) || (cmd->GetData() != 0))
+				count++;
+		}
+	}
+
+	// Allocate the lists
+	lineEvents = new uint32[numLines + 1];
+	if (lineEvents == NULL)
+		throw PMemoryException();
+
+	if (count != 0)
+	{
+		events = new MED_Event[count];
+		if (events == NULL)
+			throw PMemoryException();
+	}
+
+	// Fill out the lists in the same order as the player handles the commands
+	count = 0;
+
+	for (line = 0; line < numLines; line++)
+	{
+		lineEvents[line] = count;
+
+		for (pg = 0; pg < numCmdPages; pg++)
+		{
+			MED_Cmd *cmd = cmdPages[pg] + line * numTracks;
+
+			for (trk = 0; trk < numTracks; trk++, cmd++)
+			{
+				if ((cmd->GetCmd() != 0) || (cmd->GetData() != 0))
+				{
+					events[count].track = trk;
+					events[count].page  = pg;
+					events[count].cmd   = *cmd;
+					count++;
+				}
+			}
+		}
+	}
+
+	lineEvents[numLines] = count;
+}
+
+
+
+/******************************************************************************/
+/* Events() returns the events on the line given.                             */
+/*                                                                            */
+/* Input:  "line" is the line you want the events from.                       */
+/*         "count" will be set to the number of events on the line.           */
+/*                                                                            */
+/* Output: A pointer to the first event on the line.                          */
+/******************************************************************************/
+const MED_Event *MED_Block::Events(LINE_NUM line, uint32 &count) const
+{
+	if (lineEvents == NULL)
+	{
+		count = 0;
+		return (NULL);
+	}
+
+	count = lineEvents[line + 1] - lineEvents[line];
+	return (events + lineEvents[line]);
+}
+
+
+
 /******************************************************************************/
 /* Lines() returns the number of lines in the block.                          */
 /*                                                                            */
@@ -65,6 +65,19 @@ protected:
 
 
 
+/******************************************************************************/
+/* MED_Event class                                                            */
+/******************************************************************************/
+class MED_Event
+{
+public:
+	uint16 track;
+	uint16 page;
+	MED_Cmd cmd;
+};
+
+
+
 /******************************************************************************/
 /* MED_Block class                                                            */
 /******************************************************************************/
@@ -80,6 +93,9 @@ public:
 	MED_Note &Note(LINE_NUM line, TRACK_NUM track);
 	MED_Cmd &Cmd(LINE_NUM line, TRACK_NUM track, PAGE_NUM page);
 
+	void Compile(void);
+	const MED_Event *Events(LINE_NUM line, uint32 &count) const;
+
 	LINE_NUM Lines(void) const;
 	TRACK_NUM Tracks(void) const;
 	PAGE_NUM Pages(void) const;
@@ -90,6 +106,9 @@ protected:
 	MED_Note *grid;
 	MED_Cmd **cmdPages;
 
+	MED_Event *events;			// All the used commands, sorted by line, page and track
+	uint32 *lineEvents;			// Index to the first event on each line
+
 	LINE_NUM numLines;
 	TRACK_NUM numTracks;
 	PAGE_NUM numCmdPages;
@@ -60,6 +60,9 @@ OctaMED::OctaMED(APGlobalData *global, PString fileName) : APAddOnPlayer(global)
 	sg  = NULL;
 	plr = NULL;
 
+	loadBuffer     = NULL;
+	loadBufferSize = 0;
+
 	// Allocate the resource object
 	res = new PResource(fileName);
 	if (res == NULL)
@@ -246,7 +249,6 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 			uint32 numBlocks;
 			SubSong *css;
 			uint32 *blkArray;
-			bool usesHexVol;
 
 			// Read the module header
 			ReadMMDHeader(file, currHdr);
@@ -297,9 +299,7 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 					mixConv = true;
 
 				if (song0.flags & MMD_FLAG_VOLHEX)
-					usesHexVol = true;
-				else
-					usesHexVol = false;
+					css->SetVolHex(true);
 
 				if (song0.flags & MMD_FLAG_STSLIDE)
 					css->SetSlide1st(true);
@@ -334,6 +334,7 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 			{
 				// MMD2 or MMD3
 				uint32 *pSqTbl;
+				const uint8 *sectionData;
 
 				ReadMMD2Song(file, &song2);
 
@@ -343,9 +344,7 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 					mixConv = true;
 
 				if (song2.flags & MMD_FLAG_VOLHEX)
-					usesHexVol = true;
-				else
-					usesHexVol = false;
+					css->SetVolHex(true);
 
 				if (song2.flags & MMD_FLAG_STSLIDE)
 					css->SetSlide1st(true);
@@ -420,8 +419,10 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 				// Read in section table
 				file->Seek(song2.sectionTableOffs, PFile::pSeekBegin);
 
+				sectionData = ReadData(file, song2.numSections * 2);
+
 				for (cnt = 0; cnt < song2.numSections; cnt++)
-					css->AppendNewSec(file->Read_B_UINT16());
+					css->AppendNewSec((sectionData[cnt * 2] << 8) | sectionData[cnt * 2 + 1]);
 
 				// Read playing sequences
 				file->Seek(song2.playSeqTableOffs, PFile::pSeekBegin);
@@ -434,6 +435,7 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 				{
 					uint32 cmdPtr, cnt2;
 					uint16 seqLen, seqNum;
+					const uint8 *seqData;
 					char name[32];
 
 					file->ReadArray_B_UINT32s(pSqTbl, song2.numPlaySeqs);
@@ -460,11 +462,12 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 						newSeq->SetName(name);
 
 						// Read PlaySeq length
-						seqLen = file->Read_B_UINT16();
+						seqLen  = file->Read_B_UINT16();
+						seqData = ReadData(file, seqLen * 2);
 
 						for (cnt2 = 0; cnt2 < seqLen; cnt2++)
 						{
-							seqNum = file->Read_B_UINT16();
+							seqNum = (seqData[cnt2 * 2] << 8) | seqData[cnt2 * 2 + 1];
 							if (seqNum < 0x8000)
 								newSeq->AddTail(new PlaySeqEntry(seqNum));
 						}
@@ -561,6 +564,7 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 					{
 						TRACK_NUM tracks, trkCnt;
 						LINE_NUM lines, lineCnt;
+						const uint8 *noteData;
 						MED_Block *blk;
 
 						// Seek to the block data
@@ -578,14 +582,17 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 
 						sg->CurrSS()->Append(blk);
 
+						// Get all the notes in the block at once
+						noteData = ReadData(file, lines * tracks * 3);
+
 						for (lineCnt = 0; lineCnt < lines; lineCnt++)
 						{
 							for (trkCnt = 0; trkCnt < tracks; trkCnt++)
 							{
-								uint8 mmd0Note[3];
+								const uint8 *mmd0Note = noteData;
 								MED_Note &dn = blk->Note(lineCnt, trkCnt);
 
-								file->Read(mmd0Note, 3);
+								noteData += 3;
 								dn.noteNum  = mmd0Note[0] & 0x3f;
 								dn.instrNum = (mmd0Note[1] >> 4) | ((mmd0Note[0] & 0x80) ? 0x10 : 0x00) | ((mmd0Note[0] & 0x40) ? 0x20 : 0x00);
 
@@ -608,6 +615,7 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 						LINE_NUM lines, lineCnt;
 						uint32 blockInfoOffs;
 						uint32 skipTracks = 0;
+						const uint8 *noteData;
 						MED_Block *blk;
 
 						// Seek to the block data
@@ -644,13 +652,17 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 
 						sg->CurrSS()->Append(blk);
 
+						// Get all the notes in the block at once
+						noteData = ReadData(file, lines * (tracks + skipTracks) * 4);
+
 						for (lineCnt = 0; lineCnt < lines; lineCnt++)
 						{
 							for (trkCnt = 0; trkCnt < tracks; trkCnt++)
 							{
-								uint8 mmdNote[4];
+								const uint8 *mmdNote = noteData;
 								MED_Note &dn = blk->Note(lineCnt, trkCnt);
-								file->Read(mmdNote, 4);
+
+								noteData += 4;
 
 								if (mmdNote[0] <= NOTE_44k)
 									dn.noteNum = mmdNote[0];
@@ -664,8 +676,8 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 									blk->Cmd(lineCnt, trkCnt, 0).SetCmdData(mmdNote[2], mmdNote[3], 0);
 							}
 
-							if (skipTracks != 0)
-								file->Seek(skipTracks * 4, PFile::pSeekCurrent);
+							// Skip the high tracks
+							noteData += skipTracks * 4;
 						}
 
 						if (blockInfoOffs != 0)
@@ -715,19 +727,21 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 								try
 								{
 									uint8 cmdNum, cmdArg;
+									const uint8 *cmdData;
 
 									file->ReadArray_B_UINT32s(pages, numPages);
 
 									for (pageCnt = 0; pageCnt < numPages; pageCnt++)
 									{
 										file->Seek(pages[pageCnt], PFile::pSeekBegin);
+										cmdData = ReadData(file, lines * tracks * 2);
 
 										for (lineCnt = 0; lineCnt < lines; lineCnt++)
 										{
 											for (trkCnt = 0; trkCnt < tracks; trkCnt++)
 											{
-												cmdNum = file->Read_UINT8();
-												cmdArg = file->Read_UINT8();
+												cmdNum = *cmdData++;
+												cmdArg = *cmdData++;
 
 												// Convert cmds 00 and 19 (if only one cmd byte)
 												if ((cmdNum == 0x19) || (cmdNum == 0x00))
@@ -762,6 +776,7 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 								try
 								{
 									uint8 arg2;
+									const uint8 *extData;
 									PAGE_NUM pCnt;
 
 									file->ReadArray_B_UINT32s(cmdExt, blk->Pages());
@@ -769,13 +784,14 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 									for (pCnt = 0; pCnt < blk->Pages(); pCnt++)
 									{
 										file->Seek(cmdExt[pCnt], PFile::pSeekBegin);
+										extData = ReadData(file, lines * tracks);
 
 										for (lineCnt = 0; lineCnt < lines; lineCnt++)
 										{
 											for (trkCnt = 0; trkCnt < tracks; trkCnt++)
 											{
 												MED_Cmd &cmd = blk->Cmd(lineCnt, trkCnt, pCnt);
-												arg2         = file->Read_UINT8();
+												arg2         = *extData++;
 
 												if ((cmd.GetCmd() == 0x00) || (cmd.GetCmd() == 0x19))
 													cmd.SetData(arg2);
@@ -794,10 +810,6 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 								delete[] cmdExt;
 							}
 						}
-
-						// Convert volume command 0C to handle the new 127 volume levels
-						ScanConvertOldVolToNew cVol(usesHexVol);
-						cVol.DoBlock(*blk);
 					}
 				}
 			}
@@ -1192,19 +1204,13 @@ ap_result OctaMED::LoadModule(int32 index, PFile *file, PString &errorStr)
 			delete[] smpArray;
 		}
 
-		// Do the conversion for old 4-8 channel modules
-		if (mixConv)
-		{
-			ScanSongConvertToMixMode cmm;
-			cmm.Do(*sg, mark == '0');
-		}
+		// Convert the volume commands, old 4-8 channel modules and the
+		// special 5-8 channel tempos, and build the event lists
+		ScanSongConvert conv;
+		conv.Do(*sg, mixConv, eightChConv, mark == '0');
 
-		// And special 5-8 channel tempo conversion
-		if (eightChConv)
-		{
-			ScanSongConvertTempo ct;
-			ct.DoSong(*sg);
-		}
+		// The load buffer is not needed anymore
+		FreeLoadBuffer();
 
 		// Everything is loaded alright
 		retVal = AP_OK;
@@ -1244,11 +1250,11 @@ bool OctaMED::InitPlayer(int32 index)
 	SongTime *songTime;
 	PosInfo posInfo;
 	SubSong *ss;
+	const MED_Event *events;
 	uint32 numSongs, numSect, numSeq, repeatLine, loopCount;
+	uint32 numEvents, evCnt;
 	int32 loopLine;
 	LINE_NUM numLines, line, startLine, newLine;
-	TRACK_NUM numTracks, track;
-	PAGE_NUM numPages, page;
 	uint32 i, j, k;
 	bool pattBreak, stopPlaying;
 	float total;
@@ -1301,8 +1307,6 @@ bool OctaMED::InitPlayer(int32 index)
 				PlaySeqEntry &pse = *playSeq.GetItem(k);
 				MED_Block &block  = ss->Block((BLOCK_NUM)pse);
 				numLines          = block.Lines();
-				numTracks         = block.Tracks();
-				numPages          = block.Pages();
 
 				for (line = startLine; line < numLines; line++)
 				{
@@ -1311,92 +1315,91 @@ bool OctaMED::InitPlayer(int32 index)
 					repeatLine = 1;
 					pattBreak  = false;
 
-					for (track = 0; track < numTracks; track++)
+					events = block.Events(line, numEvents);
+
+					for (evCnt = 0; evCnt < numEvents; evCnt++)
 					{
-						for (page = 0; page < numPages; page++)
+						const MED_Cmd &cmd = events[evCnt].cmd;
+						uint8 data = cmd.GetDataB();
+
+						switch (cmd.GetCmd())
 						{
-							MED_Cmd &cmd = block.Cmd(line, track, page);
-							uint8 data   = cmd.GetDataB();
+							// Set second tempo
+							case 0x09:
+							{
+								posInfo.tempo.ticksPerLine = data & 0x1f;
+								plr->SetMixTempo(posInfo.tempo);
+								break;
+							}
 
-							switch (cmd.GetCmd())
+							// Jump to play sequence
+							case 0x0b:
 							{
-								// Set second tempo
-								case 0x09:
-								{
-									posInfo.tempo.ticksPerLine = data & 0x1f;
-									plr->SetMixTempo(posInfo.tempo);
-									break;
-								}
+								if (data <= k)
+									stopPlaying = true;
 
-								// Jump to play sequence
-								case 0x0b:
-								{
-									if (data <= k)
-										stopPlaying = true;
+								k         = data - 1;
+								pattBreak = true;
+								break;
+							}
 
-									k         = data - 1;
+							// Misc
+							case 0x0f:
+							{
+								if (data == 0x00)
+								{
+									// Pattern break
+									startLine = 0;
 									pattBreak = true;
-									break;
 								}
-
-								// Misc
-								case 0x0f:
+								else if (data == 0xfe)
 								{
-									if (data == 0x00)
-									{
-										// Pattern break
-										startLine = 0;
-										pattBreak = true;
-									}
-									else if (data == 0xfe)
-									{
-										// Stop playing
-										stopPlaying = true;
-									}
-									else if (data <= 0xf0)
-									{
-										// Change tempo
-										posInfo.tempo.tempo = data;
-										plr->SetMixTempo(posInfo.tempo);
-									}
-									break;
+									// Stop playing
+									stopPlaying = true;
 								}
+								else if (data <= 0xf0)
+								{
+									// Change tempo
+									posInfo.tempo.tempo = data;
+									plr->SetMixTempo(posInfo.tempo);
+								}
+								break;
+							}
 
-								// Loop block
-								case 0x16:
+							// Loop block
+							case 0x16:
+							{
+								if (data != 0)
 								{
-									if (data != 0)
+									if (loopCount == 0)
+										loopCount = data;		// Init loop
+									else
 									{
-										if (loopCount == 0)
-											loopCount = data;		// Init loop
-										else
-										{
-											if (--loopCount == 0)
-												break;				// Continue
-										}
-
-										newLine = loopLine;			// Jump to beginning of loop
+										if (--loopCount == 0)
+											break;				// Continue
 									}
-									else
-										loopLine = line;			// Store line number
 
-									break;
+									newLine = loopLine;			// Jump to beginning of loop
 								}
+								else
+									loopLine = line;			// Store line number
 
-								// Pattern break with new line
-								case 0x1d:
-								{
-									startLine = data;
-									pattBreak = true;
-									break;
-								}
+								break;
+							}
 
-								// Repeat line
-								case 0x1e:
-								{
-									repeatLine = data + 1;
-									break;
-								}
+							// Pattern break with new line
+							case 0x1d:
+							{
+								startLine = data;
+								pattBreak = true;
+								break;
+							}
+
+							// Repeat line
+							case 0x1e:
+							{
+								repeatLine = data + 1;
+								break;
 							}
 						}
 					}
@@ -1857,6 +1860,9 @@ void OctaMED::Cleanup(void)
 		delete songTimeList.GetItem(i);
 
 	songTimeList.MakeEmpty();
+
+	// Delete the load buffer
+	FreeLoadBuffer();
 }
 
 
@@ -2016,3 +2022,55 @@ void OctaMED::ReadMMD2Song(PFile *file, MMD2SongData *song)
 	song->masterVol        = file->Read_UINT8();
 	song->numSamples       = file->Read_UINT8();
 }
+
+
+
+/******************************************************************************/
+/* ReadData() returns a pointer to the next bytes in the file. If the file    */
+/*      can't give them directly, they are read into the load buffer.         */
+/*                                                                            */
+/* Input:  "file" is where to read from.                                      */
+/*         "length" is the number of bytes to get.                            */
+/*                                                                            */
+/* Output: A pointer to the bytes. It is only valid until the next read.      */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+const uint8 *OctaMED::ReadData(PFile *file, uint32 length)
+{
+	const uint8 *data;
+
+	// Try to get the bytes without copying them
+	data = file->ReadView(length);
+	if (data == NULL)
+	{
+		// Make sure the load buffer is big enough
+		if (length > loadBufferSize)
+		{
+			FreeLoadBuffer();
+
+			loadBuffer = new uint8[length];
+			if (loadBuffer == NULL)
+				throw PMemoryException();
+
+			loadBufferSize = length;
+		}
+
+		file->ReadArray_UINT8s(loadBuffer, length);
+		data = loadBuffer;
+	}
+
+	return (data);
+}
+
+
+
+/******************************************************************************/
+/* FreeLoadBuffer() deletes the buffer used by ReadData().                    */
+/******************************************************************************/
+void OctaMED::FreeLoadBuffer(void)
+{
+	delete[] loadBuffer;
+	loadBuffer     = NULL;
+	loadBufferSize = 0;
+}
@@ -333,6 +333,9 @@ protected:
 
 	void ReadMMD2Song(PFile *file, MMD2SongData *song);
 
+	const uint8 *ReadData(PFile *file, uint32 length);
+	void FreeLoadBuffer(void);
+
 	PResource *res;
 	uint32 mark;
 
@@ -345,6 +348,9 @@ protected:
 
 	Song *sg;
 	Player *plr;
+
+	uint8 *loadBuffer;
+	uint32 loadBufferSize;
 };
 
 #endif
@@ -111,7 +111,8 @@ void Player::PlaySong(Song *song)
 /******************************************************************************/
 void Player::PlrCallBack(void)
 {
-	PAGE_NUM pageCnt;
+	const MED_Event *events;
+	uint32 numEvents, evCnt;
 	TRACK_NUM trkCnt;
 	MED_Block *blk;
 
@@ -175,331 +176,332 @@ void Player::PlrCallBack(void)
 			}
 
 			// Pre-fx
-			for (pageCnt = 0; pageCnt < blk->Pages(); pageCnt++)
+			events = blk->Events(line, numEvents);
+
+			for (evCnt = 0; evCnt < numEvents; evCnt++)
 			{
-				for (trkCnt = 0; trkCnt < blk->Tracks(); trkCnt++)
-				{
-					TrackData &trkd = td[trkCnt];
-					if (trkd.trkFxType == TrackData::none)
-						continue;
+				trkCnt = events[evCnt].track;
 
-					MED_Cmd &cmd = blk->Cmd(line, trkCnt, pageCnt);
-					uint8 data   = cmd.GetDataB();
-					uint16 dataW = cmd.GetData();
+				TrackData &trkd = td[trkCnt];
+				if (trkd.trkFxType == TrackData::none)
+					continue;
 
-					switch (cmd.GetCmd())
+				const MED_Cmd &cmd = events[evCnt].cmd;
+				uint8 data   = cmd.GetDataB();
+				uint16 dataW = cmd.GetData();
+
+				switch (cmd.GetCmd())
+				{
+					// Portamento
+					case 0x03:
 					{
-						// Portamento
-						case 0x03:
+						if (trkd.trkCurrNote != 0)
 						{
-							if (trkd.trkCurrNote != 0)
+							NOTE_NUM dest = trkd.trkCurrNote;
+							if (dest < 0x80)
 							{
-								NOTE_NUM dest = trkd.trkCurrNote;
-								if (dest < 0x80)
-								{
-									int32 dn = (int32)dest + (ss->GetPlayTranspose() + trkd.trkSTransp);
+								int32 dn = (int32)dest + (ss->GetPlayTranspose() + trkd.trkSTransp);
 
-									while (dn >= 0x80)
-										dn -= 12;
+								while (dn >= 0x80)
+									dn -= 12;
 
-									while (dn < 1)
-										dn += 12;
+								while (dn < 1)
+									dn += 12;
 
-									dest = (NOTE_NUM)dn;
-								}
-
-								trkd.trkPortTargetFreq = GetInstrNoteFreq(dest, plrSong->GetInstr(trkd.trkPrevINum));
+								dest = (NOTE_NUM)dn;
 							}
 
-							if (dataW != 0)
-								trkd.trkPortSpeed = dataW;
-
-							trkd.trkFxType = TrackData::noPlay;
-							break;
+							trkd.trkPortTargetFreq = GetInstrNoteFreq(dest, plrSong->GetInstr(trkd.trkPrevINum));
 						}
 
-						// Set hold/decay
-						case 0x08:
-						{
-							if (plrSong->GetInstr(trkd.trkPrevINum)->IsMIDI())
-							{
-								// Two digits used for hold with MIDI instruments
-								trkd.trkInitHold = data;
-							}
-							else
-							{
-								trkd.trkInitHold  = data & 0x0f;
-								trkd.trkInitDecay = data >> 4;
-							}
-							break;
-						}
+						if (dataW != 0)
+							trkd.trkPortSpeed = dataW;
 
-						// Set ticks per line
-						case 0x09:
-						{
-							ss->SetTempoTPL(data & 0x1f);
-							ChangePlayFreq();
-							break;
-						}
+						trkd.trkFxType = TrackData::noPlay;
+						break;
+					}
 
-						// Position jump
-						case 0x0b:
+					// Set hold/decay
+					case 0x08:
+					{
+						if (plrSong->GetInstr(trkd.trkPrevINum)->IsMIDI())
 						{
-							plrBreak    = positionJump;
-							plrNextLine = data;
-							break;
+							// Two digits used for hold with MIDI instruments
+							trkd.trkInitHold = data;
 						}
-
-						// Volume
-						case 0x0c:
+						else
 						{
-							if (data < 0x80)
-								trkd.trkPrevVol = data;
-							else
-							{
-								// Set default volume
-								data &= 0x7f;
-								trkd.trkPrevVol = data;
-								plrSong->GetInstr(trkd.trkPrevINum)->SetVol(data);
-							}
-							break;
+							trkd.trkInitHold  = data & 0x0f;
+							trkd.trkInitDecay = data >> 4;
 						}
+						break;
+					}
+
+					// Set ticks per line
+					case 0x09:
+					{
+						ss->SetTempoTPL(data & 0x1f);
+						ChangePlayFreq();
+						break;
+					}
 
-						// Set synth waveform sequence position
-						case 0x0e:
+					// Position jump
+					case 0x0b:
+					{
+						plrBreak    = positionJump;
+						plrNextLine = data;
+						break;
+					}
+
+					// Volume
+					case 0x0c:
+					{
+						if (data < 0x80)
+							trkd.trkPrevVol = data;
+						else
 						{
-							trkd.trkSy.wfCmdPos = data;
-							trkd.trkMiscFlags  |= TrackData::NO_SYNTH_WFPTR_RESET;
-							break;
+							// Set default volume
+							data &= 0x7f;
+							trkd.trkPrevVol = data;
+							plrSong->GetInstr(trkd.trkPrevINum)->SetVol(data);
 						}
+						break;
+					}
+
+					// Set synth waveform sequence position
+					case 0x0e:
+					{
+						trkd.trkSy.wfCmdPos = data;
+						trkd.trkMiscFlags  |= TrackData::NO_SYNTH_WFPTR_RESET;
+						break;
+					}
 
-						// Misc/Main tempo
-						case 0x0f:
+					// Misc/Main tempo
+					case 0x0f:
+					{
+						switch (data)
 						{
-							switch (data)
+							case 0x00:
 							{
-								case 0x00:
-								{
-									plrBreak    = patternBreak;
-									plrNextLine = 0;
-									break;
-								}
+								plrBreak    = patternBreak;
+								plrNextLine = 0;
+								break;
+							}
 
-								case 0xf2:
-								case 0xf4:
-								case 0xf5:
-									goto delay_note;
+							case 0xf2:
+							case 0xf4:
+							case 0xf5:
+								goto delay_note;
 
-								case 0xf7:	// Wait until MIDI messages sent
-									break;
+							case 0xf7:	// Wait until MIDI messages sent
+								break;
 
-								// TN: Filter support added
-								case 0xf8:	// Amiga filter off
-								{
-									med->amigaFilter = false;
-									break;
-								}
+							// TN: Filter support added
+							case 0xf8:	// Amiga filter off
+							{
+								med->amigaFilter = false;
+								break;
+							}
 
-								case 0xf9:	// Amiga filter on
-								{
-									med->amigaFilter = true;
-									break;
-								}
+							case 0xf9:	// Amiga filter on
+							{
+								med->amigaFilter = true;
+								break;
+							}
 
-								case 0xfd:	// Change frequency
+							case 0xfd:	// Change frequency
+							{
+								if (trkd.trkCurrNote != 0)
 								{
-									if (trkd.trkCurrNote != 0)
+									NOTE_NUM dest = trkd.trkCurrNote;
+									if (dest < 0x80)
 									{
-										NOTE_NUM dest = trkd.trkCurrNote;
-										if (dest < 0x80)
-										{
-											int32 dn = (int32)dest + (ss->GetPlayTranspose() + trkd.trkSTransp);
-
-											while (dn >= 0x80)
-												dn -= 12;
+										int32 dn = (int32)dest + (ss->GetPlayTranspose() + trkd.trkSTransp);
 
-											while (dn < 1)
-												dn += 12;
+										while (dn >= 0x80)
+											dn -= 12;
 
-											dest = (NOTE_NUM)dn;
-										}
+										while (dn < 1)
+											dn += 12;
 
-										trkd.trkFrequency = GetInstrNoteFreq(dest, plrSong->GetInstr(trkd.trkPrevINum));
+										dest = (NOTE_NUM)dn;
 									}
-									break;
-								}
 
-								case 0xfe:	// Stop!
-								{
-									plrDelayedStop  = true;
-									med->endReached = true;
-									break;
+									trkd.trkFrequency = GetInstrNoteFreq(dest, plrSong->GetInstr(trkd.trkPrevINum));
 								}
+								break;
+							}
 
-								case 0xff:
-								{
-									MuteChannel(trkCnt);
-									break;
-								}
+							case 0xfe:	// Stop!
+							{
+								plrDelayedStop  = true;
+								med->endReached = true;
+								break;
+							}
+
+							case 0xff:
+							{
+								MuteChannel(trkCnt);
+								break;
+							}
 
-								default:	// Change tempo
+							default:	// Change tempo
+							{
+								if (data <= 240)
 								{
-									if (data <= 240)
-									{
-										ss->SetTempoBPM(data);
-										ChangePlayFreq();
-									}
-									break;
+									ss->SetTempoBPM(data);
+									ChangePlayFreq();
 								}
+								break;
 							}
-							break;
 						}
+						break;
+					}
 
-						// Send custom MIDI/SYSX message
-						case 0x10:
-						{
-							break;
-						}
+					// Send custom MIDI/SYSX message
+					case 0x10:
+					{
+						break;
+					}
 
-						// Finetune
-						case 0x15:
-						{
-							int8 sData = (int8)data;
+					// Finetune
+					case 0x15:
+					{
+						int8 sData = (int8)data;
 
-							if ((sData >= -8) && (sData <= 7))
-								trkd.trkFineTune = sData;
+						if ((sData >= -8) && (sData <= 7))
+							trkd.trkFineTune = sData;
 
-							break;
-						}
+						break;
+					}
 
-						// Repeat loop
-						case 0x16:
+					// Repeat loop
+					case 0x16:
+					{
+						if (data != 0)
 						{
-							if (data != 0)
+							if (plrRepeatCounter == 0)
+								plrRepeatCounter = data;	// Init loop
+							else
 							{
-								if (plrRepeatCounter == 0)
-									plrRepeatCounter = data;	// Init loop
-								else
-								{
-									if (--plrRepeatCounter == 0)
-										break;					// Continue
-								}
-
-								plrNextLine = plrRepeatLine;	// Jump to beginning of loop
-								plrBreak    = loop;
+								if (--plrRepeatCounter == 0)
+									break;					// Continue
 							}
-							else
-								plrRepeatLine = line;			// Store line number
 
-							break;
+							plrNextLine = plrRepeatLine;	// Jump to beginning of loop
+							plrBreak    = loop;
 						}
+						else
+							plrRepeatLine = line;			// Store line number
 
-						// Sample offset
-						case 0x19:
-						{
-							trkd.trkSOffset = (uint32)dataW << 8;
-							break;
-						}
+						break;
+					}
 
-						// Change MIDI preset
-						case 0x1c:
-						{
-							break;
-						}
+					// Sample offset
+					case 0x19:
+					{
+						trkd.trkSOffset = (uint32)dataW << 8;
+						break;
+					}
 
-						// Next pattern
-						case 0x1d:
-						{
-							plrBreak    = patternBreak;
-							plrNextLine = data;
-							break;
-						}
+					// Change MIDI preset
+					case 0x1c:
+					{
+						break;
+					}
 
-						// Block delay
-						case 0x1e:
-						{
-							if (plrBlockDelay == 0)
-								plrBlockDelay = data + 1;
+					// Next pattern
+					case 0x1d:
+					{
+						plrBreak    = patternBreak;
+						plrNextLine = data;
+						break;
+					}
 
-							break;
-						}
+					// Block delay
+					case 0x1e:
+					{
+						if (plrBlockDelay == 0)
+							plrBlockDelay = data + 1;
 
-						// Delay/Retrig
-						case 0x1f:
-						{
+						break;
+					}
+
+					// Delay/Retrig
+					case 0x1f:
+					{
 delay_note:
-							if (!(trkd.trkNoteOffCnt = trkd.trkInitHold))
-								trkd.trkNoteOffCnt = -1;
+						if (!(trkd.trkNoteOffCnt = trkd.trkInitHold))
+							trkd.trkNoteOffCnt = -1;
 
-							trkd.trkFxType = TrackData::noPlay;
-							break;
-						}
+						trkd.trkFxType = TrackData::noPlay;
+						break;
+					}
 
-						// Sample backwards
-						case 0x20:
-						{
-							if (dataW == 0)
-								trkd.trkMiscFlags |= TrackData::BACKWARDS;
+					// Sample backwards
+					case 0x20:
+					{
+						if (dataW == 0)
+							trkd.trkMiscFlags |= TrackData::BACKWARDS;
 
-							break;
-						}
+						break;
+					}
 
-						// Filter sweep (CutOff)
-						case 0x23:
+					// Filter sweep (CutOff)
+					case 0x23:
+					{
+						if (dataW == 0)
+							trkd.trkCutOffTarget = 0;
+						else
 						{
-							if (dataW == 0)
-								trkd.trkCutOffTarget = 0;
-							else
-							{
-								trkd.trkCutOffTarget  = ((int32)cmd.GetDataB() + 1) << 8;
-								trkd.trkCutOffSwSpeed = cmd.GetData2() * 20;
-								trkd.trkCutOffLogPos  = 0;		// Filled by the sweep code
-							}
-							break;
+							trkd.trkCutOffTarget  = ((int32)cmd.GetDataB() + 1) << 8;
+							trkd.trkCutOffSwSpeed = cmd.GetData2() * 20;
+							trkd.trkCutOffLogPos  = 0;		// Filled by the sweep code
 						}
+						break;
+					}
 
-						// Set filter cutoff frequency
-						case 0x24:
-						{
+					// Set filter cutoff frequency
+					case 0x24:
+					{
 //XX							EffectGroup *eg = &ss->fx.GetGroup(ss->fx.GetTrackGroup(trkCnt));
 /*							if (dataW == 0)
-								eg->FilterOff();
-							else
-								eg->SetFilter(dataW);
+							eg->FilterOff();
+						else
+							eg->SetFilter(dataW);
 */
-							trkd.trkCutOffTarget = 0;			// Stop any sweep
-							break;
-						}
+						trkd.trkCutOffTarget = 0;			// Stop any sweep
+						break;
+					}
 
-						// Set filter resonance + type
-						case 0x25:
-						{
+					// Set filter resonance + type
+					case 0x25:
+					{
 //XX							EffectGroup *eg = &ss->fx.GetGroup(ss->fx.GetTrackGroup(trkCnt));
 /*							eg->SetResonance(dataW >> 4);
 
-							uint8 fType = (uint8)dataW & 0x0f;
-							if (fType == 1)
-								eg->SetFilterType(EffectGroup::LP);
-							else
-							{
-								if (fType == 2)
-									eg->SetFilterType(EffectGroup::HP);
-							}
-*/							break;
+						uint8 fType = (uint8)dataW & 0x0f;
+						if (fType == 1)
+							eg->SetFilterType(EffectGroup::LP);
+						else
+						{
+							if (fType == 2)
+								eg->SetFilterType(EffectGroup::HP);
 						}
+*/							break;
+					}
 
-						// ARexx trigger (only on Amiga)
-						case 0x2d:
-							break;
+					// ARexx trigger (only on Amiga)
+					case 0x2d:
+						break;
 
-						// Panpot
-						case 0x2e:
-						{
-							if (((int8)data >= -16) && ((int8)data <= 16))
-								ss->SetTrackPan(trkCnt, (int8)data);
+					// Panpot
+					case 0x2e:
+					{
+						if (((int8)data >= -16) && ((int8)data <= 16))
+							ss->SetTrackPan(trkCnt, (int8)data);
 
-							break;
-						}
+						break;
 					}
 				}
 			}
@@ -640,388 +642,389 @@ delay_note:
 		plrFxLine = blk->Lines() - 1;
 
 	// Effect handling (once per timing pulse)
-	for (pageCnt = 0; pageCnt < blk->Pages(); pageCnt++)
+	events = blk->Events(plrFxLine, numEvents);
+
+	for (evCnt = 0; evCnt < numEvents; evCnt++)
 	{
-		for (trkCnt = 0; trkCnt < blk->Tracks(); trkCnt++)
-		{
-			TrackData &trkd = td[trkCnt];
+		trkCnt = events[evCnt].track;
+
+		TrackData &trkd = td[trkCnt];
 
-			if (trkd.trkFxType == TrackData::none)
-				continue;
+		if (trkd.trkFxType == TrackData::none)
+			continue;
 
-			MED_Cmd &cmd = blk->Cmd(plrFxLine, trkCnt, pageCnt);
+		const MED_Cmd &cmd = events[evCnt].cmd;
 
-			// Call MIDI command handler and skip normal cmd handling if
-			// MIDI command handled by this routine
-			if (trkd.trkLastNoteMidi && MIDICommand(trkd, cmd))
-				continue;
+		// Call MIDI command handler and skip normal cmd handling if
+		// MIDI command handled by this routine
+		if (trkd.trkLastNoteMidi && MIDICommand(trkd, cmd))
+			continue;
 
-			uint8 data = cmd.GetDataB();
-			switch (cmd.GetCmd())
+		uint8 data = cmd.GetDataB();
+		switch (cmd.GetCmd())
+		{
+			// Arpeggio
+			case 0x00:
 			{
-				// Arpeggio
-				case 0x00:
+				if (cmd.GetData2())
 				{
-					if (cmd.GetData2())
+					NOTE_NUM base = trkd.trkPrevNote;
+					if (base > 0x80)
+						break;
+
+					switch (plrPulseCtr % 3)
 					{
-						NOTE_NUM base = trkd.trkPrevNote;
-						if (base > 0x80)
+						case 0:
+						{
+							base += cmd.GetData2() >> 4;
 							break;
+						}
 
-						switch (plrPulseCtr % 3)
+						case 1:
 						{
-							case 0:
-							{
-								base += cmd.GetData2() >> 4;
-								break;
-							}
-
-							case 1:
-							{
-								base += cmd.GetData2() & 0x0f;
-								break;
-							}
+							base += cmd.GetData2() & 0x0f;
+							break;
 						}
-
-						base += (uint8)(ss->GetPlayTranspose() - 1 + trkd.trkSTransp);
-						int32 freq = GetNoteFrequency(base, trkd.trkFineTune);
-						trkd.trkArpAdjust = freq - trkd.trkFrequency;	// Arpeggio difference
 					}
-					break;
-				}
 
-				// Slide up (once)
-				case 0x11:
-				{
-					if (plrPulseCtr != 0)
-						break;
-					else
-						goto cmd1_do;
+					base += (uint8)(ss->GetPlayTranspose() - 1 + trkd.trkSTransp);
+					int32 freq = GetNoteFrequency(base, trkd.trkFineTune);
+					trkd.trkArpAdjust = freq - trkd.trkFrequency;	// Arpeggio difference
 				}
+				break;
+			}
 
-				// Slide up
-				case 0x01:
-				{
-					if ((plrPulseCtr == 0) && ss->GetSlide1st())
-						break;
+			// Slide up (once)
+			case 0x11:
+			{
+				if (plrPulseCtr != 0)
+					break;
+				else
+					goto cmd1_do;
+			}
 
-cmd1_do:			if (trkd.trkFrequency > 0)
-					{
-						int32 div = 3579545 * 256 / trkd.trkFrequency - (int32)((uint16)cmd.GetData());
-						if (div > 0)
-							trkd.trkFrequency = 3579545 * 256 / div;
-					}
+			// Slide up
+			case 0x01:
+			{
+				if ((plrPulseCtr == 0) && ss->GetSlide1st())
 					break;
-				}
 
-				// Slide down (once)
-				case 0x12:
+cmd1_do:			if (trkd.trkFrequency > 0)
 				{
-					if (plrPulseCtr != 0)
-						break;
-					else
-						goto cmd2_do;
+					int32 div = 3579545 * 256 / trkd.trkFrequency - (int32)((uint16)cmd.GetData());
+					if (div > 0)
+						trkd.trkFrequency = 3579545 * 256 / div;
 				}
+				break;
+			}
 
-				// Slide down
-				case 0x02:
-				{
-					if ((plrPulseCtr == 0) && ss->GetSlide1st())
-						break;
+			// Slide down (once)
+			case 0x12:
+			{
+				if (plrPulseCtr != 0)
+					break;
+				else
+					goto cmd2_do;
+			}
 
-cmd2_do:			if (trkd.trkFrequency > 0)
-					{
-						int32 div = 3579545 * 256 / trkd.trkFrequency + (int32)((uint16)cmd.GetData());
-						if (div > 0)
-							trkd.trkFrequency = 3579545 * 256 / div;
-					}
+			// Slide down
+			case 0x02:
+			{
+				if ((plrPulseCtr == 0) && ss->GetSlide1st())
 					break;
-				}
 
-				// Portamento
-				case 0x03:
+cmd2_do:			if (trkd.trkFrequency > 0)
 				{
-					if ((plrPulseCtr == 0) && ss->GetSlide1st())
-						break;
+					int32 div = 3579545 * 256 / trkd.trkFrequency + (int32)((uint16)cmd.GetData());
+					if (div > 0)
+						trkd.trkFrequency = 3579545 * 256 / div;
+				}
+				break;
+			}
+
+			// Portamento
+			case 0x03:
+			{
+				if ((plrPulseCtr == 0) && ss->GetSlide1st())
+					break;
 
 do_portamento:		if ((trkd.trkPortTargetFreq == 0) || (trkd.trkFrequency <= 0))
-						break;
+					break;
 
-					int32 newFreq = trkd.trkFrequency, div = 3579545 * 256 / newFreq;
+				int32 newFreq = trkd.trkFrequency, div = 3579545 * 256 / newFreq;
 
-					if (trkd.trkFrequency > trkd.trkPortTargetFreq)
-					{
-						div += (int32)trkd.trkPortSpeed;
-						if (div != 0)
-						{
-							newFreq = 3579545 * 256 / div;
-							if (newFreq <= trkd.trkPortTargetFreq)
-							{
-								newFreq = trkd.trkPortTargetFreq;
-								trkd.trkPortTargetFreq = 0;
-							}
-						}
-					}
-					else
+				if (trkd.trkFrequency > trkd.trkPortTargetFreq)
+				{
+					div += (int32)trkd.trkPortSpeed;
+					if (div != 0)
 					{
-						if (div > (int32)trkd.trkPortSpeed)
-						{
-							div -= (int32)trkd.trkPortSpeed;
-							newFreq = 3579545 * 256 / div;
-						}
-						else
-							newFreq = trkd.trkPortTargetFreq;
-
-						if (newFreq >= trkd.trkPortTargetFreq)
+						newFreq = 3579545 * 256 / div;
+						if (newFreq <= trkd.trkPortTargetFreq)
 						{
 							newFreq = trkd.trkPortTargetFreq;
 							trkd.trkPortTargetFreq = 0;
 						}
 					}
-
-					trkd.trkFrequency = newFreq;
-					break;
 				}
-
-				// Volume slide
-				case 0x0d:
-				case 0x0a:
-				case 0x06:		// (with vibrato)
-				case 0x05:		// (or portamento)
+				else
 				{
-					if ((plrPulseCtr == 0) && ss->GetSlide1st())
-						break;
-
-					if (data & 0xf0)
+					if (div > (int32)trkd.trkPortSpeed)
 					{
-						trkd.trkPrevVol += (data >> 4) * 2;
-						if (trkd.trkPrevVol > 127)
-							trkd.trkPrevVol = 127;
+						div -= (int32)trkd.trkPortSpeed;
+						newFreq = 3579545 * 256 / div;
 					}
 					else
-					{
-						if (((data & 0x0f) * 2) > trkd.trkPrevVol)
-							trkd.trkPrevVol = 0;
-						else
-							trkd.trkPrevVol -= (data & 0x0f) * 2;
-					}
+						newFreq = trkd.trkPortTargetFreq;
 
-					if (cmd.GetCmd() == 0x06)
-						goto do_vibrato;	// Command 06
-					else
+					if (newFreq >= trkd.trkPortTargetFreq)
 					{
-						if (cmd.GetCmd() == 0x05)
-							goto do_portamento;	// Command 05
+						newFreq = trkd.trkPortTargetFreq;
+						trkd.trkPortTargetFreq = 0;
 					}
-					break;
 				}
 
-				// Vibrato (deeper)
-				case 0x04:
+				trkd.trkFrequency = newFreq;
+				break;
+			}
+
+			// Volume slide
+			case 0x0d:
+			case 0x0a:
+			case 0x06:		// (with vibrato)
+			case 0x05:		// (or portamento)
+			{
+				if ((plrPulseCtr == 0) && ss->GetSlide1st())
+					break;
+
+				if (data & 0xf0)
 				{
-					trkd.trkVibShift = 5;
-					goto vib_cont;
+					trkd.trkPrevVol += (data >> 4) * 2;
+					if (trkd.trkPrevVol > 127)
+						trkd.trkPrevVol = 127;
 				}
-
-				// Vibrato (shallower)
-				case 0x14:
+				else
 				{
-					trkd.trkVibShift = 6;
-vib_cont:			if ((plrPulseCtr == 0) && (data != 0))
-					{
-						// Check data on pulse #0 for possible new values
-						if (data & 0x0f)
-							trkd.trkVibSize = data & 0x0f;	// New vibrato size
+					if (((data & 0x0f) * 2) > trkd.trkPrevVol)
+						trkd.trkPrevVol = 0;
+					else
+						trkd.trkPrevVol -= (data & 0x0f) * 2;
+				}
 
-						if (data >> 4)
-							trkd.trkVibSpeed = (data >> 4) * 2;	// New vibrato speed
-					}
+				if (cmd.GetCmd() == 0x06)
+					goto do_vibrato;	// Command 06
+				else
+				{
+					if (cmd.GetCmd() == 0x05)
+						goto do_portamento;	// Command 05
+				}
+				break;
+			}
 
-do_vibrato:			if (trkd.trkFrequency > 0)
-					{
-						// Another piece of Amiga period emulation code
-						int32 per = 3579545 / trkd.trkFrequency;
-						per += (sineTable[(trkd.trkVibOffs >> 2) & 0x1f] * trkd.trkVibSize) >> trkd.trkVibShift;
+			// Vibrato (deeper)
+			case 0x04:
+			{
+				trkd.trkVibShift = 5;
+				goto vib_cont;
+			}
 
-						if (per > 0)
-							trkd.trkVibrAdjust = 3579545 / per - trkd.trkFrequency;
-					}
+			// Vibrato (shallower)
+			case 0x14:
+			{
+				trkd.trkVibShift = 6;
+vib_cont:			if ((plrPulseCtr == 0) && (data != 0))
+				{
+					// Check data on pulse #0 for possible new values
+					if (data & 0x0f)
+						trkd.trkVibSize = data & 0x0f;	// New vibrato size
 
-					trkd.trkVibOffs += trkd.trkVibSpeed;
-					break;
+					if (data >> 4)
+						trkd.trkVibSpeed = (data >> 4) * 2;	// New vibrato speed
 				}
 
-				// Simple pulse vibrato
-				case 0x13:
+do_vibrato:			if (trkd.trkFrequency > 0)
 				{
-					if (plrPulseCtr < 3)
-						trkd.trkVibrAdjust = -(int32)data;
+					// Another piece of Amiga period emulation code
+					int32 per = 3579545 / trkd.trkFrequency;
+					per += (sineTable[(trkd.trkVibOffs >> 2) & 0x1f] * trkd.trkVibSize) >> trkd.trkVibShift;
 
-					break;
+					if (per > 0)
+						trkd.trkVibrAdjust = 3579545 / per - trkd.trkFrequency;
 				}
 
-				// Cut note
-				case 0x18:
-				{
-					if (plrPulseCtr == data)
-						trkd.trkPrevVol = 0;
+				trkd.trkVibOffs += trkd.trkVibSpeed;
+				break;
+			}
 
-					break;
-				}
+			// Simple pulse vibrato
+			case 0x13:
+			{
+				if (plrPulseCtr < 3)
+					trkd.trkVibrAdjust = -(int32)data;
 
-				// Volume slide up (small)
-				case 0x1a:
+				break;
+			}
+
+			// Cut note
+			case 0x18:
+			{
+				if (plrPulseCtr == data)
+					trkd.trkPrevVol = 0;
+
+				break;
+			}
+
+			// Volume slide up (small)
+			case 0x1a:
+			{
+				if (plrPulseCtr == 0)
 				{
-					if (plrPulseCtr == 0)
-					{
-						uint8 incr = data + (cmd.GetData2() >= 0x80 ? 1 : 0);
-						if ((trkd.trkPrevVol + incr) < 127)
-							trkd.trkPrevVol += incr;
-						else
-							trkd.trkPrevVol = 127;
-					}
-					break;
+					uint8 incr = data + (cmd.GetData2() >= 0x80 ? 1 : 0);
+					if ((trkd.trkPrevVol + incr) < 127)
+						trkd.trkPrevVol += incr;
+					else
+						trkd.trkPrevVol = 127;
 				}
+				break;
+			}
 
-				// Volume slide down (small)
-				case 0x1b:
+			// Volume slide down (small)
+			case 0x1b:
+			{
+				if (plrPulseCtr == 0)
 				{
-					if (plrPulseCtr == 0)
-					{
-						uint8 decr = data - (cmd.GetData2() >= 0x80 ? 1 : 0);
-						if (trkd.trkPrevVol > decr)
-							trkd.trkPrevVol -= decr;
-						else
-							trkd.trkPrevVol = 0;
-					}
-					break;
+					uint8 decr = data - (cmd.GetData2() >= 0x80 ? 1 : 0);
+					if (trkd.trkPrevVol > decr)
+						trkd.trkPrevVol -= decr;
+					else
+						trkd.trkPrevVol = 0;
 				}
+				break;
+			}
 
-				// Misc retrig commands
-				case 0x0f:
+			// Misc retrig commands
+			case 0x0f:
+			{
+				switch (data)
 				{
-					switch (data)
+					case 0xf1:
+					case 0xf2:
 					{
-						case 0xf1:
-						case 0xf2:
-						{
-							if (plrPulseCtr == 3)
-								PlayFXNote(trkCnt, trkd);
+						if (plrPulseCtr == 3)
+							PlayFXNote(trkCnt, trkd);
 
-							break;
-						}
+						break;
+					}
 
-						case 0xf3:
-						{
-							if ((plrPulseCtr == 2) || (plrPulseCtr == 4))
-								PlayFXNote(trkCnt, trkd);
+					case 0xf3:
+					{
+						if ((plrPulseCtr == 2) || (plrPulseCtr == 4))
+							PlayFXNote(trkCnt, trkd);
 
-							break;
-						}
+						break;
+					}
 
-						case 0xf4:
-						{
-							if ((ss->GetTempoTPL() / 3) == plrPulseCtr)
-								PlayFXNote(trkCnt, trkd);
+					case 0xf4:
+					{
+						if ((ss->GetTempoTPL() / 3) == plrPulseCtr)
+							PlayFXNote(trkCnt, trkd);
 
-							break;
-						}
+						break;
+					}
 
-						case 0xf5:
-						{
-							if (((ss->GetTempoTPL() * 2) / 3) == plrPulseCtr)
-								PlayFXNote(trkCnt, trkd);
+					case 0xf5:
+					{
+						if (((ss->GetTempoTPL() * 2) / 3) == plrPulseCtr)
+							PlayFXNote(trkCnt, trkd);
 
-							break;
-						}
+						break;
+					}
 
-						case 0xf7:
-						{
-							break;
-						}
+					case 0xf7:
+					{
+						break;
 					}
-					break;
 				}
+				break;
+			}
 
-				// Note delay/retrig
-				case 0x1f:
+			// Note delay/retrig
+			case 0x1f:
+			{
+				if (data >> 4)
 				{
-					if (data >> 4)
-					{
-						// There's note delay specified
-						if (plrPulseCtr < (data >> 4))
-							break;		// Delay still going on...
+					// There's note delay specified
+					if (plrPulseCtr < (data >> 4))
+						break;		// Delay still going on...
 
-						if (plrPulseCtr == (data >> 4))
-						{
-							PlayFXNote(trkCnt, trkd);
-							break;
-						}
+					if (plrPulseCtr == (data >> 4))
+					{
+						PlayFXNote(trkCnt, trkd);
+						break;
 					}
+				}
 
-					if ((data & 0x0f) && (!(plrPulseCtr % (data & 0x0f))))
-						PlayFXNote(trkCnt, trkd);
+				if ((data & 0x0f) && (!(plrPulseCtr % (data & 0x0f))))
+					PlayFXNote(trkCnt, trkd);
 
-					break;
-				}
+				break;
+			}
 
-				// Change sample position
-				case 0x20:
-				{
-					if ((plrPulseCtr == 0) && (data != 0))
-						ChangeSamplePosition(trkCnt, (int32)((int16)cmd.GetData()));
+			// Change sample position
+			case 0x20:
+			{
+				if ((plrPulseCtr == 0) && (data != 0))
+					ChangeSamplePosition(trkCnt, (int32)((int16)cmd.GetData()));
 
-					break;
-				}
+				break;
+			}
 
-				// Slide up (const. rate)
-				case 0x21:
-				{
-					trkd.trkFrequency += (trkd.trkFrequency * data) >> 11;
-					if (trkd.trkFrequency > 65535)
-						trkd.trkFrequency = 65535;
+			// Slide up (const. rate)
+			case 0x21:
+			{
+				trkd.trkFrequency += (trkd.trkFrequency * data) >> 11;
+				if (trkd.trkFrequency > 65535)
+					trkd.trkFrequency = 65535;
 
-					break;
-				}
+				break;
+			}
 
-				// Slide down (const. rate)
-				case 0x22:
-				{
-					if ((((trkd.trkFrequency * data) >> 11) + 1) < trkd.trkFrequency)
-						trkd.trkFrequency -= (trkd.trkFrequency * data) >> 11;
-					else
-						trkd.trkFrequency = 1;
+			// Slide down (const. rate)
+			case 0x22:
+			{
+				if ((((trkd.trkFrequency * data) >> 11) + 1) < trkd.trkFrequency)
+					trkd.trkFrequency -= (trkd.trkFrequency * data) >> 11;
+				else
+					trkd.trkFrequency = 1;
 
-					break;
-				}
+				break;
+			}
 
-				// Change sample position II (relative to sample length)
-				case 0x29:
+			// Change sample position II (relative to sample length)
+			case 0x29:
+			{
+				if (plrPulseCtr == 0)
 				{
-					if (plrPulseCtr == 0)
-					{
-						Sample *smp = plrSong->GetSample(trkd.trkPrevINum);
-						uint8 div   = cmd.GetData2();
+					Sample *smp = plrSong->GetSample(trkd.trkPrevINum);
+					uint8 div   = cmd.GetData2();
 
-						if (div == 0)
-							div = 0x10;		// Default divisor is 16
+					if (div == 0)
+						div = 0x10;		// Default divisor is 16
 
-						if ((smp != NULL) && !smp->IsSynthSound() && (data < div))
-						{
-							int32 len = smp->GetLength();
-							SetSamplePosition(trkCnt, (data * len) / div);
-						}
+					if ((smp != NULL) && !smp->IsSynthSound() && (data < div))
+					{
+						int32 len = smp->GetLength();
+						SetSamplePosition(trkCnt, (data * len) / div);
 					}
-					break;
 				}
+				break;
 			}
+		}
 
-			// Filter sweep
-			if (trkd.trkCutOffTarget != 0)
-			{
-				//XX
-				;
-			}
+		// Filter sweep
+		if (trkd.trkCutOffTarget != 0)
+		{
+			//XX
+			;
 		}
 	}
 
@@ -1282,7 +1285,7 @@ void Player::UpdateFreqVolPan(SubSong *ss, TRACK_NUM trkNum)
 /*                                                                            */
 /* Output: True if the command is a MIDI command, false if not.               */
 /******************************************************************************/
-bool Player::MIDICommand(TrackData &trkd, MED_Cmd &cmd)
+bool Player::MIDICommand(TrackData &trkd, const MED_Cmd &cmd)
 {
 	switch (cmd.GetCmd())
 	{
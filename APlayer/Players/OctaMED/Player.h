@@ -132,7 +132,7 @@ protected:
 	void ExtractInstrData(TrackData &trkd, Instr *currI);
 	void PlayFXNote(TRACK_NUM trkNum, TrackData &trkd);
 	void UpdateFreqVolPan(SubSong *ss, TRACK_NUM trkNum);
-	bool MIDICommand(TrackData &trkd, MED_Cmd &cmd);
+	bool MIDICommand(TrackData &trkd, const MED_Cmd &cmd);
 
 	int32 SynthHandler(uint32 chNum, TrackData &trkd, SynthSound *snd);
 
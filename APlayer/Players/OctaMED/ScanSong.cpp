@@ -84,6 +84,8 @@ void ScanBlock::DoBlock(MED_Block &blk)
 
 	for (trk = 0; trk < blk.Tracks(); trk++)
 		ScanTrack::DoTrack(blk, trk);
+
+	BlockOperation(blk);
 }
 
 
@@ -130,38 +132,52 @@ void ScanSong::DoSong(Song &sg)
 
 
 /******************************************************************************/
-/* ScanSongConvertToMixMode class                                             */
+/* ScanSongConvert class                                                      */
+/*                                                                            */
+/* Converts old modules to the current format and compiles the event lists    */
+/* of all the blocks in one pass over the song.                               */
 /******************************************************************************/
+const uint8 ScanSongConvert::bpmVals[9] =
+{
+	179, 164, 152, 141, 131, 123, 116, 110, 104
+};
+
+
 
 /******************************************************************************/
 /* Do()                                                                       */
 /******************************************************************************/
-void ScanSongConvertToMixMode::Do(Song &sg, bool isType0)
+void ScanSongConvert::Do(Song &sg, bool mixMode, bool tempo, bool isType0)
 {
 	uint32 cnt;
 
-	type0 = isType0;
-
-	// Check which instruments will be transposed...
-	transpInstr[0] = true;
-	iTrans[0]      = 0;
+	convMixMode = mixMode;
+	convTempo   = tempo;
+	type0       = isType0;
 
-	for (cnt = 1; cnt <= MAX_INSTRS; cnt++)
+	if (convMixMode)
 	{
-		Instr *i = sg.GetInstr(cnt - 1);
+		// Check which instruments will be transposed...
+		transpInstr[0] = true;
+		iTrans[0]      = 0;
 
-		if (!sg.SampleSlotUsed(cnt - 1))
-			transpInstr[cnt] = true;
-		else
+		for (cnt = 1; cnt <= MAX_INSTRS; cnt++)
 		{
-			if ((!sg.GetSample(cnt - 1)->IsSynthSound()) || (sg.GetSample(cnt - 1)->GetLength() != 0))
+			Instr *i = sg.GetInstr(cnt - 1);
+
+			if (!sg.SampleSlotUsed(cnt - 1))
 				transpInstr[cnt] = true;
 			else
-				transpInstr[cnt] = false;
-		}
+			{
+				if ((!sg.GetSample(cnt - 1)->IsSynthSound()) || (sg.GetSample(cnt - 1)->GetLength() != 0))
+					transpInstr[cnt] = true;
+				else
+					transpInstr[cnt] = false;
+			}
 
-		iTrans[cnt] = i->GetTransp();
-		isMidi[cnt] = i->IsMIDI();
+			iTrans[cnt] = i->GetTransp();
+			isMidi[cnt] = i->IsMIDI();
+		}
 	}
 
 	ScanSong::DoSong(sg);
@@ -169,11 +185,58 @@ void ScanSongConvertToMixMode::Do(Song &sg, bool isType0)
 
 
 
+/******************************************************************************/
+/* CmdOperation()                                                             */
+/******************************************************************************/
+void ScanSongConvert::CmdOperation(MED_Cmd &cmd)
+{
+	uint8 data;
+
+	switch (cmd.GetCmd())
+	{
+		// Convert volume command 0C to handle the new 127 volume levels.
+		// MMD0 blocks are not converted
+		case 0x0c:
+		{
+			if (type0)
+				break;
+
+			if ((data = cmd.GetData2()) != 0)
+				cmd.SetData(data, 0);
+			else
+			{
+				if ((data = cmd.GetDataB()) != 0)
+				{
+					if (!hex)
+						data = min((data >> 4) * 10 + (data & 0x0f), 64);
+
+					cmd.SetData(data * 2 - 1, 0);
+				}
+			}
+			break;
+		}
+
+		// Special 5-8 channel tempo conversion
+		case 0x0f:
+		{
+			if (convTempo && (data = cmd.GetDataB()) && (data <= 240))
+				cmd.SetData(data > 10 ? 99 : bpmVals[data - 1]);
+
+			break;
+		}
+	}
+}
+
+
+
 /******************************************************************************/
 /* NoteOperation()                                                            */
 /******************************************************************************/
-void ScanSongConvertToMixMode::NoteOperation(MED_Note &note)
+void ScanSongConvert::NoteOperation(MED_Note &note)
 {
+	if (!convMixMode)
+		return;
+
 	if ((note.noteNum != 0) && (note.noteNum <= (0x7f - 24)) && (transpInstr[lastINum]))
 	{
 		if (isMidi[lastINum])
@@ -196,43 +259,12 @@ void ScanSongConvertToMixMode::NoteOperation(MED_Note &note)
 
 
 /******************************************************************************/
-/* SubSongOperation()                                                         */
-/******************************************************************************/
-void ScanSongConvertToMixMode::SubSongOperation(SubSong &ss)
-{
-	static int8 panVals[8] = { -16, 16, 16, -16, -16, 16, 16, -16 };
-	uint32 cnt;
-
-	// For each subsong, set panning & stereo mode
-	ss.SetStereo(true);
-
-	for (cnt = 0; cnt < 8; cnt++)
-		ss.SetTrackPan(cnt, panVals[cnt]);
-}
-
-
-
-
-
-/******************************************************************************/
-/* ScanSongConvertTempo class                                                 */
+/* BlockOperation()                                                           */
 /******************************************************************************/
-const uint8 ScanSongConvertTempo::bpmVals[9] =
+void ScanSongConvert::BlockOperation(MED_Block &blk)
 {
-	179, 164, 152, 141, 131, 123, 116, 110, 104
-};
-
-
-
-/******************************************************************************/
-/* CmdOperation()                                                             */
-/******************************************************************************/
-void ScanSongConvertTempo::CmdOperation(MED_Cmd &cmd)
-{
-	uint8 data;
-
-	if ((cmd.GetCmd() == 0x0f) && (data = cmd.GetDataB()) && (data <= 240))
-		cmd.SetData(data > 10 ? 99 : bpmVals[data - 1]);
+	// All the commands has been converted, so build the event list
+	blk.Compile();
 }
 
 
@@ -240,55 +272,29 @@ void ScanSongConvertTempo::CmdOperation(MED_Cmd &cmd)
 /******************************************************************************/
 /* SubSongOperation()                                                         */
 /******************************************************************************/
-void ScanSongConvertTempo::SubSongOperation(SubSong &ss)
+void ScanSongConvert::SubSongOperation(SubSong &ss)
 {
+	static int8 panVals[8] = { -16, 16, 16, -16, -16, 16, 16, -16 };
 	uint16 oldTempo;
+	uint32 cnt;
 
-	ss.SetTempoMode(true);		// BPM tempo
-	ss.SetTempoLPB(4);
-
-	oldTempo = ss.GetTempoBPM();
-	ss.SetTempoBPM(oldTempo >= 10 ? 99 : bpmVals[oldTempo - 1]);
-}
-
-
-
-
-
-/******************************************************************************/
-/* ScanConvertOldVolToNew class                                               */
-/******************************************************************************/
-
-/******************************************************************************/
-/* Constructor                                                                */
-/******************************************************************************/
-ScanConvertOldVolToNew::ScanConvertOldVolToNew(bool volHex)
-{
-	hex = volHex;
-}
+	hex = ss.GetVolHex();
 
+	if (convMixMode)
+	{
+		// For each subsong, set panning & stereo mode
+		ss.SetStereo(true);
 
+		for (cnt = 0; cnt < 8; cnt++)
+			ss.SetTrackPan(cnt, panVals[cnt]);
+	}
 
-/******************************************************************************/
-/* CmdOperation()                                                             */
-/******************************************************************************/
-void ScanConvertOldVolToNew::CmdOperation(MED_Cmd &cmd)
-{
-	if (cmd.GetCmd() == 0x0c)
+	if (convTempo)
 	{
-		uint8 data;
+		ss.SetTempoMode(true);		// BPM tempo
+		ss.SetTempoLPB(4);
 
-		if ((data = cmd.GetData2()) != 0)
-			cmd.SetData(data, 0);
-		else
-		{
-			if ((data = cmd.GetDataB()) != 0)
-			{
-				if (!hex)
-					data = min((data >> 4) * 10 + (data & 0x0f), 64);
-
-				cmd.SetData(data * 2 - 1, 0);
-			}
-		}
+		oldTempo = ss.GetTempoBPM();
+		ss.SetTempoBPM(oldTempo >= 10 ? 99 : bpmVals[oldTempo - 1]);
 	}
 }
@@ -49,6 +49,9 @@ class ScanBlock : public ScanTrack
 {
 public:
 	virtual void DoBlock(MED_Block &blk);
+
+protected:
+	virtual void BlockOperation(MED_Block &blk) {};
 };
 
 
@@ -79,51 +82,29 @@ public:
 
 
 /******************************************************************************/
-/* ScanSongConvertToMixMode class                                             */
+/* ScanSongConvert class                                                      */
 /******************************************************************************/
-class ScanSongConvertToMixMode : public ScanSong
+class ScanSongConvert : public ScanSong
 {
 public:
-	virtual void Do(Song &sg, bool isType0);
+	virtual void Do(Song &sg, bool mixMode, bool tempo, bool isType0);
 
 protected:
+	virtual void CmdOperation(MED_Cmd &cmd);
 	virtual void NoteOperation(MED_Note &note);
+	virtual void BlockOperation(MED_Block &blk);
 	virtual void SubSongOperation(SubSong &ss);
 
+	bool convMixMode;
+	bool convTempo;
+	bool hex;
+
 	bool transpInstr[MAX_INSTRS + 1];
 	int32 iTrans[MAX_INSTRS + 1];
 	bool isMidi[MAX_INSTRS + 1];
 	bool type0;
-};
-
-
-
-/******************************************************************************/
-/* ScanSongConvertTempo class                                                 */
-/******************************************************************************/
-class ScanSongConvertTempo : public ScanSong
-{
-protected:
-	virtual void CmdOperation(MED_Cmd &cmd);
-	virtual void SubSongOperation(SubSong &ss);
 
 	static const uint8 bpmVals[9];
 };
 
-
-
-/******************************************************************************/
-/* ScanConvertOldVolToNew class                                               */
-/******************************************************************************/
-class ScanConvertOldVolToNew : public ScanBlock
-{
-public:
-	ScanConvertOldVolToNew(bool volHex);
-
-protected:
-	virtual void CmdOperation(MED_Cmd &cmd);
-
-	bool hex;
-};
-
 #endif
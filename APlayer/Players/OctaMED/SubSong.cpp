@@ -360,6 +360,19 @@ void SubSong::SetSlide1st(bool slide)
 
 
 
+/******************************************************************************/
+/* SetVolHex()                                                                */
+/******************************************************************************/
+void SubSong::SetVolHex(bool volHex)
+{
+	if (volHex)
+		s_flags |= VOLHEX;
+	else
+		s_flags &= ~VOLHEX;
+}
+
+
+
 /******************************************************************************/
 /* SetGM()                                                                    */
 /******************************************************************************/
@@ -552,6 +565,16 @@ bool SubSong::GetSlide1st(void) const
 
 
 
+/******************************************************************************/
+/* GetVolHex()                                                                */
+/******************************************************************************/
+bool SubSong::GetVolHex(void) const
+{
+	return ((s_flags & VOLHEX) ? true : false);
+}
+
+
+
 /******************************************************************************/
 /* GetAmigaFilter()                                                           */
 /******************************************************************************/
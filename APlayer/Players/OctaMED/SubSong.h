@@ -78,6 +78,7 @@ public:
 
 	void SetStereo(bool stereo);
 	void SetSlide1st(bool slide);
+	void SetVolHex(bool volHex);
 	void SetGM(bool gmMode);
 	void SetFreePan(bool fp);
 	void SetAmigaFilter(bool amigaFilter);
@@ -102,6 +103,7 @@ public:
 	int32 GetTrackPan(TRACK_NUM trk) const;
 
 	bool GetSlide1st(void) const;
+	bool GetVolHex(void) const;
 	bool GetAmigaFilter(void) const;
 
 	PString GetSongName(void) const;
@@ -347,6 +347,12 @@ ap_result Oktalyzer::LoadModule(int32 index, PFile *file, PString &errorStr)
 		// Ok, we're done
 		retVal = AP_OK;
 	}
+	catch(PMemoryException e)
+	{
+		// Out of memory
+		errorStr.LoadString(res, IDS_OKT_ERR_MEMORY);
+		Cleanup();
+	}
 	catch(PUserException e)
 	{
 		// Just delete the exception and clean up
@@ -848,13 +854,7 @@ void Oktalyzer::ParseSLEN(uint32 chunkSize, PFile *file, PString &errorStr)
 	pattNum = file->Read_B_UINT16();
 
 	// Allocate memory to hold the patterns
-	patterns = new Pattern *[pattNum];
-	if (patterns == NULL)
-	{
-		errorStr.LoadString(res, IDS_OKT_ERR_MEMORY);
-		throw PUserException();
-	}
-
+	patterns = moduleArena.AllocateArray<Pattern *>(pattNum);
 	memset(patterns, 0, pattNum * sizeof(Pattern *));
 }
 
@@ -925,26 +925,13 @@ void Oktalyzer::ParsePBOD(uint32 chunkSize, PFile *file, PString &errorStr)
 	int32 i, j;
 
 	// Allocate pattern
-	patterns[readPatt] = new Pattern;
-	if (patterns[readPatt] == NULL)
-	{
-		errorStr.LoadString(res, IDS_OKT_ERR_MEMORY);
-		throw PUserException();
-	}
-
-	// Initialize pointers
-	patterns[readPatt]->lines = NULL;
+	patterns[readPatt] = moduleArena.AllocateArray<Pattern>(1);
 
 	// First read the number of pattern lines
 	patterns[readPatt]->lineNum = file->Read_B_UINT16();
 
 	// Allocate lines
-	patterns[readPatt]->lines = new PatternLine[patterns[readPatt]->lineNum * chanNum];
-	if (patterns[readPatt]->lines == NULL)
-	{
-		errorStr.LoadString(res, IDS_OKT_ERR_MEMORY);
-		throw PUserException();
-	}
+	patterns[readPatt]->lines = moduleArena.AllocateArray<PatternLine>(patterns[readPatt]->lineNum * chanNum);
 
 	// Read the pattern data
 	for (i = 0; i < patterns[readPatt]->lineNum; i++)
@@ -992,15 +979,19 @@ void Oktalyzer::ParseSBOD(uint32 chunkSize, PFile *file, PString &errorStr)
 		}
 	}
 
-	// Allocate memory to hold the sample data
-	allocLen = max(chunkSize, sampleInfo[readSamp].length);
-	sampleInfo[readSamp].sample = new int8[allocLen];
-	if (sampleInfo[readSamp].sample == NULL)
+	// The chunk size is taken from the file, so check it before allocating
+	// anything. The last sample may miss a few bytes, the rest is checked
+	// after reading
+	if (chunkSize > (file->GetLength() - file->GetPosition() + 20))
 	{
-		errorStr.LoadString(res, IDS_OKT_ERR_MEMORY);
+		errorStr.LoadString(res, IDS_OKT_ERR_LOADING_SAMPLES);
 		throw PUserException();
 	}
 
+	// Allocate memory to hold the sample data
+	allocLen = max(chunkSize, sampleInfo[readSamp].length);
+	sampleInfo[readSamp].sample = moduleArena.AllocateArray<int8>(allocLen);
+
 	// Clear the sample data, just in case the last sample isn't whole
 	memset(sampleInfo[readSamp].sample, 0, allocLen);
 
@@ -1024,30 +1015,13 @@ void Oktalyzer::ParseSBOD(uint32 chunkSize, PFile *file, PString &errorStr)
 /******************************************************************************/
 void Oktalyzer::Cleanup(void)
 {
-	uint32 i;
-
-	// Delete the patterns
-	if (patterns != NULL)
-	{
-		for (i = 0; i < pattNum; i++)
-		{
-			delete[] patterns[i]->lines;
-			delete patterns[i];
-		}
-
-		delete[] patterns;
-		patterns = NULL;
-	}
-
 	// Delete the sample informations
-	if (sampleInfo != NULL)
-	{
-		for (i = 0; i < sampNum; i++)
-			delete[] sampleInfo[i].sample;
+	delete[] sampleInfo;
+	sampleInfo = NULL;
 
-		delete[] sampleInfo;
-		sampleInfo = NULL;
-	}
+	// Delete the patterns and sample data
+	moduleArena.FreeAll();
+	patterns = NULL;
 }
 
 
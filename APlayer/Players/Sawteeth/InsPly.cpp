@@ -36,7 +36,7 @@ InsPly::InsPly(Sawteeth *s)
 		throw PMemoryException();
 	}
 
-	w = new Wave();
+	w = new Wave(s);
 	if (w == NULL)
 	{
 		delete pwm;
@@ -326,16 +326,18 @@ bool InsPly::Next(float *buffer, uint32 count)
 /******************************************************************************/
 void InsPly::SLP(float *b, uint32 count)
 {
-	float *stop = b + count;
-	float in;
+	float l = lo;
+	float co = cutOff;
+	float invCo = 1.0f - cutOff;
+	uint32 i;
 
-	while (b < stop)
+	for (i = 0; i < count; i++)
 	{
-		in = *b;
-		lo = (cutOff * in) + (lo * (1.0f - cutOff));
-		*b = lo;
-		b++;
+		l    = (co * b[i]) + (l * invCo);
+		b[i] = l;
 	}
+
+	lo = l;
 }
 
 
@@ -345,19 +347,28 @@ void InsPly::SLP(float *b, uint32 count)
 /******************************************************************************/
 void InsPly::OLP(float *b, uint32 count)
 {
-	float *stop = b + count;
-
-	while (b < stop)
+	float l = lo;
+	float h = hi;
+	float p = bp;
+	float co = cutOff;
+	float invCo = 1.0f - cutOff;
+	float r = res;
+	uint32 i;
+
+	for (i = 0; i < count; i++)
 	{
-		lo  = cutOff * *b + (1.0f - cutOff) * hi;
-		lo += (lo - bp) * res;
+		l  = co * b[i] + invCo * h;
+		l += (l - p) * r;
 
-		bp  = hi;
-		hi  = lo;
+		p  = h;
+		h  = l;
 
-		*b  = lo;
-		b++;
+		b[i] = l;
 	}
+
+	lo = l;
+	hi = h;
+	bp = p;
 }
 
 
@@ -367,31 +378,37 @@ void InsPly::OLP(float *b, uint32 count)
 /******************************************************************************/
 void InsPly::LP(float *b, uint32 count)
 {
-	float *stop = b + count;
-	float in;
+	float l = lo;
+	float h = hi;
+	float p = bp;
+	float co = cutOff;
+	float damp = 1.8f - res * 1.8f;
+	float lim = amp;
 	float t;
+	uint32 i;
 
-	while (b < stop)
+	// Each sample depends on the state of the previous one, so this
+	// loop can not be vectorized. Its speed is bound by the latency
+	// of the chain from p through h back to p. Reordering that chain
+	// changes the rounding, and the resonance amplifies the difference
+	for (i = 0; i < count; i++)
 	{
-		in  = *b;
-		t   = lo + cutOff * bp;
-		hi  = in - lo - (1.8f - res * 1.8f) * bp;
-		bp += cutOff * hi;
+		t  = l + co * p;
+		h  = b[i] - l - damp * p;
+		p += co * h;
 
-		if (t < -amp)
-			lo = -amp;
-		else
-		{
-			if (t > amp)
-				lo = amp;
-			else
-				lo = t;
-		}
+		// Clamp the low pass output to the amplitude. It is done in two
+		// steps, so the compiler can use min/max instead of branches
+		l = (t < -lim) ? -lim : t;
+		l = (l > lim) ? lim : l;
 
-		bs = lo + hi;
-		*b = lo;
-		b++;
+		b[i] = l;
 	}
+
+	lo = l;
+	hi = h;
+	bp = p;
+	bs = l + h;
 }
 
 
@@ -401,31 +418,31 @@ void InsPly::LP(float *b, uint32 count)
 /******************************************************************************/
 void InsPly::HP(float *b, uint32 count)
 {
-	float *stop = b + count;
-	float in;
+	float l = lo;
+	float h = hi;
+	float p = bp;
+	float co = cutOff;
+	float damp = 1.8f - res * 1.8f;
+	float lim = amp;
 	float t;
+	uint32 i;
 
-	while (b < stop)
+	for (i = 0; i < count; i++)
 	{
-		in  = *b;
-		t   = lo + cutOff * bp;
-		hi  = in - lo - (1.8f - res * 1.8f) * bp;
-		bp += cutOff * hi;
+		t  = l + co * p;
+		h  = b[i] - l - damp * p;
+		p += co * h;
 
-		if (t < -amp)
-			lo = -amp;
-		else
-		{
-			if (t > amp)
-				lo = amp;
-			else
-				lo = t;
-		}
+		l = (t < -lim) ? -lim : t;
+		l = (l > lim) ? lim : l;
 
-		bs = lo + hi;
-		*b = hi;
-		b++;
+		b[i] = h;
 	}
+
+	lo = l;
+	hi = h;
+	bp = p;
+	bs = l + h;
 }
 
 
@@ -435,31 +452,31 @@ void InsPly::HP(float *b, uint32 count)
 /******************************************************************************/
 void InsPly::BP(float *b, uint32 count)
 {
-	float *stop = b + count;
-	float in;
+	float l = lo;
+	float h = hi;
+	float p = bp;
+	float co = cutOff;
+	float damp = 1.8f - res * 1.8f;
+	float lim = amp;
 	float t;
+	uint32 i;
 
-	while (b < stop)
+	for (i = 0; i < count; i++)
 	{
-		in  = *b;
-		t   = lo + cutOff * bp;
-		hi  = in - lo - (1.8f - res * 1.8f) * bp;
-		bp += cutOff * hi;
+		t  = l + co * p;
+		h  = b[i] - l - damp * p;
+		p += co * h;
 
-		if (t < -amp)
-			lo = -amp;
-		else
-		{
-			if (t > amp)
-				lo = amp;
-			else
-				lo = t;
-		}
+		l = (t < -lim) ? -lim : t;
+		l = (l > lim) ? lim : l;
 
-		bs = lo + hi;
-		*b = bp;
-		b++;
+		b[i] = p;
 	}
+
+	lo = l;
+	hi = h;
+	bp = p;
+	bs = l + h;
 }
 
 
@@ -469,31 +486,31 @@ void InsPly::BP(float *b, uint32 count)
 /******************************************************************************/
 void InsPly::BS(float *b, uint32 count)
 {
-	float *stop = b + count;
-	float in;
+	float l = lo;
+	float h = hi;
+	float p = bp;
+	float co = cutOff;
+	float damp = 1.8f - res * 1.8f;
+	float lim = amp;
 	float t;
+	uint32 i;
 
-	while (b < stop)
+	for (i = 0; i < count; i++)
 	{
-		in  = *b;
-		t   = lo + cutOff * bp;
-		hi  = in - lo - (1.8f - res * 1.8f) * bp;
-		bp += cutOff * hi;
+		t  = l + co * p;
+		h  = b[i] - l - damp * p;
+		p += co * h;
 
-		if (t < -amp)
-			lo = -amp;
-		else
-		{
-			if (t > amp)
-				lo = amp;
-			else
-				lo = t;
-		}
+		l = (t < -lim) ? -lim : t;
+		l = (l > lim) ? lim : l;
 
-		bs = lo + hi;
-		*b = bs;
-		b++;
+		b[i] = l + h;
 	}
+
+	lo = l;
+	hi = h;
+	bp = p;
+	bs = l + h;
 }
 
 
@@ -503,39 +520,16 @@ void InsPly::BS(float *b, uint32 count)
 /******************************************************************************/
 void InsPly::VanillaClip(float *b, uint32 count, float mul)
 {
-	float *stop = b + count;
+	uint32 i;
+	float v;
 
 	if (fabsf(mul - 1.0f) < 0.1f)
-	{
-		while (b < stop)
-		{
-			if (*b > 1.0f)
-				*b = 1.0f;
-			else
-			{
-				if (*b < -1.0f)
-					*b = -1.0f;
-			}
+		mul = 1.0f;
 
-			b++;
-		}
-	}
-	else
+	for (i = 0; i < count; i++)
 	{
-		while (b < stop)
-		{
-			*b *= mul;
-
-			if (*b > 1.0f)
-				*b = 1.0f;
-			else
-			{
-				if (*b < -1.0f)
-					*b = -1.0f;
-			}
-
-			b++;
-		}
+		v    = b[i] * mul;
+		b[i] = (v > 1.0f) ? 1.0f : ((v < -1.0f) ? -1.0f : v);
 	}
 }
 
@@ -546,23 +540,17 @@ void InsPly::VanillaClip(float *b, uint32 count, float mul)
 /******************************************************************************/
 void InsPly::SinusClip(float *b, uint32 count, float mul)
 {
-	float *stop = b + count;
+	uint32 i;
 
 	if (fabsf(mul - 1.0f) < 0.1f)
 	{
-		while (b < stop)
-		{
-			*b = sinf(*b);
-			b++;
-		}
+		for (i = 0; i < count; i++)
+			b[i] = sinf(b[i]);
 	}
 	else
 	{
-		while (b < stop)
-		{
-			*b *= mul;
-			*b  = sinf(*b * mul);
-			b++;
-		}
+		// The sample is multiplied twice, like the original player does
+		for (i = 0; i < count; i++)
+			b[i] = sinf(b[i] * mul * mul);
 	}
 }
@@ -614,6 +614,9 @@ bool Sawteeth::InitPlayer(int32 index)
 	float framePerSec;
 	float total = 0.0f;
 
+	// Start the noise generator
+	jngSeed = 1;
+
 	// Create player objects
 	p = new Player *[channelCount];
 	if (p == NULL)
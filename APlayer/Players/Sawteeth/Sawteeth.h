@@ -202,6 +202,7 @@ public:
 protected:
 	friend class Player;
 	friend class InsPly;
+	friend class Wave;
 
 	PString ReadString(PFile *file);
 	uint8 Read8Bit(PFile *file);
@@ -248,6 +249,8 @@ protected:
 
 	bool looped;
 
+	int32 jngSeed;			// Noise generator seed, shared by all the waves
+
 	float *n2f;
 	float *r2f;
 	float cMul[CHN];
@@ -28,18 +28,36 @@ const float pwmLim = 0.9f;
 /******************************************************************************/
 /* Static variables                                                           */
 /******************************************************************************/
-bool Wave::sIsInit = false;
 float Wave::sint[513];
 float Wave::trit[513];
 
 
 
+/******************************************************************************/
+/* WaveInit class                                                             */
+/*                                                                            */
+/* A single object of this class is created when the add-on is loaded, so the */
+/* tables are ready before any of the player instances use them.              */
+/******************************************************************************/
+class WaveInit
+{
+public:
+	WaveInit(void)
+	{
+		Wave::SInit();
+	}
+};
+
+static WaveInit waveInit;
+
+
+
 /******************************************************************************/
 /* Constructor                                                                */
 /******************************************************************************/
-Wave::Wave(void)
+Wave::Wave(Sawteeth *s)
 {
-	SInit();
+	song     = s;
 
 	fromAmp  = 0.0f;
 	noiseVal = 0.0f;
@@ -204,9 +222,6 @@ void Wave::SInit(void)
 {
 	int32 c;
 
-	if (sIsInit)
-		return;
-
 	// Sine table
 	for (c = 0; c < 513; c++)
 		sint[c] = sinf((float)c * (2.0f * M_PI) / 512.0f);
@@ -228,8 +243,6 @@ void Wave::SInit(void)
 	}
 
 	trit[512] = trit[0];
-
-	sIsInit = true;
 }
 
 
@@ -241,24 +254,26 @@ void Wave::FillSaw(float *out, uint32 count, float amp)
 {
 	float *stop = out + count;
 	float _ampAdd = (amp - fromAmp) / (float)count;
+	float c = curr;
+	float st = step;
 
 	amp = fromAmp;
 
 	while (out < stop)
 	{
-		if (curr >= 1.0f)
+		if (c >= 1.0f)
 		{
-			float d = (curr - 1.0f) / step;
-			curr -= 2.0f;
+			float d = (c - 1.0f) / st;
+			c -= 2.0f;
 
 			*out = amp * (-2.0f * d + 1.0f);
 			out++;
-			amp  += _ampAdd;
-			curr += step;
+			amp += _ampAdd;
+			c   += st;
 		}
 
-		float walkDiff = 1.0f - curr;
-		int32 walkSteps = (int32)((walkDiff / step) + 1);
+		float walkDiff = 1.0f - c;
+		int32 walkSteps = (int32)((walkDiff / st) + 1);
 
 		// Number of samples left in the buffer
 		int32 steps = stop - out;
@@ -266,53 +281,16 @@ void Wave::FillSaw(float *out, uint32 count, float amp)
 		if (steps > walkSteps)
 			steps = walkSteps;
 
-		while (steps > 8)
-		{
-			out[0] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out[1] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out[2] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out[3] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out[4] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out[5] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out[6] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out[7] = amp * curr;
-			amp   += _ampAdd;
-			curr  += step;
-
-			out   += 8;
-			steps -= 8;
-		}
-
 		while (steps--)
 		{
-			*out = amp * curr;
+			*out = amp * c;
 			out++;
-			amp  += _ampAdd;
-			curr += step;
+			amp += _ampAdd;
+			c   += st;
 		}
 	}
 
+	curr    = c;
 	fromAmp = amp;
 }
 
@@ -325,36 +303,38 @@ void Wave::FillSquare(float *out, uint32 count, float amp)
 {
 	float *stop = out + count;
 	float _ampAdd = (amp - fromAmp) / (float)count;
+	float c = curr;
+	float st = step;
 
 	amp = fromAmp;
 
 	while (out < stop)
 	{
-		if (curr >= 1.0f)
+		if (c >= 1.0f)
 		{
-			float d = (curr - 1.0f) / step;
+			float d = (c - 1.0f) / st;
 
-			curr -= 1.0f;
+			c -= 1.0f;
 			if (_pwmLo)
 			{
-				*out  = amp * d + ((1.0f - d) * -amp);
-				curr -= pwm;
+				*out = amp * d + ((1.0f - d) * -amp);
+				c   -= pwm;
 			}
 			else
 			{
-				*out  = -amp * d + ((1.0f - d) * amp);
-				curr += pwm;
+				*out = -amp * d + ((1.0f - d) * amp);
+				c   += pwm;
 			}
 
 			_pwmLo = !_pwmLo;
 			out++;
 
-			amp  += _ampAdd;
-			curr += step;
+			amp += _ampAdd;
+			c   += st;
 		}
 
-		float walkDiff = 1.0f - curr;
-		int32 walkSteps = (int32)((walkDiff / step) + 1);
+		float walkDiff = 1.0f - c;
+		int32 walkSteps = (int32)((walkDiff / st) + 1);
 
 		// Number of samples left in the buffer
 		int32 steps = stop - out;
@@ -385,10 +365,11 @@ void Wave::FillSquare(float *out, uint32 count, float amp)
 			out++;
 		}
 
-		amp  += steps * _ampAdd;
-		curr += steps * step;
+		amp += steps * _ampAdd;
+		c   += steps * st;
 	}
 
+	curr    = c;
 	fromAmp = amp;
 }
 
@@ -401,21 +382,24 @@ void Wave::FillTri(float *out, uint32 count, float amp)
 {
 	float *stop = out + count;
 	float aStep = (amp - fromAmp) / (float)count;
+	float val = currVal;
+	float st = step;
 
 	amp = fromAmp;
 
 	while (out < stop)
 	{
-		*out = amp * (2.0f * ((currVal > 0.0f) ? -currVal : currVal) + 1.0f);
-		currVal += step;
+		*out = amp * (2.0f * ((val > 0.0f) ? -val : val) + 1.0f);
+		val += st;
 
-		if (currVal > 1.0f)
-			currVal -= 2.0f;
+		if (val > 1.0f)
+			val -= 2.0f;
 
 		out++;
 		amp += aStep;
 	}
 
+	currVal = val;
 	fromAmp = amp;
 }
 
@@ -428,19 +412,22 @@ void Wave::FillNoise(float *out, uint32 count, float amp)
 {
 	float *stop = out + count;
 	float _ampAdd = (amp - fromAmp) / (float)count;
+	float c = curr;
+	float st = step;
+	float val = noiseVal;
 
 	amp = fromAmp;
 
 	while (out < stop)
 	{
-		if (curr >= 1.0f)
+		if (c >= 1.0f)
 		{
-			curr -= 2.0f;
-			noiseVal = amp * ((jngRand() / (64.0f * 256.0f * 256.0f * 256.0f)) - 1.0f);
+			c  -= 2.0f;
+			val = amp * ((jngRand() / (64.0f * 256.0f * 256.0f * 256.0f)) - 1.0f);
 		}
 
-		float walkDiff = 1.0f - curr;
-		int32 walkSteps = (int32)((walkDiff / step) + 1);
+		float walkDiff = 1.0f - c;
+		int32 walkSteps = (int32)((walkDiff / st) + 1);
 
 		// Number of samples left in the buffer
 		int32 steps = stop - out;
@@ -452,18 +439,20 @@ void Wave::FillNoise(float *out, uint32 count, float amp)
 
 		while (counter--)
 		{
-			*out = noiseVal;
+			*out = val;
 			out++;
 		}
 
-		curr += steps * step;
-		amp  += steps * _ampAdd;
+		c   += steps * st;
+		amp += steps * _ampAdd;
 	}
 
-	fromAmp = amp;
+	if (c >= 1.0f)
+		c -= 2.0f;
 
-	if (curr >= 1.0f)
-		curr -= 2.0f;
+	curr     = c;
+	noiseVal = val;
+	fromAmp  = amp;
 }
 
 
@@ -557,7 +546,7 @@ void Wave::FillSinU(float *out, uint32 count, float amp)
 
 uint32 Wave::jngRand(void)
 {
-	static int32 jngSeed = 1;
+	int32 &jngSeed = song->jngSeed;
 
 	jngSeed = 16807 * (jngSeed % W) - (jngSeed / W) * C;
 	if (jngSeed < 0)
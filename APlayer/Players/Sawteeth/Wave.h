@@ -43,7 +43,7 @@ enum
 class Wave
 {
 public:
-	Wave(void);
+	Wave(Sawteeth *s);
 	virtual ~Wave(void);
 
 	void SetFreq(float freq);
@@ -56,7 +56,8 @@ public:
 	bool Next(float *buffer, uint32 count);
 
 protected:
-	void SInit(void);
+	friend class WaveInit;
+	static void SInit(void);
 
 	void FillSaw(float *out, uint32 count, float amp);
 	void FillSquare(float *out, uint32 count, float amp);
@@ -68,6 +69,8 @@ protected:
 
 	uint32 jngRand(void);
 
+	Sawteeth *song;
+
 	uint8 form;
 
 	bool _pwmLo;
@@ -86,7 +89,6 @@ protected:
 	uint32 sinCurrVal;
 	uint32 sinStep;
 
-	static bool sIsInit;
 	static float sint[513];
 	static float trit[513];
 };
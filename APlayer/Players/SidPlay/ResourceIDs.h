@@ -37,6 +37,7 @@
 #define IDS_SID_CFG_FILTER							901
 #define IDS_SID_CFG_8580WAVEFORMS					902
 #define IDS_SID_CFG_FORCESPEED						903
+#define IDS_SID_CFG_CYCLEEXACT						904
 
 #define IDS_SID_CFG_MEMORYMODE						910
 #define IDS_SID_CFG_FULL							911
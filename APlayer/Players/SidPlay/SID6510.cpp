@@ -32,6 +32,13 @@
 
 
 
+/******************************************************************************/
+/* Reads a 16-bit little endian operand at the pointer given.                 */
+/******************************************************************************/
+#define ABSO(ptr) P_LENDIAN_TO_HOST_INT16(*((uint16 *)(ptr)))
+
+
+
 /******************************************************************************/
 /* Constructor                                                                */
 /******************************************************************************/
@@ -598,6 +605,10 @@ void SID6510::InitInterpreter(int32 inMemoryMode)
 /******************************************************************************/
 bool SID6510::Interpreter(uint16 p, uint8 ramRom, uint8 a, uint8 x, uint8 y)
 {
+	uint8 *pc;
+	uint8 ac, xr, yr;
+	uint8 opcode;
+
 	if (memoryMode == MPU_PLAYSID_ENVIRONMENT)
 	{
 		AC = a;
@@ -623,11 +634,114 @@ bool SID6510::Interpreter(uint16 p, uint8 ramRom, uint8 a, uint8 x, uint8 y)
 	sidKeysOff[4] = (sidKeysOff[4 + 7] = (sidKeysOff[4 + 14] = false));
 	sidKeysOn[4]  = (sidKeysOn[4 + 7] = (sidKeysOn[4 + 14] = false));
 
+	// The most used opcodes are run directly in the loop on local
+	// copies of the hot registers, so they can stay in CPU registers
+	// across the memory calls. The memory functions do not use the
+	// 6510 registers. All other opcodes are called through instrList
+	// with the registers stored back in the object first
+	pc = pPC;
+	ac = AC;
+	xr = XR;
+	yr = YR;
+
 	do
 	{
-		(*instrList[*(pPC++)])(this);
+		switch (opcode = *(pc++))
+		{
+			// Loads
+			case 0xA9: AffectNZ(ac = *pc++); break;
+			case 0xA5: AffectNZ(ac = ReadData_zp(*pc++)); break;
+			case 0xB5: AffectNZ(ac = ReadData_zp((uint8)(*pc++ + xr))); break;
+			case 0xAD: AffectNZ(ac = readData(this, ABSO(pc))); pc += 2; break;
+			case 0xBD: AffectNZ(ac = readData(this, ABSO(pc) + xr)); pc += 2; break;
+			case 0xB9: AffectNZ(ac = readData(this, ABSO(pc) + yr)); pc += 2; break;
+			case 0xB1: AffectNZ(ac = readData(this, yr + ABSO(&c64Mem1[*pc++]))); break;
+			case 0xA2: AffectNZ(xr = *pc++); break;
+			case 0xA6: AffectNZ(xr = ReadData_zp(*pc++)); break;
+			case 0xAE: AffectNZ(xr = readData(this, ABSO(pc))); pc += 2; break;
+			case 0xBE: AffectNZ(xr = readData(this, ABSO(pc) + yr)); pc += 2; break;
+			case 0xA0: AffectNZ(yr = *pc++); break;
+			case 0xA4: AffectNZ(yr = ReadData_zp(*pc++)); break;
+			case 0xAC: AffectNZ(yr = readData(this, ABSO(pc))); pc += 2; break;
+			case 0xBC: AffectNZ(yr = readData(this, ABSO(pc) + xr)); pc += 2; break;
+
+			// Stores
+			case 0x85: WriteData_zp(*pc++, ac); break;
+			case 0x95: WriteData_zp((uint8)(*pc++ + xr), ac); break;
+			case 0x8D: writeData(this, ABSO(pc), ac); pc += 2; break;
+			case 0x9D: writeData(this, ABSO(pc) + xr, ac); pc += 2; break;
+			case 0x99: writeData(this, ABSO(pc) + yr, ac); pc += 2; break;
+			case 0x91: writeData(this, yr + ABSO(&c64Mem1[*pc++]), ac); break;
+			case 0x86: WriteData_zp(*pc++, xr); break;
+			case 0x8E: writeData(this, ABSO(pc), xr); pc += 2; break;
+			case 0x84: WriteData_zp(*pc++, yr); break;
+			case 0x8C: writeData(this, ABSO(pc), yr); pc += 2; break;
+
+			// Transfers, increments and decrements
+			case 0xAA: AffectNZ(xr = ac); break;
+			case 0xA8: AffectNZ(yr = ac); break;
+			case 0x8A: AffectNZ(ac = xr); break;
+			case 0x98: AffectNZ(ac = yr); break;
+			case 0xE8: AffectNZ(++xr); break;
+			case 0xC8: AffectNZ(++yr); break;
+			case 0xCA: AffectNZ(--xr); break;
+			case 0x88: AffectNZ(--yr); break;
+			case 0xE6: INC_m_zp(*pc++); break;
+			case 0xC6: DEC_m_zp(*pc++); break;
+
+			// Arithmetic and logic
+			case 0x18: CF = 0; break;
+			case 0x38: CF = 1; break;
+			case 0x69: ac = Add(ac, *pc++); break;
+			case 0x65: ac = Add(ac, ReadData_zp(*pc++)); break;
+			case 0x6D: ac = Add(ac, readData(this, ABSO(pc))); pc += 2; break;
+			case 0x7D: ac = Add(ac, readData(this, ABSO(pc) + xr)); pc += 2; break;
+			case 0x79: ac = Add(ac, readData(this, ABSO(pc) + yr)); pc += 2; break;
+			case 0xE9: ac = Add(ac, (~*pc++) & 255); break;
+			case 0x29: AffectNZ(ac &= *pc++); break;
+			case 0x09: AffectNZ(ac |= *pc++); break;
+			case 0x49: AffectNZ(ac ^= *pc++); break;
+			case 0xC9: Compare(ac, *pc++); break;
+			case 0xC5: Compare(ac, ReadData_zp(*pc++)); break;
+			case 0xDD: Compare(ac, readData(this, ABSO(pc) + xr)); pc += 2; break;
+			case 0xE0: Compare(xr, *pc++); break;
+			case 0xC0: Compare(yr, *pc++); break;
+			case 0x0A: ac = ASL_m(ac); break;
+			case 0x4A: ac = LSR_m(ac); break;
+			case 0x2A: ac = ROL_m(ac); break;
+			case 0x6A: ac = ROR_m(ac); break;
+
+			// Branches
+			case 0x10: if (NF == 0) pc = Branch(pc); pc++; break;
+			case 0x30: if (NF != 0) pc = Branch(pc); pc++; break;
+			case 0x90: if (CF == 0) pc = Branch(pc); pc++; break;
+			case 0xB0: if (CF != 0) pc = Branch(pc); pc++; break;
+			case 0xD0: if (ZF == 0) pc = Branch(pc); pc++; break;
+			case 0xF0: if (ZF != 0) pc = Branch(pc); pc++; break;
+
+			default:
+			{
+				pPC = pc;
+				AC  = ac;
+				XR  = xr;
+				YR  = yr;
+
+				(*instrList[opcode])(this);
+
+				pc = pPC;
+				ac = AC;
+				xr = XR;
+				yr = YR;
+				break;
+			}
+		}
 	}
-	while (stackIsOkay && (pPC < pPCEnd));
+	while (stackIsOkay && (pc < pPCEnd));
+
+	pPC = pc;
+	AC  = ac;
+	XR  = xr;
+	YR  = yr;
 
 	return (true);
 }
@@ -777,6 +891,18 @@ inline void SID6510::AffectNZ(uint8 reg)
 
 
 
+/******************************************************************************/
+/* Compare()                                                                  */
+/******************************************************************************/
+inline void SID6510::Compare(uint8 reg, uint8 x)
+{
+	ZF = (reg == x);
+	CF = (reg >= x);
+	NF = ((int8)(reg - x) < 0);
+}
+
+
+
 /******************************************************************************/
 /* ResetSP()                                                                  */
 /******************************************************************************/
@@ -1141,14 +1267,19 @@ inline uint8 SID6510::ZPY(void)
 /******************************************************************************/
 /* Handling conditional branches.                                             */
 /******************************************************************************/
+inline uint8 *SID6510::Branch(uint8 *pc)
+{
+	PC  = pc - pPCBase;		// Calculate 16-bit PC
+	PC += (int8)*pc;		// Add offset, keep it 16-bit (uint16)
+	return (pPCBase + PC);	// Calc new pointer-PC
+}
+
+
+
 inline void SID6510::BranchIfClear(uint8 flag)
 {
 	if (flag == 0)
-	{
-		PC  = pPC - pPCBase;	// Calculate 16-bit PC
-		PC += (int8)*pPC;		// Add offset, keep it 16-bit (uint16)
-		pPC = pPCBase + PC;		// Calc new pointer-PC
-	}
+		pPC = Branch(pPC);
 
 	pPC++;
 }
@@ -1158,11 +1289,7 @@ inline void SID6510::BranchIfClear(uint8 flag)
 inline void SID6510::BranchIfSet(uint8 flag)
 {
 	if (flag != 0)
-	{
-		PC  = pPC - pPCBase;	// Calculate 16-bit PC
-		PC += (int8)*pPC;		// Add offset, keep it 16-bit (uint16)
-		pPC = pPCBase + PC;		// Calc new pointer-PC
-	}
+		pPC = Branch(pPC);
 
 	pPC++;
 }
@@ -1170,38 +1297,50 @@ inline void SID6510::BranchIfSet(uint8 flag)
 
 
 /******************************************************************************/
-/* ADC()                                                                      */
+/* Add() adds the value given with carry to the register value given and      */
+/*      returns the result. It is used by both ADC and SBC.                   */
 /******************************************************************************/
-inline void SID6510::ADC_m(uint8 x)
+inline uint8 SID6510::Add(uint8 reg, uint8 x)
 {
 	if (DF == 1)
 	{
-		uint16 AC2 = AC + x + CF;
+		uint16 AC2 = reg + x + CF;
 		ZF = (AC2 == 0);
 
-		if (((AC & 15) + (x & 15) + CF) > 9)
+		if (((reg & 15) + (x & 15) + CF) > 9)
 			AC2 += 6;
 
-		VF = (((AC ^ x ^ AC2) & 0x80) != 0) ^ CF;
+		VF = (((reg ^ x ^ AC2) & 0x80) != 0) ^ CF;
 		NF = ((AC2 & 128) != 0);
 
 		if (AC2 > 0x99)
 			AC2 += 96;
 
 		CF = (AC2 > 0x99);
-		AC = (AC2 & 255);
+		return (AC2 & 255);
 	}
 	else
 	{
-		uint16 AC2 = AC + x + CF;
+		uint16 AC2 = reg + x + CF;
 		CF = (AC2 > 255);
-		VF = (((AC ^ x ^ AC2) & 0x80) != 0) ^ CF;
-		AffectNZ(AC = (AC2 & 255));
+		VF = (((reg ^ x ^ AC2) & 0x80) != 0) ^ CF;
+		AffectNZ(AC2 & 255);
+		return (AC2 & 255);
 	}
 }
 
 
 
+/******************************************************************************/
+/* ADC()                                                                      */
+/******************************************************************************/
+inline void SID6510::ADC_m(uint8 x)
+{
+	AC = Add(AC, x);
+}
+
+
+
 void SID6510::ADC_abso(SID6510 *cpu)
 {
 	cpu->ADC_m(cpu->readData(cpu, cpu->Abso()));
@@ -1559,9 +1698,7 @@ void SID6510::CLV_(SID6510 *cpu)
 /******************************************************************************/
 inline void SID6510::CMP_m(uint8 x)
 {
-	ZF = (AC == x);
-	CF = (AC >= x);
-	NF = ((int8)(AC - x) < 0);
+	Compare(AC, x);
 }
 
 
@@ -1635,9 +1772,7 @@ void SID6510::CMP_zpx(SID6510 *cpu)
 /******************************************************************************/
 inline void SID6510::CPX_m(uint8 x)
 {
-	ZF = (XR == x);
-	CF = (XR >= x);
-	NF = ((int8)(XR - x) < 0);
+	Compare(XR, x);
 }
 
 
@@ -1671,9 +1806,7 @@ void SID6510::CPX_zp(SID6510 *cpu)
 /******************************************************************************/
 inline void SID6510::CPY_m(uint8 x)
 {
-	ZF = (YR == x);
-	CF = (YR >= x);
-	NF = ((int8)(YR - x) < 0);
+	Compare(YR, x);
 }
 
 
@@ -2521,31 +2654,7 @@ inline void SID6510::RTS_(SID6510 *cpu)
 /******************************************************************************/
 inline void SID6510::SBC_m(uint8 s)
 {
-	s = (~s) & 255;
-	if (DF == 1)
-	{
-		uint16 AC2 = AC + s + CF;
-		ZF = (AC2 == 0);
-
-		if (((AC & 15) + (s & 15) + CF) > 9)
-			AC2 += 6;
-
-		VF = (((AC ^ s ^ AC2) & 0x80) != 0) ^ CF;
-		NF = ((AC2 & 128) != 0);
-
-		if (AC2 > 0x99)
-			AC2 += 96;
-
-		CF = (AC2 > 0x99);
-		AC = (AC2 & 255);
-	}
-	else
-	{
-		uint16 AC2 = AC + s + CF;
-		CF = (AC2 > 255);
-		VF = (((AC ^ s ^ AC2) & 0x80) != 0) ^ CF;
-		AffectNZ(AC = (AC2 & 255));
-	}
+	AC = Add(AC, (~s) & 255);
 }
 
 
@@ -74,6 +74,7 @@ protected:
 	inline uint8 CodeSR(void);
 	inline void DecodeSR(uint8 stackByte);
 	inline void AffectNZ(uint8 reg);
+	inline void Compare(uint8 reg, uint8 x);
 
 	inline void ResetSP(void);
 	inline void CheckSP(void);
@@ -97,9 +98,11 @@ protected:
 	inline uint8 ZPX(void);
 	inline uint8 ZPY(void);
 
+	inline uint8 *Branch(uint8 *pc);
 	inline void BranchIfClear(uint8 flag);
 	inline void BranchIfSet(uint8 flag);
 
+	inline uint8 Add(uint8 reg, uint8 x);
 	inline void ADC_m(uint8 x);
 	static void ADC_abso(SID6510 *cpu);
 	static void ADC_absx(SID6510 *cpu);
@@ -20,6 +20,7 @@
 #include "SIDEnvelope.h"
 #include "SID6510.h"
 #include "SID6581.h"
+#include "SIDCycle.h"
 #include "SIDWave6581.h"
 #include "SIDWave8580.h"
 
@@ -39,6 +40,7 @@ SID6581::SID6581(SID6510 *cpu) : optr1(this, cpu), optr2(this, cpu), optr3(this,
 {
 	// Initialize member variables
 	ampMod1x8         = NULL;
+	cycleSid          = NULL;
 
 	c64_clockSpeed    = 985248;
 	c64_fClockSpeed   = 985248.4f;
@@ -98,6 +100,7 @@ SID6581::SID6581(SID6510 *cpu) : optr1(this, cpu), optr2(this, cpu), optr3(this,
 /******************************************************************************/
 SID6581::~SID6581(void)
 {
+	delete cycleSid;
 }
 
 
@@ -231,7 +234,7 @@ void SID6581::EmuConfigureClock(int32 clockSpeed)
 /******************************************************************************/
 /* EmuConfigure()                                                             */
 /******************************************************************************/
-void SID6581::EmuConfigure(uint32 pcmFrequency, bool measuredEnveValues, bool isNewSID, bool emulateFilter, int32 clockSpeed)
+void SID6581::EmuConfigure(uint32 pcmFrequency, bool measuredEnveValues, bool isNewSID, bool emulateFilter, bool cycleExact, int32 clockSpeed)
 {
 	pcmFreq = pcmFrequency;
 	EmuConfigureClock(clockSpeed);
@@ -240,6 +243,25 @@ void SID6581::EmuConfigure(uint32 pcmFrequency, bool measuredEnveValues, bool is
 	InitWaveformTables(isNewSID);
 
 	envelope.EnveEmuInit(pcmFreq, measuredEnveValues);
+
+	// Create the cycle exact SID if wanted. If there is not enough memory
+	// for it, fall back to the normal emulation
+	if (cycleExact)
+	{
+		if (cycleSid == NULL)
+			cycleSid = new SIDCycle(this);
+
+		if ((cycleSid != NULL) && !cycleSid->Configure(isNewSID, emulateFilter))
+		{
+			delete cycleSid;
+			cycleSid = NULL;
+		}
+	}
+	else
+	{
+		delete cycleSid;
+		cycleSid = NULL;
+	}
 }
 
 
@@ -275,6 +297,9 @@ bool SID6581::EmuReset(void)
 
 	samples.SampleEmuReset();
 
+	if (cycleSid != NULL)
+		cycleSid->Reset();
+
 	filterType  = (filterCurType = 0);
 	filterValue = 0;
 	filterDy    = (filterResDy = 0);
@@ -417,8 +442,16 @@ void SID6581::EmuFillBuffer(SIDEmuEngine &thisEmu, SIDTune &thisTune, void *buff
 
 			if (toFill == 0)
 			{
-				sid6510->optr3ReadWave = optr3.output;
-				sid6510->optr3ReadEnve = optr3.enveVol;
+				if (cycleSid != NULL)
+				{
+					sid6510->optr3ReadWave = cycleSid->ReadOsc3();
+					sid6510->optr3ReadEnve = cycleSid->ReadEnv3();
+				}
+				else
+				{
+					sid6510->optr3ReadWave = optr3.output;
+					sid6510->optr3ReadEnve = optr3.enveVol;
+				}
 
 				uint16 replayPC = thisTune.GetPlayAddr();
 
@@ -483,6 +516,9 @@ void SID6581::EmuFillBuffer(SIDEmuEngine &thisEmu, SIDTune &thisTune, void *buff
 				optr2.SidEmuSet2();
 				optr3.SidEmuSet2();
 
+				if (cycleSid != NULL)
+					cycleSid->WriteRegisters(sid6510->c64Mem2 + 0xd400, sid6510->sidKeysOn, sid6510->sidKeysOff);
+
 				samples.SampleEmuCheckForInit();
 
 				valuesAdd.w[HI] = 0;
@@ -21,6 +21,7 @@
 #include "SIDOperator.h"
 #include "SIDEnvelope.h"
 #include "SID6510.h"
+#include "SIDCycle.h"
 
 
 /******************************************************************************/
@@ -37,7 +38,7 @@ public:
 	void EmuResetAutoPanning(int32 autoPanning);
 	void EmuSetVoiceVolume(int32 voice, uint16 leftLevel, uint16 rightLevel, uint16 total);
 	void EmuConfigureClock(int32 clockSpeed);
-	void EmuConfigure(uint32 pcmFrequency, bool measuredEnveValues, bool isNewSID, bool emulateFilter, int32 clockSpeed);
+	void EmuConfigure(uint32 pcmFrequency, bool measuredEnveValues, bool isNewSID, bool emulateFilter, bool cycleExact, int32 clockSpeed);
 	bool EmuReset(void);
 	void EmuSetReplayingSpeed(int32 clockMode, uint16 callsPerSec);
 	void EmuFillBuffer(SIDEmuEngine &thisEmu, SIDTune &thisTune, void *buffer, uint32 bufferLen);
@@ -67,6 +68,8 @@ public:
 	SIDEnvelope envelope;
 	SIDSamples samples;
 
+	SIDCycle *cycleSid;			// Only used when cycle exact emulation is enabled
+
 	bool doAutoPanning;
 	bool updateAutoPanning;
 
@@ -0,0 +1,1048 @@
+/******************************************************************************/
+/* SIDCycle implementation file.                                              */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+// PolyKit headers
+#include "POS.h"
+
+// Player headers
+#include "SID6581.h"
+#include "SIDCycle.h"
+
+// SSE headers
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+
+/******************************************************************************/
+/* Envelope states                                                            */
+/******************************************************************************/
+enum
+{
+	CYCLE_ATTACK,
+	CYCLE_DECAY_SUSTAIN,
+	CYCLE_RELEASE
+};
+
+
+
+/******************************************************************************/
+/* Constants                                                                  */
+/******************************************************************************/
+#define ANTI_DENORMAL			1.0e-18f
+
+// Number of cycles between each envelope step for every rate
+static const uint16 ratePeriods[16] =
+{
+	9, 32, 63, 95, 149, 220, 267, 313, 392, 977, 1954, 3126, 3907, 11720, 19532, 31251
+};
+
+static const uint8 sustainLevels[16] =
+{
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+
+
+
+/******************************************************************************/
+/* Filter cut-off frequencies in Hz for some of the register values. The      */
+/* values between are interpolated.                                           */
+/*                                                                            */
+/* Measured curves taken from reSID.                                          */
+/* Copyright (C) 2004  Dag Lem <resid@nimrod.no>                              */
+/******************************************************************************/
+static const int32 cutOff6581[][2] =
+{
+	{    0,   220 }, {  128,   230 }, {  256,   250 }, {  384,   300 },
+	{  512,   420 }, {  640,   780 }, {  768,  1600 }, {  832,  2300 },
+	{  896,  3200 }, {  960,  4300 }, {  992,  5000 }, { 1008,  5400 },
+	{ 1016,  5700 }, { 1023,  6000 }, { 1024,  4600 }, { 1032,  4800 },
+	{ 1056,  5300 }, { 1088,  6000 }, { 1120,  6600 }, { 1152,  7200 },
+	{ 1280,  9500 }, { 1408, 12000 }, { 1536, 14500 }, { 1664, 16000 },
+	{ 1792, 17100 }, { 1920, 17700 }, { 2047, 18000 }
+};
+
+static const int32 cutOff8580[][2] =
+{
+	{    0,     0 }, {  128,   800 }, {  256,  1600 }, {  384,  2500 },
+	{  512,  3300 }, {  640,  4100 }, {  768,  4800 }, {  896,  5600 },
+	{ 1024,  6500 }, { 1152,  7500 }, { 1280,  8400 }, { 1408,  9200 },
+	{ 1536,  9800 }, { 1664, 10500 }, { 1792, 11000 }, { 1920, 11700 },
+	{ 2047, 12500 }
+};
+
+
+
+/******************************************************************************/
+/* Bessel() calculates the zeroth order modified Bessel function, which is    */
+/*      needed by the Kaiser window.                                          */
+/*                                                                            */
+/* Input:  "x" is the value to calculate it for.                              */
+/*                                                                            */
+/* Output: The result.                                                        */
+/******************************************************************************/
+static double Bessel(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	double half = x / 2.0;
+	double temp;
+	int32 n = 1;
+
+	do
+	{
+		temp  = half / n++;
+		term *= temp * temp;
+		sum  += term;
+	}
+	while (term >= 1.0e-21 * sum);
+
+	return (sum);
+}
+
+
+
+
+
+/******************************************************************************/
+/* SIDCycleVoice class                                                        */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+SIDCycleVoice::SIDCycleVoice(void)
+{
+	// Initialize member variables
+	source = NULL;
+
+	Reset();
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+SIDCycleVoice::~SIDCycleVoice(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* Reset() will set the voice to the power on state.                          */
+/******************************************************************************/
+void SIDCycleVoice::Reset(void)
+{
+	accumulator   = 0;
+	shiftRegister = 0x7ffff8;
+	freq          = 0;
+	pulseWidth    = 0;
+	waveform      = 0;
+	test          = false;
+	ring          = false;
+	sync          = false;
+	msbRising     = false;
+	waveOutput    = 0;
+
+	state              = CYCLE_RELEASE;
+	gate               = false;
+	holdZero           = true;
+	envelopeCounter    = 0;
+	rateCounter        = 0;
+	exponentialCounter = 0;
+	exponentialPeriod  = 1;
+	attack             = 0;
+	decay              = 0;
+	sustain            = 0;
+	release            = 0;
+	ratePeriod         = ratePeriods[release];
+
+	filtered = false;
+	lowPass  = 0.0f;
+	bandPass = 0.0f;
+}
+
+
+
+/******************************************************************************/
+/* WriteControl() is called when the control register is written.             */
+/*                                                                            */
+/* Input:  "control" is the new register value.                               */
+/******************************************************************************/
+void SIDCycleVoice::WriteControl(uint8 control)
+{
+	bool gateNext = ((control & 0x01) != 0);
+
+	waveform = control >> 4;
+	sync     = ((control & 0x02) != 0);
+	ring     = ((control & 0x04) != 0);
+	test     = ((control & 0x08) != 0);
+
+	// The test bit resets the oscillator and the noise and holds them
+	if (test)
+	{
+		accumulator   = 0;
+		shiftRegister = 0x7ffff8;
+	}
+
+	// Start the attack or the release when the gate changes
+	if (!gate && gateNext)
+	{
+		state      = CYCLE_ATTACK;
+		ratePeriod = ratePeriods[attack];
+		holdZero   = false;
+	}
+	else if (gate && !gateNext)
+	{
+		state      = CYCLE_RELEASE;
+		ratePeriod = ratePeriods[release];
+	}
+
+	gate = gateNext;
+}
+
+
+
+/******************************************************************************/
+/* WriteAttackDecay() is called when the attack/decay register is written.    */
+/*                                                                            */
+/* Input:  "attackDecay" is the new register value.                           */
+/******************************************************************************/
+void SIDCycleVoice::WriteAttackDecay(uint8 attackDecay)
+{
+	attack = attackDecay >> 4;
+	decay  = attackDecay & 0x0f;
+
+	if (state == CYCLE_ATTACK)
+		ratePeriod = ratePeriods[attack];
+	else if (state == CYCLE_DECAY_SUSTAIN)
+		ratePeriod = ratePeriods[decay];
+}
+
+
+
+/******************************************************************************/
+/* WriteSustainRelease() is called when the sustain/release register is       */
+/*      written.                                                              */
+/*                                                                            */
+/* Input:  "sustainRelease" is the new register value.                        */
+/******************************************************************************/
+void SIDCycleVoice::WriteSustainRelease(uint8 sustainRelease)
+{
+	sustain = sustainRelease >> 4;
+	release = sustainRelease & 0x0f;
+
+	if (state == CYCLE_RELEASE)
+		ratePeriod = ratePeriods[release];
+}
+
+
+
+/******************************************************************************/
+/* ClockOscillator() will advance the oscillator one cycle.                   */
+/******************************************************************************/
+inline void SIDCycleVoice::ClockOscillator(void)
+{
+	uint32 previous;
+
+	if (test)
+	{
+		msbRising = false;
+		return;
+	}
+
+	previous    = accumulator;
+	accumulator = (accumulator + freq) & 0xffffff;
+	msbRising   = ((~previous & accumulator & 0x800000) != 0);
+
+	// The noise is clocked every time bit 19 goes high
+	if ((~previous & accumulator & 0x080000) != 0)
+		shiftRegister = ((shiftRegister << 1) & 0x7fffff) | (((shiftRegister >> 22) ^ (shiftRegister >> 17)) & 1);
+}
+
+
+
+/******************************************************************************/
+/* Synchronize() will reset the oscillator if hard sync is enabled and the    */
+/*      oscillator of the source voice has just wrapped around. It has to be  */
+/*      called after all the oscillators have been clocked.                   */
+/******************************************************************************/
+inline void SIDCycleVoice::Synchronize(void)
+{
+	if (sync && source->msbRising)
+		accumulator = 0;
+}
+
+
+
+/******************************************************************************/
+/* Output() calculates the current output of the voice.                       */
+/*                                                                            */
+/* Input:  "combined" is a pointer to the combined waveform tables.           */
+/*                                                                            */
+/* Output: The waveform multiplied with the envelope.                         */
+/******************************************************************************/
+inline int32 SIDCycleVoice::Output(const uint8 **combined)
+{
+	uint32 phase = accumulator >> 12;
+	uint32 msb;
+	uint16 wave;
+
+	switch (waveform)
+	{
+		// Triangle
+		case 0x1:
+		{
+			msb = accumulator;
+			if (ring)
+				msb ^= source->accumulator;
+
+			wave = (((msb & 0x800000) ? ~accumulator : accumulator) >> 11) & 0x0fff;
+			break;
+		}
+
+		// Sawtooth
+		case 0x2:
+		{
+			wave = phase;
+			break;
+		}
+
+		// Triangle + sawtooth
+		case 0x3:
+		{
+			wave = combined[0x3][phase] << 4;
+			break;
+		}
+
+		// Pulse
+		case 0x4:
+		{
+			wave = (test || (phase >= pulseWidth)) ? 0x0fff : 0x0000;
+			break;
+		}
+
+		// Pulse combined with triangle. Ring modulation flips the
+		// triangle part, which is the same as moving half a period
+		case 0x5:
+		case 0x7:
+		{
+			if (test || (phase >= pulseWidth))
+			{
+				if (ring && (source->accumulator & 0x800000))
+					phase ^= 0x800;
+
+				wave = combined[waveform][phase] << 4;
+			}
+			else
+				wave = 0x0000;
+
+			break;
+		}
+
+		// Pulse + sawtooth
+		case 0x6:
+		{
+			wave = (test || (phase >= pulseWidth)) ? (combined[0x6][phase] << 4) : 0x0000;
+			break;
+		}
+
+		// Noise
+		case 0x8:
+		{
+			wave = ((shiftRegister & 0x400000) >> 11) | ((shiftRegister & 0x100000) >> 10) |
+				   ((shiftRegister & 0x010000) >> 7) | ((shiftRegister & 0x002000) >> 5) |
+				   ((shiftRegister & 0x000800) >> 4) | ((shiftRegister & 0x000080) >> 1) |
+				   ((shiftRegister & 0x000010) << 1) | ((shiftRegister & 0x000004) << 2);
+			break;
+		}
+
+		// No waveform or noise combined with other waveforms
+		default:
+		{
+			waveOutput = 0;
+			return (0);
+		}
+	}
+
+	waveOutput = wave;
+	return (((int32)wave - 0x800) * envelopeCounter);
+}
+
+
+
+/******************************************************************************/
+/* ClockEnvelope() will advance the envelope generator one cycle.             */
+/******************************************************************************/
+inline void SIDCycleVoice::ClockEnvelope(void)
+{
+	// The rate counter is 15 bits wide, so if the period is lowered
+	// below the counter, it has to wrap around first
+	if ((++rateCounter & 0x8000) != 0)
+		rateCounter = (rateCounter + 1) & 0x7fff;
+
+	if (rateCounter != ratePeriod)
+		return;
+
+	rateCounter = 0;
+
+	// The attack is linear, the decay and release are divided by the
+	// exponential counter
+	if ((state != CYCLE_ATTACK) && (++exponentialCounter != exponentialPeriod))
+		return;
+
+	exponentialCounter = 0;
+
+	if (holdZero)
+		return;
+
+	switch (state)
+	{
+		case CYCLE_ATTACK:
+		{
+			envelopeCounter++;
+			if (envelopeCounter == 0xff)
+			{
+				state      = CYCLE_DECAY_SUSTAIN;
+				ratePeriod = ratePeriods[decay];
+			}
+			break;
+		}
+
+		case CYCLE_DECAY_SUSTAIN:
+		{
+			if (envelopeCounter != sustainLevels[sustain])
+				envelopeCounter--;
+
+			break;
+		}
+
+		case CYCLE_RELEASE:
+		{
+			envelopeCounter--;
+			break;
+		}
+	}
+
+	switch (envelopeCounter)
+	{
+		case 0xff:
+			exponentialPeriod = 1;
+			break;
+
+		case 0x5d:
+			exponentialPeriod = 2;
+			break;
+
+		case 0x36:
+			exponentialPeriod = 4;
+			break;
+
+		case 0x1a:
+			exponentialPeriod = 8;
+			break;
+
+		case 0x0e:
+			exponentialPeriod = 16;
+			break;
+
+		case 0x06:
+			exponentialPeriod = 30;
+			break;
+
+		case 0x00:
+			exponentialPeriod = 1;
+			holdZero = true;
+			break;
+	}
+}
+
+
+
+
+
+/******************************************************************************/
+/* SIDCycle class                                                             */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/*                                                                            */
+/* Input:  "sid" is a pointer to the SID with the clock, mixer frequency and  */
+/*         the waveform tables.                                               */
+/******************************************************************************/
+SIDCycle::SIDCycle(SID6581 *sid)
+{
+	int32 i;
+
+	// Initialize member variables
+	sid6581 = sid;
+
+	// The voices are connected in a ring for sync and ring modulation
+	voice[0].source = &voice[2];
+	voice[1].source = &voice[0];
+	voice[2].source = &voice[1];
+
+	for (i = 0; i < 8; i++)
+		combined[i] = NULL;
+
+	fir1 = NULL;
+	fir2 = NULL;
+
+	for (i = 0; i < 3; i++)
+	{
+		cycleBuffer[i] = NULL;
+		stageBuffer[i] = NULL;
+	}
+
+	filterEnabled = true;
+	outputScale   = 0.0f;
+
+	Reset();
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+SIDCycle::~SIDCycle(void)
+{
+	FreeBuffers();
+}
+
+
+
+/******************************************************************************/
+/* Configure() builds the tables for the current clock and mixer frequency.   */
+/*                                                                            */
+/* Input:  "isNewSID" is true to emulate the MOS 8580, false for the 6581.    */
+/*         "emulateFilter" is true to emulate the filter.                     */
+/*                                                                            */
+/* Output: True for success, false if there is not enough memory.             */
+/******************************************************************************/
+bool SIDCycle::Configure(bool isNewSID, bool emulateFilter)
+{
+	const int32 (*points)[2];
+	float clock, rate, rate1;
+	float passBand, freq;
+	int32 i, count, stage1Max;
+
+	FreeBuffers();
+
+	clock = sid6581->c64_fClockSpeed;
+	rate  = sid6581->pcmFreq;
+
+	// Use the same combined waveforms as the table driven SID
+	combined[0x3] = sid6581->waveform30;
+	combined[0x5] = sid6581->waveform50;
+	combined[0x6] = sid6581->waveform60;
+	combined[0x7] = sid6581->waveform70;
+
+	// Build the filter cut-off table
+	if (isNewSID)
+	{
+		points = cutOff8580;
+		count  = sizeof(cutOff8580) / sizeof(cutOff8580[0]);
+	}
+	else
+	{
+		points = cutOff6581;
+		count  = sizeof(cutOff6581) / sizeof(cutOff6581[0]);
+	}
+
+	for (i = 0; i < 2048; i++)
+	{
+		int32 j = 1;
+
+		while ((j < (count - 1)) && (points[j][0] < i))
+			j++;
+
+		freq = points[j - 1][1] + (float)(points[j][1] - points[j - 1][1]) * (i - points[j - 1][0]) / (points[j][0] - points[j - 1][0]);
+		cutOffTable[i] = 2.0f * M_PI * freq / clock;
+	}
+
+	filterEnabled = emulateFilter;
+
+	// The output of a single voice at full volume fills the 16 bits. Leave
+	// some room for the filter resonance
+	outputScale = 32767.0f / (2048.0f * 255.0f * 15.0f);
+	if (filterEnabled)
+		outputScale *= 0.7f;
+
+	// The first stage decimates the cycles to around 2.5 times the mixer
+	// frequency. Everything that would be folded into the audible range
+	// after the second stage has to be removed by it
+	decimation = max((int32)(clock / (rate * 2.5f)), 1);
+	rate1      = clock / decimation;
+	passBand   = min(rate * 0.45f, 20000.0f);
+
+	fir1 = CreateLowPass((passBand + rate1 - rate / 2.0f) / 2.0f, rate1 - rate / 2.0f - passBand, clock, fir1Length, 1);
+	fir2 = CreateLowPass((passBand + rate / 2.0f) / 2.0f, rate / 2.0f - passBand, rate1, fir2Length, SIDCYCLE_PHASES);
+
+	resampleStep = (double)rate1 / rate;
+
+	// Allocate the buffers. They hold the samples needed for a whole block
+	// plus the history of the filters
+	stage1Max = (int32)(SIDCYCLE_BLOCK * resampleStep) + 2;
+
+	for (i = 0; i < 3; i++)
+	{
+		cycleBuffer[i] = new float[fir1Length + stage1Max * decimation];
+		stageBuffer[i] = new float[fir2Length + stage1Max];
+
+		if ((cycleBuffer[i] == NULL) || (stageBuffer[i] == NULL))
+			break;
+	}
+
+	if ((fir1 == NULL) || (fir2 == NULL) || (i < 3))
+	{
+		FreeBuffers();
+		return (false);
+	}
+
+	Reset();
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* Reset() will set the chip to the power on state.                           */
+/******************************************************************************/
+void SIDCycle::Reset(void)
+{
+	voice[0].Reset();
+	voice[1].Reset();
+	voice[2].Reset();
+
+	filterCutOff = 0;
+	filterRes    = 0;
+	filterMode   = 0;
+	filterW0     = cutOffTable[0];
+	filterDamp   = 1.0f / 0.707f;
+	gainLowPass  = 0.0f;
+	gainBandPass = 0.0f;
+	gainHighPass = 0.0f;
+	volume       = 0.0f;
+	voice3Off    = false;
+
+	// Start with silence in the history of the resampling filter, so it
+	// never needs more than a block of new samples
+	cycleLength  = 0;
+	stageLength  = 0;
+	resamplePos  = 0.0;
+
+	if (stageBuffer[0] != NULL)
+	{
+		stageLength = fir2Length - 1;
+
+		memset(stageBuffer[0], 0, stageLength * sizeof(float));
+		memset(stageBuffer[1], 0, stageLength * sizeof(float));
+		memset(stageBuffer[2], 0, stageLength * sizeof(float));
+	}
+}
+
+
+
+/******************************************************************************/
+/* WriteRegisters() will update the chip with the register values written by  */
+/*      the last player call.                                                 */
+/*                                                                            */
+/* Input:  "regs" is a pointer to the 25 SID registers.                       */
+/*         "keysOn" is a pointer to the flags telling which registers have    */
+/*         been written with the gate bit set.                                */
+/*         "keysOff" is the same for the gate bit cleared.                    */
+/******************************************************************************/
+void SIDCycle::WriteRegisters(const uint8 *regs, const bool *keysOn, const bool *keysOff)
+{
+	SIDCycleVoice *v;
+	const uint8 *r;
+	uint8 control;
+	int32 i;
+
+	for (i = 0; i < 3; i++)
+	{
+		v = &voice[i];
+		r = regs + i * 7;
+
+		v->freq       = r[0] | (r[1] << 8);
+		v->pulseWidth = (r[2] | (r[3] << 8)) & 0x0fff;
+		v->WriteAttackDecay(r[5]);
+		v->WriteSustainRelease(r[6]);
+
+		// The player may have turned the gate off and on again during
+		// the call (or the other way round), which restarts the envelope
+		control = r[4];
+
+		if (((control & 0x01) != 0) && v->gate && keysOff[i * 7 + 4])
+			v->WriteControl(control & 0xfe);
+		else if (((control & 0x01) == 0) && !v->gate && keysOn[i * 7 + 4])
+			v->WriteControl(control | 0x01);
+
+		v->WriteControl(control);
+		v->filtered = filterEnabled && ((regs[0x17] & (1 << i)) != 0);
+	}
+
+	filterCutOff = (regs[0x15] & 0x07) | (regs[0x16] << 3);
+	filterRes    = regs[0x17] >> 4;
+	filterMode   = regs[0x18] & 0x70;
+	voice3Off    = ((regs[0x18] & 0x80) != 0);
+	volume       = (regs[0x18] & 0x0f) * outputScale;
+
+	filterW0     = cutOffTable[filterCutOff];
+	filterDamp   = 1.0f / (0.707f + filterRes / 15.0f);
+	gainLowPass  = (filterMode & 0x10) ? 1.0f : 0.0f;
+	gainBandPass = (filterMode & 0x20) ? 1.0f : 0.0f;
+	gainHighPass = (filterMode & 0x40) ? 1.0f : 0.0f;
+}
+
+
+
+/******************************************************************************/
+/* ReadOsc3() returns the value of the OSC3 register.                         */
+/*                                                                            */
+/* Output: The upper 8 bits of the waveform output of voice 3.                */
+/******************************************************************************/
+uint8 SIDCycle::ReadOsc3(void) const
+{
+	return (voice[2].waveOutput >> 4);
+}
+
+
+
+/******************************************************************************/
+/* ReadEnv3() returns the value of the ENV3 register.                         */
+/*                                                                            */
+/* Output: The envelope counter of voice 3.                                   */
+/******************************************************************************/
+uint8 SIDCycle::ReadEnv3(void) const
+{
+	return (voice[2].envelopeCounter);
+}
+
+
+
+/******************************************************************************/
+/* Render() will calculate the output of the three voices at the mixer        */
+/*      frequency.                                                            */
+/*                                                                            */
+/* Input:  "v1Buffer" is a pointer to store the samples of voice 1 in.        */
+/*         "v2Buffer" is the same for voice 2.                                */
+/*         "v3Buffer" is the same for voice 3.                                */
+/*         "numberOfSamples" is the number of samples to calculate.           */
+/*         "zero" is the zero sample value.                                   */
+/******************************************************************************/
+void SIDCycle::Render(int16 *v1Buffer, int16 *v2Buffer, int16 *v3Buffer, uint32 numberOfSamples, uint16 zero)
+{
+	int16 *buffers[3];
+	int16 *out;
+	const float *data;
+	double pos;
+	float sample;
+	int32 todo, need, base, phase;
+	int32 i, j;
+
+	buffers[0] = v1Buffer;
+	buffers[1] = v2Buffer;
+	buffers[2] = v3Buffer;
+
+	while (numberOfSamples > 0)
+	{
+		todo = min(numberOfSamples, (uint32)SIDCYCLE_BLOCK);
+
+		// Make sure all the samples from the first stage needed by this
+		// block are calculated
+		need = (int32)(resamplePos + (todo - 1) * resampleStep) + fir2Length - stageLength;
+		if (need > 0)
+			Decimate(need);
+
+		// Resample each voice
+		for (i = 0; i < 3; i++)
+		{
+			data = stageBuffer[i];
+			out  = buffers[i];
+			pos  = resamplePos;
+
+			for (j = 0; j < todo; j++)
+			{
+				base   = (int32)pos;
+				phase  = (int32)((pos - base) * SIDCYCLE_PHASES);
+				sample = DotProduct(data + base, fir2 + phase * fir2Length, fir2Length);
+
+				if (sample > 32767.0f)
+					sample = 32767.0f;
+				else if (sample < -32768.0f)
+					sample = -32768.0f;
+
+				*out++ = zero + (int16)sample;
+				pos   += resampleStep;
+			}
+
+			buffers[i] = out;
+		}
+
+		// Throw away the samples which will not be used anymore
+		base        = (int32)pos;
+		resamplePos = pos - base;
+		stageLength -= base;
+
+		for (i = 0; i < 3; i++)
+			memmove(stageBuffer[i], stageBuffer[i] + base, stageLength * sizeof(float));
+
+		numberOfSamples -= todo;
+	}
+}
+
+
+
+/******************************************************************************/
+/* FreeBuffers() will delete all the filters and buffers.                     */
+/******************************************************************************/
+void SIDCycle::FreeBuffers(void)
+{
+	int32 i;
+
+	delete[] fir1;
+	fir1 = NULL;
+
+	delete[] fir2;
+	fir2 = NULL;
+
+	for (i = 0; i < 3; i++)
+	{
+		delete[] cycleBuffer[i];
+		cycleBuffer[i] = NULL;
+
+		delete[] stageBuffer[i];
+		stageBuffer[i] = NULL;
+	}
+}
+
+
+
+/******************************************************************************/
+/* CreateLowPass() will create a Kaiser windowed sinc low-pass filter. With   */
+/*      more than one phase, each phase is the filter delayed by a fraction   */
+/*      of a sample, which is used for resampling.                            */
+/*                                                                            */
+/* Input:  "cutOff" is the cut-off frequency.                                 */
+/*         "transition" is the width of the transition band.                  */
+/*         "rate" is the sample rate of the input.                            */
+/*         "length" is a reference to store the number of taps per phase.     */
+/*         "phases" is the number of phases to create.                        */
+/*                                                                            */
+/* Output: A pointer to the coefficients or NULL if there is no memory.       */
+/******************************************************************************/
+float *SIDCycle::CreateLowPass(float cutOff, float transition, float rate, int32 &length, int32 phases)
+{
+	const double attenuation = 96.0;
+	double beta, fc, center, half;
+	double x, u, value, sum;
+	float *table, *coeff;
+	int32 taps, i, j;
+
+	// Find the number of taps needed for the attenuation in the stop band
+	beta = 0.1102 * (attenuation - 8.7);
+	taps = (int32)ceil((attenuation - 7.95) / (2.285 * 2.0 * M_PI * transition / rate)) + 1;
+
+	// Round up, so the dot product can take 8 taps at the time
+	length = (taps + 7) & ~7;
+
+	table = new float[length * phases];
+	if (table == NULL)
+		return (NULL);
+
+	fc     = cutOff / rate;
+	center = (taps - 1) / 2.0;
+	half   = taps / 2.0;
+
+	for (i = 0; i < phases; i++)
+	{
+		coeff = table + i * length;
+		sum   = 0.0;
+
+		for (j = 0; j < length; j++)
+		{
+			x = j - center - (double)i / phases;
+			u = x / half;
+
+			if (fabs(u) > 1.0)
+				value = 0.0;
+			else
+			{
+				value = 2.0 * fc * Bessel(beta * sqrt(1.0 - u * u)) / Bessel(beta);
+				if (x != 0.0)
+					value *= sin(2.0 * M_PI * fc * x) / (2.0 * M_PI * fc * x);
+			}
+
+			coeff[j] = value;
+			sum     += value;
+		}
+
+		// Normalize, so every phase has unity gain
+		for (j = 0; j < length; j++)
+			coeff[j] /= sum;
+	}
+
+	return (table);
+}
+
+
+
+/******************************************************************************/
+/* ClockChip() will run the chip the number of cycles given and store the     */
+/*      output of each voice in the cycle buffers.                            */
+/*                                                                            */
+/* Input:  "cycles" is the number of cycles to run.                           */
+/******************************************************************************/
+void SIDCycle::ClockChip(int32 cycles)
+{
+	SIDCycleVoice *v;
+	float *out[3];
+	float in, highPass;
+	float w0, damp;
+	int32 i, j;
+
+	out[0] = cycleBuffer[0] + cycleLength;
+	out[1] = cycleBuffer[1] + cycleLength;
+	out[2] = cycleBuffer[2] + cycleLength;
+
+	w0   = filterW0;
+	damp = filterDamp;
+
+	for (i = 0; i < cycles; i++)
+	{
+		// All the oscillators have to be clocked before the hard sync and
+		// the ring modulation look at them
+		voice[0].ClockOscillator();
+		voice[1].ClockOscillator();
+		voice[2].ClockOscillator();
+
+		voice[0].Synchronize();
+		voice[1].Synchronize();
+		voice[2].Synchronize();
+
+		for (j = 0; j < 3; j++)
+		{
+			v  = &voice[j];
+			in = (float)v->Output(combined);
+			v->ClockEnvelope();
+
+			// The filter is linear, so filtering each voice on its own
+			// gives the same as filtering the mix
+			if (v->filtered)
+			{
+				in          += ANTI_DENORMAL;
+				v->lowPass  += w0 * v->bandPass;
+				highPass     = in - v->lowPass - damp * v->bandPass;
+				v->bandPass += w0 * highPass;
+
+				in = v->lowPass * gainLowPass + v->bandPass * gainBandPass + highPass * gainHighPass;
+			}
+			else if ((j == 2) && voice3Off)
+				in = 0.0f;
+
+			out[j][i] = in * volume;
+		}
+	}
+
+	cycleLength += cycles;
+}
+
+
+
+/******************************************************************************/
+/* Decimate() will run the first filter stage and add the samples to the      */
+/*      stage buffers. The chip is clocked as needed.                         */
+/*                                                                            */
+/* Input:  "count" is the number of samples to calculate.                     */
+/******************************************************************************/
+void SIDCycle::Decimate(int32 count)
+{
+	const float *data;
+	float *out;
+	int32 cycles, left;
+	int32 i, j;
+
+	cycles = (count - 1) * decimation + fir1Length - cycleLength;
+	if (cycles > 0)
+		ClockChip(cycles);
+
+	for (i = 0; i < 3; i++)
+	{
+		data = cycleBuffer[i];
+		out  = stageBuffer[i] + stageLength;
+
+		for (j = 0; j < count; j++)
+			out[j] = DotProduct(data + j * decimation, fir1, fir1Length);
+	}
+
+	stageLength += count;
+
+	// Keep the cycles which are still needed by the next samples
+	left = cycleLength - count * decimation;
+
+	for (i = 0; i < 3; i++)
+		memmove(cycleBuffer[i], cycleBuffer[i] + count * decimation, left * sizeof(float));
+
+	cycleLength = left;
+}
+
+
+
+/******************************************************************************/
+/* DotProduct() multiplies the samples with the filter coefficients and       */
+/*      returns the sum.                                                      */
+/*                                                                            */
+/* Input:  "data" is a pointer to the samples.                                */
+/*         "coeff" is a pointer to the coefficients.                          */
+/*         "length" is the number of taps. Has to be a multiple of 8.         */
+/*                                                                            */
+/* Output: The sum.                                                           */
+/******************************************************************************/
+inline float SIDCycle::DotProduct(const float *data, const float *coeff, int32 length)
+{
+	int32 i;
+
+#if defined(__SSE__)
+	__m128 sum1 = _mm_setzero_ps();
+	__m128 sum2 = _mm_setzero_ps();
+
+	for (i = 0; i < length; i += 8)
+	{
+		sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(coeff + i)));
+		sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(data + i + 4), _mm_loadu_ps(coeff + i + 4)));
+	}
+
+	sum1 = _mm_add_ps(sum1, sum2);
+	sum1 = _mm_add_ps(sum1, _mm_movehl_ps(sum1, sum1));
+	sum1 = _mm_add_ss(sum1, _mm_shuffle_ps(sum1, sum1, 1));
+
+	return (_mm_cvtss_f32(sum1));
+#else
+	float sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f, sum4 = 0.0f;
+
+	for (i = 0; i < length; i += 4)
+	{
+		sum1 += data[i] * coeff[i];
+		sum2 += data[i + 1] * coeff[i + 1];
+		sum3 += data[i + 2] * coeff[i + 2];
+		sum4 += data[i + 3] * coeff[i + 3];
+	}
+
+	return ((sum1 + sum2) + (sum3 + sum4));
+#endif
+}
@@ -0,0 +1,160 @@
+/******************************************************************************/
+/* SIDCycle header file.                                                      */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __SIDCycle_h
+#define __SIDCycle_h
+
+// PolyKit headers
+#include "POS.h"
+
+
+/******************************************************************************/
+/* Constants                                                                  */
+/******************************************************************************/
+#define SIDCYCLE_BLOCK				256		// Output samples calculated at once
+#define SIDCYCLE_PHASES				1024	// Phases in the resampling filter
+
+
+
+/******************************************************************************/
+/* SIDCycleVoice class                                                        */
+/*                                                                            */
+/* One voice of the cycle exact SID. It holds the oscillator, the waveform    */
+/* generator, the envelope generator and the filter state of the voice.       */
+/******************************************************************************/
+class SID6581;
+
+class SIDCycleVoice
+{
+public:
+	SIDCycleVoice(void);
+	virtual ~SIDCycleVoice(void);
+
+	void Reset(void);
+
+	void WriteControl(uint8 control);
+	void WriteAttackDecay(uint8 attackDecay);
+	void WriteSustainRelease(uint8 sustainRelease);
+
+	inline void ClockOscillator(void);
+	inline void Synchronize(void);
+	inline int32 Output(const uint8 **combined);
+	inline void ClockEnvelope(void);
+
+	SIDCycleVoice *source;		// The voice used for sync and ring modulation
+
+	// Oscillator and waveform generator
+	uint32 accumulator;
+	uint32 shiftRegister;
+	uint32 freq;
+	uint16 pulseWidth;
+	uint8 waveform;
+	bool test;
+	bool ring;
+	bool sync;
+	bool msbRising;
+	uint16 waveOutput;			// Last output, used when reading OSC3
+
+	// Envelope generator
+	uint8 state;
+	bool gate;
+	bool holdZero;
+	uint8 envelopeCounter;
+	uint16 rateCounter;
+	uint16 ratePeriod;
+	uint8 exponentialCounter;
+	uint8 exponentialPeriod;
+	uint8 attack;
+	uint8 decay;
+	uint8 sustain;
+	uint8 release;
+
+	// Filter state
+	bool filtered;
+	float lowPass;
+	float bandPass;
+};
+
+
+
+/******************************************************************************/
+/* SIDCycle class                                                             */
+/*                                                                            */
+/* A SID model which is clocked once for every C64 cycle like the real chip,  */
+/* with a state variable filter and the sampled combined waveforms. The       */
+/* output of each voice is decimated to the mixer frequency with a polyphase  */
+/* FIR filter in two stages: First an integer decimation to about 2.5 times   */
+/* the mixer frequency, then a fractional resampling down to it.              */
+/******************************************************************************/
+class SIDCycle
+{
+public:
+	SIDCycle(SID6581 *sid);
+	virtual ~SIDCycle(void);
+
+	bool Configure(bool isNewSID, bool emulateFilter);
+	void Reset(void);
+
+	void WriteRegisters(const uint8 *regs, const bool *keysOn, const bool *keysOff);
+	uint8 ReadOsc3(void) const;
+	uint8 ReadEnv3(void) const;
+
+	void Render(int16 *v1Buffer, int16 *v2Buffer, int16 *v3Buffer, uint32 numberOfSamples, uint16 zero);
+
+protected:
+	void FreeBuffers(void);
+	float *CreateLowPass(float cutOff, float transition, float rate, int32 &length, int32 phases);
+
+	void ClockChip(int32 cycles);
+	void Decimate(int32 count);
+
+	static inline float DotProduct(const float *data, const float *coeff, int32 length);
+
+	SID6581 *sid6581;
+
+	SIDCycleVoice voice[3];
+	const uint8 *combined[8];	// Combined waveforms by waveform bits
+
+	// Filter and volume registers
+	bool filterEnabled;
+	uint16 filterCutOff;
+	uint8 filterRes;
+	uint8 filterMode;
+	float filterW0;
+	float filterDamp;
+	float gainLowPass;
+	float gainBandPass;
+	float gainHighPass;
+	float volume;
+	float outputScale;
+	bool voice3Off;
+
+	float cutOffTable[2048];
+
+	// Decimation filter (1. stage)
+	float *fir1;
+	int32 fir1Length;
+	int32 decimation;
+
+	float *cycleBuffer[3];
+	int32 cycleLength;
+
+	// Resampling filter (2. stage)
+	float *fir2;
+	int32 fir2Length;
+	double resampleStep;
+	double resamplePos;
+
+	float *stageBuffer[3];
+	int32 stageLength;
+};
+
+#endif
@@ -61,6 +61,7 @@ SIDEmuEngine::SIDEmuEngine(void) : sid6581(&sid6510)
 	config.memoryMode      = MPU_BANK_SWITCHING;
 	config.clockSpeed      = SIDTUNE_CLOCK_PAL;
 	config.forceSongSpeed  = false;
+	config.cycleExact      = false;
 
 	// Reset data counter
 	bytesCountTotal = (bytesCountSong = 0);
@@ -292,6 +293,13 @@ bool SIDEmuEngine::SetConfig(const sidEmuConfig &inCfg)
 		newSIDconfig = true;
 	}
 
+	if (inCfg.cycleExact != config.cycleExact)
+	{
+		config.cycleExact = (inCfg.cycleExact == true);
+		newSIDconfig = true;		// Create the cycle exact SID
+		newMixerSettings = true;	// Fill function
+	}
+
 	// Here re-initialize the SID, if required
 	if (newSIDconfig)
 		ConfigureSID();
@@ -445,7 +453,7 @@ bool SIDEmuEngine::FreeMem(void)
 /******************************************************************************/
 void SIDEmuEngine::ConfigureSID(void)
 {
-	sid6581.EmuConfigure(config.frequency, config.measuredVolume, config.mos8580, config.emulateFilter, config.clockSpeed);
+	sid6581.EmuConfigure(config.frequency, config.measuredVolume, config.mos8580, config.emulateFilter, config.cycleExact, config.clockSpeed);
 }
 
 
@@ -577,6 +585,10 @@ void SIDEmuEngine::InitMixerEngine(void)
 
 	sidEmuFillFunc = fillFunctions[bitsIndex][monoIndex][controlIndex];
 
+	// The cycle exact SID calculates the three voices by itself
+	if ((sidEmuFillFunc == Fill16BitSplit) && (sid6581.cycleSid != NULL))
+		sidEmuFillFunc = Fill16BitSplitCycle;
+
 	// Call a function which inits more local tables
 	MixerInit(isThreeVoiceAmplified, zero8bit, zero16bit);
 
@@ -811,6 +823,46 @@ inline void SIDEmuEngine::SyncEm(void)
 
 
 
+/******************************************************************************/
+/* VoicesIndependent() tells if the voices can be calculated one at the time. */
+/*      That is the case when no voice is synchronized with or ring modulated */
+/*      by another voice.                                                     */
+/*                                                                            */
+/* Output: True if the voices do not depend on each other, false if not.      */
+/******************************************************************************/
+inline bool SIDEmuEngine::VoicesIndependent(void) const
+{
+	if (sid6581.optr1.sync || sid6581.optr2.sync || sid6581.optr3.sync)
+		return (false);
+
+	if (sid6581.optr1.ringMod || sid6581.optr2.ringMod || sid6581.optr3.ringMod)
+		return (false);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* FillVoiceSplit() calculates a whole buffer for a single voice.             */
+/*                                                                            */
+/* Input:  "optr" is a pointer to the voice.                                  */
+/*         "buffer" is a pointer to the buffer to fill.                       */
+/*         "numberOfSamples" is the number of samples to calculate.           */
+/******************************************************************************/
+inline void SIDEmuEngine::FillVoiceSplit(SIDOperator *optr, int16 *buffer, uint32 numberOfSamples)
+{
+	uint16 zero = zero16Bit;
+
+	for ( ; numberOfSamples > 0; numberOfSamples--)
+	{
+		*buffer++ = zero + ((*optr->outProc)(optr) << 8);
+		optr->cycleLenCount--;
+	}
+}
+
+
+
 /******************************************************************************/
 /* Fill16BitSplit()                                                           */
 /******************************************************************************/
@@ -821,6 +873,19 @@ void *SIDEmuEngine::Fill16BitSplit(SIDEmuEngine *obj, void *buffer, uint32 numbe
 	int16 *v3Buffer16Bit = v2Buffer16Bit + obj->splitBufferLen;
 	int16 *v4Buffer16Bit = v3Buffer16Bit + obj->splitBufferLen;
 
+	if (obj->VoicesIndependent())
+	{
+		// Calculate one voice at the time for the whole buffer
+		obj->FillVoiceSplit(&obj->sid6581.optr1, v1Buffer16Bit, numberOfSamples);
+		obj->FillVoiceSplit(&obj->sid6581.optr2, v2Buffer16Bit, numberOfSamples);
+		obj->FillVoiceSplit(&obj->sid6581.optr3, v3Buffer16Bit, numberOfSamples);
+
+		for (uint32 i = 0; i < numberOfSamples; i++)
+			v4Buffer16Bit[i] = obj->zero16Bit + ((*obj->sid6581.samples.sampleEmuRout)(&obj->sid6581.samples) << 8);
+
+		return (v1Buffer16Bit + numberOfSamples);
+	}
+
 	for ( ; numberOfSamples > 0; numberOfSamples--)
 	{
 		*v1Buffer16Bit++ = obj->zero16Bit + ((*obj->sid6581.optr1.outProc)(&obj->sid6581.optr1) << 8);
@@ -832,3 +897,24 @@ void *SIDEmuEngine::Fill16BitSplit(SIDEmuEngine *obj, void *buffer, uint32 numbe
 
 	return (v1Buffer16Bit);
 }
+
+
+
+/******************************************************************************/
+/* Fill16BitSplitCycle() is the same as Fill16BitSplit(), but uses the cycle  */
+/*      exact SID for the three voices.                                       */
+/******************************************************************************/
+void *SIDEmuEngine::Fill16BitSplitCycle(SIDEmuEngine *obj, void *buffer, uint32 numberOfSamples)
+{
+	int16 *v1Buffer16Bit = (int16 *)buffer;
+	int16 *v2Buffer16Bit = v1Buffer16Bit + obj->splitBufferLen;
+	int16 *v3Buffer16Bit = v2Buffer16Bit + obj->splitBufferLen;
+	int16 *v4Buffer16Bit = v3Buffer16Bit + obj->splitBufferLen;
+
+	obj->sid6581.cycleSid->Render(v1Buffer16Bit, v2Buffer16Bit, v3Buffer16Bit, numberOfSamples, obj->zero16Bit);
+
+	for (uint32 i = 0; i < numberOfSamples; i++)
+		v4Buffer16Bit[i] = obj->zero16Bit + ((*obj->sid6581.samples.sampleEmuRout)(&obj->sid6581.samples) << 8);
+
+	return (v1Buffer16Bit + numberOfSamples);
+}
@@ -58,6 +58,8 @@ typedef struct sidEmuConfig
 
 	bool forceSongSpeed;	// True, false
 
+	bool cycleExact;		// True, false (clock the SID every cycle)
+
 	//
 	// Working, but experimental.
 	//
@@ -300,7 +302,10 @@ protected:
 
 	void MixerInit(bool threeVoiceAmplify, uint8 zero8, uint16 zero16);
 	inline void SyncEm(void);
+	inline bool VoicesIndependent(void) const;
+	inline void FillVoiceSplit(SIDOperator *optr, int16 *buffer, uint32 numberOfSamples);
 	static void *Fill16BitSplit(SIDEmuEngine *obj, void *buffer, uint32 numberOfSamples);
+	static void *Fill16BitSplitCycle(SIDEmuEngine *obj, void *buffer, uint32 numberOfSamples);
 
 	bool isReady;
 	sidEmuConfig config;
@@ -361,14 +361,15 @@ ap_result SIDFile::TestSID(PFile *file)
 
 	// Read the first line again, so we skip it probably
 	file->SeekToBegin();
-	file->ReadLine();
+
+	PLineReader reader(file, NULL, 2048);
+	reader.ReadLine(line);
 
 	// Parse as long we have not collected all required entries
 	while (!hasAddress || !hasName || !hasAuthor || !hasCopyright || !hasSongs || !hasSpeed)
 	{
 		// Skip to next line. Leave loop, if none
-		line = file->ReadLine();
-		if (line.IsEmpty())
+		if (!reader.ReadLine(line) || line.IsEmpty())
 			break;
 
 		// Find equal sign
@@ -864,14 +865,15 @@ void SIDFile::FillInInfo(void)
 			relocPages     = 0;
 
 			descripFile->SeekToBegin();
-			descripFile->ReadLine();
+
+			PLineReader reader(descripFile, NULL, 2048);
+			reader.ReadLine(line);
 
 			// Parse as long we have not collected all required entries
 			for (;;)
 			{
 				// Skip to next line. Leave loop, if none
-				line = descripFile->ReadLine();
-				if (line.IsEmpty())
+				if (!reader.ReadLine(line) || line.IsEmpty())
 					break;
 
 				// Find equal sign
@@ -71,7 +71,8 @@ void SIDOperator::ClearSidOperator(void)
 	sidAD   = 0;
 	sidSR   = 0;
 
-	sync = false;
+	sync    = false;
+	ringMod = false;
 
 	pulseIndex = (newPulseIndex = (sidPulseWidth = 0));
 	curSIDfreq = (curNoiseFreq = 0);
@@ -317,9 +318,15 @@ void SIDOperator::SidEmuSet2(void)
 		}
 
 		if (((sidCtrl & 0x14) == 0x14) && (modulator->sidFreq != 0))
+		{
 			waveProc = sid6581->sidModeRingTable[sidCtrl >> 4];
+			ringMod  = true;
+		}
 		else
+		{
 			waveProc = sid6581->sidModeNormalTable[sidCtrl >> 4];
+			ringMod  = false;
+		}
 	}
 }
 
@@ -75,6 +75,7 @@ public:
 	SIDOperator *carrier;
 	SIDOperator *modulator;
 	bool sync;
+	bool ringMod;
 
 	uint8 output;
 	uint8 outputMask;
@@ -18,12 +18,15 @@
 #include "PSynchronize.h"
 #include "PSettings.h"
 #include "PList.h"
+#include "PTime.h"
+#include "PChecksums.h"
 
 // APlayerKit headers
 #include "APChannel.h"
 
 // Player headers
 #include "SIDStil.h"
+#include "SIDSongLength.h"
 #include "SIDTune.h"
 #include "SIDFile.h"
 #include "SIDEmuEngine.h"
@@ -55,6 +58,7 @@
 extern PSettings *sidSettings;
 extern PMutex *stilLock;
 extern SIDStil *sidStil;
+extern SIDSongLength *sidSongLength;
 
 
 
@@ -72,6 +76,9 @@ SIDPlayer::SIDPlayer(APGlobalData *global, PString fileName) : APAddOnPlayer(glo
 	tune      = NULL;
 	buffer    = NULL;
 
+	songLengthCount = 0;
+	configChanged   = false;
+
 	// Allocate the resource object
 	res = new PResource(fileName);
 	if (res == NULL)
@@ -215,6 +222,7 @@ ap_result SIDPlayer::LoadModule(int32 index, PFile *file, PString &errorStr)
 {
 	PString stilPath;
 	bool stilOk;
+	uint8 md5[16];
 	ap_result retVal = AP_OK;
 
 	try
@@ -257,6 +265,15 @@ ap_result SIDPlayer::LoadModule(int32 index, PFile *file, PString &errorStr)
 				// Now append the entries into one big one
 				stilEntries = globalComment + entry + bug;
 			}
+
+			// The song length database is only parsed when the base
+			// directory changes, so it is never read for each module
+			if (sidSongLength->GetBaseDir() != stilPath)
+				sidSongLength->SetBaseDir(stilPath);
+
+			// Find the song lengths by the tune fingerprint
+			CalculateTuneHash(md5);
+			songLengthCount = sidSongLength->GetSongLengths(md5, songLengths, sidClassMaxSongs);
 		}
 
 		// Unlock the STIL object again
@@ -315,6 +332,10 @@ bool SIDPlayer::InitPlayer(int32 index)
 		emuEngine->GetConfig(config);
 		mixerFreq = config.frequency;
 
+		// Get told when the settings are changed
+		configChanged = false;
+		sidSettings->AddChangeListener(SettingsChanged, this);
+
 		// Allocate sample buffers
 		buffer = new uint8[DEFAULT_BUFFER_SIZE];
 		if (buffer == NULL)
@@ -381,10 +402,10 @@ void SIDPlayer::Play(void)
 	uint16 *tempBuf;
 
 	// Check to see if any settings has been changed
-	if (sidSettings->HasChanged())
+	if (configChanged)
 	{
 		// The settings has changed, but first clear the flag
-		sidSettings->SetChangeFlag(false);
+		configChanged = false;
 
 		// And then change the settings in the emulator
 		InitConfig();
@@ -466,6 +487,27 @@ const uint16 *SIDPlayer::GetSubSongs(void)
 
 
 
+/******************************************************************************/
+/* GetTimeTable() will return the length of the subsong given. SID tunes does */
+/*      not have any positions, so the length is taken from the HVSC song     */
+/*      length database.                                                      */
+/*                                                                            */
+/* Input:  "songNum" is the subsong number to get the time table for.         */
+/*         "posTimes" is a reference to the list where you should store the   */
+/*         start time for each position.                                      */
+/*                                                                            */
+/* Output: The total module time or 0 if time table is not supported.         */
+/******************************************************************************/
+PTimeSpan SIDPlayer::GetTimeTable(uint16 songNum, PList<PTimeSpan> &posTimes)
+{
+	if (songNum < songLengthCount)
+		return ((int64)songLengths[songNum]);
+
+	return (0);
+}
+
+
+
 /******************************************************************************/
 /* GetInfoString() returns the description and value string on the line       */
 /*      given. If the line is out of range, false is returned.                */
@@ -597,6 +639,9 @@ bool SIDPlayer::GetInfoString(uint32 line, PString &description, PString &value)
 /******************************************************************************/
 void SIDPlayer::Cleanup(void)
 {
+	// Stop listening for settings changes
+	sidSettings->RemoveChangeListener(SettingsChanged, this);
+
 	delete[] buffer;
 	delete player;
 	delete tune;
@@ -687,6 +732,13 @@ void SIDPlayer::InitConfig(void)
 
 	config.forceSongSpeed = flag;
 
+	if (sidSettings->GetStringEntryValue("General", "CycleExact").CompareNoCase("Yes") == 0)
+		flag = true;
+	else
+		flag = false;
+
+	config.cycleExact = flag;
+
 	config.digiPlayerScans = sidSettings->GetIntEntryValue("Misc", "DigiScan") * 50;
 
 	panningTab[0] = sidSettings->GetIntEntryValue("Panning", "Channel1");
@@ -703,3 +755,71 @@ void SIDPlayer::InitConfig(void)
 
 	emuEngine->SetConfig(config);
 }
+
+
+
+/******************************************************************************/
+/* CalculateTuneHash() calculates the fingerprint used by the HVSC song       */
+/*      length database. It is a MD5 of the C64 data, the init and play       */
+/*      addresses, the number of songs, the speed of each song and the clock  */
+/*      speed if the tune needs NTSC.                                         */
+/*                                                                            */
+/* Input:  "md5" is a pointer to where the 16 bytes fingerprint is stored.    */
+/******************************************************************************/
+void SIDPlayer::CalculateTuneHash(uint8 *md5)
+{
+	PMD5 checksum;
+	uint8 tmp[2];
+	uint16 i;
+
+	// Add the C64 data
+	checksum.AddBuffer(sidFile->modAdr, sidFile->modLen);
+
+	// Add the init and play addresses and the number of songs
+	tmp[0] = sidFile->initAdr & 0xff;
+	tmp[1] = sidFile->initAdr >> 8;
+	checksum.AddBuffer(tmp, 2);
+
+	tmp[0] = sidFile->playAdr & 0xff;
+	tmp[1] = sidFile->playAdr >> 8;
+	checksum.AddBuffer(tmp, 2);
+
+	tmp[0] = sidFile->songs & 0xff;
+	tmp[1] = sidFile->songs >> 8;
+	checksum.AddBuffer(tmp, 2);
+
+	// Add the speed of each song, the same way as SIDTune
+	// builds its speed table
+	for (i = 0; i < sidFile->songs; i++)
+	{
+		tmp[0] = ((sidFile->speed >> (i & 0x1f)) & 0x01) ? SIDTUNE_SPEED_CIA_1A : SIDTUNE_SPEED_VBI;
+		checksum.AddBuffer(tmp, 1);
+	}
+
+	// Only NTSC changes the fingerprint, so PAL tunes in the
+	// different PSID versions get the same one
+	if (sidFile->clock == SIDTUNE_CLOCK_NTSC)
+	{
+		tmp[0] = sidFile->clock;
+		checksum.AddBuffer(tmp, 1);
+	}
+
+	memcpy(md5, checksum.CalculateChecksum(), 16);
+}
+
+
+
+/******************************************************************************/
+/* SettingsChanged() is called when the SID settings have been changed. The   */
+/*      emulator is reconfigured by the player thread the next time Play() is */
+/*      called.                                                               */
+/*                                                                            */
+/* Input:  "settings" is a pointer to the settings changed.                   */
+/*         "section" is the section changed.                                  */
+/*         "entry" is the entry changed.                                      */
+/*         "userData" is a pointer to the player.                             */
+/******************************************************************************/
+void SIDPlayer::SettingsChanged(PSettings *settings, PString section, PString entry, void *userData)
+{
+	((SIDPlayer *)userData)->configChanged = true;
+}
@@ -18,6 +18,8 @@
 #include "PFile.h"
 #include "PResource.h"
 #include "PList.h"
+#include "PTime.h"
+#include "PSettings.h"
 
 // APlayerKit headers
 #include "APGlobalData.h"
@@ -60,16 +62,21 @@ public:
 	virtual PString GetModuleName(void);
 	virtual PString GetAuthor(void);
 	virtual const uint16 *GetSubSongs(void);
+	virtual PTimeSpan GetTimeTable(uint16 songNum, PList<PTimeSpan> &posTimes);
 
 	virtual bool GetInfoString(uint32 line, PString &description, PString &value);
 
 protected:
 	void Cleanup(void);
 	void InitConfig(void);
+	void CalculateTuneHash(uint8 *md5);
+
+	static void SettingsChanged(PSettings *settings, PString section, PString entry, void *userData);
 
 	PResource *res;
 	APConfigInfo cfgInfo;
 	uint8 panningTab[4];
+	volatile bool configChanged;
 
 	SIDFile *sidFile;
 	SIDEmuEngine *emuEngine;
@@ -80,6 +87,9 @@ protected:
 	int32 stilLineCount;
 	PList<PString> stilLines;
 
+	uint32 songLengths[sidClassMaxSongs];
+	uint16 songLengthCount;
+
 	uint8 *buffer;
 	uint32 mixerFreq;
 	uint16 songTab[2];
@@ -28,6 +28,7 @@
 #include "SIDView.h"
 #include "SIDPlayer.h"
 #include "SIDStil.h"
+#include "SIDSongLength.h"
 #include "ResourceIDs.h"
 
 
@@ -44,6 +45,7 @@ void FixSettings(void);
 PSettings *sidSettings = NULL;
 PMutex *stilLock = NULL;
 SIDStil *sidStil = NULL;
+SIDSongLength *sidSongLength = NULL;
 
 
 
@@ -96,6 +98,10 @@ void Load(APGlobalData *global, PString fileName)
 	sidStil = new SIDStil();
 	if (sidStil == NULL)
 		throw PMemoryException();
+
+	sidSongLength = new SIDSongLength();
+	if (sidSongLength == NULL)
+		throw PMemoryException();
 }
 
 
@@ -115,6 +121,9 @@ void Unload(APGlobalData *global)
 	delete sidStil;
 	sidStil = NULL;
 
+	delete sidSongLength;
+	sidSongLength = NULL;
+
 	// Delete the settings object again
 	delete sidSettings;
 	sidSettings = NULL;
@@ -166,6 +175,9 @@ void FixSettings(void)
 	if (!sidSettings->EntryExist("General", "ForceSongSpeed"))
 		sidSettings->WriteStringEntryValue("General", "ForceSongSpeed", "No");
 
+	if (!sidSettings->EntryExist("General", "CycleExact"))
+		sidSettings->WriteStringEntryValue("General", "CycleExact", "No");
+
 	// Set default "MPU memory mode"
 	if (!sidSettings->EntryExist("MPU", "Memory"))
 		sidSettings->WriteIntEntryValue("MPU", "Memory", RADIO_MEMORY_TRANSPARENT);
@@ -0,0 +1,424 @@
+/******************************************************************************/
+/* SID Song Length Database Interface.                                        */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+#include <stdlib.h>
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PFile.h"
+#include "PDirectory.h"
+#include "PException.h"
+
+// Player headers
+#include "SIDSongLength.h"
+
+
+/******************************************************************************/
+/* Database constants                                                         */
+/******************************************************************************/
+#define SONGLENGTH_HASH_LEN			32		// Number of hex digits in an entry key
+#define SONGLENGTH_START_TUNES		1024	// Initial number of tune entries
+#define SONGLENGTH_START_LENGTHS	4096	// Initial number of song lengths
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+SIDSongLength::SIDSongLength(void)
+{
+	// Initialize member variables
+	tunes       = NULL;
+	tuneCount   = 0;
+	tuneMax     = 0;
+
+	lengths     = NULL;
+	lengthCount = 0;
+	lengthMax   = 0;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+SIDSongLength::~SIDSongLength(void)
+{
+	FreeDatabase();
+}
+
+
+
+/******************************************************************************/
+/* SetBaseDir() tells the object where the HVSC base directory is. The        */
+/*      database is read from /DOCUMENTS/Songlengths.md5 or, in older HVSC    */
+/*      versions, from /DOCUMENTS/Songlengths.txt. The file is only parsed    */
+/*      here, all lookups afterwards are done in memory.                      */
+/*                                                                            */
+/* Input:  "pathToHVSC" is the HVSC base directory.                           */
+/*                                                                            */
+/* Output: False - Problems opening or parsing the database.                  */
+/*         True - All okay.                                                   */
+/******************************************************************************/
+bool SIDSongLength::SetBaseDir(PString pathToHVSC)
+{
+	PDirectory dir;
+	PFile *file = NULL;
+	char *text = NULL;
+	int32 textLen;
+	bool retVal = true;
+
+	// Remember the directory, even if the database can't be read. That
+	// way a missing file is not searched for again on every module loaded
+	baseDir = pathToHVSC;
+	FreeDatabase();
+
+	// Sanity check the length
+	if (pathToHVSC.IsEmpty())
+		return (false);
+
+	try
+	{
+		dir.SetDirectory(pathToHVSC);
+		dir.Append("DOCUMENTS");
+
+		// Open the database file
+		try
+		{
+			file = new PFile(dir.GetDirectory() + "Songlengths.md5", PFile::pModeRead | PFile::pModeShareRead);
+		}
+		catch(PFileException e)
+		{
+			file = new PFile(dir.GetDirectory() + "Songlengths.txt", PFile::pModeRead | PFile::pModeShareRead);
+		}
+
+		if (file == NULL)
+			throw PMemoryException();
+
+		// Read the whole file in one go
+		textLen = (int32)file->GetLength();
+		text    = new char[textLen];
+		if (text == NULL)
+			throw PMemoryException();
+
+		if (file->Read(text, textLen) != textLen)
+			throw PUserException();
+
+		// Build the tables and sort the tunes, so they can be binary searched
+		ParseDatabase(text, textLen);
+		qsort(tunes, tuneCount, sizeof(TuneEntry), CompareTunes);
+	}
+	catch(...)
+	{
+		FreeDatabase();
+		retVal = false;
+	}
+
+	// Clean up
+	delete[] text;
+	delete file;
+
+	return (retVal);
+}
+
+
+
+/******************************************************************************/
+/* GetBaseDir() returns the HVSC base directory last given.                   */
+/*                                                                            */
+/* Output: The base directory.                                                */
+/******************************************************************************/
+PString SIDSongLength::GetBaseDir(void) const
+{
+	return (baseDir);
+}
+
+
+
+/******************************************************************************/
+/* GetSongLengths() will find the song lengths for a tune.                    */
+/*                                                                            */
+/* Input:  "md5" is the 16 bytes HVSC fingerprint of the tune.                */
+/*         "songLengths" is a pointer to the array to store the lengths in    */
+/*         milliseconds.                                                      */
+/*         "maxSongs" is the number of entries in the array.                  */
+/*                                                                            */
+/* Output: The number of lengths stored or 0 if the tune is unknown.          */
+/******************************************************************************/
+uint16 SIDSongLength::GetSongLengths(const uint8 *md5, uint32 *songLengths, uint16 maxSongs) const
+{
+	int32 low, high, middle, result;
+	uint16 i, count;
+
+	low  = 0;
+	high = tuneCount - 1;
+
+	while (low <= high)
+	{
+		middle = (low + high) / 2;
+		result = memcmp(md5, tunes[middle].md5, 16);
+
+		if (result == 0)
+		{
+			// Found it, copy the lengths
+			count = (tunes[middle].songs < maxSongs) ? tunes[middle].songs : maxSongs;
+			for (i = 0; i < count; i++)
+				songLengths[i] = lengths[tunes[middle].firstLength + i];
+
+			return (count);
+		}
+
+		if (result < 0)
+			high = middle - 1;
+		else
+			low = middle + 1;
+	}
+
+	return (0);
+}
+
+
+
+/******************************************************************************/
+/* FreeDatabase() frees the database tables.                                  */
+/******************************************************************************/
+void SIDSongLength::FreeDatabase(void)
+{
+	delete[] tunes;
+	tunes     = NULL;
+	tuneCount = 0;
+	tuneMax   = 0;
+
+	delete[] lengths;
+	lengths     = NULL;
+	lengthCount = 0;
+	lengthMax   = 0;
+}
+
+
+
+/******************************************************************************/
+/* ParseDatabase() parses the database text and builds the tables. Entry      */
+/*      lines look like "<md5>=m:ss m:ss.mmm(G) ...", all other lines are     */
+/*      section names, comments or paths and are skipped.                     */
+/*                                                                            */
+/* Input:  "text" is a pointer to the database text.                          */
+/*         "textLen" is the length of the text.                               */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+void SIDSongLength::ParseDatabase(const char *text, int32 textLen)
+{
+	const char *textEnd = text + textLen;
+	const char *lineEnd;
+	uint8 md5[16];
+	uint32 firstLength;
+	uint16 songs;
+
+	while (text < textEnd)
+	{
+		// Find the end of the line
+		lineEnd = text;
+		while ((lineEnd < textEnd) && (*lineEnd != '\n') && (*lineEnd != '\r'))
+			lineEnd++;
+
+		if (((lineEnd - text) > (SONGLENGTH_HASH_LEN + 1)) && (text[SONGLENGTH_HASH_LEN] == '=') && ParseFingerprint(text, md5))
+		{
+			firstLength = lengthCount;
+			songs       = 0;
+			text       += SONGLENGTH_HASH_LEN + 1;
+
+			for (;;)
+			{
+				// Skip separators
+				while ((text < lineEnd) && ((*text == ' ') || (*text == '\t')))
+					text++;
+
+				if ((text >= lineEnd) || (songs == 0xffff))
+					break;
+
+				AddLength(ParseLength(text, lineEnd));
+				songs++;
+			}
+
+			if (songs != 0)
+				AddTune(md5, firstLength, songs);
+		}
+
+		// Go to the next line
+		text = lineEnd + 1;
+	}
+}
+
+
+
+/******************************************************************************/
+/* AddTune() adds a tune entry to the table.                                  */
+/*                                                                            */
+/* Input:  "md5" is the tune fingerprint.                                     */
+/*         "firstLength" is the index of the first song length.               */
+/*         "songs" is the number of song lengths.                             */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+void SIDSongLength::AddTune(const uint8 *md5, uint32 firstLength, uint16 songs)
+{
+	TuneEntry *newTunes;
+
+	if (tuneCount == tuneMax)
+	{
+		tuneMax  = (tuneMax == 0) ? SONGLENGTH_START_TUNES : tuneMax * 2;
+		newTunes = new TuneEntry[tuneMax];
+		if (newTunes == NULL)
+			throw PMemoryException();
+
+		if (tunes != NULL)
+			memcpy(newTunes, tunes, tuneCount * sizeof(TuneEntry));
+
+		delete[] tunes;
+		tunes = newTunes;
+	}
+
+	memcpy(tunes[tuneCount].md5, md5, 16);
+	tunes[tuneCount].firstLength = firstLength;
+	tunes[tuneCount].songs       = songs;
+	tuneCount++;
+}
+
+
+
+/******************************************************************************/
+/* AddLength() adds a song length to the table.                               */
+/*                                                                            */
+/* Input:  "length" is the song length in milliseconds.                       */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+void SIDSongLength::AddLength(uint32 length)
+{
+	uint32 *newLengths;
+
+	if (lengthCount == lengthMax)
+	{
+		lengthMax  = (lengthMax == 0) ? SONGLENGTH_START_LENGTHS : lengthMax * 2;
+		newLengths = new uint32[lengthMax];
+		if (newLengths == NULL)
+			throw PMemoryException();
+
+		if (lengths != NULL)
+			memcpy(newLengths, lengths, lengthCount * sizeof(uint32));
+
+		delete[] lengths;
+		lengths = newLengths;
+	}
+
+	lengths[lengthCount++] = length;
+}
+
+
+
+/******************************************************************************/
+/* ParseFingerprint() converts the hex digits at the start of an entry line   */
+/*      to the binary fingerprint.                                            */
+/*                                                                            */
+/* Input:  "text" is a pointer to the line.                                   */
+/*         "md5" is a pointer to store the 16 bytes fingerprint.              */
+/*                                                                            */
+/* Output: True if the line starts with a valid fingerprint, false if not.    */
+/******************************************************************************/
+bool SIDSongLength::ParseFingerprint(const char *text, uint8 *md5)
+{
+	int32 i;
+	uint8 nibble;
+	char chr;
+
+	for (i = 0; i < SONGLENGTH_HASH_LEN; i++)
+	{
+		chr = text[i];
+
+		if ((chr >= '0') && (chr <= '9'))
+			nibble = chr - '0';
+		else if ((chr >= 'a') && (chr <= 'f'))
+			nibble = chr - 'a' + 10;
+		else if ((chr >= 'A') && (chr <= 'F'))
+			nibble = chr - 'A' + 10;
+		else
+			return (false);
+
+		if (i & 1)
+			md5[i / 2] |= nibble;
+		else
+			md5[i / 2] = nibble << 4;
+	}
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* ParseLength() parses a single song length in the format "m:ss" with an     */
+/*      optional ".mmm" fraction and an optional attribute like "(G)".        */
+/*                                                                            */
+/* Input:  "text" is a reference to the text pointer. It will be moved to     */
+/*         the character after the length.                                    */
+/*         "textEnd" is a pointer to the end of the line.                     */
+/*                                                                            */
+/* Output: The length in milliseconds.                                        */
+/******************************************************************************/
+uint32 SIDSongLength::ParseLength(const char *&text, const char *textEnd)
+{
+	uint32 minutes = 0;
+	uint32 seconds = 0;
+	uint32 milliSeconds = 0;
+	uint32 scale = 100;
+
+	while ((text < textEnd) && (*text >= '0') && (*text <= '9'))
+		minutes = minutes * 10 + (*text++ - '0');
+
+	if ((text < textEnd) && (*text == ':'))
+	{
+		text++;
+		while ((text < textEnd) && (*text >= '0') && (*text <= '9'))
+			seconds = seconds * 10 + (*text++ - '0');
+	}
+
+	if ((text < textEnd) && (*text == '.'))
+	{
+		text++;
+		while ((text < textEnd) && (*text >= '0') && (*text <= '9'))
+		{
+			milliSeconds += (*text++ - '0') * scale;
+			scale /= 10;
+		}
+	}
+
+	// Skip the attribute and anything else up to the next separator
+	while ((text < textEnd) && (*text != ' ') && (*text != '\t'))
+		text++;
+
+	return ((minutes * 60 + seconds) * 1000 + milliSeconds);
+}
+
+
+
+/******************************************************************************/
+/* CompareTunes() is the sort function used to sort the tune entries.         */
+/*                                                                            */
+/* Input:  "tune1" is a pointer to the first tune entry.                      */
+/*         "tune2" is a pointer to the second tune entry.                     */
+/*                                                                            */
+/* Output: The memcmp() result of the two fingerprints.                       */
+/******************************************************************************/
+int SIDSongLength::CompareTunes(const void *tune1, const void *tune2)
+{
+	return (memcmp(((const TuneEntry *)tune1)->md5, ((const TuneEntry *)tune2)->md5, 16));
+}
@@ -0,0 +1,65 @@
+/******************************************************************************/
+/* SIDSongLength header file.                                                 */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __SIDSongLength_h
+#define __SIDSongLength_h
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+
+
+/******************************************************************************/
+/* SIDSongLength class                                                        */
+/*                                                                            */
+/* Holds the HVSC song length database (Songlengths.md5) as a sorted table    */
+/* of tune fingerprints, so a lookup is a binary search in memory.            */
+/******************************************************************************/
+class SIDSongLength
+{
+public:
+	SIDSongLength(void);
+	virtual ~SIDSongLength(void);
+
+	bool SetBaseDir(PString pathToHVSC);
+	PString GetBaseDir(void) const;
+
+	uint16 GetSongLengths(const uint8 *md5, uint32 *songLengths, uint16 maxSongs) const;
+
+protected:
+	typedef struct TuneEntry
+	{
+		uint8 md5[16];				// The tune fingerprint
+		uint32 firstLength;			// Index into the length table
+		uint16 songs;				// Number of song lengths
+	} TuneEntry;
+
+	void FreeDatabase(void);
+	void ParseDatabase(const char *text, int32 textLen);
+	void AddTune(const uint8 *md5, uint32 firstLength, uint16 songs);
+	void AddLength(uint32 length);
+
+	static bool ParseFingerprint(const char *text, uint8 *md5);
+	static uint32 ParseLength(const char *&text, const char *textEnd);
+	static int CompareTunes(const void *tune1, const void *tune2);
+
+	PString baseDir;
+
+	TuneEntry *tunes;
+	int32 tuneCount;
+	int32 tuneMax;
+
+	uint32 *lengths;
+	uint32 lengthCount;
+	uint32 lengthMax;
+};
+
+#endif
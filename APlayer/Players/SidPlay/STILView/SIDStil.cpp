@@ -18,7 +18,7 @@
 #include "PFile.h"
 #include "PDirectory.h"
 #include "PException.h"
-#include "PList.h"
+#include "PSkipList.h"
 
 // Player headers
 #include "SIDStil.h"
@@ -54,8 +54,8 @@ SIDStil::SIDStil(void)
 /******************************************************************************/
 SIDStil::~SIDStil(void)
 {
-	DeleteDirList(stilDirs);
-	DeleteDirList(bugDirs);
+	delete stilFile;
+	delete bugFile;
 }
 
 
@@ -63,7 +63,8 @@ SIDStil::~SIDStil(void)
 /******************************************************************************/
 /* SetBaseDir() tells the object where the HVSC base directory is - it        */
 /*      figures that the STIL should be in /DOCUMENTS/STIL.txt and that the   */
-/*      BUGlist should be in /DOCUMENTS/BUGlist.txt.                          */
+/*      BUGlist should be in /DOCUMENTS/BUGlist.txt. Both files are indexed   */
+/*      here, so the lookups afterwards can seek directly to the entries.     */
 /*                                                                            */
 /* Input:  "pathToHVSC" is the HVSC base directory.                           */
 /*                                                                            */
@@ -72,18 +73,23 @@ SIDStil::~SIDStil(void)
 /******************************************************************************/
 bool SIDStil::SetBaseDir(PString pathToHVSC)
 {
-	PString tempName;
 	PDirectory dir;
-	PList<DirList *> tempStilDirs, tempBugDirs;
-	float tempStilVersion;
-
-	// Temporary placeholder for STIL.txt's version number
-	tempStilVersion = stilVersion;
 
 	// Sanity check the length
 	if (pathToHVSC.IsEmpty())
 		return (false);
 
+	// Forget the old database
+	delete stilFile;
+	stilFile = NULL;
+
+	delete bugFile;
+	bugFile = NULL;
+
+	stilIndex.MakeEmpty();
+	bugIndex.MakeEmpty();
+	baseDir.MakeEmpty();
+
 	try
 	{
 		// Attempt to open STIL
@@ -112,12 +118,12 @@ bool SIDStil::SetBaseDir(PString pathToHVSC)
 		// new file, too
 		stilVersion = 0.0f;
 
-		if (GetDirs(stilFile, tempStilDirs, true) != true)
+		if (BuildIndex(stilFile, stilIndex, true) != true)
 			throw PUserException();
 
 		if (bugFile != NULL)
 		{
-			if (GetDirs(bugFile, tempBugDirs, false) != true)
+			if (BuildIndex(bugFile, bugIndex, false) != true)
 			{
 				// This is not a critical error - it is possible that the
 				// BUGlist.txt file has no entries in it at all (in fact, that's
@@ -135,43 +141,27 @@ bool SIDStil::SetBaseDir(PString pathToHVSC)
 		delete stilFile;
 		stilFile = NULL;
 
-		// Delete the directory lists
-		DeleteDirList(tempStilDirs);
-		DeleteDirList(tempBugDirs);
-
-		// Copy back the original version
-		stilVersion = tempStilVersion;
+		// Delete the indexes
+		stilIndex.MakeEmpty();
+		bugIndex.MakeEmpty();
 
 		return (false);
 	}
 
 	// Close the files
 	stilFile->Close();
-	bugFile->Close();
 
-	// Now we can copy the stuff into private data.
-	// NOTE: At this point, stilVersion should contain the new info!
-	//
+	if (bugFile != NULL)
+		bugFile->Close();
+
 	// Remember the base directory
 	baseDir = pathToHVSC;
 
-	// First, delete whatever may have been there previously
-	DeleteDirList(stilDirs);
-	DeleteDirList(bugDirs);
-
-	// Now proceed with copy
-	CopyDirList(stilDirs, tempStilDirs);
-	CopyDirList(bugDirs, tempBugDirs);
-
 	// Clear the buffers (caches)
 	entryBuf.MakeEmpty();
 	globalBuf.MakeEmpty();
 	bugBuf.MakeEmpty();
 
-	// Cleanup
-	DeleteDirList(tempStilDirs);
-	DeleteDirList(tempBugDirs);
-
 	return (true);
 }
 
@@ -232,7 +222,7 @@ PString SIDStil::GetGlobalComment(PString relPathToEntry)
 
 			stilFile->Open(tempDir.GetDirectory() + "STIL.txt", PFile::pModeRead | PFile::pModeShareRead);
 
-			if (PositionToEntry(dir, stilFile, stilDirs) == false)
+			if (PositionToEntry(dir, stilFile, stilIndex) == false)
 			{
 				// Copy the dirname to the buffer
 				globalBuf = dir + "\n";
@@ -362,7 +352,7 @@ PString SIDStil::GetEntry(PString relPathToEntry, int32 tuneNo, STILField field)
 
 			stilFile->Open(tempDir.GetDirectory() + "STIL.txt", PFile::pModeRead | PFile::pModeShareRead);
 
-			if (PositionToEntry(relPathToEntry, stilFile, stilDirs) == false)
+			if (PositionToEntry(relPathToEntry, stilFile, stilIndex) == false)
 			{
 				// Copy the entry's name to the buffer
 				entryBuf = relPathToEntry + "\n";
@@ -443,7 +433,7 @@ PString SIDStil::GetAbsEntry(PString absPathToEntry, int32 tuneNo, STILField fie
 /******************************************************************************/
 PString SIDStil::GetBug(PString relPathToEntry, int32 tuneNo)
 {
-	if (baseDir.IsEmpty())
+	if (baseDir.IsEmpty() || (bugFile == NULL))
 		return ("");
 
 	// Older versions of STIL is detected
@@ -466,7 +456,7 @@ PString SIDStil::GetBug(PString relPathToEntry, int32 tuneNo)
 
 			bugFile->Open(tempDir.GetDirectory() + "BUGlist.txt", PFile::pModeRead | PFile::pModeShareRead);
 
-			if (PositionToEntry(relPathToEntry, bugFile, bugDirs) == false)
+			if (PositionToEntry(relPathToEntry, bugFile, bugIndex) == false)
 			{
 				// Copy the entry's name to the buffer
 				bugBuf = relPathToEntry + "\n";
@@ -533,288 +523,118 @@ PString SIDStil::GetAbsBug(PString absPathToEntry, int32 tuneNo)
 
 
 /******************************************************************************/
-/* GetDirs() populates the given dirList array with the directories obtained  */
-/*      from 'inFile' for faster positioning within 'inFile'.                 */
+/* BuildIndex() reads the whole of 'inFile' in one go and stores the file     */
+/*      position of every entry in the index, keyed by the HVSC path of the   */
+/*      entry. Section-global comments are stored by their directory name.    */
 /*                                                                            */
-/* Input:  "inFile" is where to read the directories from.                    */
-/*         "dirs" is the list that should be populated with the directory     */
-/*         list.                                                              */
+/* Input:  "inFile" is where to read the entries from.                        */
+/*         "index" is the index that should be filled.                        */
 /*         "isStilFile" indicates if the file is a STIL or BUGlist file.      */
 /*                                                                            */
 /* Output: False - No entries were found or otherwise failed to process       */
 /*         inFile.                                                            */
 /*         True - Everything is okay.                                         */
 /******************************************************************************/
-bool SIDStil::GetDirs(PFile *inFile, PList<DirList *> &dirs, bool isStilFile)
+bool SIDStil::BuildIndex(PFile *inFile, PSkipList<PString, int32> &index, bool isStilFile)
 {
-	PString line, temp;
-	char *tempStr;
-	int32 i = 0;
-	int32 j;
-	bool newDir;
-	DirList *item;
-	int32 startPos;
+	char *text = NULL;
+	int32 textLen;
+	int32 lineStart, lineEnd, keyEnd;
+	PString key;
+	bool retVal = true;
 	PCharSet_MS_WIN_1252 charSet;
 
 	try
 	{
-		if (isStilFile)
-			newDir = false;
-		else
-			newDir = true;
+		// Read the whole file into memory
+		textLen = (int32)inFile->GetLength();
+		text    = new char[textLen + 1];
+		if (text == NULL)
+			throw PMemoryException();
 
 		inFile->SeekToBegin();
+		if (inFile->Read(text, textLen) != textLen)
+			throw PUserException();
 
-		while (!inFile->IsEOF())
-		{
-			// Remember the start of line position
-			startPos = inFile->GetPosition();
+		text[textLen] = 0x00;
 
-			// Read the next line
-			line = inFile->ReadLine(&charSet);
+		lineStart = 0;
+		while (lineStart < textLen)
+		{
+			// Find the end of the line
+			lineEnd = lineStart;
+			while ((lineEnd < textLen) && (text[lineEnd] != '\n') && (text[lineEnd] != '\r'))
+				lineEnd++;
 
-			// Try to extract STIL's version number if it's not done, yet
-			if (isStilFile && (stilVersion == 0.0f))
+			if (text[lineStart] == '/')
 			{
-				if (line.Left(9) == "#  STIL v")
-				{
-					// Get the version number
-					temp        = line.Mid(9);
-					tempStr     = temp.GetString();
-					stilVersion = atof(tempStr);
-					temp.FreeBuffer(tempStr);
-					continue;
-				}
+				// This is the start of an entry. Older versions of STIL may
+				// have the tune designation on the same line, so the key
+				// stops at the first space
+				keyEnd = lineStart;
+				while ((keyEnd < lineEnd) && (text[keyEnd] != ' ') && (text[keyEnd] != '\t'))
+					keyEnd++;
+
+				// Only the first entry of a path is used, like
+				// the old sequential search did
+				key.SetString(text + lineStart, keyEnd - lineStart, &charSet);
+				index.InsertItem(key, lineStart);
 			}
-
-			// Search for the start of a dir separator first
-			if (isStilFile && !newDir && (line.Left(4) == "### "))
+			else
 			{
-				newDir = true;
-				continue;
+				// Try to extract STIL's version number if it's not done, yet
+				if (isStilFile && (stilVersion == 0.0f) && (strncmp(text + lineStart, "#  STIL v", 9) == 0))
+					stilVersion = atof(text + lineStart + 9);
 			}
 
-			// Is this the start of an entry immediately following a dir separator?
-			if (newDir && !line.IsEmpty() && (line.GetAt(0) == '/'))
-			{
-				// Get the directory only
-				j = line.ReverseFind('/') + 1;
-
-				if (!isStilFile)
-				{
-					// Compare it to the last stored dirname
-					if (i == 0)
-						newDir = true;
-					else
-					{
-						if (dirs.GetItem(i - 1)->dirName != line.Left(j))
-							newDir = true;
-						else
-							newDir = false;
-					}
-				}
-
-				// Store the info
-				if (newDir)
-				{
-					item = new DirList;
-					if (item == NULL)
-						throw PMemoryException();
-
-					item->dirName  = line.Left(j);
-					item->position = startPos;
+			// Skip the line ending
+			if ((lineEnd < textLen - 1) && (text[lineEnd] == '\r') && (text[lineEnd + 1] == '\n'))
+				lineEnd++;
 
-					dirs.AddTail(item);
-					i++;
-				}
-
-				if (isStilFile)
-					newDir = false;
-				else
-					newDir = true;
-			}
+			lineStart = lineEnd + 1;
 		}
 
-		if (i == 0)
-		{
-			// No entries found - something is wrong.
-			// NOTE: It's perfectly valid to have a BUGlist.txt file with no
-			// entries in it!
-			return (false);
-		}
+		// No entries found - something is wrong.
+		// NOTE: It's perfectly valid to have a BUGlist.txt file with no
+		// entries in it!
+		if (index.CountItems() == 0)
+			retVal = false;
 	}
 	catch(...)
 	{
-		return (false);
+		retVal = false;
 	}
 
-	return (true);
-}
-
-
-
-/******************************************************************************/
-/* DeleteDirList() deletes *all* of the list of dirnames.                     */
-/*                                                                            */
-/* Input:  "dirs" is a reference to the list to delete.                       */
-/******************************************************************************/
-void SIDStil::DeleteDirList(PList<DirList *> &dirs)
-{
-	DirList *item;
-	int32 i, count;
-
-	count = dirs.CountItems();
-	for (i = 0; i < count; i++)
-	{
-		item = dirs.GetItem(i);
-		delete item;
-	}
+	delete[] text;
 
-	dirs.MakeEmpty();
-}
-
-
-
-/******************************************************************************/
-/* CopyDirList() copies the list of dirnames from one list to another. It     */
-/*      creates new dirlist entries in the destination list as needed.        */
-/*                                                                            */
-/* Input:  "toList" is a reference to the destination list.                   */
-/*         "fromList" is a reference to the source list.                      */
-/******************************************************************************/
-void SIDStil::CopyDirList(PList<DirList *> &toList, PList<DirList *> &fromList)
-{
-	DirList *sourceItem, *destItem;
-	int32 i, count;
-
-	count = fromList.CountItems();
-	for (i = 0; i < count; i++)
-	{
-		sourceItem = fromList.GetItem(i);
-
-		destItem = new DirList;
-		if (destItem == NULL)
-			throw PMemoryException();
-
-		destItem->dirName  = sourceItem->dirName;
-		destItem->position = sourceItem->position;
-
-		toList.AddTail(destItem);
-	}
+	return (retVal);
 }
 
 
 
 /******************************************************************************/
 /* PositionToEntry() positions the file pointer to the given entry in         */
-/*      'inFile' using the 'dirs' dirList for faster positioning.             */
+/*      'inFile' by looking it up in the 'index'.                             */
 /*                                                                            */
 /* Input:  "entryStr" is the entry to position to.                            */
 /*         "inFile" is a pointer to the file to change the position in.       */
-/*         "dirs" is a reference to the list to use for faster positioning.   */
+/*         "index" is a reference to the index of the file.                   */
 /*                                                                            */
 /* Output: True for success, false for an error.                              */
 /******************************************************************************/
-bool SIDStil::PositionToEntry(PString entryStr, PFile *inFile, PList<DirList *> &dirs)
+bool SIDStil::PositionToEntry(PString entryStr, PFile *inFile, const PSkipList<PString, int32> &index)
 {
-	DirList *item = NULL;
-	int32 slashIndex;
-	int32 startPos;
-	int32 i, count;
-	int32 pathLen, entryStrLen;
-	PString line;
-	bool foundIt = false;
-	bool globComm = false;
-	bool temp;
-	PCharSet_MS_WIN_1252 charSet;
+	int32 position;
+
+	// Find the entry in the index
+	if (!index.GetItem(entryStr, position))
+		return (false);
 
 	try
 	{
-		// Seek to the start of the file
-		inFile->SeekToBegin();
-
-		// Get the dirpath
-		slashIndex = entryStr.ReverseFind('/');
-
-		// If no slash was found, something is screwed up in the entryStr
-		if (slashIndex == -1)
-			return (false);
-
-		pathLen = slashIndex + 1;
-
-		// Determine whether a section-global comment is asked for
-		entryStrLen = entryStr.GetLength();
-		if (pathLen == entryStrLen)
-			globComm = true;
-
-		// Find it in the table
-		count = dirs.CountItems();
-		for (i = 0; i < count; i++)
-		{
-			item = dirs.GetItem(i);
-			if (entryStr.Left(pathLen) == item->dirName)
-			{
-				foundIt = true;
-				break;
-			}
-		}
-
-		if (!foundIt)
-		{
-			// The directory was not found
-			return (false);
-		}
-
-		// Jump to the first entry of this section
-		inFile->Seek(item->position, PFile::pSeekBegin);
-		foundIt = false;
-
-		// Now find the desired entry
-		do
-		{
-			startPos = inFile->GetPosition();
-			line     = inFile->ReadLine(&charSet);
-
-			if (inFile->IsEOF())
-				break;
-
-			// Check if it is the start of an entry
-			if (!line.IsEmpty() && (line.GetAt(0) == '/'))
-			{
-				if (line.Left(pathLen) != item->dirName)
-				{
-					// We are outside the section - get out of the loop,
-					// which will fail the search
-					break;
-				}
-
-				// Check whether we need to find a section-global comment or
-				// a specific entry
-				if (globComm || (stilVersion > 2.59f))
-					temp = (line == entryStr);
-				else
-				{
-					// To be compatible with older versions of STIL, which may have
-					// the tune designation on the first line of a STIL entry
-					// together with the pathname
-					temp = (line.Left(entryStrLen) == entryStr);
-				}
-
-				if (temp)
-				{
-					// Found it!
-					foundIt = true;
-				}
-			}
-		}
-		while (!foundIt);
-
-		if (foundIt)
-		{
-			// Reposition the file pointer back to the start of the entry
-			inFile->Seek(startPos, PFile::pSeekBegin);
-			return (true);
-		}
+		// Jump to the entry
+		inFile->Seek(position, PFile::pSeekBegin);
+		return (true);
 	}
 	catch(PFileException e)
 	{
@@ -841,14 +661,17 @@ void SIDStil::ReadEntry(PFile *inFile, PString &buffer)
 
 	try
 	{
-		do
+		// Entries are short, so only read a small chunk at the time
+		PLineReader reader(inFile, &charSet, 2048);
+
+		while (reader.ReadLine(line))
 		{
-			line = inFile->ReadLine(&charSet);
+			if (line.IsEmpty())
+				break;
+
 			buffer += line;
-			if (!line.IsEmpty())
-				buffer += "\n";
+			buffer += "\n";
 		}
-		while(!line.IsEmpty());
 	}
 	catch(PFileException e)
 	{
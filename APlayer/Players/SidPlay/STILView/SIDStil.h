@@ -16,7 +16,7 @@
 #include "POS.h"
 #include "PString.h"
 #include "PFile.h"
-#include "PList.h"
+#include "PSkipList.h"
 
 
 /******************************************************************************/
@@ -43,17 +43,8 @@ public:
 	PString GetAbsBug(PString absPathToEntry, int32 tuneNo = 0);
 
 protected:
-	typedef struct DirList
-	{
-		PString dirName;
-		int32 position;
-	} DirList;
-
-	bool GetDirs(PFile *inFile, PList<DirList *> &dirs, bool isStilFile);
-	void DeleteDirList(PList<DirList *> &dirs);
-	void CopyDirList(PList<DirList *> &toList, PList<DirList *> &fromList);
-
-	bool PositionToEntry(PString entryStr, PFile *inFile, PList<DirList *> &dirs);
+	bool BuildIndex(PFile *inFile, PSkipList<PString, int32> &index, bool isStilFile);
+	bool PositionToEntry(PString entryStr, PFile *inFile, const PSkipList<PString, int32> &index);
 	void ReadEntry(PFile *inFile, PString &buffer);
 
 	bool GetField(PString &result, PString buffer, int32 tuneNo = 0, STILField field = all);
@@ -66,8 +57,8 @@ protected:
 	PCacheFile *stilFile;
 	PCacheFile *bugFile;
 
-	PList<DirList *> stilDirs;
-	PList<DirList *> bugDirs;
+	PSkipList<PString, int32> stilIndex;
+	PSkipList<PString, int32> bugIndex;
 
 	PString globalBuf;
 	PString entryBuf;
@@ -91,6 +91,12 @@ SIDView::SIDView(PResource *resource) : BView(BRect(0.0f, 0.0f, 0.0f, 0.0f), NUL
 	generalBox->AddChild(forceSpeedCheck);
 	label.FreeBuffer(labelPtr);
 
+	message = new BMessage(SID_CHECK_CYCLE);
+	label.LoadString(res, IDS_SID_CFG_CYCLEEXACT);
+	cycleExactCheck = new BCheckBox(rect, NULL, (labelPtr = label.GetString()), message);
+	generalBox->AddChild(cycleExactCheck);
+	label.FreeBuffer(labelPtr);
+
 	//
 	// Create "MPU Memory Mode" box
 	//
@@ -276,6 +282,13 @@ SIDView::SIDView(PResource *resource) : BView(BRect(0.0f, 0.0f, 0.0f, 0.0f), NUL
 
 	forceSpeedCheck->SetValue(value);
 
+	if (sidSettings->GetStringEntryValue("General", "CycleExact").CompareNoCase("Yes") == 0)
+		value = B_CONTROL_ON;
+	else
+		value = B_CONTROL_OFF;
+
+	cycleExactCheck->SetValue(value);
+
 	// Setup "MPU memory mode"
 	switch (sidSettings->GetIntEntryValue("MPU", "Memory"))
 	{
@@ -416,6 +429,20 @@ void SIDView::MessageReceived(BMessage *message)
 			break;
 		}
 
+		////////////////////////////////////////////////////////////////////////
+		// Cycle exact checkbox
+		////////////////////////////////////////////////////////////////////////
+		case SID_CHECK_CYCLE:
+		{
+			if (cycleExactCheck->Value() == B_CONTROL_ON)
+				strValue = "Yes";
+			else
+				strValue = "No";
+
+			sidSettings->WriteStringEntryValue("General", "CycleExact", strValue);
+			break;
+		}
+
 		////////////////////////////////////////////////////////////////////////
 		// Full bank-switching radio button
 		////////////////////////////////////////////////////////////////////////
@@ -706,6 +733,9 @@ BPoint SIDView::CalcMinSize(void)
 	forceSpeedCheck->GetPreferredSize(&sw, &sh);
 	w = max(sw, w);
 
+	cycleExactCheck->GetPreferredSize(&sw, &sh);
+	w = max(sw, w);
+
 	fullRadio->GetPreferredSize(&sw, &sh);
 	w = max(sw, w);
 
@@ -763,6 +793,9 @@ void SIDView::SetPosAndSize(void)
 	forceSpeedCheck->GetPreferredSize(&w, &controlHeight);
 	controlWidth = max(controlWidth, w);
 
+	cycleExactCheck->GetPreferredSize(&w, &controlHeight);
+	controlWidth = max(controlWidth, w);
+
 	fullRadio->GetPreferredSize(&w, &controlHeight);
 	controlWidth = max(controlWidth, w);
 
@@ -791,6 +824,10 @@ void SIDView::SetPosAndSize(void)
 	forceSpeedCheck->MoveTo(HSPACE, y);
 	forceSpeedCheck->ResizeTo(controlWidth, controlHeight);
 
+	y += (controlHeight + VSPACE);
+	cycleExactCheck->MoveTo(HSPACE, y);
+	cycleExactCheck->ResizeTo(controlWidth, controlHeight);
+
 	w = max(controlWidth, B_DEFAULT_MITER_LIMIT * 2.0f + generalBox->StringWidth(generalBox->Label()));
 	w = max(controlWidth, B_DEFAULT_MITER_LIMIT * 2.0f + memoryBox->StringWidth(memoryBox->Label()));
 	w = max(controlWidth, B_DEFAULT_MITER_LIMIT * 2.0f + speedBox->StringWidth(speedBox->Label()));
@@ -830,7 +867,7 @@ void SIDView::SetPosAndSize(void)
 	ntscRadio->MoveTo(HSPACE, y);
 	ntscRadio->ResizeTo(controlWidth, controlHeight);
 
-	speedBox->MoveTo(HSPACE, VSPACE + (h + VSPACE * 3.0f) * 2.0f);
+	speedBox->MoveTo(HSPACE, memoryBox->Frame().bottom + VSPACE * 3.0f);
 	h = fontHeight + 3.0f * VSPACE + (y + controlHeight - (fontHeight + VSPACE));
 	speedBox->ResizeTo(w, h);
 
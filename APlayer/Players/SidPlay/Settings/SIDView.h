@@ -54,6 +54,7 @@
 #define SID_CHECK_FILTER				'_cfi'
 #define SID_CHECK_8580					'_mos'
 #define SID_CHECK_SPEED					'_spd'
+#define SID_CHECK_CYCLE					'_cyc'
 
 #define SID_RADIO_FULLBANK				'_ful'
 #define SID_RADIO_TRANSPARENT			'_tra'
@@ -104,6 +105,7 @@ protected:
 	BCheckBox *filterCheck;
 	BCheckBox *mos8580Check;
 	BCheckBox *forceSpeedCheck;
+	BCheckBox *cycleExactCheck;
 
 	BBox *memoryBox;
 	BRadioButton *fullRadio;
@@ -40,13 +40,6 @@
 
 
 
-/******************************************************************************/
-/* Macros                                                                     */
-/******************************************************************************/
-#define BUFSIZE				1024
-
-
-
 /******************************************************************************/
 /* Global variables                                                           */
 /******************************************************************************/
@@ -101,22 +94,6 @@ TFMX::TFMX(APGlobalData *global, PString fileName) : APAddOnPlayer(global)
 	sampleData  = NULL;
 	sampleEnd   = NULL;
 
-	tbuf[0]     = NULL;
-	tbuf[1]     = NULL;
-	tbuf[2]     = NULL;
-	tbuf[3]     = NULL;
-	tbuf[4]     = NULL;
-	tbuf[5]     = NULL;
-	tbuf[6]     = NULL;
-
-	outBuf[0]   = NULL;
-	outBuf[1]   = NULL;
-	outBuf[2]   = NULL;
-	outBuf[3]   = NULL;
-	outBuf[4]   = NULL;
-	outBuf[5]   = NULL;
-	outBuf[6]   = NULL;
-
 	// Allocate the resource object
 	res = new PResource(fileName);
 	if (res == NULL)
@@ -169,7 +146,7 @@ int32 TFMX::GetCount(void)
 /******************************************************************************/
 uint32 TFMX::GetSupportFlags(int32 index)
 {
-	return (appSamplePlayer | appSetPosition);
+	return (appSetPosition);
 }
 
 
@@ -402,11 +379,8 @@ ap_result TFMX::LoadModule(int32 index, PFile *file, PString &errorStr)
 		sh = (uint16 *)&musicData[trackStart];
 		numTS = (patterns[0] - trackStart) >> 2;
 
-		while (sh < lg)
-		{
-			x = P_BENDIAN_TO_HOST_INT16(*sh);
-			*sh++ = (uint16)x;
-		}
+		if (sh < lg)
+			PFile::ConvertArray_B_UINT16s(sh, lg - sh);
 
 		// Now the song is fully loaded, except for the sample data.
 		// Everything is done but fixing endianess on the actual
@@ -510,8 +484,6 @@ ap_result TFMX::LoadModule(int32 index, PFile *file, PString &errorStr)
 /******************************************************************************/
 bool TFMX::InitPlayer(int32 index)
 {
-	int32 i;
-
 	// Remember the module type
 	modType = (ModType)index;
 
@@ -531,36 +503,6 @@ bool TFMX::InitPlayer(int32 index)
 	else
 		multiMode = 0;
 
-	// Allocate mixer buffers
-	for (i = 0; i < 4; i++)
-	{
-		tbuf[i] = new int32[BUFSIZE];
-		if (tbuf[i] == NULL)
-			throw PMemoryException();
-
-		memset(tbuf[i], 0, BUFSIZE * sizeof(int32));
-
-		outBuf[i] = new int16[BUFSIZE];
-		if (outBuf[i] == NULL)
-			throw PMemoryException();
-	}
-
-	if (multiMode)
-	{
-		for (i = 4; i < 7; i++)
-		{
-			tbuf[i] = new int32[BUFSIZE];
-			if (tbuf[i] == NULL)
-				throw PMemoryException();
-
-			memset(tbuf[i], 0, BUFSIZE * sizeof(int32));
-
-			outBuf[i] = new int16[BUFSIZE];
-			if (outBuf[i] == NULL)
-				throw PMemoryException();
-		}
-	}
-
 	// Calculate the time for each subsong
 	CalcTimes();
 
@@ -602,6 +544,8 @@ void TFMX::InitSound(int32 index, uint16 songNum)
 	// Initialize the player
 	TfmxInit();
 	StartSong(songNum, 0);
+
+	playFreq = 715909.0f / eClocks;
 }
 
 
@@ -611,94 +555,44 @@ void TFMX::InitSound(int32 index, uint16 songNum)
 /******************************************************************************/
 void TFMX::Play(void)
 {
-	static int32 nb = 0, bd = 0;	// Num bytes, bytes done
-	int32 n;
-	bool stop = false;
+	int32 numSamples;
 
-	while (bd < BUFSIZE)
+	if (mdb.playerEnable)
 	{
-		while (nb > 0)
-		{
-			n = BUFSIZE - bd;
-
-			if (n > nb)
-				n = nb;
-
-			MixIt(n, bd);
-
-			bd    += n;
-			nb    -= n;
-
-			if (bd == BUFSIZE)
-			{
-				stop = true;
-				break;
-			}
-		}
-
-		if (stop)
-			break;
+		DoAllMacros();
 
-		if (mdb.playerEnable)
-		{
-			DoAllMacros();
-
-			if (mdb.currSong >= 0)
-				DoTracks();
-
-			nb    = (eClocks * (outRate >> 1));
-			eRem += (nb % 357955);
-			nb   /= 357955;
-
-			if (eRem > 357955)
-			{
-				nb++;
-				eRem -= 357955;
-			}
-		}
-		else
-			bd = BUFSIZE;
+		if (mdb.currSong >= 0)
+			DoTracks();
 	}
 
-	Conv16(tbuf[0], outBuf[0], bd);
-	Conv16(tbuf[1], outBuf[1], bd);
-	Conv16(tbuf[2], outBuf[2], bd);
-	Conv16(tbuf[3], outBuf[3], bd);
+	// Find out how many samples the mixer will play before the next tick
+	numSamples  = (eClocks * (outRate >> 1));
+	eRem       += (numSamples % 357955);
+	numSamples /= 357955;
 
-	if (multiMode)
+	if (eRem > 357955)
 	{
-		Conv16(tbuf[4], outBuf[4], bd);
-		Conv16(tbuf[5], outBuf[5], bd);
-		Conv16(tbuf[6], outBuf[6], bd);
+		numSamples++;
+		eRem -= 357955;
 	}
 
-	bd = 0;
-
 	// Tell APlayer what to play
-	SetupChannel(0);
-	SetupChannel(1);
-	SetupChannel(2);
-	SetupChannel(3);
-
 	if (multiMode)
 	{
-		SetupChannel(4);
-		SetupChannel(5);
-		SetupChannel(6);
+		SetupChannel(3, &hdb[4], numSamples);
+		SetupChannel(4, &hdb[5], numSamples);
+		SetupChannel(5, &hdb[6], numSamples);
+		SetupChannel(6, &hdb[7], numSamples);
 	}
-}
-
+	else
+		SetupChannel(3, &hdb[3], numSamples);
 
+	SetupChannel(0, &hdb[0], numSamples);
+	SetupChannel(1, &hdb[1], numSamples);
+	SetupChannel(2, &hdb[2], numSamples);
 
-/******************************************************************************/
-/* GetSamplePlayerInfo() will fill out the sample info structure given.       */
-/*                                                                            */
-/* Input:  "sampInfo" is a pointer to the sample info structure to fill.      */
-/******************************************************************************/
-void TFMX::GetSamplePlayerInfo(APSamplePlayerInfo *sampInfo)
-{
-	sampInfo->bitSize   = 16;
-	sampInfo->frequency = outRate;
+	// The tracks may have changed the CIA timer
+	playFreq = 715909.0f / eClocks;
 }
 
 
@@ -796,6 +690,7 @@ void TFMX::SetSongPosition(int16 pos)
 	posInfo      = songTime->posInfoList.GetItem(pos);
 	mdb.ciaSave  = eClocks = posInfo.cia;
 	mdb.speedCnt = pdb.prescale = posInfo.speed;
+	playFreq     = 715909.0f / eClocks;
 
 	// Change the position
 	pdb.currPos = pdb.firstPos + pos;
@@ -1289,16 +1184,6 @@ void TFMX::Cleanup(void)
 
 	songTimeList.MakeEmpty();
 
-	// Delete mixer buffers
-	for (i = 0; i < 7; i++)
-	{
-		delete[] outBuf[i];
-		outBuf[i] = NULL;
-
-		delete[] tbuf[i];
-		tbuf[i] = NULL;
-	}
-
 	// Delete the module
 	delete[] sampleData;
 	delete[] musicData;
@@ -1663,24 +1548,111 @@ bool TFMX::DoAChannelRow(struct Pdb *p1, struct Pdb *p, int32 chan)
 
 
 /******************************************************************************/
-/* SetupChannel() setup the APlayer channel.                                  */
+/* SetupChannel() tells the APlayer channel what the "hardware" plays and     */
+/*      moves the DMA position forward, so the macros waiting on the DMA will */
+/*      continue at the right time.                                           */
 /*                                                                            */
 /* Input:  "chan" is the channel number.                                      */
+/*         "hw" is a pointer to the "hardware" information.                   */
+/*         "numSamples" is the number of samples played before the next tick. */
 /******************************************************************************/
-void TFMX::SetupChannel(int32 chan)
+void TFMX::SetupChannel(int32 chan, struct Hdb *hw, int32 numSamples)
 {
 	APChannel *channel;
+	uint64 ps;
+	uint32 l, length;
+	uint16 v;
 
 	channel = virtChannels[chan];
 
-	// Fill out the Channel object
-	channel->SetBuffer(outBuf[chan], BUFSIZE);
-	channel->SetVolume(256);
-
 	if (multiMode)
 		channel->SetPanning(pan7[chan]);
 	else
 		channel->SetPanning(pan4[chan]);
+
+	if ((hw->sampleStart < sampleData) || (hw->sBeg < sampleData) ||
+		(hw->sampleStart >= sampleEnd) || (hw->sBeg >= sampleEnd))
+	{
+		channel->Mute();
+		return;
+	}
+
+	// This is used to have (p == &sampleData).  Broke with GrandMonsterSlam
+	if ((hw->sBeg == (int8 *)&nul) || ((hw->mode & 1) == 0) || (hw->sLen < 4))
+	{
+		channel->Mute();
+		return;
+	}
+
+	// Start the DMA if it has just been turned on
+	if ((hw->mode & 3) == 1)
+	{
+		hw->sBeg     = hw->sampleStart;
+		hw->sLen     = hw->sampleLength;
+		hw->pos      = 0;
+		hw->mode    |= 2;
+		hw->trigger  = true;
+	}
+
+	// Never let the mixer play outside the sample data
+	// (Apidya Title, R-Type and others set the registers wrong)
+	if (hw->trigger)
+	{
+		length = min((uint32)hw->sLen, (uint32)(sampleEnd - hw->sBeg));
+		channel->PlaySample(hw->sBeg, 0, length);
+		hw->trigger = false;
+	}
+
+	// Paula reloads the sample registers when the sample ends, which
+	// is the same as an APlayer loop
+	if (hw->sampleLength >= 4)
+	{
+		length = min((uint32)hw->sampleLength, (uint32)(sampleEnd - hw->sampleStart));
+		channel->SetLoop(hw->sampleStart, 0, length);
+	}
+	else
+		channel->SetLoop(&nul, 0, sizeof(nul));
+
+	if (hw->period != 0)
+		channel->SetFrequency(3579545 / hw->period);
+
+	v = hw->vol;
+	if (v > 0x40)
+		v = 0x40;
+
+	channel->SetVolume(v * 4);
+
+	// Move the DMA position forward
+	ps = hw->pos + (uint64)hw->delta * numSamples;
+	l  = hw->sLen << 14;
+
+	while (ps >= l)
+	{
+		ps      -= l;
+		hw->sBeg = hw->sampleStart;
+
+		if (((l = ((hw->sLen = hw->sampleLength) << 14)) < 0x10000) || (!hw->loop(hw)))
+		{
+			// The DMA stops when the sample playing now ends, so
+			// don't let the mixer continue with the loop set above
+			channel->SetLoop(&nul, 0, sizeof(nul));
+
+			hw->sLen  = 0;
+			hw->sBeg  = sampleData;
+			hw->delta = 0;
+			ps        = 0;
+			break;
+		}
+
+		// When nothing waits on the DMA any more, skip the rest of the loops
+		if (hw->loop == &LoopOff)
+			ps %= l;
+	}
+
+	hw->pos = ps;
+
+	if (hw->mode & 4)
+		hw->mode = 0;
 }
 
 
@@ -1900,6 +1872,7 @@ loop:
 				c->hw->sLen         = c->hw->sampleLength;
 				c->hw->pos          = 0;
 				c->hw->mode        |= 2;
+				c->hw->trigger      = true;
 				break;
 			}
 			else
@@ -2381,7 +2354,8 @@ void TFMX::DoMacro(int32 cc)
 	DoEffects(c);
 
 	// Has to be here because of if (efxRun = 1)
-	c->hw->delta = (c->curPeriod) ? (3579545 << 9) / (c->curPeriod * outRate >> 5) : 0;
+	c->hw->period = c->curPeriod;
+	c->hw->delta  = (c->curPeriod) ? (3579545 << 9) / (c->curPeriod * outRate >> 5) : 0;
 	c->hw->sampleStart = &sampleData[c->saveAddr];
 
 	c->hw->sampleLength = (c->saveLen) ? c->saveLen << 1 : 131072;
@@ -2971,122 +2945,3 @@ void TFMX::StartSong(int32 song, int32 mode)
 	mdb.speedCnt = mdb.endFlag = 0;
 	mdb.playerEnable = 1;
 }
-
-
-
-/******************************************************************************/
-/* Conv16() converts a sample buffer to 16 bit.                               */
-/*                                                                            */
-/* Input:  "b" is a pointer to the buffer to convert.                         */
-/*         "out" is a pointer to the destination buffer.                      */
-/*         "num" is the number of samples to convert.                         */
-/******************************************************************************/
-void TFMX::Conv16(int32 *b, int16 *out, int32 num)
-{
-	int32 x;
-	int32 *c = b;
-	int16 *a = out;
-
-	for (x = 0; x < num; x++)
-		*a++ = (*c++);
-
-	// Clear source buffer
-	memset(b, 0, num * sizeof(int32));
-}
-
-
-
-/******************************************************************************/
-/* MixIt() generate the sample data for all channels.                         */
-/*                                                                            */
-/* Input:  "n" is the number of samples to mix.                               */
-/*         "b" is the number of samples done so far.                          */
-/******************************************************************************/
-void TFMX::MixIt(int32 n, int32 b)
-{
-	if (multiMode)
-	{
-		MixAdd(&hdb[4], n, &tbuf[3][b]);
-		MixAdd(&hdb[5], n, &tbuf[4][b]);
-		MixAdd(&hdb[6], n, &tbuf[5][b]);
-		MixAdd(&hdb[7], n, &tbuf[6][b]);
-	}
-	else
-		MixAdd(&hdb[3], n, &tbuf[3][b]);
-
-	MixAdd(&hdb[0], n, &tbuf[0][b]);
-	MixAdd(&hdb[1], n, &tbuf[1][b]);
-	MixAdd(&hdb[2], n, &tbuf[2][b]);
-}
-
-
-
-/******************************************************************************/
-/* MixAdd() generate the sample data for one channel.                         */
-/*                                                                            */
-/* Input:  "hw" is a pointer to the "hardware" information.                   */
-/*         "n" is the number of samples to generate.                          */
-/*         "b" is a pointer to store the sample data.                         */
-/******************************************************************************/
-void TFMX::MixAdd(struct Hdb *hw, int32 n, int32 *b)
-{
-	register int8 *p = hw->sBeg;
-	register uint32 ps = hw->pos;
-	int32 v = hw->vol;
-	uint32 d = hw->delta;
-	uint32 l = (hw->sLen << 14);
-
-	if ((hw->sampleStart < sampleData) || (hw->sBeg < sampleData))
-		return;
-
-	if ((hw->sampleStart >= sampleEnd) || (hw->sBeg >= sampleEnd))
-		return;
-
-	if (v > 0x40)
-		v = 0x40;
-
-	// This is used to have (p == &sampleData).  Broke with GrandMonsterSlam
-	if ((p == (int8 *)&nul) || ((hw->mode & 1) == 0) || (l < 0x10000))
-		return;
-
-	if ((hw->mode & 3) == 1)
-	{
-		p = hw->sBeg = hw->sampleStart;
-		l = (hw->sLen = hw->sampleLength) << 14;
-		ps = 0;
-		hw->mode |= 2;
-	}
-
-	while (n--)
-	{
-		// p[] went out of sampleData, when SetBegin messed up c->saveAddr (sBeg):
-		// p[] goes negative on repeated AddBegin:s (R-Type)
-		// p[] went out of sampleData on Apidya Title (Fix by Thomas Neumann)
-		int32 index = (ps += d) >> 14;
-
-		if ((p + index) >= sampleEnd)
-			(*b++) = 0x00;
-		else
-			(*b++) = p[index] * v * 4;
-
-		if (ps < l)
-			continue;
-
-		ps -= l;
-		p   = hw->sampleStart;
-
-		if (((l = ((hw->sLen = hw->sampleLength) << 14)) < 0x10000) || (!hw->loop(hw)))
-		{
-			hw->sLen = ps = d = 0;
-			p        = sampleData;
-			break;
-		}
-	}
-
-	hw->sBeg  = p;
-	hw->pos   = ps;
-	hw->delta = d;
-
-	if (hw->mode & 4)
-		hw->mode = 0;
-}
@@ -32,12 +32,14 @@ struct Hdb
 {
 	uint32 pos;
 	uint32 delta;
+	uint16 period;
 	uint16 sLen;
 	uint16 sampleLength;
 	int8 *sBeg;
 	int8 *sampleStart;
 	uint8 vol;
 	uint8 mode;
+	bool trigger;			// Set when the sample has to be restarted in the channel
 	int32 (*loop)(struct Hdb *);
 	int32 loopCnt;
 	struct Cdb *c;
@@ -266,7 +268,6 @@ public:
 	virtual void InitSound(int32 index, uint16 songNum);
 	virtual void Play(void);
 
-	virtual void GetSamplePlayerInfo(APSamplePlayerInfo *sampInfo);
 	virtual uint16 GetModuleChannels(void);
 	virtual const uint16 *GetSubSongs(void);
 
@@ -291,7 +292,7 @@ protected:
 	void CalcTimes(void);
 	bool DoAChannelRow(struct Pdb *p1, struct Pdb *p, int32 chan);
 
-	void SetupChannel(int32 chan);
+	void SetupChannel(int32 chan, struct Hdb *hw, int32 numSamples);
 
 	void NotePort(uint32 i);
 
@@ -312,10 +313,6 @@ protected:
 	void TfmxInit(void);
 	void StartSong(int32 song, int32 mode);
 
-	void Conv16(int32 *b, int16 *out, int32 num);
-	void MixIt(int32 n, int32 b);
-	void MixAdd(struct Hdb *hw, int32 n, int32 *b);
-
 	PResource *res;
 	ModType modType;
 	uint16 currentSong;
@@ -370,9 +367,6 @@ protected:
 
 	uint32 eClocks;
 	int32 eRem;
-
-	int32 *tbuf[7];
-	int16 *outBuf[7];
 };
 
 #endif
@@ -41,6 +41,7 @@ APClientCommunication::APClientCommunication(void) : BLooper("Server client add-
 {
 	// Add all the commands to the list
 	cmdList.InsertItem("AddFile", AddFile);
+	cmdList.InsertItem("CancelDurationScan", CancelDurationScan);
 	cmdList.InsertItem("CanChangePosition", CanChangePosition);
 	cmdList.InsertItem("ChangeChannels", ChangeChannels);
 	cmdList.InsertItem("DisableAddOn", DisableAddOn);
@@ -68,6 +69,7 @@ APClientCommunication::APClientCommunication(void) : BLooper("Server client add-
 	cmdList.InsertItem("RemoveFile", RemoveFile);
 	cmdList.InsertItem("ResumePlayer", ResumePlayer);
 	cmdList.InsertItem("SaveSettings", SaveSettings);
+	cmdList.InsertItem("ScanDurations", ScanDurations);
 	cmdList.InsertItem("SetMixerSettings", SetMixerSettings);
 	cmdList.InsertItem("SetOutputAgent", SetOutputAgent);
 	cmdList.InsertItem("SetPosition", SetPosition);
@@ -97,6 +99,9 @@ void APClientCommunication::Start(void)
 	// Tell the global data object about this looper
 	globalData->communication->SetServerLooper(this);
 
+	// Start the duration scanner
+	durationScanner.Start();
+
 	// Start the BLooper
 	Run();
 }
@@ -111,6 +116,9 @@ void APClientCommunication::Stop(void)
 	BMessenger messenger(NULL, this);
 	BMessage message(B_QUIT_REQUESTED);
 
+	// Stop the duration scanner, so no more results are sent
+	durationScanner.Stop();
+
 	// Tell the BLooper to quit and delete itself
 	// This call is synchronous, so we are sure the
 	// object has been deleted when the function
@@ -131,11 +139,9 @@ void APClientCommunication::SendCommand(APPlayer *player, PString command)
 	BMessage message(APSERVER_MSG_DATA);
 	APFileHandle handle;
 	int32 i, count;
-	char *commandStr;
 
 	// Package the command into the message
-	message.AddString("Command", (commandStr = command.GetString()));
-	command.FreeBuffer(commandStr);
+	message.AddString("Command", command.GetCString());
 
 	// Lock the file handle list
 	fileHandleList.LockList();
@@ -179,11 +185,9 @@ void APClientCommunication::SendCommandToAll(PString command)
 {
 	BMessage message(APSERVER_MSG_DATA);
 	int32 i, count;
-	char *commandStr;
 
 	// Package the command into the message
-	message.AddString("Command", (commandStr = command.GetString()));
-	command.FreeBuffer(commandStr);
+	message.AddString("Command", command.GetCString());
 
 	// Lock the client list
 	clientLoopers.LockList();
@@ -284,6 +288,19 @@ void APClientCommunication::UnlockSampleList(uint32 fileHandle)
 
 
 
+/******************************************************************************/
+/* GetDurationScanner() returns the duration scanner, so the players can add  */
+/*      the times they find to the duration cache.                            */
+/*                                                                            */
+/* Output: A pointer to the duration scanner.                                 */
+/******************************************************************************/
+APDurationScanner *APClientCommunication::GetDurationScanner(void)
+{
+	return (&durationScanner);
+}
+
+
+
 /******************************************************************************/
 /* MessageReceived() is called for each message sent to the looper.           */
 /*                                                                            */
@@ -353,6 +370,9 @@ void APClientCommunication::MessageReceived(BMessage *message)
 				// Unlock list
 				clientLoopers.UnlockList();
 
+				// Forget all the files the client wanted scanned
+				durationScanner.CancelFiles((BLooper *)looper);
+
 				// Send an ok back
 				message->SendReply(APSERVER_MSG_OK);
 
@@ -389,7 +409,6 @@ void APClientCommunication::MessageReceived(BMessage *message)
 				else
 				{
 					BMessage reply;
-					char *resultStr;
 
 					//
 					// FUTURE: Make each command to run in its own thread if possible
@@ -403,8 +422,7 @@ void APClientCommunication::MessageReceived(BMessage *message)
 					if (!result.IsEmpty())
 					{
 						// Add the result
-						reply.AddString("Result", (resultStr = result.GetString()));
-						result.FreeBuffer(resultStr);
+						reply.AddString("Result", result.GetCString());
 					}
 
 					// Send the reply
@@ -726,6 +744,36 @@ bool APClientCommunication::AddFile(APClientCommunication *comm, BLooper *looper
 
 
 
+/******************************************************************************/
+/* CancelDurationScan() will cancel all the duration scannings the client has */
+/*      asked for. No more "DurationScanned" commands will be sent to it.     */
+/*                                                                            */
+/* Syntax: CancelDurationScan=                                                */
+/*                                                                            */
+/* Input:  "comm" is a pointer to the communication object.                   */
+/*         "looper" is a pointer to the client looper that sent this command. */
+/*         "args" is a list with all the arguments                            */
+/*         "result" is where the result should be stored.                     */
+/*                                                                            */
+/* Output: True for success, false for failure.                               */
+/******************************************************************************/
+bool APClientCommunication::CancelDurationScan(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result)
+{
+	// Check the arguments
+	if (args.CountItems() != 0)
+	{
+		result.LoadString(GetApp()->resource, IDS_CMDERR_ARGLIST);
+		return (false);
+	}
+
+	// Cancel the jobs
+	comm->durationScanner.CancelFiles(looper);
+
+	return (true);
+}
+
+
+
 /******************************************************************************/
 /* CanChangePosition() will return if the player support position change.     */
 /*                                                                            */
@@ -1140,18 +1188,10 @@ bool APClientCommunication::EndPlayer(APClientCommunication *comm, BLooper * /*l
 	// Cleanup the player and mixer
 	handle.player->EndPlayer();
 
-	// Delete the player object
-	{
-		BMessenger messenger(NULL, handle.player);
-		BMessage message(B_QUIT_REQUESTED);
-
-		// Tell the BLooper to quit and delete itself
-		// This call is synchronous, so we are sure the
-		// object has been deleted when the function
-		// call returns
-		messenger.SendMessage(&message, &message);
-		handle.player = NULL;
-	}
+	// Delete the player object. The destructor waits until
+	// all the events already posted to it have been handled
+	delete handle.player;
+	handle.player = NULL;
 
 	// Set the handle back in the list
 	comm->SetFileHandle(uniqueID, handle);
@@ -1854,17 +1894,8 @@ bool APClientCommunication::InitPlayer(APClientCommunication *comm, BLooper * /*
 		// Couldn't initialize the player
 		//
 		// Delete the player object
-		{
-			BMessenger messenger(NULL, handle.player);
-			BMessage message(B_QUIT_REQUESTED);
-
-			// Tell the BLooper to quit and delete itself
-			// This call is synchronous, so we are sure the
-			// object has been deleted when the function
-			// call returns
-			messenger.SendMessage(&message, &message);
-			handle.player = NULL;
-		}
+		delete handle.player;
+		handle.player = NULL;
 
 		return (false);
 	}
@@ -2291,6 +2322,39 @@ bool APClientCommunication::SaveSettings(APClientCommunication * /*comm*/, BLoop
 
 
 
+/******************************************************************************/
+/* ScanDurations() will add the files to the duration scanner. The command    */
+/*      returns at once, and each result is sent back later as a              */
+/*      "DurationScanned" command with the file name, the default sub song    */
+/*      and the time of each sub song in milliseconds. If the time list is    */
+/*      empty, the file could not be scanned.                                 */
+/*                                                                            */
+/* Syntax: ScanDurations=<file name>[,<file name>...]                         */
+/*                                                                            */
+/* Input:  "comm" is a pointer to the communication object.                   */
+/*         "looper" is a pointer to the client looper that sent this command. */
+/*         "args" is a list with all the arguments                            */
+/*         "result" is where the result should be stored.                     */
+/*                                                                            */
+/* Output: True for success, false for failure.                               */
+/******************************************************************************/
+bool APClientCommunication::ScanDurations(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result)
+{
+	// Check the arguments
+	if (args.CountItems() == 0)
+	{
+		result.LoadString(GetApp()->resource, IDS_CMDERR_ARGLIST);
+		return (false);
+	}
+
+	// Add the files to the job queue
+	comm->durationScanner.AddFiles(looper, args);
+
+	return (true);
+}
+
+
+
 /******************************************************************************/
 /* SetMixerSettings() will change the mixer settings to use on the added      */
 /*      file. Send this command before you send the InitPlayer command.       */
@@ -23,6 +23,7 @@
 
 // Server headers
 #include "APModuleLoader.h"
+#include "APDurationScanner.h"
 
 
 /******************************************************************************/
@@ -80,6 +81,8 @@ public:
 	const PList<APSampleInfo *> *GetSampleList(uint32 fileHandle);
 	void UnlockSampleList(uint32 fileHandle);
 
+	APDurationScanner *GetDurationScanner(void);
+
 protected:
 	virtual void MessageReceived(BMessage *message);
 
@@ -91,6 +94,7 @@ protected:
 	void DisableVirtualMixer(AddOnInfo *agent);
 
 	static bool AddFile(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
+	static bool CancelDurationScan(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool CanChangePosition(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool ChangeChannels(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool DisableAddOn(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
@@ -118,6 +122,7 @@ protected:
 	static bool RemoveFile(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool ResumePlayer(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool SaveSettings(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
+	static bool ScanDurations(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool SetMixerSettings(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool SetOutputAgent(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
 	static bool SetPosition(APClientCommunication *comm, BLooper *looper, const PList<PString> &args, PString &result);
@@ -131,6 +136,8 @@ protected:
 	PSkipList<PString, CommandFunc> cmdList;
 
 	APList<APFileHandle> fileHandleList;
+
+	APDurationScanner durationScanner;
 };
 
 #endif
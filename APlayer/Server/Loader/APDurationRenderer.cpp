@@ -0,0 +1,500 @@
+/******************************************************************************/
+/* APlayer duration renderer class.                                           */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+// PolyKit headers
+#include "POS.h"
+#include "PException.h"
+#include "PTime.h"
+
+// APlayerKit headers
+#include "APChannel.h"
+#include "APAddOns.h"
+
+// Server headers
+#include "APDurationRenderer.h"
+
+
+/******************************************************************************/
+/* Hash constants (64-bit FNV)                                                */
+/******************************************************************************/
+#define HASH_START					0xcbf29ce484222325ULL
+#define HASH_PRIME					0x100000001b3ULL
+
+// Minimum number of ticks in a window where something must change
+#define WINDOW_MIN_CHANGES			4
+
+// Flags that only tell what happened in the last tick
+#define TRANSIENT_FLAGS				(NP_TRIGIT | NP_RETRIGLOOP | NP_VOLUME | NP_PANNING | NP_FREQUENCY | NP_RELEASE)
+
+
+
+/******************************************************************************/
+/* AddHash() will mix a value into a hash.                                    */
+/*                                                                            */
+/* Input:  "hash" is the hash so far.                                         */
+/*         "value" is the value to add.                                       */
+/*                                                                            */
+/* Output: The new hash.                                                      */
+/******************************************************************************/
+static inline uint64 AddHash(uint64 hash, uint64 value)
+{
+	return ((hash ^ value) * HASH_PRIME);
+}
+
+
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+APChannelProbe::APChannelProbe(void)
+{
+	// Initialize member variables
+	loopAddress = NULL;
+	playLeft    = 0.0f;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+APChannelProbe::~APChannelProbe(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* GetStateHash() will add the channel state to the hash given and clear all  */
+/*      the flags that only last for a single tick.                           */
+/*                                                                            */
+/* Input:  "hash" is the hash so far.                                         */
+/*                                                                            */
+/* Output: The new hash.                                                      */
+/******************************************************************************/
+uint64 APChannelProbe::GetStateHash(uint64 hash)
+{
+	hash = AddHash(hash, flags);
+	hash = AddHash(hash, (uint64)(size_t)sampAddress);
+	hash = AddHash(hash, ((uint64)sampStart << 32) | sampLength);
+	hash = AddHash(hash, (uint64)(size_t)loopAddress);
+	hash = AddHash(hash, ((uint64)loopStart << 32) | loopLength);
+	hash = AddHash(hash, ((uint64)frequency << 32) | ((uint32)volume << 16) | panning);
+	hash = AddHash(hash, ((uint32)leftVolume << 16) | rightVolume);
+
+	flags &= ~TRANSIENT_FLAGS;
+
+	return (hash);
+}
+
+
+
+/******************************************************************************/
+/* GetBufferHash() will add the content of the buffer set by a sample player  */
+/*      to the hash given. The buffer is then marked as used.                 */
+/*                                                                            */
+/* Input:  "hash" is the hash so far.                                         */
+/*         "bitSize" is the number of bits in each sample.                    */
+/*         "silent" is a reference that is cleared if anything is heard.      */
+/*                                                                            */
+/* Output: The new hash.                                                      */
+/******************************************************************************/
+uint64 APChannelProbe::GetBufferHash(uint64 hash, uint16 bitSize, bool &silent)
+{
+	bool heard = false;
+	uint32 i;
+
+	if ((sampAddress == NULL) || (sampLength == 0))
+		return (hash);
+
+	if (bitSize == 16)
+	{
+		const int16 *buffer = (const int16 *)sampAddress;
+
+		for (i = 0; i < sampLength; i++)
+		{
+			hash = AddHash(hash, (uint16)buffer[i]);
+
+			if ((buffer[i] > DURATION_SILENCE_LEVEL) || (buffer[i] < -DURATION_SILENCE_LEVEL))
+				heard = true;
+		}
+	}
+	else
+	{
+		const int8 *buffer = (const int8 *)sampAddress;
+
+		for (i = 0; i < sampLength; i++)
+		{
+			hash = AddHash(hash, (uint8)buffer[i]);
+
+			if ((buffer[i] > (DURATION_SILENCE_LEVEL >> 8)) || (buffer[i] < -(DURATION_SILENCE_LEVEL >> 8)))
+				heard = true;
+		}
+	}
+
+	// A muted channel is not heard, even if the buffer has data
+	if (heard && !(flags & NP_MUTEIT))
+		silent = false;
+
+	sampLength = 0;
+
+	return (hash);
+}
+
+
+
+/******************************************************************************/
+/* IsAudible() will check if the channel plays something that can be heard.   */
+/*      A sample without a loop is only heard for its own length.             */
+/*                                                                            */
+/* Input:  "tickTime" is the length of the last tick in milliseconds.         */
+/*                                                                            */
+/* Output: True if the channel can be heard.                                  */
+/******************************************************************************/
+bool APChannelProbe::IsAudible(float tickTime)
+{
+	// Calculate the time of a new sample
+	if ((flags & NP_TRIGIT) && (frequency != 0) && (sampLength > sampStart))
+		playLeft = (sampLength - sampStart) * 1000.0f / frequency;
+	else
+		playLeft -= tickTime;
+
+	if ((sampAddress == NULL) || (flags & NP_MUTEIT))
+		return (false);
+
+	if ((volume == 0) && (leftVolume == 0) && (rightVolume == 0))
+		return (false);
+
+	return ((flags & NP_LOOP) || (playLeft > 0.0f));
+}
+
+
+
+/******************************************************************************/
+/* GetBufferLength() returns the length of the buffer set by a sample player. */
+/*                                                                            */
+/* Output: The number of samples in the buffer.                               */
+/******************************************************************************/
+uint32 APChannelProbe::GetBufferLength(void) const
+{
+	return (sampLength);
+}
+
+
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/*                                                                            */
+/* Input:  "player" is a pointer to the player to render. InitPlayer() must   */
+/*         have been called.                                                  */
+/*         "index" is the player index.                                       */
+/******************************************************************************/
+APDurationRenderer::APDurationRenderer(APAddOnPlayer *player, int32 index)
+{
+	uint16 i;
+
+	// Initialize member variables
+	renderPlayer = player;
+	tableKeys    = NULL;
+	tableTicks   = NULL;
+	tableSize    = 0;
+	tableCount   = 0;
+
+	// Find out which kind of player it is
+	samplePlay = (player->GetSupportFlags(index) & appSamplePlayer) != 0;
+	if (samplePlay)
+		player->GetSamplePlayerInfo(&samplePlayInfo);
+
+	// Give the player some channels to play in
+	channelNum = player->GetVirtualChannels();
+
+	channels = new APChannelProbe *[channelNum];
+	if (channels == NULL)
+		throw PMemoryException();
+
+	for (i = 0; i < channelNum; i++)
+	{
+		channels[i] = new APChannelProbe();
+		if (channels[i] == NULL)
+			throw PMemoryException();
+	}
+
+	player->virtChannels = (APChannel **)channels;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+APDurationRenderer::~APDurationRenderer(void)
+{
+	uint16 i;
+
+	// Take back the channels
+	renderPlayer->virtChannels = NULL;
+
+	for (i = 0; i < channelNum; i++)
+		delete channels[i];
+
+	delete[] channels;
+
+	delete[] tableKeys;
+	delete[] tableTicks;
+}
+
+
+
+/******************************************************************************/
+/* RenderSong() will call the player as fast as possible without mixing to    */
+/*      find the length of the current song. The song ends when the player    */
+/*      says so, when it goes silent or when the channel states starts to     */
+/*      repeat. InitSound() must have been called.                            */
+/*                                                                            */
+/* Input:  "maxSeconds" is the maximum number of seconds to render.           */
+/*                                                                            */
+/* Output: The length of the song. If no end could be found, the maximum      */
+/*         time is returned.                                                  */
+/******************************************************************************/
+PTimeSpan APDurationRenderer::RenderSong(uint32 maxSeconds)
+{
+	uint64 *ringHash = NULL;
+	float *ringTime = NULL;
+	bool *ringChange = NULL;
+	uint64 hash, prevHash = 0, windowHash = 0, windowPower = 1;
+	float elapsed = 0.0f, silentTime = 0.0f, tickTime;
+	float limit = maxSeconds * 1000.0f;
+	int32 tick, windowLen = 0, changeCount = 0, firstTick, pos, i;
+	bool silent, heard = false;
+	PTimeSpan result;
+
+	// Start with an empty window table
+	tableCount = 0;
+	if (tableKeys != NULL)
+		memset(tableKeys, 0, tableSize * sizeof(uint64));
+
+	try
+	{
+		for (tick = 0; elapsed < limit; tick++)
+		{
+			// Let the player do its work
+			renderPlayer->Play();
+
+			// Find the length of the tick and fingerprint it
+			hash   = HASH_START;
+			silent = true;
+
+			if (samplePlay)
+			{
+				if ((samplePlayInfo.frequency == 0) || (channels[0]->GetBufferLength() == 0))
+					break;
+
+				tickTime = channels[0]->GetBufferLength() * 1000.0f / samplePlayInfo.frequency;
+
+				for (i = 0; i < channelNum; i++)
+					hash = channels[i]->GetBufferHash(hash, samplePlayInfo.bitSize, silent);
+			}
+			else
+			{
+				if (renderPlayer->playFreq <= 0.0f)
+					break;
+
+				tickTime = 1000.0f / renderPlayer->playFreq;
+				hash     = AddHash(hash, (uint16)renderPlayer->GetSongPosition());
+
+				for (i = 0; i < channelNum; i++)
+				{
+					if (channels[i]->IsAudible(tickTime))
+						silent = false;
+
+					hash = channels[i]->GetStateHash(hash);
+				}
+			}
+
+			// Did the player reach the end by itself?
+			if (renderPlayer->endReached)
+			{
+				result.SetTimeSpan((int64)(elapsed + tickTime));
+				break;
+			}
+
+			// Check for silence. Silence in the beginning of
+			// the song is skipped
+			if (!silent)
+			{
+				heard      = true;
+				silentTime = 0.0f;
+			}
+			else
+			{
+				if (heard)
+				{
+					silentTime += tickTime;
+					if (silentTime >= (DURATION_SILENCE_LIMIT * 1000.0f))
+					{
+						result.SetTimeSpan((int64)(elapsed + tickTime - silentTime));
+						break;
+					}
+				}
+			}
+
+			// Allocate the window now we know how long a tick is
+			if (tick == 0)
+			{
+				windowLen = (int32)(DURATION_LOOP_WINDOW * 1000.0f / tickTime) + 1;
+
+				ringHash   = new uint64[windowLen];
+				ringTime   = new float[windowLen];
+				ringChange = new bool[windowLen];
+				if ((ringHash == NULL) || (ringTime == NULL) || (ringChange == NULL))
+					throw PMemoryException();
+
+				memset(ringHash, 0, windowLen * sizeof(uint64));
+				memset(ringChange, 0, windowLen * sizeof(bool));
+
+				for (i = 0; i < windowLen; i++)
+					windowPower *= HASH_PRIME;
+			}
+
+			// Roll the new tick into the window hash
+			pos = tick % windowLen;
+
+			windowHash   = windowHash * HASH_PRIME + hash - ringHash[pos] * windowPower;
+			changeCount -= ringChange[pos];
+
+			ringHash[pos]   = hash;
+			ringTime[pos]   = elapsed;
+			ringChange[pos] = (tick != 0) && (hash != prevHash);
+			changeCount    += ringChange[pos];
+			prevHash        = hash;
+
+			// If the whole window has been seen before, the song
+			// has started over at the beginning of the window. Windows
+			// where nothing happens are skipped, else a long note
+			// would look like a loop
+			if ((tick >= windowLen - 1) && (changeCount >= WINDOW_MIN_CHANGES))
+			{
+				if (FindWindow(windowHash, tick, firstTick) && ((tick - firstTick) >= windowLen))
+				{
+					result.SetTimeSpan((int64)ringTime[(tick + 1) % windowLen]);
+					break;
+				}
+			}
+
+			elapsed += tickTime;
+		}
+
+		// Did we hit the limit?
+		if (elapsed >= limit)
+			result.SetTimeSpan((int64)limit);
+	}
+	catch(...)
+	{
+		delete[] ringHash;
+		delete[] ringTime;
+		delete[] ringChange;
+		throw;
+	}
+
+	delete[] ringHash;
+	delete[] ringTime;
+	delete[] ringChange;
+
+	return (result);
+}
+
+
+
+/******************************************************************************/
+/* FindWindow() will look up a window hash in the table. If not found, it is  */
+/*      added.                                                                */
+/*                                                                            */
+/* Input:  "hash" is the window hash.                                         */
+/*         "tick" is the tick where the window ends.                          */
+/*         "firstTick" is a reference where the tick of the first window with */
+/*         the same hash is stored.                                           */
+/*                                                                            */
+/* Output: True if the window was seen before, false if not.                  */
+/******************************************************************************/
+bool APDurationRenderer::FindWindow(uint64 hash, int32 tick, int32 &firstTick)
+{
+	int32 pos;
+
+	// Zero marks an empty slot
+	if (hash == 0)
+		hash = 1;
+
+	// Keep the table at most half full
+	if ((tableCount + 1) * 2 > tableSize)
+		GrowTable();
+
+	pos = (int32)(hash & (tableSize - 1));
+
+	while (tableKeys[pos] != 0)
+	{
+		if (tableKeys[pos] == hash)
+		{
+			firstTick = tableTicks[pos];
+			return (true);
+		}
+
+		pos = (pos + 1) & (tableSize - 1);
+	}
+
+	tableKeys[pos]  = hash;
+	tableTicks[pos] = tick;
+	tableCount++;
+
+	return (false);
+}
+
+
+
+/******************************************************************************/
+/* GrowTable() will double the size of the window table.                      */
+/******************************************************************************/
+void APDurationRenderer::GrowTable(void)
+{
+	uint64 *oldKeys = tableKeys;
+	int32 *oldTicks = tableTicks;
+	int32 oldSize = tableSize;
+	int32 i, pos;
+
+	tableSize = (oldSize == 0) ? 4096 : oldSize * 2;
+
+	tableKeys  = new uint64[tableSize];
+	tableTicks = new int32[tableSize];
+	if ((tableKeys == NULL) || (tableTicks == NULL))
+		throw PMemoryException();
+
+	memset(tableKeys, 0, tableSize * sizeof(uint64));
+
+	// Move the old entries over
+	for (i = 0; i < oldSize; i++)
+	{
+		if (oldKeys[i] != 0)
+		{
+			pos = (int32)(oldKeys[i] & (tableSize - 1));
+			while (tableKeys[pos] != 0)
+				pos = (pos + 1) & (tableSize - 1);
+
+			tableKeys[pos]  = oldKeys[i];
+			tableTicks[pos] = oldTicks[i];
+		}
+	}
+
+	delete[] oldKeys;
+	delete[] oldTicks;
+}
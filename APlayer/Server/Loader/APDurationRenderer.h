@@ -0,0 +1,85 @@
+/******************************************************************************/
+/* APDurationRenderer header file.                                            */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __APDurationRenderer_h
+#define __APDurationRenderer_h
+
+// PolyKit headers
+#include "POS.h"
+#include "PTime.h"
+
+// APlayerKit headers
+#include "APChannel.h"
+#include "APAddOns.h"
+
+
+/******************************************************************************/
+/* Render constants                                                           */
+/******************************************************************************/
+#define DURATION_RENDER_LIMIT		600		// Default maximum seconds to render
+#define DURATION_LOOP_WINDOW		8		// Seconds that must repeat to detect a loop
+#define DURATION_SILENCE_LIMIT		3		// Seconds of silence that ends the song
+#define DURATION_SILENCE_LEVEL		64		// Highest 16-bit sample value that is silence
+
+
+
+/******************************************************************************/
+/* APChannelProbe class                                                       */
+/*                                                                            */
+/* A channel that does not play anything, but can tell what the player did    */
+/* to it since the last tick.                                                 */
+/******************************************************************************/
+class APChannelProbe : public APChannel
+{
+public:
+	APChannelProbe(void);
+	virtual ~APChannelProbe(void);
+
+	uint64 GetStateHash(uint64 hash);
+	uint64 GetBufferHash(uint64 hash, uint16 bitSize, bool &silent);
+	bool IsAudible(float tickTime);
+	uint32 GetBufferLength(void) const;
+
+protected:
+	float playLeft;				// Milliseconds left of a sample without loop
+};
+
+
+
+/******************************************************************************/
+/* APDurationRenderer class                                                   */
+/******************************************************************************/
+class APDurationRenderer
+{
+public:
+	APDurationRenderer(APAddOnPlayer *player, int32 index);
+	virtual ~APDurationRenderer(void);
+
+	PTimeSpan RenderSong(uint32 maxSeconds);
+
+protected:
+	bool FindWindow(uint64 hash, int32 tick, int32 &firstTick);
+	void GrowTable(void);
+
+	APAddOnPlayer *renderPlayer;
+	APChannelProbe **channels;
+	uint16 channelNum;
+
+	bool samplePlay;
+	APSamplePlayerInfo samplePlayInfo;
+
+	uint64 *tableKeys;
+	int32 *tableTicks;
+	int32 tableSize;
+	int32 tableCount;
+};
+
+#endif
@@ -0,0 +1,720 @@
+/******************************************************************************/
+/* APlayer duration scanner class.                                            */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+// PolyKit headers
+#include "POS.h"
+#include "PDebug.h"
+#include "PException.h"
+#include "PString.h"
+#include "PFile.h"
+#include "PDirectory.h"
+#include "PChecksums.h"
+#include "PSynchronize.h"
+#include "PThread.h"
+#include "PList.h"
+#include "PSkipList.h"
+#include "PTime.h"
+
+// APlayerKit headers
+#include "APAddOns.h"
+#include "APServerCommunication.h"
+
+// Server headers
+#include "APApplication.h"
+#include "APModuleLoader.h"
+#include "APDurationRenderer.h"
+#include "APDurationScanner.h"
+
+
+/******************************************************************************/
+/* Cache file name                                                            */
+/******************************************************************************/
+#define DURATION_CACHE_FILE			"DurationCache2.txt"		// The keys were MD5 in the first one
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+APDurationScanner::APDurationScanner(void) : queueLock(false), cacheLock(false)
+{
+	// Initialize member variables
+	jobSemaphore = NULL;
+	exitFlag     = false;
+	workerCount  = 0;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+APDurationScanner::~APDurationScanner(void)
+{
+	delete jobSemaphore;
+}
+
+
+
+/******************************************************************************/
+/* Start() will load the duration cache and start the worker threads.         */
+/******************************************************************************/
+void APDurationScanner::Start(void)
+{
+	system_info sysInfo;
+	int32 i;
+
+	// Load the durations found in earlier sessions
+	LoadCache();
+
+	// Create the semaphore counting the jobs in the queue. It is
+	// used as a counter, so the same thread must block on it too
+	jobSemaphore = new PSemaphore("Duration Scanner Jobs", 0, true);
+	if (jobSemaphore == NULL)
+		throw PMemoryException();
+
+	// Find out how many workers to start. Use one per CPU,
+	// but never so many the playing will suffer
+	get_system_info(&sysInfo);
+	workerCount = max(1, min((int32)sysInfo.cpu_count, DURATION_MAX_WORKERS));
+
+	exitFlag = false;
+
+	for (i = 0; i < workerCount; i++)
+	{
+		workers[i].scanner   = this;
+		workers[i].looper    = NULL;
+		workers[i].cancelled = false;
+
+		workers[i].thread.SetName("Duration Scanner");
+		workers[i].thread.SetHookFunc(WorkerThread, &workers[i]);
+		workers[i].thread.SetPriority(PThread::pLow);
+		workers[i].thread.StartThread();
+	}
+}
+
+
+
+/******************************************************************************/
+/* Stop() will stop all the worker threads and save the duration cache.       */
+/******************************************************************************/
+void APDurationScanner::Stop(void)
+{
+	int32 i;
+
+	if (jobSemaphore != NULL)
+	{
+		// Throw away all the jobs not started yet and
+		// tell the workers to exit
+		queueLock.Lock();
+		jobList.MakeEmpty();
+		exitFlag = true;
+
+		for (i = 0; i < workerCount; i++)
+			workers[i].cancelled = true;
+
+		queueLock.Unlock();
+
+		// Wake up all the workers and wait for them to finish
+		jobSemaphore->UnlockWithCount(workerCount);
+
+		for (i = 0; i < workerCount; i++)
+			workers[i].thread.WaitOnThread();
+
+		workerCount = 0;
+
+		delete jobSemaphore;
+		jobSemaphore = NULL;
+	}
+
+	// Write the new durations to disk
+	cacheLock.Lock();
+	SaveCache();
+	cacheLock.Unlock();
+}
+
+
+
+/******************************************************************************/
+/* AddFiles() will add the files given to the job queue. The result for each  */
+/*      file is sent to the client looper as a "DurationScanned" command when */
+/*      it is ready.                                                          */
+/*                                                                            */
+/* Input:  "looper" is a pointer to the client looper to send the result to.  */
+/*         "files" is a list with the file names to scan.                     */
+/******************************************************************************/
+void APDurationScanner::AddFiles(BLooper *looper, const PList<PString> &files)
+{
+	APDurationJob job;
+	int32 i, count;
+
+	count = files.CountItems();
+	if (count == 0)
+		return;
+
+	job.looper = looper;
+
+	// Add the jobs to the queue
+	queueLock.Lock();
+
+	try
+	{
+		for (i = 0; i < count; i++)
+		{
+			job.fileName = files.GetItem(i);
+			jobList.AddTail(job);
+		}
+	}
+	catch(...)
+	{
+		queueLock.Unlock();
+		throw;
+	}
+
+	queueLock.Unlock();
+
+	// Wake up the workers
+	jobSemaphore->UnlockWithCount(count);
+}
+
+
+
+/******************************************************************************/
+/* CancelFiles() will remove all the jobs added by the client given. Jobs in  */
+/*      progress will finish, but the result will not be sent. When this      */
+/*      function returns, no more results will be sent to the looper.         */
+/*                                                                            */
+/* Input:  "looper" is a pointer to the client looper to cancel the jobs for. */
+/******************************************************************************/
+void APDurationScanner::CancelFiles(BLooper *looper)
+{
+	int32 i;
+
+	queueLock.Lock();
+
+	// Remove the jobs in the queue. The semaphore count will
+	// be too high now, but the workers just skip the empty queue
+	for (i = jobList.CountItems() - 1; i >= 0; i--)
+	{
+		if (jobList.GetItem(i).looper == looper)
+			jobList.RemoveItem(i);
+	}
+
+	// Mark the jobs in progress
+	for (i = 0; i < workerCount; i++)
+	{
+		if (workers[i].looper == looper)
+			workers[i].cancelled = true;
+	}
+
+	queueLock.Unlock();
+}
+
+
+
+/******************************************************************************/
+/* FindCachedDurations() will look up the file given in the duration cache.   */
+/*                                                                            */
+/* Input:  "fileName" is the file name to the module.                         */
+/*         "startSong" is a reference where the default sub song is stored.   */
+/*         "timeStr" is a reference where the times in milliseconds separated */
+/*         by commas are stored.                                              */
+/*                                                                            */
+/* Output: True if the file was found, false if not.                          */
+/******************************************************************************/
+bool APDurationScanner::FindCachedDurations(PString fileName, uint16 &startSong, PString &timeStr)
+{
+	return (FindInCache(GetContentKey(fileName), startSong, timeStr));
+}
+
+
+
+/******************************************************************************/
+/* AddDurations() will add durations found outside the scanner to the cache,  */
+/*      so the file does not have to be scanned later on.                     */
+/*                                                                            */
+/* Input:  "fileName" is the file name to the module.                         */
+/*         "startSong" is the default sub song.                               */
+/*         "timeStr" is the times in milliseconds separated by commas.        */
+/******************************************************************************/
+void APDurationScanner::AddDurations(PString fileName, uint16 startSong, PString timeStr)
+{
+	AddToCache(GetContentKey(fileName), startSong, timeStr);
+}
+
+
+
+/******************************************************************************/
+/* WorkerThread() is the worker thread function. It will take jobs from the   */
+/*      queue until the scanner is stopped.                                   */
+/*                                                                            */
+/* Input:  "userData" is a pointer to the worker structure.                   */
+/*                                                                            */
+/* Output: Always 0.                                                          */
+/******************************************************************************/
+int32 APDurationScanner::WorkerThread(void *userData)
+{
+	APDurationWorker *worker = (APDurationWorker *)userData;
+	APDurationScanner *scanner = worker->scanner;
+	APDurationJob job;
+	bool gotJob;
+
+	for (;;)
+	{
+		// Wait for a job
+		scanner->jobSemaphore->Lock();
+
+		// Take the next job in the queue
+		scanner->queueLock.Lock();
+
+		if (scanner->exitFlag)
+		{
+			scanner->queueLock.Unlock();
+			break;
+		}
+
+		gotJob = !scanner->jobList.IsEmpty();
+		if (gotJob)
+		{
+			job = scanner->jobList.GetAndRemoveItem(0);
+
+			worker->looper    = job.looper;
+			worker->cancelled = false;
+		}
+
+		scanner->queueLock.Unlock();
+
+		if (gotJob)
+		{
+			try
+			{
+				scanner->ScanFile(worker, job);
+			}
+			catch(...)
+			{
+				;
+			}
+
+			// The job is done
+			scanner->queueLock.Lock();
+			worker->looper = NULL;
+			scanner->queueLock.Unlock();
+		}
+	}
+
+	return (0);
+}
+
+
+
+/******************************************************************************/
+/* ScanFile() will find the durations of a single file, either from the cache */
+/*      or by loading the module, and send the result to the client.          */
+/*                                                                            */
+/* Input:  "worker" is a pointer to the worker running the job.               */
+/*         "job" is a reference to the job to run.                            */
+/******************************************************************************/
+void APDurationScanner::ScanFile(APDurationWorker *worker, const APDurationJob &job)
+{
+	PList<PTimeSpan> times;
+	PString key, timeStr;
+	uint16 startSong;
+	int32 i, count;
+
+	// Find the key to look up in the cache
+	key = GetContentKey(job.fileName);
+
+	// Did we scan the file before?
+	if (FindInCache(key, startSong, timeStr))
+	{
+		SendResult(worker, job.fileName, startSong, timeStr);
+		return;
+	}
+
+	// Load the module and let the player calculate the times
+	if (!FindDurations(job.fileName, times, startSong))
+	{
+		// Send an empty result, so the client knows we are done
+		SendResult(worker, job.fileName, 0, "");
+		return;
+	}
+
+	// Build the time string
+	count = times.CountItems();
+	for (i = 0; i < count; i++)
+	{
+		if (i != 0)
+			timeStr += ",";
+
+		timeStr += PString::CreateNumber64(times.GetItem(i).GetTotalMilliSeconds());
+	}
+
+	// Remember the times
+	AddToCache(key, startSong, timeStr);
+
+	// And send them to the client
+	SendResult(worker, job.fileName, startSong, timeStr);
+}
+
+
+
+/******************************************************************************/
+/* FindDurations() will load the module and initialize the player to find     */
+/*      the duration of each sub song. No mixer is created. Players without   */
+/*      a time table are rendered until the song ends.                        */
+/*                                                                            */
+/* Input:  "fileName" is the file name to the module.                         */
+/*         "times" is a reference to a list where the times are stored.       */
+/*         "startSong" is a reference where the default sub song is stored.   */
+/*                                                                            */
+/* Output: True for success, false if the module could not be loaded.         */
+/******************************************************************************/
+bool APDurationScanner::FindDurations(PString fileName, PList<PTimeSpan> &times, uint16 &startSong)
+{
+	APModuleLoader loader;
+	APAddOnPlayer *player;
+	APDurationRenderer *renderer = NULL;
+	PList<PTimeSpan> posTimes;
+	PTimeSpan totalTime;
+	PString errorStr;
+	const uint16 *songs;
+	uint32 renderLimit;
+	int32 index;
+	uint16 i;
+	bool result = false;
+
+	// Load the module. The file type is never changed while scanning
+	if (!loader.LoadModule(fileName, false, errorStr))
+		return (false);
+
+	player = loader.GetPlayer(index);
+	player->mixerFreq = 44100;
+
+	// There is no server looper, so the position and module
+	// information changes the player sends are ignored. The
+	// channels are given to it by the renderer
+	player->SetLooper(NULL);
+
+	// Find the maximum time to render players without a time table
+	renderLimit = GetApp()->useSettings->GetIntEntryValue("Durations", "RenderLimit", DURATION_RENDER_LIMIT);
+
+	try
+	{
+		if (player->InitPlayer(index))
+		{
+			try
+			{
+				// Create the channels the player needs if it has to be rendered
+				renderer = new APDurationRenderer(player, index);
+				if (renderer == NULL)
+					throw PMemoryException();
+
+				songs     = player->GetSubSongs();
+				startSong = songs[1];
+
+				// Find the time for each sub song
+				for (i = 0; i < songs[0]; i++)
+				{
+					player->playFreq   = 50.0f;
+					player->endReached = false;
+
+					player->InitSound(index, i);
+
+					posTimes.MakeEmpty();
+					totalTime = player->GetTimeTable(i, posTimes);
+
+					// If the player can't calculate the time itself,
+					// play the song to find it
+					if ((totalTime.GetTotalMilliSeconds() == 0) && (renderLimit != 0))
+						totalTime = renderer->RenderSong(renderLimit);
+
+					times.AddTail(totalTime);
+
+					player->EndSound(index);
+				}
+
+				result = true;
+			}
+			catch(...)
+			{
+				result = false;
+			}
+
+			delete renderer;
+			player->EndPlayer(index);
+		}
+	}
+	catch(...)
+	{
+		result = false;
+	}
+
+	// Free the module again
+	loader.FreeModule();
+
+	return (result);
+}
+
+
+
+/******************************************************************************/
+/* GetContentKey() will calculate the cache key for the file given. It is the */
+/*      128 bit XXH3 checksum of the file data, so renamed or moved files are */
+/*      still found in the cache.                                             */
+/*                                                                            */
+/* Input:  "fileName" is the file name to the module.                         */
+/*                                                                            */
+/* Output: The key as a hex string.                                           */
+/******************************************************************************/
+PString APDurationScanner::GetContentKey(PString fileName)
+{
+	PXXH3 hash;
+	PFile file;
+	PString key;
+	const uint8 *checksum;
+	char *nameStr;
+	int32 len, i;
+
+	try
+	{
+		if (PFile::FileExists(fileName))
+		{
+			// Calculate the checksum of the whole file
+			file.Open(fileName, PFile::pModeRead | PFile::pModeShareRead);
+			hash.AddFile(&file);
+			file.Close();
+		}
+		else
+		{
+			// Members inside archives are keyed on their name
+			nameStr = fileName.GetString(&len);
+			hash.AddBuffer((const uint8 *)nameStr, len);
+			fileName.FreeBuffer(nameStr);
+		}
+	}
+	catch(PFileException e)
+	{
+		;
+	}
+
+	// Convert the checksum to a string
+	checksum = hash.CalculateChecksum128();
+
+	for (i = 0; i < 16; i++)
+	{
+		if (checksum[i] < 0x10)
+			key += "0";
+
+		key += PString::CreateHexNumber(checksum[i], false);
+	}
+
+	return (key);
+}
+
+
+
+/******************************************************************************/
+/* FindInCache() will look up the key given in the duration cache.            */
+/*                                                                            */
+/* Input:  "key" is the content key of the file.                              */
+/*         "startSong" is a reference where the default sub song is stored.   */
+/*         "timeStr" is a reference where the times are stored.               */
+/*                                                                            */
+/* Output: True if the key was found, false if not.                           */
+/******************************************************************************/
+bool APDurationScanner::FindInCache(PString key, uint16 &startSong, PString &timeStr)
+{
+	PString value;
+	int32 index;
+	bool found;
+
+	cacheLock.Lock();
+	found = durationCache.GetItem(key, value);
+	cacheLock.Unlock();
+
+	if (!found)
+		return (false);
+
+	// The value holds the start song and the times separated by a colon
+	index = value.Find(':');
+	if (index == -1)
+		return (false);
+
+	startSong = value.GetUNumber();
+	timeStr   = value.Mid(index + 1);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* AddToCache() will add the durations to the cache and write them to disk    */
+/*      when enough new entries have been collected.                          */
+/*                                                                            */
+/* Input:  "key" is the content key of the file.                              */
+/*         "startSong" is the default sub song.                               */
+/*         "timeStr" is the times in milliseconds separated by commas.        */
+/******************************************************************************/
+void APDurationScanner::AddToCache(PString key, uint16 startSong, PString timeStr)
+{
+	PString value;
+
+	value = PString::CreateUNumber(startSong) + ":" + timeStr;
+
+	cacheLock.Lock();
+
+	try
+	{
+		if (durationCache.InsertItem(key, value))
+		{
+			newEntries.AddTail(key + "=" + value);
+
+			if (newEntries.CountItems() >= DURATION_FLUSH_COUNT)
+				SaveCache();
+		}
+	}
+	catch(...)
+	{
+		;
+	}
+
+	cacheLock.Unlock();
+}
+
+
+
+/******************************************************************************/
+/* SendResult() will build and send a "DurationScanned" command to the client */
+/*      which asked for the file, unless the job has been cancelled.          */
+/*                                                                            */
+/* Input:  "worker" is a pointer to the worker running the job.               */
+/*         "fileName" is the file name to the module.                         */
+/*         "startSong" is the default sub song.                               */
+/*         "timeStr" is the times in milliseconds separated by commas.        */
+/******************************************************************************/
+void APDurationScanner::SendResult(APDurationWorker *worker, PString fileName, uint16 startSong, PString timeStr)
+{
+	BMessage message(APSERVER_MSG_DATA);
+	PString command;
+	char *commandStr;
+
+	// Build the command
+	command = APServerCommunication::AddArgument("DurationScanned=", fileName);
+	command = APServerCommunication::AddArgument(command, PString::CreateUNumber(startSong));
+	command = APServerCommunication::AddArgument(command, timeStr);
+
+	message.AddString("Command", (commandStr = command.GetString()));
+	command.FreeBuffer(commandStr);
+
+	// Send it while holding the queue lock, so the client
+	// can't cancel and go away in the meantime
+	queueLock.Lock();
+
+	if (!worker->cancelled)
+		worker->looper->PostMessage(&message);
+
+	queueLock.Unlock();
+}
+
+
+
+/******************************************************************************/
+/* LoadCache() will read the duration cache file into memory.                 */
+/******************************************************************************/
+void APDurationScanner::LoadCache(void)
+{
+	PDirectory dir;
+	PFile file;
+	PString fileName, line;
+	int32 index;
+
+	// Build the file name
+	dir.FindDirectory(PDirectory::pSettings);
+	dir.Append("Polycode");
+	dir.Append("APlayer");
+	fileName = dir.GetDirectory() + DURATION_CACHE_FILE;
+
+	cacheLock.Lock();
+
+	try
+	{
+		durationCache.MakeEmpty();
+		newEntries.MakeEmpty();
+
+		if (PFile::FileExists(fileName))
+		{
+			file.Open(fileName, PFile::pModeRead | PFile::pModeShareRead);
+
+			// Each line holds the key and value separated by an equal sign
+			PLineReader reader(&file);
+
+			while (reader.ReadLine(line))
+			{
+				index = line.Find('=');
+
+				if (index > 0)
+					durationCache.InsertItem(line.Left(index), line.Mid(index + 1));
+			}
+		}
+	}
+	catch(...)
+	{
+		// A broken cache file is just ignored
+		;
+	}
+
+	cacheLock.Unlock();
+}
+
+
+
+/******************************************************************************/
+/* SaveCache() will append all the new durations to the cache file. The       */
+/*      cache lock must be held when calling this function.                   */
+/******************************************************************************/
+void APDurationScanner::SaveCache(void)
+{
+	PDirectory dir;
+	PFile file;
+	PString fileName;
+	int32 i, count;
+
+	count = newEntries.CountItems();
+	if (count == 0)
+		return;
+
+	try
+	{
+		// Build the file name
+		dir.FindDirectory(PDirectory::pSettings);
+		dir.Append("Polycode");
+		dir.Append("APlayer");
+		dir.CreateDirectory();
+		fileName = dir.GetDirectory() + DURATION_CACHE_FILE;
+
+		// The file is only appended to, so old entries never
+		// have to be written again
+		file.Open(fileName, PFile::pModeWrite | PFile::pModeCreate | PFile::pModeNoTruncate);
+		file.SeekToEnd();
+
+		for (i = 0; i < count; i++)
+			file.WriteLine(newEntries.GetItem(i));
+
+		file.Close();
+	}
+	catch(PFileException e)
+	{
+		;
+	}
+
+	newEntries.MakeEmpty();
+}
@@ -0,0 +1,91 @@
+/******************************************************************************/
+/* APDurationScanner header file.                                             */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of APlayer is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by The APlayer-Team.                               */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __APDurationScanner_h
+#define __APDurationScanner_h
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PSynchronize.h"
+#include "PThread.h"
+#include "PList.h"
+#include "PSkipList.h"
+#include "PTime.h"
+
+
+/******************************************************************************/
+/* Worker and cache constants                                                 */
+/******************************************************************************/
+#define DURATION_MAX_WORKERS		4
+#define DURATION_FLUSH_COUNT		64
+
+
+
+/******************************************************************************/
+/* APDurationScanner class                                                    */
+/******************************************************************************/
+class APDurationScanner
+{
+public:
+	APDurationScanner(void);
+	virtual ~APDurationScanner(void);
+
+	void Start(void);
+	void Stop(void);
+
+	void AddFiles(BLooper *looper, const PList<PString> &files);
+	void CancelFiles(BLooper *looper);
+
+	bool FindCachedDurations(PString fileName, uint16 &startSong, PString &timeStr);
+	void AddDurations(PString fileName, uint16 startSong, PString timeStr);
+
+protected:
+	typedef struct APDurationJob
+	{
+		PString fileName;			// The file name with path
+		BLooper *looper;			// The client looper to send the result to
+	} APDurationJob;
+
+	typedef struct APDurationWorker
+	{
+		APDurationScanner *scanner;	// Pointer to the scanner object
+		PThread thread;				// The worker thread
+		BLooper *looper;			// The client looper of the job in progress
+		bool cancelled;				// True if the job in progress has been cancelled
+	} APDurationWorker;
+
+	static int32 WorkerThread(void *userData);
+
+	void ScanFile(APDurationWorker *worker, const APDurationJob &job);
+	bool FindDurations(PString fileName, PList<PTimeSpan> &times, uint16 &startSong);
+	PString GetContentKey(PString fileName);
+	bool FindInCache(PString key, uint16 &startSong, PString &timeStr);
+	void AddToCache(PString key, uint16 startSong, PString timeStr);
+	void SendResult(APDurationWorker *worker, PString fileName, uint16 startSong, PString timeStr);
+
+	void LoadCache(void);
+	void SaveCache(void);
+
+	PMutex queueLock;
+	PSemaphore *jobSemaphore;
+	PList<APDurationJob> jobList;
+	bool exitFlag;
+
+	APDurationWorker workers[DURATION_MAX_WORKERS];
+	int32 workerCount;
+
+	PMutex cacheLock;
+	PSkipList<PString, PString> durationCache;
+	PList<PString> newEntries;
+};
+
+#endif
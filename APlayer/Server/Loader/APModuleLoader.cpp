@@ -61,6 +61,7 @@ bool APModuleLoader::LoadModule(PString fileName, bool changeType, PString &erro
 	APAgent_DecrunchFile decrunchInfo;
 	APAgent_ConvertModule convInfo;
 	APMRSWList<AddOnInfo *> *infoList;
+	PString archiveName;
 	bool modConverted = false;
 	bool foundType = false;
 	bool result = false;
@@ -80,9 +81,13 @@ bool APModuleLoader::LoadModule(PString fileName, bool changeType, PString &erro
 		// Initialize the decruncher structure
 		decrunchInfo.file           = file;
 		decrunchInfo.decrunchedFile = NULL;
+		decrunchInfo.fromArchive    = false;
+
+		// Find out if a member inside an archive should be loaded
+		SplitArchiveName(fileName, archiveName, decrunchInfo.archiveMember);
 
 		// Open the module
-		decrunchInfo.file->Open(fileName, PFile::pModeReadWrite | PFile::pModeShareRead | PFile::pModeNoTruncate);
+		decrunchInfo.file->Open(archiveName, PFile::pModeReadWrite | PFile::pModeShareRead | PFile::pModeNoTruncate);
 
 		// Get the original length of the file
 		fileLength = decrunchInfo.file->GetLength();
@@ -90,6 +95,14 @@ bool APModuleLoader::LoadModule(PString fileName, bool changeType, PString &erro
 		// Decrunch the file
 		DecrunchFile(&decrunchInfo);
 
+		// Use the length of the member if it was taken from an archive
+		// and never change the file type of the archive
+		if (decrunchInfo.fromArchive)
+		{
+			fileLength = decrunchInfo.file->GetLength();
+			changeType = false;
+		}
+
 		// Copy the file used for decrunching into the converter structure
 		convInfo.moduleFile = decrunchInfo.file;
 
@@ -624,6 +637,10 @@ void APModuleLoader::DecrunchFile(APAgent_DecrunchFile *decrunchInfo)
 					decrunchInfo->file           = decrunchInfo->decrunchedFile;
 					decrunchInfo->decrunchedFile = NULL;
 
+					// The archive member has been extracted, so
+					// the new file should be treated as a whole
+					decrunchInfo->archiveMember.MakeEmpty();
+
 					// Take all the decruncher agents one more time,
 					// so we can handle recursive packed modules
 					i = -1;
@@ -641,3 +658,40 @@ void APModuleLoader::DecrunchFile(APAgent_DecrunchFile *decrunchInfo)
 	// Done with the plug-ins
 	GetApp()->pluginLock.DoneReading();
 }
+
+
+
+/******************************************************************************/
+/* SplitArchiveName() will split a file name in the form archive#member into  */
+/*      the archive name and the name of the member inside the archive. If    */
+/*      the file name exists as it is, it is not split.                       */
+/*                                                                            */
+/* Input:  "fileName" is the file name to split.                              */
+/*         "archiveName" is a reference where to store the file name to open. */
+/*         "memberName" is a reference where to store the member name or an   */
+/*         empty string if it is not an archive member.                       */
+/******************************************************************************/
+void APModuleLoader::SplitArchiveName(PString fileName, PString &archiveName, PString &memberName)
+{
+	int32 index;
+
+	archiveName = fileName;
+	memberName.MakeEmpty();
+
+	if (PFile::FileExists(fileName))
+		return;
+
+	// Find the first # where the left part is an existing file
+	index = fileName.Find('#');
+	while (index != -1)
+	{
+		if (PFile::FileExists(fileName.Left(index)))
+		{
+			archiveName = fileName.Left(index);
+			memberName  = fileName.Mid(index + 1);
+			break;
+		}
+
+		index = fileName.Find('#', index + 1);
+	}
+}
@@ -46,6 +46,7 @@ protected:
 	bool FindPlayer(PFile *modFile);
 	bool ConvertModule(APAgent_ConvertModule *convInfo);
 	void DecrunchFile(APAgent_DecrunchFile *decrunchInfo);
+	void SplitArchiveName(PString fileName, PString &archiveName, PString &memberName);
 
 	PCacheFile *file;
 	PFile *usingFile;
@@ -88,6 +88,7 @@ void APChannelParser::ParseSampleInfo(VINFO *info, int32 clickBuffer)
 		info->releaseLen = 0;
 		info->frq        = samplePlayInfo.frequency;
 		info->flags     &= SF_SPEAKER;
+		info->flags     |= SF_STREAM;
 		info->kick       = true;
 
 		if (samplePlayInfo.bitSize == 16)
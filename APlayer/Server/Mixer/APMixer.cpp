@@ -54,9 +54,11 @@ APMixer::APMixer(void) : mixerLock(false)
 	holdPlaying       = true;
 	samplePlay        = false;
 	emulateFilter     = false;
+	moduleEnded       = false;
 
 	// Initialize ring buffer variables
 	useRingBuffer     = false;
+	memoryLocked      = false;
 	exitEvent         = NULL;
 	fillBuffer        = NULL;
 	newPosSignal      = NULL;
@@ -437,7 +439,8 @@ void APMixer::StartMixer(void)
 	currentMixer->ClearVoices();
 
 	// Initialize ticks left to call the player
-	tickLeft = 0;
+	tickLeft    = 0;
+	moduleEnded = false;
 
 	if (useRingBuffer)
 	{
@@ -561,6 +564,25 @@ bool APMixer::UsingRingBuffers(void) const
 
 
 
+/******************************************************************************/
+/* GetRingThreadStats() returns how the OS schedules the ring buffer filler   */
+/*      thread, e.g. to verify it got real-time scheduling.                   */
+/*                                                                            */
+/* Input:  "stats" is a reference to the structure to fill out.               */
+/*                                                                            */
+/* Output: True if the statistics are filled, false if the mixer does not use */
+/*         ring buffers or the thread has not been started.                   */
+/******************************************************************************/
+bool APMixer::GetRingThreadStats(PThread::PThreadStats &stats) const
+{
+	if (!useRingBuffer)
+		return (false);
+
+	return (ringThread.GetStats(stats));
+}
+
+
+
 /******************************************************************************/
 /* SetSongPosition() will change the song position in the ring buffer.        */
 /*                                                                            */
@@ -726,6 +748,11 @@ int32 APMixer::Mixer(void *handle, int16 *buffer, int32 count)
 	APMixer *object = (APMixer *)handle;
 	int32 retVal = 0;
 
+	// Try again to tell the player about the module end,
+	// if the event queue was full the last time
+	if (object->moduleEnded)
+		object->PostModuleEnded();
+
 	if (object->holdPlaying)
 	{
 		// Clear the buffer and return
@@ -873,7 +900,7 @@ int32 APMixer::DoMixing1(int32 todo)
 						fillBuffer->ResetEvent();
 					}
 					else
-						playerInfo->PostMessage(AP_MODULE_ENDED);
+						PostModuleEnded();
 
 					break;
 				}
@@ -1221,7 +1248,12 @@ void APMixer::InitRingBuffer(void)
 		// Initialize ring buffer thread
 		ringThread.SetName("Ringbuffer filler");
 		ringThread.SetHookFunc(RingBufferFiller, this);
-		ringThread.SetPriority(PThread::pHigh);
+		ringThread.SetPriority(PThread::pAudio);
+		ringThread.SetAffinity(GetApp()->useSettings->GetIntEntryValue("Mixer", "AudioCPU", -1));
+
+		// Keep the audio path in RAM if the user wants it
+		if (GetApp()->useSettings->GetIntEntryValue("Mixer", "LockMemory", 0) != 0)
+			memoryLocked = PThread::LockMemory();
 	}
 }
 
@@ -1251,6 +1283,13 @@ void APMixer::EndRingBuffer(void)
 
 		ringThread.WaitOnThread();
 
+		// Unlock the memory again
+		if (memoryLocked)
+		{
+			PThread::UnlockMemory();
+			memoryLocked = false;
+		}
+
 		// Delete all the events
 		delete readySignal;
 		readySignal = NULL;
@@ -1368,12 +1407,9 @@ int32 APMixer::DoRingBuffer(int16 *buf, int32 count)
 		// If the position has changed, report it
 		if (newPos != oldPos)
 		{
-			BMessage msg(AP_REPORT_POSITION);
-
-			// Build and send the message
-			msg.AddInt16("position", newPos);
-			playerInfo->PostMessage(&msg);
-
+			// If the queue is full, the position is just reported
+			// the next time it changes
+			playerInfo->PostEvent(AP_REPORT_POSITION, newPos);
 			oldPos = newPos;
 		}
 
@@ -1395,13 +1431,9 @@ int32 APMixer::DoRingBuffer(int16 *buf, int32 count)
 					memset(buffer, 0, count << 1);
 
 				// The module has been played, so tell about
-				// a position change and then a module end message
-				BMessage msg(AP_REPORT_POSITION);
-				msg.AddInt16("position", endSongPosition);
-				playerInfo->PostMessage(&msg);
-
-				// Send the module ended message
-				playerInfo->PostMessage(AP_MODULE_ENDED);
+				// a position change and then a module end event
+				playerInfo->PostEvent(AP_REPORT_POSITION, endSongPosition);
+				PostModuleEnded();
 				endIndex = -1;
 				retVal = mixed;
 			}
@@ -1550,3 +1582,16 @@ void APMixer::SetNewPosition(void)
 	// Reset the signal event
 	newPosSignal->ResetEvent();
 }
+
+
+
+/******************************************************************************/
+/* PostModuleEnded() will tell the player that the module has ended. Unlike   */
+/*      the position events, this one must not be lost. It is called from the */
+/*      mixer thread, so it does not wait if the event queue is full, but     */
+/*      remembers it and Mixer() tries again with the next buffer.            */
+/******************************************************************************/
+void APMixer::PostModuleEnded(void)
+{
+	moduleEnded = !playerInfo->PostEvent(AP_MODULE_ENDED);
+}
@@ -78,6 +78,7 @@ public:
 	void ResumePlaying(void);
 	void HoldPlaying(bool hold);
 	bool UsingRingBuffers(void) const;
+	bool GetRingThreadStats(PThread::PThreadStats &stats) const;
 
 	void SetSongPosition(int16 newPos);
 
@@ -109,6 +110,8 @@ protected:
 	static int32 RingBufferFiller(void *userData);
 	void SetNewPosition(void);
 
+	void PostModuleEnded(void);
+
 	// Variables
 	PMutex mixerLock;
 	PList<VirtualMixer> mixerList;
@@ -119,6 +122,7 @@ protected:
 	bool holdPlaying;
 	bool samplePlay;
 	bool emulateFilter;
+	bool moduleEnded;		// Set when the module end could not be posted and has to be tried again
 
 	PMutex *playerLock;
 	APPlayer *playerInfo;
@@ -134,6 +138,7 @@ protected:
 	bool playLocked;
 	bool firstTime;
 	bool allMutexesFree;
+	bool memoryLocked;
 
 	int8 playIndex;
 	int8 fillIndex;
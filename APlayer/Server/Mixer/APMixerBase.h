@@ -47,6 +47,7 @@ enum MixerModes
 #define SF_RELEASE				0x1000
 
 // APlayer specific flags
+#define SF_STREAM				0x4000		// Buffer from a sample player
 #define SF_SPEAKER				0x8000
 
 // Panning constants
@@ -166,11 +166,20 @@ void APMixerNormal::DoMixing(int32 *dest, int32 todo, uint32 mode)
 				vnf->lVolSel = lVol;
 			}
 
-			idxSize = (vnf->size)   ? ((int64)vnf->size << FRACBITS) - 1 : 0;
-			idxLEnd = (vnf->repEnd) ? ((int64)vnf->repEnd << FRACBITS) - 1 : 0;
-			idxLPos = (int64)vnf->repPos << FRACBITS;
-			idxREnd = (vnf->releaseLen) ? ((int64)vnf->releaseLen << FRACBITS) - 1 : 0;
-			AddChannel(dest, todo, mode);
+			// Buffers from sample players which are rendered at the
+			// mixer frequency are added directly without resampling.
+			// While the click removal ramps the volume, the normal
+			// mixer routines are used, because they do the ramping
+			if ((vnf->flags & SF_STREAM) && (vnf->flags & SF_16BITS) && (vnf->frq == mixerFreq) && (vnf->rampVol == 0))
+				AddStream(dest, todo, mode);
+			else
+			{
+				idxSize = (vnf->size)   ? ((int64)vnf->size << FRACBITS) - 1 : 0;
+				idxLEnd = (vnf->repEnd) ? ((int64)vnf->repEnd << FRACBITS) - 1 : 0;
+				idxLPos = (int64)vnf->repPos << FRACBITS;
+				idxREnd = (vnf->releaseLen) ? ((int64)vnf->releaseLen << FRACBITS) - 1 : 0;
+				AddChannel(dest, todo, mode);
+			}
 		}
 	}
 }
@@ -481,6 +490,63 @@ void APMixerNormal::AddChannel(int32 *buf, int32 todo, uint32 mode)
 
 
 
+/******************************************************************************/
+/* AddStream() adds a 16 bit sample player buffer into the mixing buffer. The */
+/*      buffer is played at the mixer frequency, so each sample is just       */
+/*      multiplied by the volume and added to the output.                     */
+/*                                                                            */
+/* Input:  "buf" is a pointer to the buffer to fill with the sampling.        */
+/*         "todo" is the size of the buffer in sample pairs.                  */
+/*         "mode" is the mixer mode.                                          */
+/******************************************************************************/
+void APMixerNormal::AddStream(int32 *buf, int32 todo, uint32 mode)
+{
+	const int16 *s;
+	int32 index, done;
+
+	if ((s = (const int16 *)vnf->adr) == NULL)
+	{
+		vnf->current = 0;
+		vnf->active  = false;
+		return;
+	}
+
+	// Find out how much there is left in the buffer
+	index = (int32)(vnf->current >> FRACBITS);
+	done  = min((int32)vnf->size - index, todo);
+
+	if (done <= 0)
+	{
+		vnf->current = 0;
+		vnf->active  = false;
+		return;
+	}
+
+	if (vnf->leftVol || vnf->rightVol)
+	{
+		if (mode & DMODE_STEREO)
+		{
+			if ((vnf->pan == PAN_SURROUND) && (mode & DMODE_SURROUND))
+				Stream16Surround(s + index, buf, done);
+			else
+				Stream16Stereo(s + index, buf, done);
+		}
+		else
+			Stream16Mono(s + index, buf, done);
+	}
+
+	// Update the sample position and stop when the buffer has been played
+	vnf->current += (int64)done << FRACBITS;
+
+	if (done < todo)
+	{
+		vnf->current = 0;
+		vnf->active  = false;
+	}
+}
+
+
+
 /******************************************************************************/
 /* Mix32To16() converts the mixed data to a 16 bit sample buffer.             */
 /*                                                                            */
@@ -1690,3 +1756,72 @@ int64 APMixerNormal::Mix8SurroundInterp64(int8 *source, int32 *dest, int64 index
 
 	return (index);
 }
+
+
+
+/******************************************************************************/
+/* Stream16Mono() adds a 16 bit buffer into a mono output buffer.             */
+/*                                                                            */
+/* Input:  "source" in a pointer to the first sample to add.                  */
+/*         "dest" is a pointer to the store the mixed data.                   */
+/*         "todo" is the number of sample pairs the destination buffer is.    */
+/******************************************************************************/
+void APMixerNormal::Stream16Mono(const int16 *source, int32 *dest, int32 todo)
+{
+	int32 lVolSel = vnf->lVolSel;
+	int32 i;
+
+	for (i = 0; i < todo; i++)
+		dest[i] += lVolSel * source[i];
+}
+
+
+
+/******************************************************************************/
+/* Stream16Stereo() adds a 16 bit buffer into a stereo output buffer.         */
+/*                                                                            */
+/* Input:  "source" in a pointer to the first sample to add.                  */
+/*         "dest" is a pointer to the store the mixed data.                   */
+/*         "todo" is the number of sample pairs the destination buffer is.    */
+/******************************************************************************/
+void APMixerNormal::Stream16Stereo(const int16 *source, int32 *dest, int32 todo)
+{
+	int32 lVolSel = vnf->lVolSel;
+	int32 rVolSel = vnf->rVolSel;
+	int32 i;
+
+	for (i = 0; i < todo; i++)
+	{
+		dest[i * 2]     += lVolSel * source[i];
+		dest[i * 2 + 1] += rVolSel * source[i];
+	}
+}
+
+
+
+/******************************************************************************/
+/* Stream16Surround() adds a 16 bit surround buffer into a stereo output      */
+/*      buffer.                                                               */
+/*                                                                            */
+/* Input:  "source" in a pointer to the first sample to add.                  */
+/*         "dest" is a pointer to the store the mixed data.                   */
+/*         "todo" is the number of sample pairs the destination buffer is.    */
+/******************************************************************************/
+void APMixerNormal::Stream16Surround(const int16 *source, int32 *dest, int32 todo)
+{
+	int32 volSel;
+	int32 i;
+
+	// The signal is put in phase on the loudest side and
+	// out of phase on the other
+	if (vnf->lVolSel >= vnf->rVolSel)
+		volSel = vnf->lVolSel;
+	else
+		volSel = -vnf->rVolSel;
+
+	for (i = 0; i < todo; i++)
+	{
+		dest[i * 2]     += volSel * source[i];
+		dest[i * 2 + 1] -= volSel * source[i];
+	}
+}
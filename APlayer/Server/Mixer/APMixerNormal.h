@@ -40,6 +40,12 @@ protected:
 
 	// Own functions
 	void AddChannel(int32 *buf, int32 todo, uint32 mode);
+	void AddStream(int32 *buf, int32 todo, uint32 mode);
+
+	// Mixer functions for sample player buffers at the mixer frequency
+	void Stream16Mono(const int16 *source, int32 *dest, int32 todo);
+	void Stream16Stereo(const int16 *source, int32 *dest, int32 todo);
+	void Stream16Surround(const int16 *source, int32 *dest, int32 todo);
 
 	// Mixer functions using 32 bit position counter
 	int32 Mix16MonoNormal(int16 *source, int32 *dest, int32 index, int32 increment, int32 todo);
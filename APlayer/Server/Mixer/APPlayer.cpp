@@ -16,6 +16,7 @@
 #include "PTime.h"
 #include "PList.h"
 #include "PSynchronize.h"
+#include "PEventLoop.h"
 
 // APlayerKit headers
 #include "APAddOns.h"
@@ -29,20 +30,24 @@
 /******************************************************************************/
 /* Constructor                                                                */
 /******************************************************************************/
-APPlayer::APPlayer(void) : BLooper("Player Looper")
+APPlayer::APPlayer(void) : timeTableLock(false)
 {
 	// Initialize member variables
 	songNum       = 0;
 	songLength    = 0;
 	moduleSize    = 0;
 
+	timeTableGeneration = 0;
+	timeTableNext       = 0;
+	timeTableStarted    = false;
+
 	infoLock      = NULL;
 
 	playerLock    = NULL;
 	currentPlayer = NULL;
 
-	// Start the BLooper
-	Run();
+	// Start the event loop
+	StartLoop("Player Looper");
 }
 
 
@@ -52,6 +57,8 @@ APPlayer::APPlayer(void) : BLooper("Player Looper")
 /******************************************************************************/
 APPlayer::~APPlayer(void)
 {
+	// Stop the event loop, while EventReceived() can still be called
+	StopLoop();
 }
 
 
@@ -76,6 +83,10 @@ bool APPlayer::InitPlayer(APFileHandle handle, PString &result)
 		// Remember the module length
 		moduleSize = handle.loader->GetModuleSize();
 
+		// Remember the file name, used as key in the duration cache
+		fileName = handle.fileName;
+		timeTableStarted = false;
+
 		// Initialize other stuff
 		moduleFormat = handle.loader->GetModuleFormat();
 		playerName   = handle.loader->GetPlayerName();
@@ -150,6 +161,13 @@ void APPlayer::EndPlayer(void)
 {
 	try
 	{
+		// Stop the time table calculation. When we get the lock,
+		// it is not in the middle of calling the player
+		timeTableLock.Lock();
+		timeTableGeneration++;
+		songTimes.MakeEmpty();
+		timeTableLock.Unlock();
+
 		if (currentPlayer != NULL)
 		{
 			// End the mixer
@@ -245,6 +263,19 @@ void APPlayer::StartPlaying(int16 song)
 	// Start the mixer
 	mixer.StartMixer();
 	ResumePlaying();
+
+	// The time table for the song is ready now. Find the ones for
+	// the other sub songs in the background while playing
+	if (!timeTableStarted)
+	{
+		timeTableStarted = true;
+
+		timeTableLock.Lock();
+		timeTableNext = 0;
+		songTimes.MakeEmpty();
+		PostEvent(AP_CALC_TIMETABLE, timeTableGeneration);
+		timeTableLock.Unlock();
+	}
 }
 
 
@@ -694,13 +725,14 @@ void APPlayer::DisableVirtualMixer(AddOnInfo *agent)
 
 
 /******************************************************************************/
-/* MessageReceived() is called when the player sends some information.        */
+/* EventReceived() is called when the player or mixer sends some              */
+/*      information.                                                          */
 /*                                                                            */
-/* Input:  "msg" is a pointer to the message.                                 */
+/* Input:  "event" is a reference to the event.                               */
 /******************************************************************************/
-void APPlayer::MessageReceived(BMessage *msg)
+void APPlayer::EventReceived(const PQueueEvent &event)
 {
-	switch (msg->what)
+	switch (event.what)
 	{
 		//
 		// The position in the player has changed
@@ -723,18 +755,11 @@ void APPlayer::MessageReceived(BMessage *msg)
 		//
 		case AP_MODULEINFO_CHANGED:
 		{
-			const char *value;
-			int32 line;
+			PString *value = (PString *)event.pointer;
 
-			// Extract the information
-			if (msg->FindInt32("line", &line) == B_OK)
-			{
-				if (msg->FindString("value", &value) == B_OK)
-				{
-					// Send the information to all the clients
-					SendNewInformation(line, value);
-				}
-			}
+			// Send the information to all the clients. The string
+			// is one of the player's slots, so it is not freed here
+			SendNewInformation(event.data, *value);
 			break;
 		}
 
@@ -744,10 +769,7 @@ void APPlayer::MessageReceived(BMessage *msg)
 		//
 		case AP_REPORT_POSITION:
 		{
-			int16 newPos;
-
-			if (msg->FindInt16("position", &newPos) == B_OK)
-				SendNewPosition(newPos);
+			SendNewPosition(event.data);
 			break;
 		}
 
@@ -761,9 +783,14 @@ void APPlayer::MessageReceived(BMessage *msg)
 			break;
 		}
 
-		default:
-			BLooper::MessageReceived(msg);
+		//
+		// Calculate the next time table
+		//
+		case AP_CALC_TIMETABLE:
+		{
+			CalculateTimeTable(event.data);
 			break;
+		}
 	}
 }
 
@@ -821,6 +848,124 @@ void APPlayer::SendModuleEnded(void)
 
 
 
+/******************************************************************************/
+/* SendTimeTableReady() will build and send a "TimeTableReady" command to all */
+/*      the clients.                                                          */
+/*                                                                            */
+/* Input:  "startSong" is the default sub song.                               */
+/*         "timeStr" is the times in milliseconds separated by commas.        */
+/******************************************************************************/
+void APPlayer::SendTimeTableReady(uint16 startSong, PString timeStr)
+{
+	PString command;
+
+	// Build the command
+	command = APServerCommunication::AddArgument("TimeTableReady=", PString::CreateUNumber(startSong));
+	command = APServerCommunication::AddArgument(command, timeStr);
+
+	// And send it to all the clients
+	GetApp()->client->SendCommand(this, command);
+}
+
+
+
+/******************************************************************************/
+/* CalculateTimeTable() will find the time of the next sub song. It is called */
+/*      from the event loop once for each sub song, so the player lock is     */
+/*      only held for a short time. When all the sub songs are walked, the    */
+/*      times are sent to the clients and added to the duration cache if      */
+/*      none of them are missing.                                             */
+/*                                                                            */
+/* Input:  "generation" is the generation number the event was posted with.   */
+/*         If the player has been ended since, nothing is done.               */
+/******************************************************************************/
+void APPlayer::CalculateTimeTable(int32 generation)
+{
+	APDurationScanner *scanner;
+	PList<PTimeSpan> tempTimes;
+	PTimeSpan time;
+	PString timeStr;
+	uint16 startSong;
+	int32 i, count, missing;
+
+	timeTableLock.Lock();
+
+	try
+	{
+		if ((generation == timeTableGeneration) && (currentPlayer != NULL) && (timeTableNext < subSongs[0]))
+		{
+			scanner = GetApp()->client->GetDurationScanner();
+
+			// If the module has been played before, the times are in the cache
+			if ((timeTableNext == 0) && scanner->FindCachedDurations(fileName, startSong, timeStr))
+			{
+				timeTableNext = subSongs[0];
+				SendTimeTableReady(startSong, timeStr);
+			}
+			else
+			{
+				// Let the player calculate the time table
+				playerLock->Lock();
+
+				try
+				{
+					time = currentPlayer->GetTimeTable(timeTableNext, tempTimes);
+				}
+				catch(...)
+				{
+					playerLock->Unlock();
+					throw;
+				}
+
+				playerLock->Unlock();
+
+				// A sub song without a time is stored as 0, so the
+				// rest of the sub songs are still found
+				songTimes.AddTail(time);
+				timeTableNext++;
+
+				if (timeTableNext < subSongs[0])
+					PostEvent(AP_CALC_TIMETABLE, generation);
+				else
+				{
+					// All the sub songs have been walked
+					missing = 0;
+
+					count = songTimes.CountItems();
+					for (i = 0; i < count; i++)
+					{
+						if (i != 0)
+							timeStr += ",";
+
+						time = songTimes.GetItem(i);
+						if (time.GetTotalMilliSeconds() == 0)
+							missing++;
+
+						timeStr += PString::CreateNumber64(time.GetTotalMilliSeconds());
+					}
+
+					// Only complete time tables are cached, so the duration
+					// scanner can render the missing ones later
+					if (missing == 0)
+						scanner->AddDurations(fileName, subSongs[1], timeStr);
+
+					// Nothing to tell if the player has no time tables at all
+					if (missing < count)
+						SendTimeTableReady(subSongs[1], timeStr);
+				}
+			}
+		}
+	}
+	catch(...)
+	{
+		;
+	}
+
+	timeTableLock.Unlock();
+}
+
+
+
 /******************************************************************************/
 /* FindAuthor() returns the author of the module.                             */
 /*                                                                            */
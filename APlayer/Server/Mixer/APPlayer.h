@@ -18,16 +18,24 @@
 #include "PTime.h"
 #include "PList.h"
 #include "PSynchronize.h"
+#include "PEventLoop.h"
 
 // Server headers
 #include "APClientCommunication.h"
 #include "APMixer.h"
 
 
+/******************************************************************************/
+/* Internal events                                                            */
+/******************************************************************************/
+#define AP_CALC_TIMETABLE				'_ACT'
+
+
+
 /******************************************************************************/
 /* APPlayer class                                                             */
 /******************************************************************************/
-class APPlayer : public BLooper
+class APPlayer : public PEventLoop
 {
 public:
 	APPlayer(void);
@@ -77,11 +85,14 @@ public:
 	void DisableVirtualMixer(AddOnInfo *agent);
 
 protected:
-	virtual void MessageReceived(BMessage *message);
+	virtual void EventReceived(const PQueueEvent &event);
 
 	void SendNewPosition(int16 position);
 	void SendNewInformation(int32 line, PString value);
 	void SendModuleEnded(void);
+	void SendTimeTableReady(uint16 startSong, PString timeStr);
+
+	void CalculateTimeTable(int32 generation);
 
 	PString FindAuthor(void);
 	PString FindAuthorInList(PList<PString> &list);
@@ -97,6 +108,14 @@ protected:
 	PTimeSpan totalTime;
 	PList<PTimeSpan> posTimes;
 
+	// Time tables of all the sub songs, calculated in the background
+	PString fileName;
+	PMutex timeTableLock;
+	int32 timeTableGeneration;
+	uint16 timeTableNext;
+	bool timeTableStarted;
+	PList<PTimeSpan> songTimes;
+
 	PString moduleFormat;
 	PString playerName;
 	uint32 moduleSize;
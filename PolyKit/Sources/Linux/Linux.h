@@ -0,0 +1,102 @@
+/******************************************************************************/
+/* Linux header file.                                                         */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+#ifndef __Linux_h
+#define __Linux_h
+
+// Standard
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+// POSIX headers
+#include <endian.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+
+/******************************************************************************/
+/* The BeOS types and functions used by the shared PolyKit code               */
+/******************************************************************************/
+typedef int64_t bigtime_t;
+typedef int32_t thread_id;
+typedef int32_t status_t;
+
+#define is_instance_of(object, class)	(dynamic_cast<class *>(object) != NULL)
+
+
+
+/******************************************************************************/
+/* find_thread() returns the kernel id of the calling thread. The id is       */
+/*      cached per thread, so only the first call goes to the kernel.         */
+/*                                                                            */
+/* Input:  "name" must be NULL.                                               */
+/*                                                                            */
+/* Output: The thread id.                                                     */
+/******************************************************************************/
+inline thread_id find_thread(const char * /*name*/)
+{
+	static __thread thread_id threadID = 0;
+
+	if (threadID == 0)
+		threadID = (thread_id)syscall(SYS_gettid);
+
+	return (threadID);
+}
+
+
+
+/******************************************************************************/
+/* system_time() returns the time since boot in microseconds.                 */
+/*                                                                            */
+/* Output: The time in microseconds.                                          */
+/******************************************************************************/
+inline bigtime_t system_time(void)
+{
+	struct timespec spec;
+
+	clock_gettime(CLOCK_MONOTONIC, &spec);
+	return (((bigtime_t)spec.tv_sec * 1000000) + (spec.tv_nsec / 1000));
+}
+
+
+
+/******************************************************************************/
+/* snooze() will sleep the number of microseconds given.                      */
+/*                                                                            */
+/* Input:  "microSeconds" is the time to sleep.                               */
+/******************************************************************************/
+inline void snooze(bigtime_t microSeconds)
+{
+	usleep(microSeconds);
+}
+
+
+
+/******************************************************************************/
+/* debugger() is called by failed assertions in debug builds. It prints the  */
+/*      message and stops the program, like the BeOS debugger would.          */
+/*                                                                            */
+/* Input:  "message" is the assertion message.                                */
+/******************************************************************************/
+inline void debugger(const char *message)
+{
+	fprintf(stderr, "%s\n", message);
+	abort();
+}
+
+#endif
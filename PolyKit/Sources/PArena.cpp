@@ -0,0 +1,223 @@
+/******************************************************************************/
+/* PArena implementation file.                                                */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#define _BUILDING_POLYKIT_LIBRARY_
+
+// PolyKit headers
+#include "POS.h"
+#include "PException.h"
+#include "PArena.h"
+
+
+/******************************************************************************/
+/* Arena constants                                                            */
+/******************************************************************************/
+#define P_ARENA_ALIGN				8		// All allocations are aligned to this
+#define P_ARENA_HEADER				((sizeof(PArenaBlock) + P_ARENA_ALIGN - 1) & ~(P_ARENA_ALIGN - 1))
+
+
+
+/******************************************************************************/
+/* PArena class                                                               */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/*                                                                            */
+/* Input:  "blockSize" is the number of bytes to allocate from the system at  */
+/*         once.                                                              */
+/******************************************************************************/
+PArena::PArena(uint32 blockSize)
+{
+	// Initialize member variables
+	firstBlock      = NULL;
+	this->blockSize = blockSize;
+	allocated       = 0;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PArena::~PArena(void)
+{
+	FreeBlocks(firstBlock);
+}
+
+
+
+/******************************************************************************/
+/* Allocate() returns a piece of memory from the arena. The memory is not     */
+/*      cleared and is valid until FreeAll() is called or the arena is        */
+/*      destroyed.                                                            */
+/*                                                                            */
+/* Input:  "size" is the number of bytes to allocate.                         */
+/*                                                                            */
+/* Output: A pointer to the memory, aligned to 8 bytes.                       */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+void *PArena::Allocate(uint32 size)
+{
+	PArenaBlock *block;
+	uint8 *memory;
+
+	// Sizes which would wrap around when rounded up or when the
+	// block header is added can never be allocated
+	if (size > (0xffffffff - P_ARENA_HEADER - P_ARENA_ALIGN))
+		throw PMemoryException();
+
+	// Round up the size, so the next allocation is aligned too
+	size = (size + P_ARENA_ALIGN - 1) & ~(P_ARENA_ALIGN - 1);
+
+	block = firstBlock;
+	if ((block == NULL) || ((block->size - block->used) < size))
+	{
+		if (size > (blockSize / 4))
+		{
+			// Big allocations get a block of their own. It is put after
+			// the current block, so the rest of that can still be used
+			block       = NewBlock(size);
+			block->used = size;
+
+			if (firstBlock == NULL)
+			{
+				block->next = NULL;
+				firstBlock  = block;
+			}
+			else
+			{
+				block->next      = firstBlock->next;
+				firstBlock->next = block;
+			}
+
+			allocated += size;
+			return ((uint8 *)block + P_ARENA_HEADER);
+		}
+
+		// Start a new block
+		block       = NewBlock(blockSize);
+		block->next = firstBlock;
+		firstBlock  = block;
+	}
+
+	// Take the memory from the block
+	memory       = (uint8 *)block + P_ARENA_HEADER + block->used;
+	block->used += size;
+	allocated   += size;
+
+	return (memory);
+}
+
+
+
+/******************************************************************************/
+/* Allocate() returns memory for an array from the arena.                     */
+/*                                                                            */
+/* Input:  "count" is the number of elements to allocate.                     */
+/*         "size" is the size of each element in bytes.                       */
+/*                                                                            */
+/* Output: A pointer to the memory, aligned to 8 bytes.                       */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+void *PArena::Allocate(uint32 count, uint32 size)
+{
+	// Check the total size does not overflow
+	if ((size != 0) && (count > (0xffffffff / size)))
+		throw PMemoryException();
+
+	return (Allocate(count * size));
+}
+
+
+
+/******************************************************************************/
+/* FreeAll() frees all the memory allocated from the arena. One normal block  */
+/*      is kept, so the next module loaded does not have to start from        */
+/*      scratch.                                                              */
+/******************************************************************************/
+void PArena::FreeAll(void)
+{
+	if ((firstBlock != NULL) && (firstBlock->size == blockSize))
+	{
+		// Keep the first block and empty it
+		FreeBlocks(firstBlock->next);
+		firstBlock->next = NULL;
+		firstBlock->used = 0;
+	}
+	else
+	{
+		FreeBlocks(firstBlock);
+		firstBlock = NULL;
+	}
+
+	allocated = 0;
+}
+
+
+
+/******************************************************************************/
+/* GetAllocatedSize() returns the number of bytes handed out by the arena     */
+/*      since it was last freed.                                              */
+/*                                                                            */
+/* Output: The number of bytes.                                               */
+/******************************************************************************/
+uint32 PArena::GetAllocatedSize(void) const
+{
+	return (allocated);
+}
+
+
+
+/******************************************************************************/
+/* NewBlock() allocates a new empty block.                                    */
+/*                                                                            */
+/* Input:  "size" is the number of bytes the block can hold.                  */
+/*                                                                            */
+/* Output: A pointer to the block.                                            */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+PArena::PArenaBlock *PArena::NewBlock(uint32 size)
+{
+	PArenaBlock *block;
+
+	block = (PArenaBlock *)new uint8[P_ARENA_HEADER + size];
+	if (block == NULL)
+		throw PMemoryException();
+
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+
+	return (block);
+}
+
+
+
+/******************************************************************************/
+/* FreeBlocks() frees a chain of blocks.                                      */
+/*                                                                            */
+/* Input:  "block" is a pointer to the first block to free.                   */
+/******************************************************************************/
+void PArena::FreeBlocks(PArenaBlock *block)
+{
+	PArenaBlock *next;
+
+	while (block != NULL)
+	{
+		next = block->next;
+		delete[] (uint8 *)block;
+		block = next;
+	}
+}
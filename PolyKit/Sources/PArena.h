@@ -0,0 +1,64 @@
+/******************************************************************************/
+/* PArena header file.                                                        */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __PArena_h
+#define __PArena_h
+
+// PolyKit headers
+#include "POS.h"
+#include "ImportExport.h"
+
+
+/******************************************************************************/
+/* PArena class                                                               */
+/*                                                                            */
+/* An arena hands out memory from big blocks by moving a pointer, and all the */
+/* memory is freed at once with FreeAll(). There is no way to free a single   */
+/* allocation, and no destructors are called, so only use it for plain data.  */
+/******************************************************************************/
+#if __p_os == __p_beos && __POWERPC__
+#pragma export on
+#endif
+
+class _IMPEXP_PKLIB PArena
+{
+public:
+	PArena(uint32 blockSize = 65536);
+	virtual ~PArena(void);
+
+	void *Allocate(uint32 size);
+	void *Allocate(uint32 count, uint32 size);
+	template<class TYPE> TYPE *AllocateArray(uint32 count) { return ((TYPE *)Allocate(count, sizeof(TYPE))); };
+
+	void FreeAll(void);
+	uint32 GetAllocatedSize(void) const;
+
+protected:
+	typedef struct PArenaBlock
+	{
+		PArenaBlock *next;
+		uint32 size;
+		uint32 used;
+	} PArenaBlock;
+
+	PArenaBlock *NewBlock(uint32 size);
+	void FreeBlocks(PArenaBlock *block);
+
+	PArenaBlock *firstBlock;	// The block being filled is always the first one
+	uint32 blockSize;
+	uint32 allocated;
+};
+
+#if __p_os == __p_beos && __POWERPC__
+#pragma export off
+#endif
+
+#endif
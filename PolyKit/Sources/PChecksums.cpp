@@ -15,9 +15,81 @@
 
 // PolyKit headers
 #include "POS.h"
+#include "PFile.h"
 #include "PChecksums.h"
 
 
+/******************************************************************************/
+/* Number of bytes AddFile() reads or views at a time                         */
+/******************************************************************************/
+#define P_CHECKSUM_CHUNK		32768
+
+
+
+/******************************************************************************/
+/* PChecksum class                                                            */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+PChecksum::PChecksum(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PChecksum::~PChecksum(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* AddFile() will add the rest of a file to be included in the final          */
+/*      checksum. If the file holds its data in memory, the data is used      */
+/*      directly, else it is read in chunks.                                  */
+/*                                                                            */
+/* Input:  "file" is a pointer to the file to add. It has to be open.         */
+/*                                                                            */
+/* Except: PFileException.                                                    */
+/******************************************************************************/
+void PChecksum::AddFile(PFile *file)
+{
+	uint8 buffer[P_CHECKSUM_CHUNK];
+	const uint8 *view;
+	int64 left;
+	int32 len;
+
+	left = file->GetLength() - file->GetPosition();
+
+	while (left > 0)
+	{
+		len = (int32)min(left, P_CHECKSUM_CHUNK);
+
+		view = file->ReadView(len);
+		if (view != NULL)
+			AddBuffer(view, len);
+		else
+		{
+			len = file->Read(buffer, len);
+			if (len <= 0)
+				break;
+
+			AddBuffer(buffer, len);
+		}
+
+		left -= len;
+	}
+}
+
+
+
+
+
 /******************************************************************************/
 /* PMD5 class                                                                 */
 /*                                                                            */
@@ -148,6 +220,26 @@ static uint8 padBuffer[64] =
 PMD5::PMD5(void)
 {
 	// Initialize member variables
+	Reset();
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PMD5::~PMD5(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* Reset() will start a new checksum. It has to be called before the object   */
+/*      is used again after CalculateChecksum().                              */
+/******************************************************************************/
+void PMD5::Reset(void)
+{
 	count[0]  = 0;
 	count[1]  = 0;
 
@@ -162,15 +254,6 @@ PMD5::PMD5(void)
 
 
 
-/******************************************************************************/
-/* Destructor                                                                 */
-/******************************************************************************/
-PMD5::~PMD5(void)
-{
-}
-
-
-
 /******************************************************************************/
 /* AddBuffer() will add a memory buffer to be included in the final checksum. */
 /*                                                                            */
@@ -480,3 +563,1021 @@ void PMD5::From32BitToByte(uint8 *dest, const uint32 *source, int32 length)
 		dest[j + 3] = ((source[i] >> 24) & 0xff);
 	}
 }
+
+
+
+
+
+/******************************************************************************/
+/* PXXH3 class                                                                */
+/*                                                                            */
+/* This is an implementation of the XXH3 hash by Yann Collet, using the       */
+/* default secret and no seed. The hashes are the same as the ones made by    */
+/* the xxHash library.                                                        */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Different constants used in the algorithm                                  */
+/******************************************************************************/
+#define XXH_PRIME32_1			0x9e3779b1U
+#define XXH_PRIME32_2			0x85ebca77U
+#define XXH_PRIME32_3			0xc2b2ae3dU
+
+#define XXH_PRIME64_1			0x9e3779b185ebca87ULL
+#define XXH_PRIME64_2			0xc2b2ae3d27d4eb4fULL
+#define XXH_PRIME64_3			0x165667b19e3779f9ULL
+#define XXH_PRIME64_4			0x85ebca77c2b2ae63ULL
+#define XXH_PRIME64_5			0x27d4eb2f165667c5ULL
+
+#define XXH_PRIME_MX1			0x165667919e3779f9ULL
+#define XXH_PRIME_MX2			0x9fb21c651e98df25ULL
+
+// Sizes
+#define XXH_SECRET_SIZE			192
+#define XXH_SECRET_SIZE_MIN		136
+#define XXH_STRIPE_LEN			64
+#define XXH_SECRET_RATE			8		// Secret bytes used per stripe
+#define XXH_STRIPES_PER_BLOCK	((XXH_SECRET_SIZE - XXH_STRIPE_LEN) / XXH_SECRET_RATE)
+#define XXH_SECRET_LIMIT		(XXH_SECRET_SIZE - XXH_STRIPE_LEN)
+#define XXH_BUFFER_STRIPES		4
+
+// Offsets into the secret
+#define XXH_MIDSIZE_MAX			240
+#define XXH_MIDSIZE_START		3
+#define XXH_MIDSIZE_LAST		17
+#define XXH_LASTACC_START		7
+#define XXH_MERGEACCS_START		11
+
+
+
+/******************************************************************************/
+/* The default secret                                                         */
+/******************************************************************************/
+static const uint8 xxhSecret[XXH_SECRET_SIZE] =
+{
+	0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+	0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+	0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+	0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+	0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+	0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+	0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+	0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+	0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+	0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+	0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+	0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+
+
+/******************************************************************************/
+/* Helper functions                                                           */
+/******************************************************************************/
+static inline uint32 ReadLE32(const uint8 *p)
+{
+	uint32 val;
+
+	memcpy(&val, p, 4);
+	return (P_LENDIAN_TO_HOST_INT32(val));
+}
+
+
+
+static inline uint64 ReadLE64(const uint8 *p)
+{
+	uint64 val;
+
+	memcpy(&val, p, 8);
+	return (P_LENDIAN_TO_HOST_INT64(val));
+}
+
+
+
+static inline uint32 Swap32(uint32 x)
+{
+	return ((x << 24) | ((x << 8) & 0x00ff0000) | ((x >> 8) & 0x0000ff00) | (x >> 24));
+}
+
+
+
+static inline uint64 Swap64(uint64 x)
+{
+	return (((uint64)Swap32((uint32)x) << 32) | Swap32((uint32)(x >> 32)));
+}
+
+
+
+static inline uint64 RotateLeft64(uint64 x, int32 n)
+{
+	return ((x << n) | (x >> (64 - n)));
+}
+
+
+
+// Multiplies two 64-bit numbers into a 128-bit result
+static inline void Multiply128(uint64 a, uint64 b, uint64 &low, uint64 &high)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 product = (unsigned __int128)a * b;
+
+	low  = (uint64)product;
+	high = (uint64)(product >> 64);
+#else
+	uint64 loLo, hiLo, loHi, hiHi, cross;
+
+	loLo  = (a & 0xffffffff) * (b & 0xffffffff);
+	hiLo  = (a >> 32) * (b & 0xffffffff);
+	loHi  = (a & 0xffffffff) * (b >> 32);
+	hiHi  = (a >> 32) * (b >> 32);
+	cross = (loLo >> 32) + (hiLo & 0xffffffff) + loHi;
+
+	low  = (cross << 32) | (loLo & 0xffffffff);
+	high = (hiLo >> 32) + (cross >> 32) + hiHi;
+#endif
+}
+
+
+
+static inline uint64 MultiplyFold64(uint64 a, uint64 b)
+{
+	uint64 low, high;
+
+	Multiply128(a, b, low, high);
+	return (low ^ high);
+}
+
+
+
+static inline uint64 XXH64Avalanche(uint64 h)
+{
+	h ^= h >> 33;
+	h *= XXH_PRIME64_2;
+	h ^= h >> 29;
+	h *= XXH_PRIME64_3;
+	h ^= h >> 32;
+	return (h);
+}
+
+
+
+static inline uint64 Avalanche(uint64 h)
+{
+	h ^= h >> 37;
+	h *= XXH_PRIME_MX1;
+	h ^= h >> 32;
+	return (h);
+}
+
+
+
+static inline uint64 RRMXMX(uint64 h, uint64 len)
+{
+	h ^= RotateLeft64(h, 49) ^ RotateLeft64(h, 24);
+	h *= XXH_PRIME_MX2;
+	h ^= (h >> 35) + len;
+	h *= XXH_PRIME_MX2;
+	h ^= h >> 28;
+	return (h);
+}
+
+
+
+static inline uint64 Mix16(const uint8 *input, const uint8 *secret)
+{
+	return (MultiplyFold64(ReadLE64(input) ^ ReadLE64(secret), ReadLE64(input + 8) ^ ReadLE64(secret + 8)));
+}
+
+
+
+static inline void Mix32(uint64 &low, uint64 &high, const uint8 *input1, const uint8 *input2, const uint8 *secret)
+{
+	low  += Mix16(input1, secret);
+	low  ^= ReadLE64(input2) + ReadLE64(input2 + 8);
+	high += Mix16(input2, secret + 16);
+	high ^= ReadLE64(input1) + ReadLE64(input1 + 8);
+}
+
+
+
+// Adds one stripe of 64 bytes to the accumulators
+static inline void Accumulate512(uint64 *acc, const uint8 *input, const uint8 *secret)
+{
+	uint64 data, key;
+	int32 i;
+
+	for (i = 0; i < 8; i++)
+	{
+		data        = ReadLE64(input + i * 8);
+		key         = data ^ ReadLE64(secret + i * 8);
+		acc[i ^ 1] += data;
+		acc[i]     += (key & 0xffffffff) * (key >> 32);
+	}
+}
+
+
+
+static inline void Accumulate(uint64 *acc, const uint8 *input, const uint8 *secret, uint32 stripes)
+{
+	uint32 i;
+
+	for (i = 0; i < stripes; i++)
+		Accumulate512(acc, input + i * XXH_STRIPE_LEN, secret + i * XXH_SECRET_RATE);
+}
+
+
+
+static inline void Scramble(uint64 *acc, const uint8 *secret)
+{
+	int32 i;
+
+	for (i = 0; i < 8; i++)
+	{
+		acc[i] ^= acc[i] >> 47;
+		acc[i] ^= ReadLE64(secret + i * 8);
+		acc[i] *= XXH_PRIME32_1;
+	}
+}
+
+
+
+static inline void InitAccs(uint64 *acc)
+{
+	acc[0] = XXH_PRIME32_3;
+	acc[1] = XXH_PRIME64_1;
+	acc[2] = XXH_PRIME64_2;
+	acc[3] = XXH_PRIME64_3;
+	acc[4] = XXH_PRIME64_4;
+	acc[5] = XXH_PRIME32_2;
+	acc[6] = XXH_PRIME64_5;
+	acc[7] = XXH_PRIME32_1;
+}
+
+
+
+static inline void StoreBE64(uint8 *dest, uint64 val)
+{
+	int32 i;
+
+	for (i = 7; i >= 0; i--)
+	{
+		dest[i] = (uint8)val;
+		val   >>= 8;
+	}
+}
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+PXXH3::PXXH3(void)
+{
+	// Initialize member variables
+	Reset();
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PXXH3::~PXXH3(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* Reset() will start a new checksum.                                         */
+/******************************************************************************/
+void PXXH3::Reset(void)
+{
+	InitAccs(curAcc);
+
+	bufferedSize = 0;
+	stripesSoFar = 0;
+	totalLength  = 0;
+}
+
+
+
+/******************************************************************************/
+/* AddBuffer() will add a memory buffer to be included in the final checksum. */
+/*                                                                            */
+/* Input:  "buffer" is a pointer to the buffer to add.                        */
+/*         "length" is the length of the buffer.                              */
+/******************************************************************************/
+void PXXH3::AddBuffer(const uint8 *buffer, int32 length)
+{
+	const uint8 *end = buffer + length;
+	uint32 loadSize;
+
+	totalLength += length;
+
+	// Small additions are just collected in the buffer
+	if ((uint32)length <= (sizeof(tempBuffer) - bufferedSize))
+	{
+		memcpy(tempBuffer + bufferedSize, buffer, length);
+		bufferedSize += length;
+		return;
+	}
+
+	// Fill up and hash the buffer first
+	if (bufferedSize != 0)
+	{
+		loadSize = sizeof(tempBuffer) - bufferedSize;
+		memcpy(tempBuffer + bufferedSize, buffer, loadSize);
+		buffer += loadSize;
+
+		ConsumeStripes(curAcc, stripesSoFar, tempBuffer, XXH_BUFFER_STRIPES);
+		bufferedSize = 0;
+	}
+
+	// Hash the rest directly from the input, but always keep the last
+	// bytes, since the final stripe is handled in a special way
+	if ((end - buffer) > (int32)sizeof(tempBuffer))
+	{
+		buffer = ConsumeStripes(curAcc, stripesSoFar, buffer, (end - buffer - 1) / XXH_STRIPE_LEN);
+
+		// Remember the last stripe, in case it is needed by the final stripe
+		memcpy(tempBuffer + sizeof(tempBuffer) - XXH_STRIPE_LEN, buffer - XXH_STRIPE_LEN, XXH_STRIPE_LEN);
+	}
+
+	memcpy(tempBuffer, buffer, end - buffer);
+	bufferedSize = end - buffer;
+}
+
+
+
+/******************************************************************************/
+/* CalculateChecksum64() will calculate the 64 bit checksum of all the bytes  */
+/*      added. More bytes can be added afterwards.                            */
+/*                                                                            */
+/* Output: The checksum.                                                      */
+/******************************************************************************/
+uint64 PXXH3::CalculateChecksum64(void) const
+{
+	uint64 acc[8];
+
+	if (totalLength <= XXH_MIDSIZE_MAX)
+		return (Hash64(tempBuffer, (uint32)totalLength));
+
+	DigestLong(acc);
+	return (MergeAccs(acc, xxhSecret + XXH_MERGEACCS_START, totalLength * XXH_PRIME64_1));
+}
+
+
+
+/******************************************************************************/
+/* CalculateChecksum128() will calculate the 128 bit checksum of all the      */
+/*      bytes added and return a pointer to a buffer holding the checksum.    */
+/*      More bytes can be added afterwards.                                   */
+/*                                                                            */
+/* Output: A pointer to the buffer holding the 16 bytes long checksum. The    */
+/*         bytes are in the same order as the hex string from xxHash.         */
+/******************************************************************************/
+const uint8 *PXXH3::CalculateChecksum128(void)
+{
+	uint64 acc[8];
+	uint64 low, high;
+
+	if (totalLength <= XXH_MIDSIZE_MAX)
+		Hash128(tempBuffer, (uint32)totalLength, low, high);
+	else
+	{
+		DigestLong(acc);
+		low  = MergeAccs(acc, xxhSecret + XXH_MERGEACCS_START, totalLength * XXH_PRIME64_1);
+		high = MergeAccs(acc, xxhSecret + XXH_SECRET_SIZE - sizeof(acc) - XXH_MERGEACCS_START, ~(totalLength * XXH_PRIME64_2));
+	}
+
+	StoreBE64(checksum, high);
+	StoreBE64(checksum + 8, low);
+
+	return (checksum);
+}
+
+
+
+/******************************************************************************/
+/* Checksum64() will calculate the 64 bit checksum of a single buffer.        */
+/*                                                                            */
+/* Input:  "buffer" is a pointer to the buffer.                               */
+/*         "length" is the length of the buffer.                              */
+/*                                                                            */
+/* Output: The checksum.                                                      */
+/******************************************************************************/
+uint64 PXXH3::Checksum64(const uint8 *buffer, int32 length)
+{
+	return (Hash64(buffer, length));
+}
+
+
+
+/******************************************************************************/
+/* Checksum128() will calculate the 128 bit checksum of a single buffer.      */
+/*                                                                            */
+/* Input:  "buffer" is a pointer to the buffer.                               */
+/*         "length" is the length of the buffer.                              */
+/*         "checksum" is where to store the 16 bytes long checksum.           */
+/******************************************************************************/
+void PXXH3::Checksum128(const uint8 *buffer, int32 length, uint8 *checksum)
+{
+	uint64 low, high;
+
+	Hash128(buffer, length, low, high);
+
+	StoreBE64(checksum, high);
+	StoreBE64(checksum + 8, low);
+}
+
+
+
+/******************************************************************************/
+/* DigestLong() will hash the bytes left in the buffer into a copy of the     */
+/*      accumulators, so more bytes can still be added.                       */
+/*                                                                            */
+/* Input:  "acc" is where to store the accumulators.                          */
+/******************************************************************************/
+void PXXH3::DigestLong(uint64 *acc) const
+{
+	uint8 lastStripe[XXH_STRIPE_LEN];
+	const uint8 *lastStripePtr;
+	uint32 stripes, catchUp;
+
+	memcpy(acc, curAcc, sizeof(curAcc));
+	stripes = stripesSoFar;
+
+	if (bufferedSize >= XXH_STRIPE_LEN)
+	{
+		ConsumeStripes(acc, stripes, tempBuffer, (bufferedSize - 1) / XXH_STRIPE_LEN);
+		lastStripePtr = tempBuffer + bufferedSize - XXH_STRIPE_LEN;
+	}
+	else
+	{
+		// The last stripe is made of the end of the previous one
+		catchUp = XXH_STRIPE_LEN - bufferedSize;
+		memcpy(lastStripe, tempBuffer + sizeof(tempBuffer) - catchUp, catchUp);
+		memcpy(lastStripe + catchUp, tempBuffer, bufferedSize);
+		lastStripePtr = lastStripe;
+	}
+
+	Accumulate512(acc, lastStripePtr, xxhSecret + XXH_SECRET_LIMIT - XXH_LASTACC_START);
+}
+
+
+
+/******************************************************************************/
+/* Hash64() will calculate the 64 bit hash of a buffer.                       */
+/*                                                                            */
+/* Input:  "input" is a pointer to the buffer.                                */
+/*         "length" is the length of the buffer.                              */
+/*                                                                            */
+/* Output: The hash.                                                          */
+/******************************************************************************/
+uint64 PXXH3::Hash64(const uint8 *input, uint32 length)
+{
+	uint64 acc[8];
+	uint64 accLong, accEnd, inputLo, inputHi;
+	uint32 combined, i;
+
+	if (length <= 16)
+	{
+		if (length > 8)
+		{
+			inputLo = ReadLE64(input) ^ (ReadLE64(xxhSecret + 24) ^ ReadLE64(xxhSecret + 32));
+			inputHi = ReadLE64(input + length - 8) ^ (ReadLE64(xxhSecret + 40) ^ ReadLE64(xxhSecret + 48));
+			return (Avalanche(length + Swap64(inputLo) + inputHi + MultiplyFold64(inputLo, inputHi)));
+		}
+
+		if (length >= 4)
+		{
+			inputLo = ReadLE32(input + length - 4) + ((uint64)ReadLE32(input) << 32);
+			return (RRMXMX(inputLo ^ (ReadLE64(xxhSecret + 8) ^ ReadLE64(xxhSecret + 16)), length));
+		}
+
+		if (length > 0)
+		{
+			combined = ((uint32)input[0] << 16) | ((uint32)input[length >> 1] << 24) | input[length - 1] | (length << 8);
+			return (XXH64Avalanche(combined ^ (uint64)(ReadLE32(xxhSecret) ^ ReadLE32(xxhSecret + 4))));
+		}
+
+		return (XXH64Avalanche(ReadLE64(xxhSecret + 56) ^ ReadLE64(xxhSecret + 64)));
+	}
+
+	if (length <= 128)
+	{
+		accLong = length * XXH_PRIME64_1;
+
+		if (length > 32)
+		{
+			if (length > 64)
+			{
+				if (length > 96)
+				{
+					accLong += Mix16(input + 48, xxhSecret + 96);
+					accLong += Mix16(input + length - 64, xxhSecret + 112);
+				}
+
+				accLong += Mix16(input + 32, xxhSecret + 64);
+				accLong += Mix16(input + length - 48, xxhSecret + 80);
+			}
+
+			accLong += Mix16(input + 16, xxhSecret + 32);
+			accLong += Mix16(input + length - 32, xxhSecret + 48);
+		}
+
+		accLong += Mix16(input, xxhSecret);
+		accLong += Mix16(input + length - 16, xxhSecret + 16);
+
+		return (Avalanche(accLong));
+	}
+
+	if (length <= XXH_MIDSIZE_MAX)
+	{
+		accLong = length * XXH_PRIME64_1;
+
+		for (i = 0; i < 8; i++)
+			accLong += Mix16(input + 16 * i, xxhSecret + 16 * i);
+
+		accLong = Avalanche(accLong);
+		accEnd  = Mix16(input + length - 16, xxhSecret + XXH_SECRET_SIZE_MIN - XXH_MIDSIZE_LAST);
+
+		for (i = 8; i < length / 16; i++)
+			accEnd += Mix16(input + 16 * i, xxhSecret + 16 * (i - 8) + XXH_MIDSIZE_START);
+
+		return (Avalanche(accLong + accEnd));
+	}
+
+	HashLong(acc, input, length);
+	return (MergeAccs(acc, xxhSecret + XXH_MERGEACCS_START, length * XXH_PRIME64_1));
+}
+
+
+
+/******************************************************************************/
+/* Hash128() will calculate the 128 bit hash of a buffer.                     */
+/*                                                                            */
+/* Input:  "input" is a pointer to the buffer.                                */
+/*         "length" is the length of the buffer.                              */
+/*         "low" is where to store the low 64 bits of the hash.               */
+/*         "high" is where to store the high 64 bits of the hash.             */
+/******************************************************************************/
+void PXXH3::Hash128(const uint8 *input, uint32 length, uint64 &low, uint64 &high)
+{
+	uint64 acc[8];
+	uint64 inputLo, inputHi, mulLow, mulHigh;
+	uint32 combined, i;
+
+	if (length <= 16)
+	{
+		if (length > 8)
+		{
+			inputLo = ReadLE64(input);
+			inputHi = ReadLE64(input + length - 8);
+			Multiply128(inputLo ^ inputHi ^ (ReadLE64(xxhSecret + 32) ^ ReadLE64(xxhSecret + 40)), XXH_PRIME64_1, mulLow, mulHigh);
+
+			mulLow  += (uint64)(length - 1) << 54;
+			inputHi ^= ReadLE64(xxhSecret + 48) ^ ReadLE64(xxhSecret + 56);
+			mulHigh += inputHi + (uint64)(uint32)inputHi * (XXH_PRIME32_2 - 1);
+			mulLow  ^= Swap64(mulHigh);
+
+			Multiply128(mulLow, XXH_PRIME64_2, low, high);
+			high += mulHigh * XXH_PRIME64_2;
+
+			low  = Avalanche(low);
+			high = Avalanche(high);
+			return;
+		}
+
+		if (length >= 4)
+		{
+			inputLo = ReadLE32(input) + ((uint64)ReadLE32(input + length - 4) << 32);
+			Multiply128(inputLo ^ (ReadLE64(xxhSecret + 16) ^ ReadLE64(xxhSecret + 24)), XXH_PRIME64_1 + (length << 2), mulLow, mulHigh);
+
+			mulHigh += mulLow << 1;
+			mulLow  ^= mulHigh >> 3;
+			mulLow  ^= mulLow >> 35;
+			mulLow  *= XXH_PRIME_MX2;
+			mulLow  ^= mulLow >> 28;
+
+			low  = mulLow;
+			high = Avalanche(mulHigh);
+			return;
+		}
+
+		if (length > 0)
+		{
+			combined = ((uint32)input[0] << 16) | ((uint32)input[length >> 1] << 24) | input[length - 1] | (length << 8);
+			low      = XXH64Avalanche(combined ^ (uint64)(ReadLE32(xxhSecret) ^ ReadLE32(xxhSecret + 4)));
+
+			combined = Swap32(combined);
+			combined = (combined << 13) | (combined >> 19);
+			high     = XXH64Avalanche(combined ^ (uint64)(ReadLE32(xxhSecret + 8) ^ ReadLE32(xxhSecret + 12)));
+			return;
+		}
+
+		low  = XXH64Avalanche(ReadLE64(xxhSecret + 64) ^ ReadLE64(xxhSecret + 72));
+		high = XXH64Avalanche(ReadLE64(xxhSecret + 80) ^ ReadLE64(xxhSecret + 88));
+		return;
+	}
+
+	if (length <= XXH_MIDSIZE_MAX)
+	{
+		low  = length * XXH_PRIME64_1;
+		high = 0;
+
+		if (length <= 128)
+		{
+			if (length > 32)
+			{
+				if (length > 64)
+				{
+					if (length > 96)
+						Mix32(low, high, input + 48, input + length - 64, xxhSecret + 96);
+
+					Mix32(low, high, input + 32, input + length - 48, xxhSecret + 64);
+				}
+
+				Mix32(low, high, input + 16, input + length - 32, xxhSecret + 32);
+			}
+
+			Mix32(low, high, input, input + length - 16, xxhSecret);
+		}
+		else
+		{
+			for (i = 32; i < 160; i += 32)
+				Mix32(low, high, input + i - 32, input + i - 16, xxhSecret + i - 32);
+
+			low  = Avalanche(low);
+			high = Avalanche(high);
+
+			for (i = 160; i <= length; i += 32)
+				Mix32(low, high, input + i - 32, input + i - 16, xxhSecret + XXH_MIDSIZE_START + i - 160);
+
+			Mix32(low, high, input + length - 16, input + length - 32, xxhSecret + XXH_SECRET_SIZE_MIN - XXH_MIDSIZE_LAST - 16);
+		}
+
+		inputLo = low + high;
+		inputHi = (low * XXH_PRIME64_1) + (high * XXH_PRIME64_4) + (length * XXH_PRIME64_2);
+
+		low  = Avalanche(inputLo);
+		high = 0 - Avalanche(inputHi);
+		return;
+	}
+
+	HashLong(acc, input, length);
+	low  = MergeAccs(acc, xxhSecret + XXH_MERGEACCS_START, length * XXH_PRIME64_1);
+	high = MergeAccs(acc, xxhSecret + XXH_SECRET_SIZE - sizeof(acc) - XXH_MERGEACCS_START, ~(length * XXH_PRIME64_2));
+}
+
+
+
+/******************************************************************************/
+/* HashLong() will run the accumulators over a buffer bigger than 240 bytes.  */
+/*                                                                            */
+/* Input:  "acc" is where to store the accumulators.                          */
+/*         "input" is a pointer to the buffer.                                */
+/*         "length" is the length of the buffer.                              */
+/******************************************************************************/
+void PXXH3::HashLong(uint64 *acc, const uint8 *input, uint32 length)
+{
+	uint32 blockLen, blocks, stripes, i;
+
+	InitAccs(acc);
+
+	blockLen = XXH_STRIPE_LEN * XXH_STRIPES_PER_BLOCK;
+	blocks   = (length - 1) / blockLen;
+
+	for (i = 0; i < blocks; i++)
+	{
+		Accumulate(acc, input + i * blockLen, xxhSecret, XXH_STRIPES_PER_BLOCK);
+		Scramble(acc, xxhSecret + XXH_SECRET_LIMIT);
+	}
+
+	// The last partial block and the last stripe, which may overlap it
+	stripes = ((length - 1) - (blockLen * blocks)) / XXH_STRIPE_LEN;
+	Accumulate(acc, input + blocks * blockLen, xxhSecret, stripes);
+
+	Accumulate512(acc, input + length - XXH_STRIPE_LEN, xxhSecret + XXH_SECRET_LIMIT - XXH_LASTACC_START);
+}
+
+
+
+/******************************************************************************/
+/* ConsumeStripes() will add whole stripes to the accumulators and scramble   */
+/*      them every time a block is full.                                      */
+/*                                                                            */
+/* Input:  "acc" is a pointer to the accumulators.                            */
+/*         "stripesSoFar" is the number of stripes in the current block. It   */
+/*         is updated.                                                        */
+/*         "input" is a pointer to the stripes.                               */
+/*         "stripes" is the number of stripes to add.                         */
+/*                                                                            */
+/* Output: A pointer to the first byte after the stripes.                     */
+/******************************************************************************/
+const uint8 *PXXH3::ConsumeStripes(uint64 *acc, uint32 &stripesSoFar, const uint8 *input, uint32 stripes)
+{
+	const uint8 *secret;
+	uint32 stripesThisTime;
+
+	secret = xxhSecret + stripesSoFar * XXH_SECRET_RATE;
+
+	if (stripes >= (XXH_STRIPES_PER_BLOCK - stripesSoFar))
+	{
+		// Finish the current block and run all the whole blocks
+		stripesThisTime = XXH_STRIPES_PER_BLOCK - stripesSoFar;
+
+		do
+		{
+			Accumulate(acc, input, secret, stripesThisTime);
+			Scramble(acc, xxhSecret + XXH_SECRET_LIMIT);
+
+			input          += stripesThisTime * XXH_STRIPE_LEN;
+			stripes        -= stripesThisTime;
+			stripesThisTime = XXH_STRIPES_PER_BLOCK;
+			secret          = xxhSecret;
+		}
+		while (stripes >= XXH_STRIPES_PER_BLOCK);
+
+		stripesSoFar = 0;
+	}
+
+	if (stripes > 0)
+	{
+		Accumulate(acc, input, secret, stripes);
+
+		input        += stripes * XXH_STRIPE_LEN;
+		stripesSoFar += stripes;
+	}
+
+	return (input);
+}
+
+
+
+/******************************************************************************/
+/* MergeAccs() will merge the accumulators into a single 64 bit hash.         */
+/*                                                                            */
+/* Input:  "acc" is a pointer to the accumulators.                            */
+/*         "secret" is a pointer to the part of the secret to use.            */
+/*         "start" is the start value.                                        */
+/*                                                                            */
+/* Output: The hash.                                                          */
+/******************************************************************************/
+uint64 PXXH3::MergeAccs(const uint64 *acc, const uint8 *secret, uint64 start)
+{
+	int32 i;
+
+	for (i = 0; i < 4; i++)
+		start += MultiplyFold64(acc[i * 2] ^ ReadLE64(secret + i * 16), acc[i * 2 + 1] ^ ReadLE64(secret + i * 16 + 8));
+
+	return (Avalanche(start));
+}
+
+
+
+
+
+/******************************************************************************/
+/* PCRC32C class                                                              */
+/*                                                                            */
+/* The tables are made at start up. When the CPU has SSE4.2, the CRC32        */
+/* instruction is used instead of the tables.                                 */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Different constants used in the algorithm                                  */
+/******************************************************************************/
+#define CRC32C_POLYNOMIAL		0x82f63b78		// Reversed Castagnoli polynomial
+
+// Only compilers which can build single functions for SSE4.2 get the
+// hardware version, so the rest of the library still runs on any CPU
+#if defined(__GNUC__) && (__GNUC__ >= 5) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32C_HARDWARE
+#endif
+
+
+
+/******************************************************************************/
+/* Tables                                                                     */
+/******************************************************************************/
+static uint32 crcTables[8][256];
+static bool crcHardware = false;
+
+
+
+/******************************************************************************/
+/* PCRC32CInit class                                                          */
+/*                                                                            */
+/* A single object of this class is created at start up to build the tables   */
+/* and check the CPU.                                                         */
+/******************************************************************************/
+class PCRC32CInit
+{
+public:
+	PCRC32CInit(void)
+	{
+		uint32 crc;
+		int32 i, j;
+
+		// Build the table for one byte at a time
+		for (i = 0; i < 256; i++)
+		{
+			crc = i;
+			for (j = 0; j < 8; j++)
+				crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+
+			crcTables[0][i] = crc;
+		}
+
+		// Then the tables used for 8 bytes at a time
+		for (i = 0; i < 256; i++)
+		{
+			for (j = 1; j < 8; j++)
+				crcTables[j][i] = (crcTables[j - 1][i] >> 8) ^ crcTables[0][crcTables[j - 1][i] & 0xff];
+		}
+
+#ifdef CRC32C_HARDWARE
+		__builtin_cpu_init();
+		crcHardware = __builtin_cpu_supports("sse4.2");
+#endif
+	}
+};
+
+static PCRC32CInit crcInit;
+
+
+
+#ifdef CRC32C_HARDWARE
+/******************************************************************************/
+/* HardwareUpdate() will add a buffer to the CRC using the CRC32 instruction. */
+/*                                                                            */
+/* Input:  "crc" is the current inverted CRC.                                 */
+/*         "buffer" is a pointer to the buffer to add.                        */
+/*         "length" is the length of the buffer.                              */
+/*                                                                            */
+/* Output: The new inverted CRC.                                              */
+/******************************************************************************/
+__attribute__((target("sse4.2")))
+static uint32 HardwareUpdate(uint32 crc, const uint8 *buffer, int32 length)
+{
+#ifdef __x86_64__
+	uint64 crc64, val;
+#else
+	uint32 val;
+#endif
+
+	// Go byte by byte until the buffer is aligned
+	while ((length > 0) && (((size_t)buffer & 7) != 0))
+	{
+		crc = __builtin_ia32_crc32qi(crc, *buffer++);
+		length--;
+	}
+
+#ifdef __x86_64__
+	crc64 = crc;
+
+	while (length >= 8)
+	{
+		memcpy(&val, buffer, 8);
+		crc64   = __builtin_ia32_crc32di(crc64, val);
+		buffer += 8;
+		length -= 8;
+	}
+
+	crc = (uint32)crc64;
+#else
+	while (length >= 4)
+	{
+		memcpy(&val, buffer, 4);
+		crc     = __builtin_ia32_crc32si(crc, val);
+		buffer += 4;
+		length -= 4;
+	}
+#endif
+
+	while (length > 0)
+	{
+		crc = __builtin_ia32_crc32qi(crc, *buffer++);
+		length--;
+	}
+
+	return (crc);
+}
+#endif
+
+
+
+/******************************************************************************/
+/* Constructor                                                                */
+/******************************************************************************/
+PCRC32C::PCRC32C(void)
+{
+	// Initialize member variables
+	Reset();
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PCRC32C::~PCRC32C(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* Reset() will start a new checksum.                                         */
+/******************************************************************************/
+void PCRC32C::Reset(void)
+{
+	curCRC = 0xffffffff;
+}
+
+
+
+/******************************************************************************/
+/* AddBuffer() will add a memory buffer to be included in the final checksum. */
+/*                                                                            */
+/* Input:  "buffer" is a pointer to the buffer to add.                        */
+/*         "length" is the length of the buffer.                              */
+/******************************************************************************/
+void PCRC32C::AddBuffer(const uint8 *buffer, int32 length)
+{
+	curCRC = Update(curCRC, buffer, length);
+}
+
+
+
+/******************************************************************************/
+/* CalculateChecksum() will return the checksum of all the bytes added. More  */
+/*      bytes can be added afterwards.                                        */
+/*                                                                            */
+/* Output: The checksum.                                                      */
+/******************************************************************************/
+uint32 PCRC32C::CalculateChecksum(void) const
+{
+	return (~curCRC);
+}
+
+
+
+/******************************************************************************/
+/* Checksum() will calculate the checksum of a single buffer.                 */
+/*                                                                            */
+/* Input:  "buffer" is a pointer to the buffer.                               */
+/*         "length" is the length of the buffer.                              */
+/*                                                                            */
+/* Output: The checksum.                                                      */
+/******************************************************************************/
+uint32 PCRC32C::Checksum(const uint8 *buffer, int32 length)
+{
+	return (~Update(0xffffffff, buffer, length));
+}
+
+
+
+/******************************************************************************/
+/* Update() will add a buffer to the CRC.                                     */
+/*                                                                            */
+/* Input:  "crc" is the current inverted CRC.                                 */
+/*         "buffer" is a pointer to the buffer to add.                        */
+/*         "length" is the length of the buffer.                              */
+/*                                                                            */
+/* Output: The new inverted CRC.                                              */
+/******************************************************************************/
+uint32 PCRC32C::Update(uint32 crc, const uint8 *buffer, int32 length)
+{
+	uint32 low, high;
+
+#ifdef CRC32C_HARDWARE
+	if (crcHardware)
+		return (HardwareUpdate(crc, buffer, length));
+#endif
+
+	// Take 8 bytes at a time using all the tables
+	while (length >= 8)
+	{
+		low  = crc ^ ReadLE32(buffer);
+		high = ReadLE32(buffer + 4);
+
+		crc = crcTables[7][low & 0xff] ^ crcTables[6][(low >> 8) & 0xff] ^
+			  crcTables[5][(low >> 16) & 0xff] ^ crcTables[4][low >> 24] ^
+			  crcTables[3][high & 0xff] ^ crcTables[2][(high >> 8) & 0xff] ^
+			  crcTables[1][(high >> 16) & 0xff] ^ crcTables[0][high >> 24];
+
+		buffer += 8;
+		length -= 8;
+	}
+
+	while (length > 0)
+	{
+		crc = (crc >> 8) ^ crcTables[0][(crc ^ *buffer++) & 0xff];
+		length--;
+	}
+
+	return (crc);
+}
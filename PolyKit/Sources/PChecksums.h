@@ -18,19 +18,42 @@
 
 
 /******************************************************************************/
-/* PMD5 class                                                                 */
+/* PChecksum class                                                            */
+/*                                                                            */
+/* This is the base class for all the checksums. It can feed a whole file to  */
+/* the checksum. Files which hold their data in memory are read without any   */
+/* copying.                                                                   */
 /******************************************************************************/
 #if __p_os == __p_beos && __POWERPC__
 #pragma export on
 #endif
 
-class _IMPEXP_PKLIB PMD5
+class PFile;
+
+class _IMPEXP_PKLIB PChecksum
+{
+public:
+	PChecksum(void);
+	virtual ~PChecksum(void);
+
+	virtual void Reset(void) = 0;
+	virtual void AddBuffer(const uint8 *buffer, int32 length) = 0;
+	void AddFile(PFile *file);
+};
+
+
+
+/******************************************************************************/
+/* PMD5 class                                                                 */
+/******************************************************************************/
+class _IMPEXP_PKLIB PMD5 : public PChecksum
 {
 public:
 	PMD5(void);
 	virtual ~PMD5(void);
 
-	void AddBuffer(const uint8 *buffer, int32 length);
+	virtual void Reset(void);
+	virtual void AddBuffer(const uint8 *buffer, int32 length);
 	const uint8 *CalculateChecksum(void);
 
 protected:
@@ -52,6 +75,72 @@ protected:
 	uint8 checksum[16];		// Holding the last returned MD5 checksum
 };
 
+
+
+/******************************************************************************/
+/* PXXH3 class                                                                */
+/*                                                                            */
+/* A fast non-cryptographic 64 or 128 bit hash, used as cache keys for files. */
+/******************************************************************************/
+class _IMPEXP_PKLIB PXXH3 : public PChecksum
+{
+public:
+	PXXH3(void);
+	virtual ~PXXH3(void);
+
+	virtual void Reset(void);
+	virtual void AddBuffer(const uint8 *buffer, int32 length);
+	uint64 CalculateChecksum64(void) const;
+	const uint8 *CalculateChecksum128(void);
+
+	static uint64 Checksum64(const uint8 *buffer, int32 length);
+	static void Checksum128(const uint8 *buffer, int32 length, uint8 *checksum);
+
+protected:
+	void DigestLong(uint64 *acc) const;
+
+	static uint64 Hash64(const uint8 *input, uint32 length);
+	static void Hash128(const uint8 *input, uint32 length, uint64 &low, uint64 &high);
+
+	static void HashLong(uint64 *acc, const uint8 *input, uint32 length);
+	static const uint8 *ConsumeStripes(uint64 *acc, uint32 &stripesSoFar, const uint8 *input, uint32 stripes);
+	static uint64 MergeAccs(const uint64 *acc, const uint8 *secret, uint64 start);
+
+	uint64 curAcc[8];		// The accumulators
+	uint8 tempBuffer[256];	// Holds the bytes not hashed yet
+	uint32 bufferedSize;	// Number of bytes in the buffer
+	uint32 stripesSoFar;	// Number of stripes hashed in the current block
+	uint64 totalLength;		// Number of bytes added
+
+	uint8 checksum[16];		// Holding the last returned 128 bit checksum
+};
+
+
+
+/******************************************************************************/
+/* PCRC32C class                                                              */
+/*                                                                            */
+/* The CRC32C (Castagnoli) checksum. The CRC32 instruction is used on CPUs    */
+/* with SSE4.2.                                                               */
+/******************************************************************************/
+class _IMPEXP_PKLIB PCRC32C : public PChecksum
+{
+public:
+	PCRC32C(void);
+	virtual ~PCRC32C(void);
+
+	virtual void Reset(void);
+	virtual void AddBuffer(const uint8 *buffer, int32 length);
+	uint32 CalculateChecksum(void) const;
+
+	static uint32 Checksum(const uint8 *buffer, int32 length);
+
+protected:
+	static uint32 Update(uint32 crc, const uint8 *buffer, int32 length);
+
+	uint32 curCRC;			// Current CRC, inverted
+};
+
 #if __p_os == __p_beos && __POWERPC__
 #pragma export off
 #endif
@@ -28,9 +28,9 @@
 /******************************************************************************/
 
 //
-// BeOS versions
+// BeOS and Linux versions
 //
-#if __p_os == __p_beos
+#if (__p_os == __p_beos) || (__p_os == __p_linux)
 
 #ifdef PDEBUG
 
@@ -0,0 +1,218 @@
+/******************************************************************************/
+/* PEventLoop implementation file.                                            */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#define _BUILDING_POLYKIT_LIBRARY_
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PSynchronize.h"
+#include "PThread.h"
+#include "PEventQueue.h"
+#include "PTimerWheel.h"
+#include "PEventLoop.h"
+
+
+/******************************************************************************/
+/* PEventLoop class                                                           */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/*                                                                            */
+/* Input:  "queueSize" is the number of events that can wait in the queue.    */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+PEventLoop::PEventLoop(int32 queueSize) : queue(queueSize), wheel(TimerFunc, this)
+{
+	// Initialize member variables
+	loopThread = -1;
+	running    = false;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PEventLoop::~PEventLoop(void)
+{
+	// The derived class should have stopped the loop already, because
+	// the thread may call its functions
+	StopLoop();
+}
+
+
+
+/******************************************************************************/
+/* StartLoop() will start the loop thread.                                    */
+/*                                                                            */
+/* Input:  "name" is the name of the thread.                                  */
+/*         "priority" is the priority of the thread.                          */
+/******************************************************************************/
+void PEventLoop::StartLoop(PString name, PThread::PPriority priority)
+{
+	if (!running)
+	{
+		thread.SetName(name);
+		thread.SetHookFunc(LoopThread, this);
+		thread.SetPriority(priority);
+		thread.StartThread();
+
+		running = true;
+	}
+}
+
+
+
+/******************************************************************************/
+/* StopLoop() will stop the loop thread. All the events posted before are     */
+/*      handled first. When the function returns, the thread has ended.       */
+/******************************************************************************/
+void PEventLoop::StopLoop(void)
+{
+	if (running)
+	{
+		// Keep trying if the queue is full
+		while (!queue.PostEvent(PM_QUIT_LOOP))
+			snooze(1000);
+
+		thread.WaitOnThread();
+		running = false;
+	}
+}
+
+
+
+/******************************************************************************/
+/* PostEvent() will post an event to the loop. It can be called from any      */
+/*      thread and never blocks or allocates memory.                          */
+/*                                                                            */
+/* Input:  "what" is the event code.                                          */
+/*         "data" is a number that belongs to the event.                      */
+/*         "pointer" is a pointer that belongs to the event.                  */
+/*                                                                            */
+/* Output: True if the event has been posted, false if the queue is full.     */
+/******************************************************************************/
+bool PEventLoop::PostEvent(uint32 what, int32 data, void *pointer)
+{
+	return (queue.PostEvent(what, data, pointer));
+}
+
+
+
+/******************************************************************************/
+/* StartTimer() will start a timer. TimerElapsed() is called when it          */
+/*      elapses.                                                              */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer to start.                        */
+/*         "delay" is the time in microseconds before it elapses.             */
+/*         "period" is the time in microseconds between each elapse after     */
+/*         the first one or 0 to elapse only once.                            */
+/******************************************************************************/
+void PEventLoop::StartTimer(PWheelTimer *timer, bigtime_t delay, bigtime_t period)
+{
+	ASSERT((loopThread == -1) || (loopThread == find_thread(NULL)));
+	wheel.AddTimer(timer, delay, period);
+}
+
+
+
+/******************************************************************************/
+/* StopTimer() will stop a timer.                                             */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer to stop.                         */
+/******************************************************************************/
+void PEventLoop::StopTimer(PWheelTimer *timer)
+{
+	ASSERT((loopThread == -1) || (loopThread == find_thread(NULL)));
+	wheel.RemoveTimer(timer);
+}
+
+
+
+/******************************************************************************/
+/* EventReceived() is called for each event posted to the loop.               */
+/*                                                                            */
+/* Input:  "event" is a reference to the event.                               */
+/******************************************************************************/
+void PEventLoop::EventReceived(const PQueueEvent & /*event*/)
+{
+}
+
+
+
+/******************************************************************************/
+/* TimerElapsed() is called every time a timer elapses.                       */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer.                                 */
+/******************************************************************************/
+void PEventLoop::TimerElapsed(PWheelTimer * /*timer*/)
+{
+}
+
+
+
+/******************************************************************************/
+/* LoopThread() is the loop thread function. It waits for events until the    */
+/*      next timer elapses and handles both.                                  */
+/*                                                                            */
+/* Input:  "userData" is a pointer to the loop object.                        */
+/*                                                                            */
+/* Output: Always 0.                                                          */
+/******************************************************************************/
+int32 PEventLoop::LoopThread(void *userData)
+{
+	PEventLoop *loop = (PEventLoop *)userData;
+	PQueueEvent event;
+	bigtime_t timeLeft;
+	uint32 timeout;
+
+	loop->loopThread = find_thread(NULL);
+
+	for (;;)
+	{
+		// Call the timers which have elapsed
+		loop->wheel.Advance(system_time());
+
+		// Find out how long to wait for an event
+		timeLeft = loop->wheel.GetTimeToNext(system_time());
+		if (timeLeft < 0)
+			timeout = PSYNC_INFINITE;
+		else
+			timeout = (uint32)((timeLeft + 999) / 1000);
+
+		if (loop->queue.WaitForEvent(event, timeout))
+		{
+			if (event.what == PM_QUIT_LOOP)
+				break;
+
+			loop->EventReceived(event);
+		}
+	}
+
+	loop->loopThread = -1;
+	return (0);
+}
+
+
+
+/******************************************************************************/
+/* TimerFunc() is called by the timer wheel when a timer elapses.             */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer.                                 */
+/*         "userData" is a pointer to the loop object.                        */
+/******************************************************************************/
+void PEventLoop::TimerFunc(PWheelTimer *timer, void *userData)
+{
+	((PEventLoop *)userData)->TimerElapsed(timer);
+}
@@ -0,0 +1,76 @@
+/******************************************************************************/
+/* PEventLoop header file.                                                    */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __PEventLoop_h
+#define __PEventLoop_h
+
+// PolyKit headers
+#include "POS.h"
+#include "PString.h"
+#include "PThread.h"
+#include "PEventQueue.h"
+#include "PTimerWheel.h"
+#include "ImportExport.h"
+
+
+/******************************************************************************/
+/* The event used to stop the loop                                            */
+/******************************************************************************/
+#define PM_QUIT_LOOP		'Pqlp'
+
+
+
+/******************************************************************************/
+/* PEventLoop class                                                           */
+/*                                                                            */
+/* A thread which waits for events and timers and calls the virtual functions */
+/* below for each of them. It replaces a BLooper where the messages are small */
+/* and have to be sent without allocating memory.                             */
+/******************************************************************************/
+#if __p_os == __p_beos && __POWERPC__
+#pragma export on
+#endif
+
+class _IMPEXP_PKLIB PEventLoop
+{
+public:
+	PEventLoop(int32 queueSize = 256);
+	virtual ~PEventLoop(void);
+
+	void StartLoop(PString name, PThread::PPriority priority = PThread::pNormal);
+	void StopLoop(void);
+
+	bool PostEvent(uint32 what, int32 data = 0, void *pointer = NULL);
+
+	// These may only be called from the loop thread
+	void StartTimer(PWheelTimer *timer, bigtime_t delay, bigtime_t period = 0);
+	void StopTimer(PWheelTimer *timer);
+
+protected:
+	virtual void EventReceived(const PQueueEvent &event);
+	virtual void TimerElapsed(PWheelTimer *timer);
+
+	static int32 LoopThread(void *userData);
+	static void TimerFunc(PWheelTimer *timer, void *userData);
+
+	PEventQueue queue;
+	PTimerWheel wheel;
+	PThread thread;
+
+	thread_id loopThread;
+	bool running;
+};
+
+#if __p_os == __p_beos && __POWERPC__
+#pragma export off
+#endif
+
+#endif
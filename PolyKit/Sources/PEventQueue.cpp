@@ -0,0 +1,226 @@
+/******************************************************************************/
+/* PEventQueue implementation file.                                           */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#define _BUILDING_POLYKIT_LIBRARY_
+
+// PolyKit headers
+#include "POS.h"
+#include "PException.h"
+#include "PSynchronize.h"
+#include "PEventQueue.h"
+
+
+/******************************************************************************/
+/* PEventQueue class                                                          */
+/*                                                                            */
+/* Every cell holds a sequence number, which tells the writers and the reader */
+/* whose turn it is. A writer first reserves a position by moving writePos    */
+/* forward, fills the cell and then publishes it by changing the sequence.    */
+/* The reader frees the cell again by setting the sequence to the position    */
+/* the cell will have in the next round.                                      */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/*                                                                            */
+/* Input:  "size" is the number of events the queue can hold. It is rounded   */
+/*         up to a power of 2.                                                */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+PEventQueue::PEventQueue(int32 size)
+{
+	int32 count, i;
+
+	// Find the number of cells
+	count = 2;
+	while (count < size)
+		count *= 2;
+
+	// Initialize member variables
+	mask       = count - 1;
+	writePos   = 0;
+	readPos    = 0;
+	sleeping   = 0;
+	lostEvents = 0;
+
+	// Allocate the cells
+	cells = new PQueueCell[count];
+	if (cells == NULL)
+		throw PMemoryException();
+
+	for (i = 0; i < count; i++)
+		cells[i].sequence = i;
+
+	// Create the semaphore used to wake up the reader. An automatic
+	// event can't be used, because a set is lost if the reader has
+	// not started to wait yet
+	wakeSignal = new PSemaphore(0, true);
+	if (wakeSignal == NULL)
+	{
+		delete[] cells;
+		throw PMemoryException();
+	}
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PEventQueue::~PEventQueue(void)
+{
+	delete wakeSignal;
+	delete[] cells;
+}
+
+
+
+/******************************************************************************/
+/* PostEvent() will add an event to the end of the queue. It can be called    */
+/*      from any thread and never blocks.                                     */
+/*                                                                            */
+/* Input:  "what" is the event code.                                          */
+/*         "data" is a number that belongs to the event.                      */
+/*         "pointer" is a pointer that belongs to the event.                  */
+/*                                                                            */
+/* Output: True if the event has been added, false if the queue is full.      */
+/******************************************************************************/
+bool PEventQueue::PostEvent(uint32 what, int32 data, void *pointer)
+{
+	PQueueCell *cell;
+	int32 pos, oldPos, seq, diff;
+
+	// Reserve a cell
+	pos = AtomicGet(&writePos);
+
+	for (;;)
+	{
+		cell = &cells[pos & mask];
+		seq  = AtomicGet(&cell->sequence);
+		diff = (int32)((uint32)seq - (uint32)pos);
+
+		if (diff == 0)
+		{
+			// The cell is free, try to take it
+			oldPos = AtomicTestAndSet(&writePos, (int32)((uint32)pos + 1), pos);
+			if (oldPos == pos)
+				break;
+
+			// Another thread got it first
+			pos = oldPos;
+		}
+		else if (diff < 0)
+		{
+			// The reader has not freed the cell yet, so the queue is full
+			AtomicIncrement(&lostEvents);
+			return (false);
+		}
+		else
+		{
+			// Another thread has filled the cell, try again
+			// with the new write position
+			pos = AtomicGet(&writePos);
+		}
+	}
+
+	// Fill and publish the cell
+	cell->event.what    = what;
+	cell->event.data    = data;
+	cell->event.pointer = pointer;
+	AtomicSet(&cell->sequence, (int32)((uint32)pos + 1));
+
+	// Wake up the reader if it sleeps. Only the writer which clears
+	// the flag releases the semaphore, so it is released at most once
+	// per wait
+	if ((AtomicGet(&sleeping) != 0) && (AtomicTestAndSet(&sleeping, 0, 1) == 1))
+		wakeSignal->Unlock();
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* GetEvent() will take the first event in the queue. Only one thread may     */
+/*      read from the queue.                                                  */
+/*                                                                            */
+/* Input:  "event" is a reference to store the event in.                      */
+/*                                                                            */
+/* Output: True if an event has been taken, false if the queue is empty.      */
+/******************************************************************************/
+bool PEventQueue::GetEvent(PQueueEvent &event)
+{
+	PQueueCell *cell;
+
+	cell = &cells[readPos & mask];
+	if (AtomicGet(&cell->sequence) != (int32)((uint32)readPos + 1))
+		return (false);
+
+	// Copy the event and give the cell back to the writers
+	event = cell->event;
+	AtomicSet(&cell->sequence, (int32)((uint32)readPos + mask + 1));
+	readPos = (int32)((uint32)readPos + 1);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* WaitForEvent() will take the first event in the queue. If the queue is     */
+/*      empty, it waits until an event is posted. Only one thread may read    */
+/*      from the queue. It can return before the time has run out without an  */
+/*      event, so the caller has to be ready to wait again.                   */
+/*                                                                            */
+/* Input:  "event" is a reference to store the event in.                      */
+/*         "timeout" is the maximum time to wait in milliseconds.             */
+/*                                                                            */
+/* Output: True if an event has been taken, false if not.                     */
+/******************************************************************************/
+bool PEventQueue::WaitForEvent(PQueueEvent &event, uint32 timeout)
+{
+	if (GetEvent(event))
+		return (true);
+
+	if (timeout == 0)
+		return (false);
+
+	// Tell the writers we are going to sleep and check the queue again,
+	// because an event may have been posted before they could see it
+	AtomicSet(&sleeping, 1);
+
+	if (!GetEvent(event))
+	{
+		wakeSignal->Lock(timeout);
+
+		// If a writer has cleared the flag after the time ran out, the
+		// semaphore stays released and the next wait returns at once
+		AtomicTestAndSet(&sleeping, 0, 1);
+		return (GetEvent(event));
+	}
+
+	AtomicTestAndSet(&sleeping, 0, 1);
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* CountLostEvents() returns the number of events which could not be posted,  */
+/*      because the queue was full.                                           */
+/*                                                                            */
+/* Output: The number of lost events.                                         */
+/******************************************************************************/
+int32 PEventQueue::CountLostEvents(void)
+{
+	return (AtomicGet(&lostEvents));
+}
@@ -0,0 +1,80 @@
+/******************************************************************************/
+/* PEventQueue header file.                                                   */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __PEventQueue_h
+#define __PEventQueue_h
+
+// PolyKit headers
+#include "POS.h"
+#include "PSynchronize.h"
+#include "ImportExport.h"
+
+
+/******************************************************************************/
+/* Event structure                                                            */
+/******************************************************************************/
+typedef struct PQueueEvent
+{
+	uint32 what;					// The event code
+	int32 data;						// A number that belongs to the event
+	void *pointer;					// A pointer that belongs to the event
+} PQueueEvent;
+
+
+
+/******************************************************************************/
+/* PEventQueue class                                                          */
+/*                                                                            */
+/* A fixed size queue which any number of threads can post events to, while   */
+/* only one thread reads them. Posting never locks or allocates memory, so    */
+/* it is safe to do from real-time threads like the mixer.                    */
+/******************************************************************************/
+#if __p_os == __p_beos && __POWERPC__
+#pragma export on
+#endif
+
+class _IMPEXP_PKLIB PEventQueue
+{
+public:
+	PEventQueue(int32 size = 256);
+	virtual ~PEventQueue(void);
+
+	bool PostEvent(uint32 what, int32 data = 0, void *pointer = NULL);
+
+	bool GetEvent(PQueueEvent &event);
+	bool WaitForEvent(PQueueEvent &event, uint32 timeout = PSYNC_INFINITE);
+
+	int32 CountLostEvents(void);
+
+protected:
+	typedef struct PQueueCell
+	{
+		int32 sequence;				// The write position the cell is ready for, or that position + 1 when filled
+		PQueueEvent event;
+	} PQueueCell;
+
+	PQueueCell *cells;
+	int32 mask;
+
+	int32 writePos;					// Next position to write, shared by all the posting threads
+	uint8 writePad[60];				// Keeps the two positions in different cache lines
+	int32 readPos;					// Next position to read, only used by the reader
+	int32 sleeping;					// 1 when the reader is waiting on the semaphore
+
+	PSemaphore *wakeSignal;
+	int32 lostEvents;
+};
+
+#if __p_os == __p_beos && __POWERPC__
+#pragma export off
+#endif
+
+#endif
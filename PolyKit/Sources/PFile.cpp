@@ -19,6 +19,52 @@
 #include "PSystem.h"
 
 
+/******************************************************************************/
+/* Line reading constants                                                     */
+/******************************************************************************/
+#define P_FILE_LINE_CHUNK			256		// Bytes read at once by ReadLine()
+
+
+
+
+/******************************************************************************/
+/* SwapUINT16s() swaps the bytes in all the 16 bit integers in an array. It   */
+/*      is a plain loop over the array without any calls or branches, so the  */
+/*      compiler is able to turn it into vector instructions.                 */
+/*                                                                            */
+/* Input:  "buffer" is a pointer to the array.                                */
+/*         "count" is the number of integers in the array.                    */
+/******************************************************************************/
+static inline void SwapUINT16s(uint16 *buffer, int32 count)
+{
+	int32 i;
+
+	for (i = 0; i < count; i++)
+		buffer[i] = (uint16)((buffer[i] << 8) | (buffer[i] >> 8));
+}
+
+
+
+/******************************************************************************/
+/* SwapUINT32s() swaps the bytes in all the 32 bit integers in an array.      */
+/*                                                                            */
+/* Input:  "buffer" is a pointer to the array.                                */
+/*         "count" is the number of integers in the array.                    */
+/******************************************************************************/
+static inline void SwapUINT32s(uint32 *buffer, int32 count)
+{
+	uint32 value;
+	int32 i;
+
+	for (i = 0; i < count; i++)
+	{
+		value     = buffer[i];
+		buffer[i] = (value >> 24) | ((value >> 8) & 0x0000ff00) | ((value << 8) & 0x00ff0000) | (value << 24);
+	}
+}
+
+
+
 /******************************************************************************/
 /* PFile class                                                                */
 /******************************************************************************/
@@ -365,6 +411,166 @@ PString PFile::ReadString(PCharacterSet *characterSet)
 PString PFile::ReadLine(PCharacterSet *characterSet)
 {
 	PCharacterSet *charSet;
+	PString retLine;
+	int8 nullLen;
+
+	// Find the character set to use
+	if (characterSet == NULL)
+		charSet = CreateHostCharacterSet();
+	else
+		charSet = characterSet;
+
+	try
+	{
+		// Find the length of the null terminator. If it is a single
+		// byte, all the control characters are single bytes too, so
+		// the line end can be found directly in the bytes read
+		charSet->FromUnicode(0x0000, nullLen);
+
+		if (nullLen == 1)
+			retLine = ReadByteLine(charSet);
+		else
+			retLine = ReadCharLine(charSet);
+	}
+	catch(...)
+	{
+		if (characterSet == NULL)
+			delete charSet;
+
+		throw;
+	}
+
+	// If no character set was given, delete it
+	if (characterSet == NULL)
+		delete charSet;
+
+	// Return the line
+	return (retLine);
+}
+
+
+
+/******************************************************************************/
+/**	Reads a line from the file of this object, when the character set has
+ *	single byte control characters. The file is read in chunks which are
+ *	scanned for the line end, and the line is only converted once.
+ *
+ *	@param charSet pointer to the character set to use.
+ *
+ *	@return the read line.
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+PString PFile::ReadByteLine(PCharacterSet *charSet)
+{
+	PString retLine;
+	char *lineBuf = NULL;
+	char *newBuf;
+	int32 lineLen = 0, lineMax = 0;
+	int32 bytesRead, used, i;
+	char tempBuf[P_FILE_LINE_CHUNK];
+	char chr;
+
+	try
+	{
+		// Read until we reach EOF or the line has been read
+		while (!IsEOF())
+		{
+			// Read a bit from the file
+			bytesRead = Read(tempBuf, P_FILE_LINE_CHUNK);
+			if (bytesRead == 0)
+				break;
+
+			// Find the line end
+			for (i = 0; i < bytesRead; i++)
+			{
+				chr = tempBuf[i];
+				if ((chr == '\n') || (chr == '\r') || (chr == 0x00))
+					break;
+			}
+
+			if ((i == bytesRead) || (lineBuf != NULL))
+			{
+				// The line continues in the next chunk, so collect
+				// the bytes until the whole line has been read
+				if ((lineLen + i) > lineMax)
+				{
+					lineMax = max(lineMax * 2, lineLen + i);
+					newBuf  = new char[lineMax];
+					if (newBuf == NULL)
+						throw PMemoryException();
+
+					if (lineBuf != NULL)
+						memcpy(newBuf, lineBuf, lineLen);
+
+					delete[] lineBuf;
+					lineBuf = newBuf;
+				}
+
+				memcpy(lineBuf + lineLen, tempBuf, i);
+				lineLen += i;
+
+				if (i == bytesRead)
+					continue;
+			}
+
+			// Skip the line end. A carriage return can be followed
+			// by a line feed, which is part of the same line end
+			used = i + 1;
+			if (chr == '\r')
+			{
+				if (used < bytesRead)
+				{
+					if (tempBuf[used] == '\n')
+						used++;
+				}
+				else
+				{
+					if ((Read(&chr, 1) == 1) && (chr != '\n'))
+						Seek(-1, pSeekCurrent);
+				}
+			}
+
+			// Go back to the start of the next line
+			if (used < bytesRead)
+				Seek(-(bytesRead - used), pSeekCurrent);
+
+			// Convert the line
+			if (lineBuf == NULL)
+				retLine.SetString(tempBuf, i, charSet);
+
+			break;
+		}
+
+		// Convert a line that has been collected from more than one chunk
+		if (lineBuf != NULL)
+			retLine.SetString(lineBuf, lineLen, charSet);
+	}
+	catch(...)
+	{
+		delete[] lineBuf;
+		throw;
+	}
+
+	delete[] lineBuf;
+
+	return (retLine);
+}
+
+
+
+/******************************************************************************/
+/**	Reads a line from the file of this object one character at the time. This
+ *	is used for character sets with multi byte control characters.
+ *
+ *	@param charSet pointer to the character set to use.
+ *
+ *	@return the read line.
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+PString PFile::ReadCharLine(PCharacterSet *charSet)
+{
 	PChar chr;
 	PString retLine;
 	PString appendLine;
@@ -378,12 +584,6 @@ PString PFile::ReadLine(PCharacterSet *characterSet)
 	// Clear the last bytes in the temp buffer
 	memset(&tempBuf[80], 0, P_MAX_CHAR_LEN);
 
-	// Find the character set to use
-	if (characterSet == NULL)
-		charSet = CreateHostCharacterSet();
-	else
-		charSet = characterSet;
-
 	// Find the length of the null terminator
 	nullChar = charSet->FromUnicode(0x0000, nullLen);
 
@@ -460,10 +660,6 @@ PString PFile::ReadLine(PCharacterSet *characterSet)
 		}
 	}
 
-	// If no character set was given, delete it
-	if (characterSet == NULL)
-		delete charSet;
-
 	// Return the line
 	return (retLine);
 }
@@ -489,6 +685,55 @@ uint8 PFile::Read_UINT8(void)
 
 
 
+/******************************************************************************/
+/**	Reads an array of bytes from the file of this object. If the end of the
+ *	file is reached, the rest of the array is cleared and the EOF flag is set,
+ *	just like reading the bytes one by one would do.
+ *
+ *	@param buffer pointer to where to store the bytes.
+ *	@param count the number of bytes to read.
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+void PFile::ReadArray_UINT8s(uint8 *buffer, int32 count)
+{
+	int32 bytesRead;
+
+	// Read the bytes
+	bytesRead = Read(buffer, count);
+
+	if (bytesRead < count)
+	{
+		// Hit the end of the file
+		memset(buffer + bytesRead, 0, count - bytesRead);
+		eof = true;
+	}
+}
+
+
+
+/******************************************************************************/
+/**	Returns a pointer directly to the next bytes in the file and skips them.
+ *	No data is copied, so the pointer is only valid until the next call to the
+ *	file object. Multi byte values have to be converted by the caller, e.g.
+ *	with the P_BENDIAN_TO_HOST_INT16() macro. Only files which hold the data
+ *	in memory support this.
+ *
+ *	@param count the number of bytes to get.
+ *
+ *	@return a pointer to the bytes or NULL if the bytes can't be accessed
+ *		directly. In that case the file position is not changed and the bytes
+ *		have to be read in the normal way.
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+const uint8 *PFile::ReadView(int32 count)
+{
+	return (NULL);
+}
+
+
+
 /******************************************************************************/
 /**	Reads a 16 bit integer in little endian format from the file of this object
  *	and return it in the native host format.
@@ -540,8 +785,9 @@ uint32 PFile::Read_L_UINT32(void)
  *//***************************************************************************/
 void PFile::ReadArray_L_UINT16s(uint16 *buffer, int32 count)
 {
-	for (int32 i = 0; i < count; i++)
-		*buffer++ = Read_L_UINT16();
+	// Read the whole array at once and convert it afterwards
+	ReadArray_UINT8s((uint8 *)buffer, count * 2);
+	ConvertArray_L_UINT16s(buffer, count);
 }
 
 
@@ -557,8 +803,9 @@ void PFile::ReadArray_L_UINT16s(uint16 *buffer, int32 count)
  *//***************************************************************************/
 void PFile::ReadArray_L_UINT32s(uint32 *buffer, int32 count)
 {
-	for (int32 i = 0; i < count; i++)
-		*buffer++ = Read_L_UINT32();
+	// Read the whole array at once and convert it afterwards
+	ReadArray_UINT8s((uint8 *)buffer, count * 4);
+	ConvertArray_L_UINT32s(buffer, count);
 }
 
 
@@ -614,8 +861,9 @@ uint32 PFile::Read_B_UINT32(void)
  *//***************************************************************************/
 void PFile::ReadArray_B_UINT16s(uint16 *buffer, int32 count)
 {
-	for (int32 i = 0; i < count; i++)
-		*buffer++ = Read_B_UINT16();
+	// Read the whole array at once and convert it afterwards
+	ReadArray_UINT8s((uint8 *)buffer, count * 2);
+	ConvertArray_B_UINT16s(buffer, count);
 }
 
 
@@ -631,8 +879,73 @@ void PFile::ReadArray_B_UINT16s(uint16 *buffer, int32 count)
  *//***************************************************************************/
 void PFile::ReadArray_B_UINT32s(uint32 *buffer, int32 count)
 {
-	for (int32 i = 0; i < count; i++)
-		*buffer++ = Read_B_UINT32();
+	// Read the whole array at once and convert it afterwards
+	ReadArray_UINT8s((uint8 *)buffer, count * 4);
+	ConvertArray_B_UINT32s(buffer, count);
+}
+
+
+
+/******************************************************************************/
+/**	Converts an array of 16 bit integers in little endian format to the native
+ *	host format.
+ *
+ *	@param buffer pointer to the array to convert.
+ *	@param count the number of 16 bit integers in the array.
+ *//***************************************************************************/
+void PFile::ConvertArray_L_UINT16s(uint16 *buffer, int32 count)
+{
+#if P_HOST_IS_BENDIAN
+	SwapUINT16s(buffer, count);
+#endif
+}
+
+
+
+/******************************************************************************/
+/**	Converts an array of 32 bit integers in little endian format to the native
+ *	host format.
+ *
+ *	@param buffer pointer to the array to convert.
+ *	@param count the number of 32 bit integers in the array.
+ *//***************************************************************************/
+void PFile::ConvertArray_L_UINT32s(uint32 *buffer, int32 count)
+{
+#if P_HOST_IS_BENDIAN
+	SwapUINT32s(buffer, count);
+#endif
+}
+
+
+
+/******************************************************************************/
+/**	Converts an array of 16 bit integers in big endian format to the native
+ *	host format.
+ *
+ *	@param buffer pointer to the array to convert.
+ *	@param count the number of 16 bit integers in the array.
+ *//***************************************************************************/
+void PFile::ConvertArray_B_UINT16s(uint16 *buffer, int32 count)
+{
+#if !P_HOST_IS_BENDIAN
+	SwapUINT16s(buffer, count);
+#endif
+}
+
+
+
+/******************************************************************************/
+/**	Converts an array of 32 bit integers in big endian format to the native
+ *	host format.
+ *
+ *	@param buffer pointer to the array to convert.
+ *	@param count the number of 32 bit integers in the array.
+ *//***************************************************************************/
+void PFile::ConvertArray_B_UINT32s(uint32 *buffer, int32 count)
+{
+#if !P_HOST_IS_BENDIAN
+	SwapUINT32s(buffer, count);
+#endif
 }
 
 
@@ -1580,6 +1893,171 @@ int32 PCacheFile::Write(const void *buffer, int32 count)
 
 
 
+/******************************************************************************/
+/**	Reads a byte (8 bit integer) from the file of this object. The byte is
+ *	taken directly from the cache when possible.
+ *
+ *	@return the read byte (uint8).
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+uint8 PCacheFile::Read_UINT8(void)
+{
+	if (cachePosition < cacheFilled)
+		return (cache[cachePosition++]);
+
+	return (PFile::Read_UINT8());
+}
+
+
+
+/******************************************************************************/
+/**	Returns a pointer directly into the cache at the current position and
+ *	skips the bytes. If not all the bytes are in the cache, the cache is
+ *	filled again starting at the current position. The pointer is only valid
+ *	until the next call to the file object.
+ *
+ *	@param count the number of bytes to get.
+ *
+ *	@return a pointer to the bytes or NULL if there are more bytes than the
+ *		cache can hold or the end of the file is reached.
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+const uint8 *PCacheFile::ReadView(int32 count)
+{
+	const uint8 *view;
+	int32 left;
+
+	left = cacheFilled - cachePosition;
+
+	if (left < count)
+	{
+		// The bytes can't be bigger than the cache
+		if (count > cacheSize)
+			return (NULL);
+
+		// Move what is left to the beginning of the cache and fill
+		// up the rest of it
+		if (left != 0)
+			memmove(cache, cache + cachePosition, left);
+
+		cacheStart   += cachePosition;
+		cachePosition = 0;
+		cacheFilled   = left + PFile::Read(cache + left, cacheSize - left);
+
+		if (cacheFilled < count)
+			return (NULL);
+	}
+
+	view           = cache + cachePosition;
+	cachePosition += count;
+
+	return (view);
+}
+
+
+
+/******************************************************************************/
+/**	Reads a 16 bit integer in little endian format from the file of this object
+ *	and return it in the native host format. The number is taken directly from
+ *	the cache when possible.
+ *
+ *	@return the read 16 bit integer (uint16).
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+uint16 PCacheFile::Read_L_UINT16(void)
+{
+	uint16 retVal;
+
+	if ((cacheFilled - cachePosition) >= 2)
+	{
+		retVal         = P_LENDIAN_TO_HOST_INT16(*((uint16 *)(cache + cachePosition)));
+		cachePosition += 2;
+		return (retVal);
+	}
+
+	return (PFile::Read_L_UINT16());
+}
+
+
+
+/******************************************************************************/
+/**	Reads a 32 bit integer in little endian format from the file of this object
+ *	and return it in the native host format. The number is taken directly from
+ *	the cache when possible.
+ *
+ *	@return the read 32 bit integer (uint32).
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+uint32 PCacheFile::Read_L_UINT32(void)
+{
+	uint32 retVal;
+
+	if ((cacheFilled - cachePosition) >= 4)
+	{
+		retVal         = P_LENDIAN_TO_HOST_INT32(*((uint32 *)(cache + cachePosition)));
+		cachePosition += 4;
+		return (retVal);
+	}
+
+	return (PFile::Read_L_UINT32());
+}
+
+
+
+/******************************************************************************/
+/**	Reads a 16 bit integer in big endian format from the file of this object
+ *	and return it in the native host format. The number is taken directly from
+ *	the cache when possible.
+ *
+ *	@return the read 16 bit integer (uint16).
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+uint16 PCacheFile::Read_B_UINT16(void)
+{
+	uint16 retVal;
+
+	if ((cacheFilled - cachePosition) >= 2)
+	{
+		retVal         = P_BENDIAN_TO_HOST_INT16(*((uint16 *)(cache + cachePosition)));
+		cachePosition += 2;
+		return (retVal);
+	}
+
+	return (PFile::Read_B_UINT16());
+}
+
+
+
+/******************************************************************************/
+/**	Reads a 32 bit integer in big endian format from the file of this object
+ *	and return it in the native host format. The number is taken directly from
+ *	the cache when possible.
+ *
+ *	@return the read 32 bit integer (uint32).
+ *
+ *	@exception PFileException
+ *//***************************************************************************/
+uint32 PCacheFile::Read_B_UINT32(void)
+{
+	uint32 retVal;
+
+	if ((cacheFilled - cachePosition) >= 4)
+	{
+		retVal         = P_BENDIAN_TO_HOST_INT32(*((uint32 *)(cache + cachePosition)));
+		cachePosition += 4;
+		return (retVal);
+	}
+
+	return (PFile::Read_B_UINT32());
+}
+
+
+
 /******************************************************************************/
 /**	Seeks to a new position in the file of this object.
  *
@@ -1949,6 +2427,34 @@ uint8 PMemFile::Read_UINT8(void)
 
 
 
+/******************************************************************************/
+/**	Returns a pointer directly into the memory buffer at the current position
+ *	and skips the bytes. The pointer is valid until the buffer is changed.
+ *
+ *	@param count the number of bytes to get.
+ *
+ *	@return a pointer to the bytes or NULL if there are not enough bytes left
+ *		in the file.
+ *//***************************************************************************/
+const uint8 *PMemFile::ReadView(int32 count)
+{
+	const uint8 *view;
+
+	ASSERT(fileOpened == true);
+
+	// Check for end of file is reached
+	if ((position + count) > fileSize)
+		return (NULL);
+
+	view      = memBuffer + position;
+	position += count;
+	eof       = false;
+
+	return (view);
+}
+
+
+
 /******************************************************************************/
 /**	Reads a 16 bit integer in little endian format from the file of this object
  *	and return it in the native host format.
@@ -2005,50 +2511,6 @@ uint32 PMemFile::Read_L_UINT32(void)
 
 
 
-/******************************************************************************/
-/**	Reads an array of 16 bit integers in little endian format from the file of
- *	this object and convert the integers to the native host format.
- *
- *	@param buffer pointer to where to store the array of 16 bit integers.
- *	@param count the number of 16 bit integers to read.
- *//***************************************************************************/
-void PMemFile::ReadArray_L_UINT16s(uint16 *buffer, int32 count)
-{
-	uint16 *tempBuffer;
-
-	ASSERT(fileOpened == true);
-
-	// Initialize temp variables
-	tempBuffer = (uint16 *)(memBuffer + position);
-
-	for (; ((count > 0) && ((position + 1) < fileSize)); count--, position += 2)
-		*buffer++ = P_LENDIAN_TO_HOST_INT16(*tempBuffer++);
-}
-
-
-
-/******************************************************************************/
-/**	Reads an array of 32 bit integers in little endian format from the file of
- *	this object and convert the integers to the native host format.
- *
- *	@param buffer pointer to where to store the array of 32 bit integers.
- *	@param count the number of 32 bit integers to read.
- *//***************************************************************************/
-void PMemFile::ReadArray_L_UINT32s(uint32 *buffer, int32 count)
-{
-	uint32 *tempBuffer;
-
-	ASSERT(fileOpened == true);
-
-	// Initialize temp variables
-	tempBuffer = (uint32 *)(memBuffer + position);
-
-	for (; ((count > 0) && ((position + 3) < fileSize)); count--, position += 4)
-		*buffer++ = P_LENDIAN_TO_HOST_INT32(*tempBuffer++);
-}
-
-
-
 /******************************************************************************/
 /**	Reads a 16 bit integer in big endian format from the file of this object
  *	and return it in the native host format.
@@ -2105,53 +2567,6 @@ uint32 PMemFile::Read_B_UINT32(void)
 
 
 
-/******************************************************************************/
-/**	Reads an array of 16 bit integers in big endian format from the file of
- *	this object and convert the integers to the native host format.
- *
- *	@param buffer pointer to where to store the array of 16 bit integers.
- *	@param count the number of 16 bit integers to read.
- *//***************************************************************************/
-void PMemFile::ReadArray_B_UINT16s(uint16 *buffer, int32 count)
-{
-	uint16 *tempBuffer;
-
-	ASSERT(fileOpened == true);
-
-	// Initialize temp variables
-	tempBuffer = (uint16 *)(memBuffer + position);
-
-	for (; ((count > 0) && ((position + 1) < fileSize)); count--, position += 2)
-	{
-		*buffer++ = P_BENDIAN_TO_HOST_INT16(*tempBuffer++);
-		position += 2;
-	}
-}
-
-
-
-/******************************************************************************/
-/**	Reads an array of 32 bit integers in big endian format from the file of
- *	this object and convert the integers to the native host format.
- *
- *	@param buffer pointer to where to store the array of 32 bit integers.
- *	@param count the number of 32 bit integers to read.
- *//***************************************************************************/
-void PMemFile::ReadArray_B_UINT32s(uint32 *buffer, int32 count)
-{
-	uint32 *tempBuffer;
-
-	ASSERT(fileOpened == true);
-
-	// Initialize temp variables
-	tempBuffer = (uint32 *)(memBuffer + position);
-
-	for (; ((count > 0) && ((position + 3) < fileSize)); count--, position += 4)
-		*buffer++ = P_BENDIAN_TO_HOST_INT32(*tempBuffer++);
-}
-
-
-
 /******************************************************************************/
 /**	Writes a byte (8 bit integer) to the file of this object.
  *
@@ -3753,3 +4168,205 @@ PFile *PFTPFile::DuplicateFile(void) const
 
 	return (newFile);
 }
+
+
+
+
+
+/******************************************************************************/
+/* PLineReader class                                                          */
+/******************************************************************************/
+
+/******************************************************************************/
+/**	Standard constructor. The file is not owned by the reader and has to be
+ *	open as long as the reader is used.
+ *
+ *	@param file pointer to the file to read the lines from.
+ *	@param characterSet pointer to the character set the lines are stored in.
+ *	If NULL, the host character set is used.
+ *	@param size is the number of bytes read from the file at once.
+ *
+ *	@exception PMemoryException
+ *//***************************************************************************/
+PLineReader::PLineReader(PFile *file, PCharacterSet *characterSet, int32 size)
+{
+	int8 nullLen;
+
+	// Initialize member variables
+	readFile       = file;
+	bufferSize     = size;
+	bufferFilled   = 0;
+	bufferPosition = 0;
+	endOfFile      = false;
+	buffer         = NULL;
+
+	// Find the character set to use
+	if (characterSet == NULL)
+	{
+		charSet    = CreateHostCharacterSet();
+		ownCharSet = true;
+	}
+	else
+	{
+		charSet    = characterSet;
+		ownCharSet = false;
+	}
+
+	// The line ends can only be found directly in the bytes, if the
+	// character set use single byte control characters
+	charSet->FromUnicode(0x0000, nullLen);
+	byteLines = (nullLen == 1);
+
+	if (byteLines)
+	{
+		// Allocate the buffer
+		buffer = new char[bufferSize];
+		if (buffer == NULL)
+		{
+			if (ownCharSet)
+				delete charSet;
+
+			throw PMemoryException();
+		}
+	}
+}
+
+
+
+/******************************************************************************/
+/**	Destructor.
+ *//***************************************************************************/
+PLineReader::~PLineReader(void)
+{
+	delete[] buffer;
+
+	if (ownCharSet)
+		delete charSet;
+}
+
+
+
+/******************************************************************************/
+/**	Reads the next line from the file. The line end can be a line feed, a
+ *	carriage return, both or a null character.
+ *
+ *	@param line is where the line read is stored. It will be empty when the
+ *	end of the file has been reached.
+ *
+ *	@return true if a line has been read, false at the end of the file.
+ *
+ *	@exception PFileException
+ *	@exception PMemoryException
+ *//***************************************************************************/
+bool PLineReader::ReadLine(PString &line)
+{
+	const char *start, *end, *lineEnd, *found;
+
+	// Character sets with multi byte control characters can't be
+	// scanned as bytes, so let the file read the line
+	if (!byteLines)
+	{
+		line = readFile->ReadLine(charSet);
+		return (!(line.IsEmpty() && readFile->IsEOF()));
+	}
+
+	for (;;)
+	{
+		start = buffer + bufferPosition;
+		end   = buffer + bufferFilled;
+
+		// Find the first line end character in the buffer
+		lineEnd = (const char *)memchr(start, '\n', end - start);
+		if (lineEnd == NULL)
+			lineEnd = end;
+
+		found = (const char *)memchr(start, '\r', lineEnd - start);
+		if (found != NULL)
+			lineEnd = found;
+
+		found = (const char *)memchr(start, 0x00, lineEnd - start);
+		if (found != NULL)
+			lineEnd = found;
+
+		if (lineEnd != end)
+		{
+			// A carriage return as the last byte in the buffer can be
+			// followed by a line feed, so read more before using it
+			if ((*lineEnd != '\r') || ((lineEnd + 1) != end) || endOfFile)
+			{
+				line.SetString(start, lineEnd - start, charSet);
+
+				bufferPosition = lineEnd - buffer + 1;
+				if ((*lineEnd == '\r') && ((lineEnd + 1) != end) && (lineEnd[1] == '\n'))
+					bufferPosition++;
+
+				return (true);
+			}
+		}
+		else
+		{
+			if (endOfFile)
+			{
+				// Nothing more in the file
+				if (start == end)
+				{
+					line.MakeEmpty();
+					return (false);
+				}
+
+				// The last line does not have a line end
+				line.SetString(start, end - start, charSet);
+				bufferPosition = bufferFilled;
+				return (true);
+			}
+		}
+
+		// Get some more data
+		FillBuffer();
+	}
+}
+
+
+
+/******************************************************************************/
+/**	Moves the unused bytes to the start of the buffer and fills the rest of
+ *	it from the file. If the buffer is full with a single line, it is made
+ *	bigger.
+ *
+ *	@exception PFileException
+ *	@exception PMemoryException
+ *//***************************************************************************/
+void PLineReader::FillBuffer(void)
+{
+	char *newBuffer;
+	int32 bytesLeft, bytesRead;
+
+	// Move the rest of the buffer to the start
+	bytesLeft = bufferFilled - bufferPosition;
+	if ((bytesLeft != 0) && (bufferPosition != 0))
+		memmove(buffer, buffer + bufferPosition, bytesLeft);
+
+	bufferFilled   = bytesLeft;
+	bufferPosition = 0;
+
+	// Is the buffer full with a single line?
+	if (bufferFilled == bufferSize)
+	{
+		newBuffer = new char[bufferSize * 2];
+		if (newBuffer == NULL)
+			throw PMemoryException();
+
+		memcpy(newBuffer, buffer, bufferFilled);
+		delete[] buffer;
+
+		buffer      = newBuffer;
+		bufferSize *= 2;
+	}
+
+	// Read the next chunk
+	bytesRead = readFile->Read(buffer + bufferFilled, bufferSize - bufferFilled);
+	if (bytesRead == 0)
+		endOfFile = true;
+
+	bufferFilled += bytesRead;
+}
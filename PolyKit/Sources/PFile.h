@@ -71,6 +71,8 @@ public:
 	virtual PString ReadLine(PCharacterSet *characterSet = NULL);
 
 	virtual uint8 Read_UINT8(void);
+	virtual void ReadArray_UINT8s(uint8 *buffer, int32 count);
+	virtual const uint8 *ReadView(int32 count);
 
 	virtual uint16 Read_L_UINT16(void);
 	virtual uint32 Read_L_UINT32(void);
@@ -82,6 +84,11 @@ public:
 	virtual void ReadArray_B_UINT16s(uint16 *buffer, int32 count);
 	virtual void ReadArray_B_UINT32s(uint32 *buffer, int32 count);
 
+	static void ConvertArray_L_UINT16s(uint16 *buffer, int32 count);
+	static void ConvertArray_L_UINT32s(uint32 *buffer, int32 count);
+	static void ConvertArray_B_UINT16s(uint16 *buffer, int32 count);
+	static void ConvertArray_B_UINT32s(uint32 *buffer, int32 count);
+
 	virtual void WriteString(PString string, PCharacterSet *characterSet = NULL);
 	virtual void WriteLine(PString line, PCharacterSet *characterSet = NULL);
 
@@ -123,6 +130,9 @@ public:
 	virtual PFile *DuplicateFile(void) const;
 
 protected:
+	PString ReadByteLine(PCharacterSet *charSet);
+	PString ReadCharLine(PCharacterSet *charSet);
+
 	bool fileOpened;
 	bool eof;
 	uint16 prevOpenFlags;
@@ -154,6 +164,15 @@ public:
 	virtual int32 Read(void *buffer, int32 count);
 	virtual int32 Write(const void *buffer, int32 count);
 
+	virtual uint8 Read_UINT8(void);
+	virtual const uint8 *ReadView(int32 count);
+
+	virtual uint16 Read_L_UINT16(void);
+	virtual uint32 Read_L_UINT32(void);
+
+	virtual uint16 Read_B_UINT16(void);
+	virtual uint32 Read_B_UINT32(void);
+
 	virtual int64 Seek(int64 offset, PSeekFlags from);
 	virtual int64 GetPosition(void) const;
 
@@ -193,16 +212,13 @@ public:
 	virtual int32 Write(const void *buffer, int32 count);
 
 	virtual uint8 Read_UINT8(void);
+	virtual const uint8 *ReadView(int32 count);
 
 	virtual uint16 Read_L_UINT16(void);
 	virtual uint32 Read_L_UINT32(void);
-	virtual void ReadArray_L_UINT16s(uint16 *buffer, int32 count);
-	virtual void ReadArray_L_UINT32s(uint32 *buffer, int32 count);
 
 	virtual uint16 Read_B_UINT16(void);
 	virtual uint32 Read_B_UINT32(void);
-	virtual void ReadArray_B_UINT16s(uint16 *buffer, int32 count);
-	virtual void ReadArray_B_UINT32s(uint32 *buffer, int32 count);
 
 	virtual void Write_UINT8(uint8 value);
 
@@ -373,6 +389,40 @@ protected:
 	PString logonPassword;
 };
 
+
+
+/******************************************************************************/
+/* PLineReader class                                                          */
+/******************************************************************************/
+/**
+ *	This class is used to read many lines from a file. It reads big chunks
+ *	from the file and finds the lines in them, so it never has to seek back.
+ *	Because of this, the file position will be after the last chunk read and
+ *	not after the last line returned.
+ */
+class _IMPEXP_PKLIB PLineReader
+{
+public:
+	PLineReader(PFile *file, PCharacterSet *characterSet = NULL, int32 size = 32768);
+	virtual ~PLineReader(void);
+
+	bool ReadLine(PString &line);
+
+protected:
+	void FillBuffer(void);
+
+	PFile *readFile;
+	PCharacterSet *charSet;
+	bool ownCharSet;
+	bool byteLines;
+
+	char *buffer;
+	int32 bufferSize;
+	int32 bufferFilled;
+	int32 bufferPosition;
+	bool endOfFile;
+};
+
 #if __p_os == __p_beos && __POWERPC__
 #pragma export off
 #endif
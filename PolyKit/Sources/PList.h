@@ -20,6 +20,11 @@
 
 /******************************************************************************/
 /* PList class                                                                */
+/*                                                                            */
+/* The items are stored in one array, so getting an item at any index is      */
+/* done in constant time. The array grows when needed, which means that       */
+/* references returned by GetElement() are only valid until the list is       */
+/* changed.                                                                   */
 /******************************************************************************/
 template<class TYPE>
 class PList
@@ -62,32 +67,13 @@ public:
 	const PList<TYPE> & operator = (const PList<TYPE> &newList);
 
 protected:
-	typedef struct PNode
-	{
-		PNode *nextNode;
-		PNode *prevNode;
-		TYPE *data;
-		int32 dataCount;
-	} PNode;
-
-	typedef struct PListOptimize
-	{
-		// These variables are used to optimize all the get functions
-		PNode *lastUsedNode;
-		int32 lastUsedNodeIndex;
-	} PListOptimize;
-
-	PNode *AllocateNode(void) const;
-	PNode *FindNode(int32 index, int32 *pos) const;
-	void InsertNewItem(TYPE item, PNode *node, int32 index);
+	void MakeRoom(int32 index, int32 count);
 	TYPE RemoveSomeItems(int32 index, int32 count);
 
-	PNode *firstNode;
-	PNode *lastNode;
+	TYPE *items;
 	int32 addSize;
 	int32 itemCount;
-
-	PListOptimize *optimize;
+	int32 itemMax;
 };
 
 
@@ -95,24 +81,16 @@ protected:
 /******************************************************************************/
 /* Constructor                                                                */
 /*                                                                            */
-/* Input:  "blockSize" is the number of items to allocate at once.            */
+/* Input:  "blockSize" is the minimum number of items to allocate at once.    */
 /******************************************************************************/
 template<class TYPE>
 PList<TYPE>::PList(int32 blockSize)
 {
 	// Initialize member variables
-	firstNode = NULL;
-	lastNode  = NULL;
-	addSize   = blockSize;
+	items     = NULL;
+	addSize   = (blockSize < 1) ? 1 : blockSize;
 	itemCount = 0;
-
-	// Initialize optimization variables
-	optimize = new PListOptimize;
-	if (optimize == NULL)
-		throw PMemoryException();
-
-	optimize->lastUsedNode      = NULL;
-	optimize->lastUsedNodeIndex = 0;
+	itemMax   = 0;
 }
 
 
@@ -124,8 +102,6 @@ template<class TYPE>
 PList<TYPE>::~PList(void)
 {
 	MakeEmpty();
-
-	delete optimize;
 }
 
 
@@ -138,24 +114,8 @@ PList<TYPE>::~PList(void)
 template<class TYPE>
 void PList<TYPE>::AddHead(TYPE item)
 {
-	if (firstNode == NULL)
-	{
-		PNode *workNode;
-
-		// First item in the list we are about to add
-		workNode = AllocateNode();
-		workNode->data[0] = item;
-
-		// Link the new node to the list
-		firstNode = workNode;
-		lastNode  = workNode;
-		itemCount = 1;
-	}
-	else
-	{
-		// Insert the new item at the first position in the node
-		InsertNewItem(item, firstNode, 0);
-	}
+	MakeRoom(0, 1);
+	items[0] = item;
 }
 
 
@@ -170,45 +130,8 @@ void PList<TYPE>::AddHead(TYPE item)
 template<class TYPE>
 int32 PList<TYPE>::AddTail(TYPE item)
 {
-	PNode *workNode;
-
-	if (lastNode == NULL)
-	{
-		// First item in the list we are about to add
-		workNode = AllocateNode();
-		workNode->data[0] = item;
-
-		// Link the new node to the list
-		firstNode = workNode;
-		lastNode  = workNode;
-	}
-	else
-	{
-		// Find an empty space at the tail
-		if (lastNode->dataCount < addSize)
-		{
-			// There are some space in the last node
-			lastNode->data[lastNode->dataCount] = item;
-			lastNode->dataCount++;
-		}
-		else
-		{
-			// We need to allocate a new node
-			workNode = AllocateNode();
-			workNode->data[0] = item;
-
-			// Link the new node to the list
-			lastNode->nextNode = workNode;
-			workNode->prevNode = lastNode;
-			lastNode           = workNode;
-		}
-
-		// Reset the get state variable
-		optimize->lastUsedNode = NULL;
-	}
-
-	// Increment the number of items
-	itemCount++;
+	MakeRoom(itemCount, 1);
+	items[itemCount - 1] = item;
 
 	return (itemCount - 1);
 }
@@ -226,30 +149,12 @@ int32 PList<TYPE>::AddTail(TYPE item)
 template<class TYPE>
 void PList<TYPE>::InsertItem(TYPE item, int32 index)
 {
-	PNode *insertNode;
-	int32 pos;
-
 	// First check for out of range
-	if ((index < 0) || (index > CountItems()))
+	if ((index < 0) || (index > itemCount))
 		throw PBoundsException(P_ERR_ANY, index);
 
-	// Add at the head of the list?
-	if (index == 0)
-	{
-		AddHead(item);
-		return;
-	}
-
-	// Add at the tail of the list?
-	if (index == CountItems())
-	{
-		AddTail(item);
-		return;
-	}
-
-	// Find the node to insert the item in
-	insertNode = FindNode(index, &pos);
-	InsertNewItem(item, insertNode, index - pos);
+	MakeRoom(index, 1);
+	items[index] = item;
 }
 
 
@@ -266,29 +171,25 @@ void PList<TYPE>::InsertItem(TYPE item, int32 index)
 template<class TYPE>
 void PList<TYPE>::InsertList(const PList<TYPE> &list, int32 index)
 {
-	PNode *curNode;
-	int32 i;
+	int32 i, count;
 
-	// Copy the list
-	curNode = list.firstNode;
-	while (curNode != NULL)
-	{
-		if (index == -1)
-		{
-			for (i = 0; i < curNode->dataCount; i++)
-				AddTail(curNode->data[i]);
-		}
-		else
-		{
-			for (i = 0; i < curNode->dataCount; i++)
-				InsertItem(curNode->data[i], index++);
-		}
-
-		curNode = curNode->nextNode;
-	}
+	// Find the insert position
+	if (index == -1)
+		index = itemCount;
+
+	if ((index < 0) || (index > itemCount))
+		throw PBoundsException(P_ERR_ANY, index);
+
+	// Nothing to copy?
+	count = list.itemCount;
+	if (count == 0)
+		return;
 
-	// Reset the get state variable
-	optimize->lastUsedNode = NULL;
+	// Make room for all the items in one go and copy them
+	MakeRoom(index, count);
+
+	for (i = 0; i < count; i++)
+		items[index + i] = list.items[i];
 }
 
 
@@ -373,10 +274,10 @@ void PList<TYPE>::RemoveItems(int32 index, int32 count)
 template<class TYPE>
 TYPE PList<TYPE>::GetHead(void) const
 {
-	if (firstNode == NULL)
+	if (itemCount == 0)
 		throw PBoundsException();
 
-	return (firstNode->data[0]);
+	return (items[0]);
 }
 
 
@@ -391,10 +292,10 @@ TYPE PList<TYPE>::GetHead(void) const
 template<class TYPE>
 TYPE PList<TYPE>::GetTail(void) const
 {
-	if (lastNode == NULL)
+	if (itemCount == 0)
 		throw PBoundsException();
 
-	return (lastNode->data[lastNode->dataCount - 1]);
+	return (items[itemCount - 1]);
 }
 
 
@@ -409,17 +310,13 @@ TYPE PList<TYPE>::GetTail(void) const
 /* Except: PBoundsException.                                                  */
 /******************************************************************************/
 template<class TYPE>
-TYPE PList<TYPE>::GetItem(int32 index) const
+inline TYPE PList<TYPE>::GetItem(int32 index) const
 {
-	PNode *itemNode;
-	int32 pos;
-
 	// First check for out of range
-	if ((index < 0) || (index >= CountItems()))
+	if ((index < 0) || (index >= itemCount))
 		throw PBoundsException(P_ERR_ANY, index);
 
-	itemNode = FindNode(index, &pos);
-	return (itemNode->data[index - pos]);
+	return (items[index]);
 }
 
 
@@ -433,18 +330,13 @@ TYPE PList<TYPE>::GetItem(int32 index) const
 /* Except: PBoundsException.                                                  */
 /******************************************************************************/
 template<class TYPE>
-void PList<TYPE>::SetItem(TYPE item, int32 index)
+inline void PList<TYPE>::SetItem(TYPE item, int32 index)
 {
-	PNode *setNode;
-	int32 pos;
-
 	// First check for out of range
-	if ((index < 0) || (index >= CountItems()))
+	if ((index < 0) || (index >= itemCount))
 		throw PBoundsException(P_ERR_ANY, index);
 
-	// Find the node to change
-	setNode = FindNode(index, &pos);
-	setNode->data[index - pos] = item;
+	items[index] = item;
 }
 
 
@@ -462,18 +354,14 @@ void PList<TYPE>::SetItem(TYPE item, int32 index)
 template<class TYPE>
 TYPE PList<TYPE>::GetAndSetItem(TYPE item, int32 index)
 {
-	PNode *setNode;
-	int32 pos;
 	TYPE oldValue;
 
 	// First check for out of range
-	if ((index < 0) || (index >= CountItems()))
+	if ((index < 0) || (index >= itemCount))
 		throw PBoundsException(P_ERR_ANY, index);
 
-	// Find the node to change
-	setNode = FindNode(index, &pos);
-	oldValue = setNode->data[index - pos];
-	setNode->data[index - pos] = item;
+	oldValue     = items[index];
+	items[index] = item;
 
 	return (oldValue);
 }
@@ -481,7 +369,8 @@ TYPE PList<TYPE>::GetAndSetItem(TYPE item, int32 index)
 
 
 /******************************************************************************/
-/* GetElement() will return a reference to the item at the index given.       */
+/* GetElement() will return a reference to the item at the index given. The   */
+/*      reference is valid until the list is changed.                         */
 /*                                                                            */
 /* Input:  "index" is the index in the list of the item you want.             */
 /*                                                                            */
@@ -490,17 +379,13 @@ TYPE PList<TYPE>::GetAndSetItem(TYPE item, int32 index)
 /* Except: PBoundsException.                                                  */
 /******************************************************************************/
 template<class TYPE>
-TYPE & PList<TYPE>::GetElement(int32 index) const
+inline TYPE & PList<TYPE>::GetElement(int32 index) const
 {
-	PNode *itemNode;
-	int32 pos;
-
 	// First check for out of range
-	if ((index < 0) || (index >= CountItems()))
+	if ((index < 0) || (index >= itemCount))
 		throw PBoundsException(P_ERR_ANY, index);
 
-	itemNode = FindNode(index, &pos);
-	return (itemNode->data[index - pos]);
+	return (items[index]);
 }
 
 
@@ -539,39 +424,17 @@ bool PList<TYPE>::HasItem(TYPE item, int32 startPos) const
 template<class TYPE>
 int32 PList<TYPE>::GetItemIndex(TYPE item, int32 startPos) const
 {
-	PNode *curNode;
-	int32 pos;
 	int32 i;
 
 	// First check for out of range
-	if ((startPos < 0) || (startPos >= CountItems()))
+	if ((startPos < 0) || (startPos >= itemCount))
 		throw PBoundsException(P_ERR_ANY, startPos);
 
-	try
-	{
-		// First find the start node
-		curNode = FindNode(startPos, &pos);
-	}
-	catch(PBoundsException e)
-	{
-		// Well, we couldn't find the node, so return -1
-		return (-1);
-	}
-
 	// Now begin to search for the item
-	startPos -= pos;
-	while (curNode != NULL)
+	for (i = startPos; i < itemCount; i++)
 	{
-		for (i = startPos; i < curNode->dataCount; i++)
-		{
-			if (curNode->data[i] == item)
-				return (pos + i);			// Return the index
-		}
-
-		// Go to the next node
-		pos     += curNode->dataCount;
-		curNode  = curNode->nextNode;
-		startPos = 0;
+		if (items[i] == item)
+			return (i);			// Return the index
 	}
 
 	// Item not found
@@ -612,25 +475,13 @@ inline bool PList<TYPE>::IsEmpty(void) const
 template<class TYPE>
 void PList<TYPE>::MakeEmpty(void)
 {
-	PNode *curNode, *nextNode;
-
-	// Delete all the items and nodes
-	curNode = firstNode;
-	while (curNode != NULL)
-	{
-		nextNode = curNode->nextNode;
-
-		delete[] curNode->data;
-		delete curNode;
-
-		curNode = nextNode;
-	}
+	// Delete all the items
+	delete[] items;
 
 	// Clear the list variables
-	firstNode              = NULL;
-	lastNode               = NULL;
-	itemCount              = 0;
-	optimize->lastUsedNode = NULL;
+	items     = NULL;
+	itemCount = 0;
+	itemMax   = 0;
 }
 
 
@@ -639,13 +490,17 @@ void PList<TYPE>::MakeEmpty(void)
 /* operator = (PList &) will empty the current list and copy all the elements */
 /*      from the list given.                                                  */
 /*                                                                            */
-/* Input:  "newList" is the new list.                                            */
+/* Input:  "newList" is the new list.                                         */
 /*                                                                            */
 /* Output: The pointer to the current list.                                   */
 /******************************************************************************/
 template<class TYPE>
 const PList<TYPE> & PList<TYPE>::operator = (const PList<TYPE> &newList)
 {
+	// Assigning the list to itself should not clear it
+	if (&newList == this)
+		return (*this);
+
 	// Clear the list
 	MakeEmpty();
 
@@ -658,234 +513,53 @@ const PList<TYPE> & PList<TYPE>::operator = (const PList<TYPE> &newList)
 
 
 /******************************************************************************/
-/* AllocateNode() will allocate a new node and return it.                     */
+/* MakeRoom() will make room for a number of items at the index given. The    */
+/*      array is made bigger if needed and the item count is incremented.     */
 /*                                                                            */
-/* Output: A pointer to the new node.                                         */
-/******************************************************************************/
-template<class TYPE>
-typename PList<TYPE>::PNode *PList<TYPE>::AllocateNode(void) const
-{
-	PNode *newNode;
-
-	// Allocate the node
-	newNode = new PNode;
-	if (newNode == NULL)
-		throw PMemoryException();
-
-	// Fill out the new node
-	newNode->nextNode  = NULL;
-	newNode->prevNode  = NULL;
-	newNode->dataCount = 1;	// We know that there will be at least added one item in the list
-	newNode->data      = new TYPE[addSize];
-	if (newNode->data == NULL)
-	{
-		delete newNode;
-		throw PMemoryException();
-	}
-
-	return (newNode);
-}
-
-
-
-/******************************************************************************/
-/* FindNode() will try to find the node with the index given.                 */
+/* Input:  "index" is where the new items should be inserted.                 */
+/*         "count" is the number of items to make room for.                   */
 /*                                                                            */
-/* Input:  "index" is the index to find the node at.                          */
-/*         "pos" is a pointer to store the position the first item in the     */
-/*         node have.                                                         */
-/*                                                                            */
-/* Output: A pointer to the new node.                                         */
-/*                                                                            */
-/* Except: PBoundsException.                                                  */
+/* Except: PMemoryException.                                                  */
 /******************************************************************************/
 template<class TYPE>
-typename PList<TYPE>::PNode *PList<TYPE>::FindNode(int32 index, int32 *pos) const
+void PList<TYPE>::MakeRoom(int32 index, int32 count)
 {
-	PNode *workNode;
-	int32 workPos;
+	TYPE *newItems;
+	int32 i, newMax;
 
-	if (optimize->lastUsedNode != NULL)
+	if ((itemCount + count) > itemMax)
 	{
-		// If the new index is bigger than the old one, continue the search
-		if (index >= optimize->lastUsedNodeIndex)
-		{
-			workNode = optimize->lastUsedNode;
-			workPos  = optimize->lastUsedNodeIndex;
-		}
-		else
-		{
-			// Ok, the new index is lower than the old one.
-			// Now find out if it is faster to make a backward
-			// search or we should begin from the start
-			//
-			// If the new index is in the upper half of the
-			// list going from the start to the old index,
-			// a backward search is faster
-			if (index < (optimize->lastUsedNodeIndex / 2))
-			{
-				// The new index is in the lower half, so begin over
-				workNode = firstNode;
-				workPos  = 0;
-			}
-			else
-			{
-				// Make backward search
-				workNode = optimize->lastUsedNode->prevNode;
-				workPos  = optimize->lastUsedNodeIndex - workNode->dataCount;
-
-				while (workNode != NULL)
-				{
-					if (index >= workPos)
-					{
-						// Found the node, now return it
-						*pos                        = workPos;
-						optimize->lastUsedNodeIndex = workPos;
-						optimize->lastUsedNode      = workNode;
-
-						return (workNode);
-					}
-
-					// Go to the previous node
-					workNode = workNode->prevNode;
-
-					if (workNode != NULL)
-						workPos -= workNode->dataCount;
-				}
-
-				// Something is wrong, we should never get here!
-				throw PBoundsException(P_ERR_ANY, index);
-			}
-		}
+		// The array is full, so allocate a bigger one. It is
+		// doubled each time, so adding items is amortized O(1)
+		newMax = max(itemMax * 2, itemMax + addSize);
+		if (newMax < (itemCount + count))
+			newMax = itemCount + count;
+
+		newItems = new TYPE[newMax];
+		if (newItems == NULL)
+			throw PMemoryException();
+
+		// Copy the items into the new array, leaving a hole
+		// where the new items will be inserted
+		for (i = 0; i < index; i++)
+			newItems[i] = items[i];
+
+		for (i = index; i < itemCount; i++)
+			newItems[i + count] = items[i];
+
+		delete[] items;
+		items   = newItems;
+		itemMax = newMax;
 	}
 	else
 	{
-		// Start over from the beginning of the list
-		workNode = firstNode;
-		workPos  = 0;
+		// Move the items after the index to make room
+		for (i = itemCount - 1; i >= index; i--)
+			items[i + count] = items[i];
 	}
 
-	// Search for the index using forward search
-	while (workNode != NULL)
-	{
-		if (index < (workPos + workNode->dataCount))
-		{
-			// Found the node, now return it
-			*pos                        = workPos;
-			optimize->lastUsedNodeIndex = workPos;
-			optimize->lastUsedNode      = workNode;
-
-			return (workNode);
-		}
-
-		// Go to the next node
-		workPos += workNode->dataCount;
-		workNode = workNode->nextNode;
-	}
-
-	// Something is wrong, we should never get here!
-	throw PBoundsException(P_ERR_ANY, index);
-
-	// Just to make the compiler happy
-	return (NULL);
-}
-
-
-
-/******************************************************************************/
-/* InsertNewItem() will insert the item in the node and index given.          */
-/*                                                                            */
-/* Input:  "item" is the item to insert.                                      */
-/*         "node" is a pointer to the node.                                   */
-/*         "index" is the index in the node.                                  */
-/******************************************************************************/
-template<class TYPE>
-void PList<TYPE>::InsertNewItem(TYPE item, PNode *node, int32 index)
-{
-	int32 i, j;
-
-	// Start to check to see if the data array is full
-	if (node->dataCount < addSize)
-	{
-		// It isn't, so move the items in the array to
-		// make space for the new item
-		for (i = node->dataCount; i > index; i--)
-			node->data[i] = node->data[i - 1];
-
-		// Now insert the new item
-		node->data[index] = item;
-		node->dataCount++;
-	}
-	else
-	{
-		// Well, the array is full. Check to see if there is any
-		// space in the next array
-		if ((node->nextNode != NULL) && (node->nextNode->dataCount < addSize))
-		{
-			// Yeah, now copy as many items as possible, but
-			// first move the items to make room
-			PNode *workNode = node->nextNode;
-			int32 toCopy;
-
-			toCopy = min(addSize - workNode->dataCount, node->dataCount - index);
-
-			for (i = workNode->dataCount + toCopy - 1; i >= toCopy; i--)
-				workNode->data[i] = workNode->data[i - toCopy];
-
-			// Now copy the items into the room we have created
-			for (i = node->dataCount - toCopy, j = 0; j < toCopy; i++, j++)
-				workNode->data[j] = node->data[i];
-
-			// Now move the items in the first node to make room
-			// for the new item to insert if needed
-			if ((node->dataCount - index) != toCopy)
-			{
-				for (i = node->dataCount - toCopy; i > index; i--)
-					node->data[i] = node->data[i - 1];
-			}
-
-			// Insert the new item
-			node->data[index] = item;
-
-			// Adjust the data counters
-			node->dataCount     -= (toCopy - 1);
-			workNode->dataCount += toCopy;
-		}
-		else
-		{
-			// There isn't enough space, so we need to allocate
-			// a new node and array
-			PNode *newNode = AllocateNode();
-
-			// Move the items from the insert position to the end
-			// into the new array
-			for (i = index, j = 0; i < node->dataCount; i++, j++)
-				newNode->data[j] = node->data[i];
-
-			// Insert the new item
-			node->data[index] = item;
-
-			// Adjust the data count in the node structures
-			newNode->dataCount = node->dataCount - index;
-			node->dataCount    = index + 1;
-
-			// Link the new node into the list
-			newNode->nextNode = node->nextNode;
-			node->nextNode    = newNode;
-			newNode->prevNode = node;
-
-			if (newNode->nextNode != NULL)
-				newNode->nextNode->prevNode = newNode;
-			else
-				lastNode = newNode;
-		}
-	}
-
-	// Increment the list counter
-	itemCount++;
-
-	// Reset the get state variable
-	optimize->lastUsedNode = NULL;
+	// Increment the number of items
+	itemCount += count;
 }
 
 
@@ -903,132 +577,29 @@ void PList<TYPE>::InsertNewItem(TYPE item, PNode *node, int32 index)
 template<class TYPE>
 TYPE PList<TYPE>::RemoveSomeItems(int32 index, int32 count)
 {
-	PNode *workNode, *prevNode;
-	int32 tempCount = count;
-	int32 i, pos, oldDataCount;
 	TYPE firstItem;
+	int32 i;
 
 	// First check for out of range
-	if ((index < 0) || (index >= CountItems()))
+	if ((index < 0) || (index >= itemCount))
 		throw PBoundsException(P_ERR_ANY, index);
 
-	// Find the node where the first item to remove is
-	workNode = FindNode(index, &pos);
-
 	// Remember the first item
-	firstItem = workNode->data[index - pos];
-
-	// Decrement the data counters in the nodes where we remove items
-	oldDataCount = workNode->dataCount;
-	pos          = index - pos;
+	firstItem = items[index];
 
-	while ((workNode != NULL) && (tempCount > 0))
-	{
-		workNode->dataCount--;
-		tempCount--;
-		pos++;
-		itemCount--;
-
-		if (pos == oldDataCount)
-		{
-			pos      = 0;
-			workNode = workNode->nextNode;
-
-			if (workNode != NULL)
-				oldDataCount = workNode->dataCount;
-		}
-	}
-
-	// Move the items in the last node
-	if (pos != 0)
-	{
-		if (pos <= workNode->dataCount)
-		{
-			for (i = max(pos - count, 0); pos < oldDataCount; i++, pos++)
-				workNode->data[i] = workNode->data[pos];
-		}
-		else
-		{
-			for (i = pos - workNode->dataCount; pos < oldDataCount; i++, pos++)
-				workNode->data[i] = workNode->data[pos];
-		}
-	}
+	// Do not remove more items than there are
+	if (count > (itemCount - index))
+		count = itemCount - index;
 
-	// Remove empty nodes
-	prevNode = NULL;
-	workNode = firstNode;
+	// Move the rest of the items back
+	for (i = index + count; i < itemCount; i++)
+		items[i - count] = items[i];
 
-	while (workNode != NULL)
-	{
-		if (workNode->dataCount == 0)
-		{
-			// Found a node that is empty, so deallocate the memory
-			PNode *removeNode;
-
-			if (prevNode == NULL)
-				firstNode = workNode->nextNode;
-			else
-				prevNode->nextNode = workNode->nextNode;
-
-			removeNode = workNode;
-			workNode   = workNode->nextNode;
-
-			delete[] removeNode->data;
-			delete removeNode;
-
-			if (workNode == NULL)
-				lastNode = prevNode;
-		}
-		else
-		{
-			prevNode = workNode;
-			workNode = workNode->nextNode;
-		}
-	}
-
-	// Compact the list
-	workNode = firstNode;
-
-	while (workNode != NULL)
-	{
-		if ((workNode->dataCount < (addSize / 2)) && (workNode->nextNode != NULL))
-		{
-			int32 toCopy = min(addSize - workNode->dataCount, workNode->nextNode->dataCount);
-			int32 j;
-
-			for (i = workNode->dataCount, j = 0; j < toCopy; i++, j++)
-			{
-				workNode->data[i] = workNode->nextNode->data[j];
-				workNode->dataCount++;
-				workNode->nextNode->dataCount--;
-			}
-
-			// Move the rest of the item back
-			for (i = 0; i < workNode->nextNode->dataCount; i++)
-				workNode->nextNode->data[i] = workNode->nextNode->data[i + toCopy];
-
-			// Have we removed all the items so we can delete the node?
-			if (workNode->nextNode->dataCount == 0)
-			{
-				// Yes, so we remove it
-				PNode *removeNode;
-
-				removeNode = workNode->nextNode;
-
-				workNode->nextNode = workNode->nextNode->nextNode;
-				delete[] removeNode->data;
-				delete removeNode;
-
-				if (workNode->nextNode == NULL)
-					lastNode = workNode;
-			}
-		}
-		else
-			workNode = workNode->nextNode;
-	}
+	// Clear the items left behind, so they don't hold on to any resources
+	for (i = itemCount - count; i < itemCount; i++)
+		items[i] = TYPE();
 
-	// Reset the get state variable
-	optimize->lastUsedNode = NULL;
+	itemCount -= count;
 
 	return (firstItem);
 }
@@ -20,8 +20,10 @@
 // Set the operation system to compile under to one of these values:
 //
 // __p_beos     - BeOS
+// __p_linux    - Linux
 ////////////////////////////////////////////////////////////////////////////////
 #define __p_beos			1
+#define __p_linux			2
 
 // Define __p_os according to the native operative system
 //
@@ -34,11 +36,21 @@
 #define __p_os				__p_beos
 #endif
 
+// Linux
+#if defined(__linux__) && !defined(__p_os)
+#define __p_os				__p_linux
+#endif
+
 // BeOS headers
 #if __p_os == __p_beos
 #include "BeOS/BeOS.h"
 #endif
 
+// Linux headers
+#if __p_os == __p_linux
+#include "Linux/Linux.h"
+#endif
+
 // Debug headers
 #include "PDebug.h"
 
@@ -63,6 +75,16 @@
 
 #endif
 
+#if __p_os == __p_linux
+
+#if __BYTE_ORDER == __BIG_ENDIAN
+#define __p_endian			__p_big
+#else
+#define __p_endian			__p_little
+#endif
+
+#endif
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -73,20 +95,20 @@
 ////////////////////////////////////////////////////////////////////////////////
 #if __p_os != __p_beos
 
-typedef signed char						int8;
-typedef unsigned char					uint8;
-typedef volatile signed char			vint8;
-typedef volatile unsigned char			vuint8;
+typedef int8_t							int8;
+typedef uint8_t							uint8;
+typedef volatile int8_t					vint8;
+typedef volatile uint8_t				vuint8;
 
-typedef short							int16;
-typedef unsigned short					uint16;
-typedef volatile short					vint16;
-typedef volatile unsigned short			vuint16;
+typedef int16_t							int16;
+typedef uint16_t						uint16;
+typedef volatile int16_t				vint16;
+typedef volatile uint16_t				vuint16;
 
-typedef long							int32;
-typedef unsigned long					uint32;
-typedef volatile long					vint32;
-typedef volatile unsigned long			vuint32;
+typedef int32_t							int32;
+typedef uint32_t						uint32;
+typedef volatile int32_t				vint32;
+typedef volatile uint32_t				vuint32;
 
 typedef int64_t							int64;
 typedef uint64_t						uint64;
@@ -122,6 +144,38 @@ typedef unsigned short					unichar;
 
 #endif
 
+#if __p_os == __p_linux
+
+#if __cplusplus >= 201103L
+
+// Functions and not macros, so the standard headers using the
+// names still compile. The result has the same type as with
+// the conditional operator, but is always a value and never a
+// reference to one of the arguments
+template<class TYPE1, class TYPE2>
+inline auto min(TYPE1 x, TYPE2 y) -> decltype(true ? TYPE1() : TYPE2())
+{
+	return (x < y ? x : y);
+}
+
+template<class TYPE1, class TYPE2>
+inline auto max(TYPE1 x, TYPE2 y) -> decltype(true ? TYPE1() : TYPE2())
+{
+	return (x > y ? x : y);
+}
+
+#else
+
+// Older compilers can not find the result type, so they get the macros
+#undef min
+#undef max
+#define min(x, y)						((x) < (y) ? (x) : (y))
+#define max(x, y)						((x) > (y) ? (x) : (y))
+
+#endif
+
+#endif
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,15 +186,43 @@ typedef unsigned short					unichar;
 // Well, under BeOS, we just use Be's own macros
 #define P_HOST_TO_LENDIAN_INT16(arg)	B_HOST_TO_LENDIAN_INT16(arg)
 #define P_HOST_TO_LENDIAN_INT32(arg)	B_HOST_TO_LENDIAN_INT32(arg)
+#define P_HOST_TO_LENDIAN_INT64(arg)	B_HOST_TO_LENDIAN_INT64(arg)
 
 #define P_HOST_TO_BENDIAN_INT16(arg)	B_HOST_TO_BENDIAN_INT16(arg)
 #define P_HOST_TO_BENDIAN_INT32(arg)	B_HOST_TO_BENDIAN_INT32(arg)
+#define P_HOST_TO_BENDIAN_INT64(arg)	B_HOST_TO_BENDIAN_INT64(arg)
 
 #define P_LENDIAN_TO_HOST_INT16(arg)	B_LENDIAN_TO_HOST_INT16(arg)
 #define P_LENDIAN_TO_HOST_INT32(arg)	B_LENDIAN_TO_HOST_INT32(arg)
+#define P_LENDIAN_TO_HOST_INT64(arg)	B_LENDIAN_TO_HOST_INT64(arg)
 
 #define P_BENDIAN_TO_HOST_INT16(arg)	B_BENDIAN_TO_HOST_INT16(arg)
 #define P_BENDIAN_TO_HOST_INT32(arg)	B_BENDIAN_TO_HOST_INT32(arg)
+#define P_BENDIAN_TO_HOST_INT64(arg)	B_BENDIAN_TO_HOST_INT64(arg)
+
+#define P_HOST_IS_BENDIAN				B_HOST_IS_BENDIAN
+
+#endif
+
+#if __p_os == __p_linux
+
+#define P_HOST_TO_LENDIAN_INT16(arg)	htole16(arg)
+#define P_HOST_TO_LENDIAN_INT32(arg)	htole32(arg)
+#define P_HOST_TO_LENDIAN_INT64(arg)	htole64(arg)
+
+#define P_HOST_TO_BENDIAN_INT16(arg)	htobe16(arg)
+#define P_HOST_TO_BENDIAN_INT32(arg)	htobe32(arg)
+#define P_HOST_TO_BENDIAN_INT64(arg)	htobe64(arg)
+
+#define P_LENDIAN_TO_HOST_INT16(arg)	le16toh(arg)
+#define P_LENDIAN_TO_HOST_INT32(arg)	le32toh(arg)
+#define P_LENDIAN_TO_HOST_INT64(arg)	le64toh(arg)
+
+#define P_BENDIAN_TO_HOST_INT16(arg)	be16toh(arg)
+#define P_BENDIAN_TO_HOST_INT32(arg)	be32toh(arg)
+#define P_BENDIAN_TO_HOST_INT64(arg)	be64toh(arg)
+
+#define P_HOST_IS_BENDIAN				(__BYTE_ORDER == __BIG_ENDIAN)
 
 #endif
 
@@ -149,7 +231,7 @@ typedef unsigned short					unichar;
 ////////////////////////////////////////////////////////////////////////////////
 // Directory slashes
 ////////////////////////////////////////////////////////////////////////////////
-#if __p_os == __p_beos
+#if (__p_os == __p_beos) || (__p_os == __p_linux)
 
 #define P_DIRSLASH_STR	"/"
 #define P_DIRSLASH_CHR	'/'
@@ -161,7 +243,7 @@ typedef unsigned short					unichar;
 ////////////////////////////////////////////////////////////////////////////////
 // New line strings
 ////////////////////////////////////////////////////////////////////////////////
-#if __p_os == __p_beos
+#if (__p_os == __p_beos) || (__p_os == __p_linux)
 #define P_NEWLINE_STR	"\n"
 #endif
 
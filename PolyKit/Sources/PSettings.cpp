@@ -22,6 +22,13 @@
 #include "PSettings.h"
 
 
+/******************************************************************************/
+/* Index constants                                                            */
+/******************************************************************************/
+#define PSETTINGS_HASH_START		64		// Initial number of hash buckets
+
+
+
 /******************************************************************************/
 /* PSettings class                                                            */
 /******************************************************************************/
@@ -34,12 +41,32 @@
 PSettings::PSettings(void)
 {
 	// Initialize member variables
-	changed = false;
+	changed   = false;
+	hashSize  = PSETTINGS_HASH_START;
+	hashCount = 0;
 
-	// Allocate syncronize object
+	// Allocate syncronize objects
 	listLock = new PMRSWLock();
 	if (listLock == NULL)
 		throw PMemoryException();
+
+	notifyEvent = new PEvent(true, false);
+	if (notifyEvent == NULL)
+	{
+		delete listLock;
+		throw PMemoryException();
+	}
+
+	// Allocate the index
+	hashTable = new PIndexEntry *[hashSize];
+	if (hashTable == NULL)
+	{
+		delete notifyEvent;
+		delete listLock;
+		throw PMemoryException();
+	}
+
+	memset(hashTable, 0, hashSize * sizeof(PIndexEntry *));
 }
 
 
@@ -49,11 +76,17 @@ PSettings::PSettings(void)
 /******************************************************************************/
 PSettings::~PSettings(void)
 {
-	// Destroy the file lock
+	// Destroy the synchronize objects
+	delete notifyEvent;
 	delete listLock;
 
-	// Empty the list of lines
+	// Empty the list of lines and the index
 	lines.MakeEmpty();
+	FlushIndex();
+	delete[] hashTable;
+
+	// Remove all listeners
+	listeners.MakeEmpty();
 }
 
 
@@ -99,11 +132,10 @@ void PSettings::LoadFile(PString fileName, PString company, PString product)
 			file.Open(fileName, PFile::pModeRead | PFile::pModeShareRead);
 
 			// Read one line at the time into the memory
-			while (!file.IsEOF())
-			{
-				// Read the line
-				line.line = file.ReadLine();
+			PLineReader reader(&file);
 
+			while (reader.ReadLine(line.line))
+			{
 				// Skip empty lines
 				if (line.line.IsEmpty())
 					continue;
@@ -141,6 +173,9 @@ void PSettings::LoadFile(PString fileName, PString company, PString product)
 			// Close the file
 			file.Close();
 		}
+
+		// Index the new lines
+		BuildIndex();
 	}
 	catch(...)
 	{
@@ -151,6 +186,9 @@ void PSettings::LoadFile(PString fileName, PString company, PString product)
 
 	// Unlock again
 	listLock->DoneWriting();
+
+	// Tell everybody that all the settings may have changed
+	NotifyListeners("", "");
 }
 
 
@@ -265,9 +303,24 @@ void PSettings::CloneSettings(const PSettings *source)
 	// The settings has been changed
 	changed = true;
 
-	// Unlock the settings again
+	// Unlock the source settings again
 	source->listLock->DoneReading();
+
+	// Index the new lines
+	try
+	{
+		BuildIndex();
+	}
+	catch(...)
+	{
+		listLock->DoneWriting();
+		throw;
+	}
+
 	listLock->DoneWriting();
+
+	// Tell everybody that all the settings may have changed
+	NotifyListeners("", "");
 }
 
 
@@ -320,28 +373,16 @@ bool PSettings::HasChanged(void) const
 /******************************************************************************/
 PString PSettings::GetStringEntryValue(PString section, PString entry, PString defaultValue) const
 {
-	PFileLine line;
+	const PIndexEntry *indexEntry;
 	PString value(defaultValue);
-	int32 index, insertPos;
-	int32 valPos;
 
 	// Start to lock the list
 	listLock->WaitToRead();
 
-	// Now find the section
-	index = FindSection(section);
-	if (index != -1)
-	{
-		// Found it, now find the entry
-		index = FindEntry(index + 1, entry, insertPos);
-		if (index != -1)
-		{
-			// Got it, now extract the value
-			line   = lines.GetItem(index);
-			valPos = line.line.Find('=');
-			value  = line.line.Mid(valPos + 1);
-		}
-	}
+	// Look up the entry in the index
+	indexEntry = FindIndex(section, entry, false);
+	if (indexEntry != NULL)
+		value = indexEntry->value;
 
 	// Unlock again
 	listLock->DoneReading();
@@ -411,14 +452,22 @@ PString PSettings::GetStringEntryValue(PString section, int32 entryNum, PString
 /******************************************************************************/
 int32 PSettings::GetIntEntryValue(PString section, PString entry, int32 defaultValue) const
 {
-	PString value;
+	const PIndexEntry *indexEntry;
+	int32 value = defaultValue;
 
-	// Use the string read function
-	value = GetStringEntryValue(section, entry);
-	if (value.IsEmpty())
-		return (defaultValue);
+	// Start to lock the list
+	listLock->WaitToRead();
 
-	return (value.GetNumber());
+	// Look up the entry in the index. The number is converted
+	// when the entry is indexed, so just return it
+	indexEntry = FindIndex(section, entry, false);
+	if ((indexEntry != NULL) && (!indexEntry->value.IsEmpty()))
+		value = indexEntry->intValue;
+
+	// Unlock again
+	listLock->DoneReading();
+
+	return (value);
 }
 
 
@@ -461,7 +510,9 @@ int32 PSettings::GetIntEntryValue(PString section, int32 entryNum, PString &entr
 void PSettings::WriteStringEntryValue(PString section, PString entry, PString value)
 {
 	PFileLine line;
+	PIndexEntry *indexEntry;
 	int32 index, insertPos;
+	bool notify = true;
 
 	// Start to lock the list
 	listLock->WaitToWrite();
@@ -499,13 +550,33 @@ void PSettings::WriteStringEntryValue(PString section, PString entry, PString va
 		line.line.Format_S2("%s=%s", entry, value);
 		line.type = pEntry;
 		lines.AddTail(line);
+
+		// Add the section to the index
+		AddIndex(section, "", true);
 	}
 
+	// Update the index
+	indexEntry = FindIndex(section, entry, false);
+	if (indexEntry == NULL)
+		indexEntry = AddIndex(section, entry, false);
+	else
+	{
+		// Only tell the listeners if the value is changed
+		if (indexEntry->value == value)
+			notify = false;
+	}
+
+	SetIndexValue(indexEntry, value);
+
 	// Settings has been changed
 	changed = true;
 
 	// Unlock again
 	listLock->DoneWriting();
+
+	// Tell the listeners about the change
+	if (notify)
+		NotifyListeners(section, entry);
 }
 
 
@@ -541,21 +612,13 @@ void PSettings::WriteIntEntryValue(PString section, PString entry, int32 value)
 /******************************************************************************/
 bool PSettings::EntryExist(PString section, PString entry) const
 {
-	int32 index, insertPos;
-	bool result = false;
+	bool result;
 
 	// Start to lock the list
 	listLock->WaitToRead();
 
-	// Start to find the section
-	index = FindSection(section);
-	if (index != -1)
-	{
-		// Found the section, now find the entry
-		index = FindEntry(index + 1, entry, insertPos);
-		if (index != -1)
-			result = true;
-	}
+	// Look up the entry in the index
+	result = (FindIndex(section, entry, false) != NULL);
 
 	// Unlock again
 	listLock->DoneReading();
@@ -604,12 +667,29 @@ bool PSettings::RemoveEntry(PString section, PString entry)
 
 			// Settings has been changed
 			changed = true;
+
+			// Index the lines again. An entry with the same name
+			// further down in the file or a removed section may
+			// change what is visible
+			try
+			{
+				BuildIndex();
+			}
+			catch(...)
+			{
+				listLock->DoneWriting();
+				throw;
+			}
 		}
 	}
 
 	// Unlock again
 	listLock->DoneWriting();
 
+	// Tell the listeners about the change
+	if (result)
+		NotifyListeners(section, entry);
+
 	return (result);
 }
 
@@ -656,12 +736,32 @@ bool PSettings::RenameEntry(PString section, PString entry, PString newEntry)
 
 			// Settings has been changed
 			changed = true;
+
+			// Index the lines again. An entry with the same name
+			// further down in the file or a removed section may
+			// change what is visible
+			try
+			{
+				BuildIndex();
+			}
+			catch(...)
+			{
+				listLock->DoneWriting();
+				throw;
+			}
 		}
 	}
 
 	// Unlock again
 	listLock->DoneWriting();
 
+	// Tell the listeners about the change
+	if (result)
+	{
+		NotifyListeners(section, entry);
+		NotifyListeners(section, newEntry);
+	}
+
 	return (result);
 }
 
@@ -822,3 +922,389 @@ int32 PSettings::FindEntryByNumber(int32 startIndex, int32 entryNum, int32 &inse
 	insertPos = startIndex + i;
 	return (insertPos);
 }
+
+
+
+/******************************************************************************/
+/* AddChangeListener() registers a function that is called every time the     */
+/*      settings are changed. The function is called in the thread that made  */
+/*      the change, after the settings are unlocked again.                    */
+/*                                                                            */
+/* Input:  "func" is the function to call.                                    */
+/*         "userData" is given to the function as it is.                      */
+/******************************************************************************/
+void PSettings::AddChangeListener(PSettingsChangeFunc func, void *userData)
+{
+	PListener listener;
+
+	listener.func     = func;
+	listener.userData = userData;
+
+	listLock->WaitToWrite();
+
+	try
+	{
+		listeners.AddTail(listener);
+	}
+	catch(...)
+	{
+		listLock->DoneWriting();
+		throw;
+	}
+
+	listLock->DoneWriting();
+}
+
+
+
+/******************************************************************************/
+/* RemoveChangeListener() removes a function added with AddChangeListener().  */
+/*      It waits until other threads calling the listeners are done, so the   */
+/*      function is never called after this returns and the user data can be  */
+/*      freed. Calls made by the current thread are not waited for, so a      */
+/*      listener can remove itself.                                           */
+/*                                                                            */
+/* Input:  "func" is the function to remove.                                  */
+/*         "userData" is the same pointer as given when it was added.         */
+/******************************************************************************/
+void PSettings::RemoveChangeListener(PSettingsChangeFunc func, void *userData)
+{
+	PListener listener;
+	int32 thread, i, count;
+	bool wait;
+
+	thread = find_thread(NULL);
+
+	listLock->WaitToWrite();
+
+	count = listeners.CountItems();
+	for (i = 0; i < count; i++)
+	{
+		listener = listeners.GetItem(i);
+		if ((listener.func == func) && (listener.userData == userData))
+		{
+			listeners.RemoveItem(i);
+			break;
+		}
+	}
+
+	for (;;)
+	{
+		// Does other threads call the listeners?
+		wait  = false;
+		count = notifyThreads.CountItems();
+		for (i = 0; i < count; i++)
+		{
+			if (notifyThreads.GetItem(i) != thread)
+			{
+				wait = true;
+				break;
+			}
+		}
+
+		if (!wait)
+			break;
+
+		// Wait for one of them to finish and check again
+		notifyEvent->ResetEvent();
+		listLock->DoneWriting();
+
+		notifyEvent->Lock();
+
+		listLock->WaitToWrite();
+	}
+
+	listLock->DoneWriting();
+}
+
+
+
+/******************************************************************************/
+/* NotifyListeners() calls all the registered change functions. The list is   */
+/*      copied first, so the functions can read the settings or remove        */
+/*      themselves. The thread is remembered while the functions are called,  */
+/*      so RemoveChangeListener() can wait for it.                            */
+/*                                                                            */
+/* Input:  "section" is the section name that has been changed.               */
+/*         "entry" is the entry name that has been changed.                   */
+/******************************************************************************/
+void PSettings::NotifyListeners(PString section, PString entry)
+{
+	PList<PListener> callList;
+	PListener listener;
+	int32 thread, i, count;
+
+	thread = find_thread(NULL);
+
+	// Take a copy of the listeners
+	listLock->WaitToWrite();
+
+	if (listeners.IsEmpty())
+	{
+		listLock->DoneWriting();
+		return;
+	}
+
+	try
+	{
+		callList = listeners;
+		notifyThreads.AddTail(thread);
+	}
+	catch(...)
+	{
+		listLock->DoneWriting();
+		throw;
+	}
+
+	listLock->DoneWriting();
+
+	// Now call them
+	try
+	{
+		count = callList.CountItems();
+		for (i = 0; i < count; i++)
+		{
+			listener = callList.GetItem(i);
+			listener.func(this, section, entry, listener.userData);
+		}
+	}
+	catch(...)
+	{
+		DoneNotifying(thread);
+		throw;
+	}
+
+	DoneNotifying(thread);
+}
+
+
+
+/******************************************************************************/
+/* DoneNotifying() removes the thread from the list of threads calling the    */
+/*      listeners and wakes up RemoveChangeListener() calls waiting for it.   */
+/*                                                                            */
+/* Input:  "thread" is the thread id given to the list in NotifyListeners().  */
+/******************************************************************************/
+void PSettings::DoneNotifying(int32 thread)
+{
+	listLock->WaitToWrite();
+
+	notifyThreads.RemoveItem(notifyThreads.GetItemIndex(thread));
+	notifyEvent->SetEvent();
+
+	listLock->DoneWriting();
+}
+
+
+
+/******************************************************************************/
+/* BuildIndex() will build the section and entry index from the lines. Only   */
+/*      the first section with a given name and the first entry with a given  */
+/*      name in it are indexed, the same ones FindSection() and FindEntry()   */
+/*      will find. The list must be locked for writing.                       */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+void PSettings::BuildIndex(void)
+{
+	PFileLine line;
+	PIndexEntry *indexEntry;
+	PString section, entry;
+	int32 i, count;
+	int32 valPos;
+	bool inSection = false;
+
+	// Start to remove the old index
+	FlushIndex();
+
+	count = lines.CountItems();
+	for (i = 0; i < count; i++)
+	{
+		line = lines.GetItem(i);
+
+		if (line.type == pSection)
+		{
+			// Only the first section with the same name is used
+			section   = line.line;
+			inSection = (FindIndex(section, "", true) == NULL);
+
+			if (inSection)
+				AddIndex(section, "", true);
+
+			continue;
+		}
+
+		if ((line.type == pEntry) && inSection)
+		{
+			valPos = line.line.Find('=');
+			entry  = line.line.Left(valPos);
+
+			if (FindIndex(section, entry, false) == NULL)
+			{
+				indexEntry = AddIndex(section, entry, false);
+				SetIndexValue(indexEntry, line.line.Mid(valPos + 1));
+			}
+		}
+	}
+}
+
+
+
+/******************************************************************************/
+/* FlushIndex() will remove all the entries in the index.                     */
+/******************************************************************************/
+void PSettings::FlushIndex(void)
+{
+	PIndexEntry *indexEntry, *nextEntry;
+	int32 i;
+
+	for (i = 0; i < hashSize; i++)
+	{
+		indexEntry = hashTable[i];
+		while (indexEntry != NULL)
+		{
+			nextEntry = indexEntry->next;
+			delete indexEntry;
+			indexEntry = nextEntry;
+		}
+
+		hashTable[i] = NULL;
+	}
+
+	hashCount = 0;
+}
+
+
+
+/******************************************************************************/
+/* FindIndex() will look up a section or entry in the index.                  */
+/*                                                                            */
+/* Input:  "section" is the section name.                                     */
+/*         "entry" is the entry name.                                         */
+/*         "isSection" is true to find the section itself.                    */
+/*                                                                            */
+/* Output: A pointer to the index entry or NULL if not found.                 */
+/******************************************************************************/
+PSettings::PIndexEntry *PSettings::FindIndex(const PString &section, const PString &entry, bool isSection) const
+{
+	PIndexEntry *indexEntry;
+	uint32 hash;
+
+	hash       = HashNames(section, entry, isSection);
+	indexEntry = hashTable[hash & (hashSize - 1)];
+
+	while (indexEntry != NULL)
+	{
+		if ((indexEntry->hash == hash) && (indexEntry->section == isSection) &&
+			(indexEntry->entryName == entry) && (indexEntry->sectionName == section))
+		{
+			return (indexEntry);
+		}
+
+		indexEntry = indexEntry->next;
+	}
+
+	return (NULL);
+}
+
+
+
+/******************************************************************************/
+/* AddIndex() will add a new section or entry to the index. The caller must   */
+/*      make sure it is not already there.                                    */
+/*                                                                            */
+/* Input:  "section" is the section name.                                     */
+/*         "entry" is the entry name.                                         */
+/*         "isSection" is true if it is the section itself.                   */
+/*                                                                            */
+/* Output: A pointer to the new index entry.                                  */
+/*                                                                            */
+/* Except: PMemoryException.                                                  */
+/******************************************************************************/
+PSettings::PIndexEntry *PSettings::AddIndex(const PString &section, const PString &entry, bool isSection)
+{
+	PIndexEntry *indexEntry, *nextEntry;
+	PIndexEntry **newTable;
+	int32 i, newSize;
+
+	// Make the table bigger if it begins to fill up
+	if (hashCount >= hashSize)
+	{
+		newSize  = hashSize * 2;
+		newTable = new PIndexEntry *[newSize];
+		if (newTable == NULL)
+			throw PMemoryException();
+
+		memset(newTable, 0, newSize * sizeof(PIndexEntry *));
+
+		for (i = 0; i < hashSize; i++)
+		{
+			indexEntry = hashTable[i];
+			while (indexEntry != NULL)
+			{
+				nextEntry = indexEntry->next;
+				indexEntry->next = newTable[indexEntry->hash & (newSize - 1)];
+				newTable[indexEntry->hash & (newSize - 1)] = indexEntry;
+				indexEntry = nextEntry;
+			}
+		}
+
+		delete[] hashTable;
+		hashTable = newTable;
+		hashSize  = newSize;
+	}
+
+	// Create the new entry
+	indexEntry = new PIndexEntry;
+	if (indexEntry == NULL)
+		throw PMemoryException();
+
+	indexEntry->hash        = HashNames(section, entry, isSection);
+	indexEntry->section     = isSection;
+	indexEntry->sectionName = section;
+	indexEntry->entryName   = entry;
+	indexEntry->intValue    = 0;
+
+	// Link it into the table
+	indexEntry->next = hashTable[indexEntry->hash & (hashSize - 1)];
+	hashTable[indexEntry->hash & (hashSize - 1)] = indexEntry;
+	hashCount++;
+
+	return (indexEntry);
+}
+
+
+
+/******************************************************************************/
+/* SetIndexValue() will store a new value in an index entry.                  */
+/*                                                                            */
+/* Input:  "indexEntry" is a pointer to the index entry.                      */
+/*         "value" is the entry value.                                        */
+/******************************************************************************/
+void PSettings::SetIndexValue(PIndexEntry *indexEntry, const PString &value)
+{
+	indexEntry->value    = value;
+	indexEntry->intValue = value.IsEmpty() ? 0 : value.GetNumber();
+}
+
+
+
+/******************************************************************************/
+/* HashNames() calculates the index hash value for a section or entry.        */
+/*                                                                            */
+/* Input:  "section" is the section name.                                     */
+/*         "entry" is the entry name.                                         */
+/*         "isSection" is true if it is the section itself.                   */
+/*                                                                            */
+/* Output: The hash value.                                                    */
+/******************************************************************************/
+uint32 PSettings::HashNames(const PString &section, const PString &entry, bool isSection)
+{
+	uint32 hash;
+
+	hash = section.GetHashCode() * 31 + entry.GetHashCode();
+	if (isSection)
+		hash = ~hash;
+
+	return (hash);
+}
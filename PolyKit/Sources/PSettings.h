@@ -20,6 +20,18 @@
 #include "ImportExport.h"
 
 
+/******************************************************************************/
+/* Change callback                                                            */
+/*                                                                            */
+/* Called after an entry has been written, removed or renamed. When a whole   */
+/* file is loaded or cloned, "section" and "entry" are both empty.            */
+/******************************************************************************/
+class PSettings;
+
+typedef void (*PSettingsChangeFunc)(PSettings *settings, PString section, PString entry, void *userData);
+
+
+
 /******************************************************************************/
 /* PSettings class                                                            */
 /******************************************************************************/
@@ -53,6 +65,9 @@ public:
 	bool RemoveEntry(PString section, PString entry);
 	bool RenameEntry(PString section, PString entry, PString newEntry);
 
+	void AddChangeListener(PSettingsChangeFunc func, void *userData);
+	void RemoveChangeListener(PSettingsChangeFunc func, void *userData);
+
 protected:
 	enum PFileLineType { pComment, pSection, pEntry };
 
@@ -62,13 +77,48 @@ protected:
 		PString line;
 	} PFileLine;
 
+	typedef struct PIndexEntry
+	{
+		PIndexEntry *next;			// Next entry in the same hash bucket
+		uint32 hash;				// Hash of the section and entry names
+		bool section;				// True if this is a section name
+		PString sectionName;
+		PString entryName;
+		PString value;				// The entry value
+		int32 intValue;				// The value converted to a number
+	} PIndexEntry;
+
+	typedef struct PListener
+	{
+		PSettingsChangeFunc func;
+		void *userData;
+	} PListener;
+
 	int32 FindSection(PString section) const;
 	int32 FindEntry(int32 startIndex, PString entry, int32 &insertPos) const;
 	int32 FindEntryByNumber(int32 startIndex, int32 entryNum, int32 &insertPos) const;
 
+	void BuildIndex(void);
+	void FlushIndex(void);
+	PIndexEntry *FindIndex(const PString &section, const PString &entry, bool isSection) const;
+	PIndexEntry *AddIndex(const PString &section, const PString &entry, bool isSection);
+	void SetIndexValue(PIndexEntry *indexEntry, const PString &value);
+	static uint32 HashNames(const PString &section, const PString &entry, bool isSection);
+
+	void NotifyListeners(PString section, PString entry);
+	void DoneNotifying(int32 thread);
+
 	PMRSWLock *listLock;
 	PList<PFileLine> lines;
 	bool changed;
+
+	PIndexEntry **hashTable;		// Section and entry index
+	int32 hashSize;					// Number of hash buckets
+	int32 hashCount;				// Number of entries in the index
+
+	PList<PListener> listeners;
+	PList<int32> notifyThreads;		// The threads calling the listeners right now
+	PEvent *notifyEvent;			// Set each time a thread is done calling the listeners
 };
 
 #if __p_os == __p_beos && __POWERPC__
@@ -1163,6 +1163,117 @@ PCharacterSet *PCharSet_MS_WIN_1258::CreateObject(void) const
 
 
 
+/******************************************************************************/
+/* PCharSet_ISO_8859_1 class                                                  */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Default constructor                                                        */
+/******************************************************************************/
+PCharSet_ISO_8859_1::PCharSet_ISO_8859_1(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PCharSet_ISO_8859_1::~PCharSet_ISO_8859_1(void)
+{
+}
+
+
+
+/******************************************************************************/
+/* ToUnicode() convert a character to unicode.                                */
+/*                                                                            */
+/* Input:  "chr" is a pointer to the character.                               */
+/*         "len" is a reference where the source character length is stored.  */
+/*                                                                            */
+/* Output: The unicode character.                                             */
+/******************************************************************************/
+uint16 PCharSet_ISO_8859_1::ToUnicode(const char *chr, int8 &len)
+{
+	// Store the length
+	len = 1;
+
+	// The first 256 unicode characters are the same as ISO-8859-1
+	return ((uint8)*chr);
+}
+
+
+
+/******************************************************************************/
+/* FromUnicode() convert an unicode character to a character.                 */
+/*                                                                            */
+/* Input:  "chr" is the unicode character.                                    */
+/*         "len" is where the converted character length should be stored.    */
+/*                                                                            */
+/* Output: The character in ISO-8859-1 character set.                         */
+/******************************************************************************/
+const char *PCharSet_ISO_8859_1::FromUnicode(uint16 chr, int8 &len)
+{
+	// Convert the character
+	if (chr > 0x00ff)
+		charBuf = 0x3f;		// Return '?' as an unknown character
+	else
+		charBuf = (char)chr;
+
+	// Store the length
+	len = 1;
+
+	return (&charBuf);
+}
+
+
+
+/******************************************************************************/
+/* GetCharLength() calculate the length of the character given and return it. */
+/*                                                                            */
+/* Input:  "chr" is the character in the current character set.               */
+/*                                                                            */
+/* Output: The length of the character.                                       */
+/******************************************************************************/
+int8 PCharSet_ISO_8859_1::GetCharLength(const char *chr)
+{
+	return (1);
+}
+
+
+
+/******************************************************************************/
+/* IsValid() will check to see if the character given is valid.               */
+/*                                                                            */
+/* Input:  "chr" is the character in the current character set.               */
+/*         "len" is the maximum length of the character.                      */
+/*                                                                            */
+/* Output: True if the character is valid, false if not.                      */
+/******************************************************************************/
+bool PCharSet_ISO_8859_1::IsValid(const char *chr, int8 len)
+{
+	if (len < 1)
+		return (false);
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* CreateObject() create a new ISO-8859-1 character set object.               */
+/*                                                                            */
+/* Output: A pointer to the new object. When done, use delete on the pointer. */
+/******************************************************************************/
+PCharacterSet *PCharSet_ISO_8859_1::CreateObject(void) const
+{
+	return (new PCharSet_ISO_8859_1());
+}
+
+
+
+
+
 /******************************************************************************/
 /* PCharSet_UNICODE class                                                     */
 /******************************************************************************/
@@ -2823,25 +2934,90 @@ uint16 PChar::ChangeCase(uint16 uniChar)
 /******************************************************************************/
 
 /******************************************************************************/
-/* String structure                                                           */
+/* Empty string                                                               */
 /******************************************************************************/
-typedef struct PString::PStringData
+PString::PStringData PString::emptyString =
 {
-	int32	refCount;		// Number of objects that points to this string
-	int32	stringLen;		// Length of the string in characters
-	int32	allocatedLen;	// Number of characters allocated
-	uint16 *string;			// Pointer to the string which is always stored in unicode
-} PStringData;
+	-1, 0, 0, NULL, NULL, 0
+};
 
 
 
 /******************************************************************************/
-/* Empty string                                                               */
+/* HostToUnicode() converts a single character in the host character set      */
+/*      (UTF-8) to unicode. It is the same conversion as PCharSet_UTF8 does,  */
+/*      but without the virtual calls and exceptions, because most strings    */
+/*      are converted from and to the host character set.                     */
+/*                                                                            */
+/* Input:  "chr" is a pointer to the character.                               */
+/*         "len" is a reference where the character length is stored.         */
+/*                                                                            */
+/* Output: The unicode character. Invalid characters are returned as '?'.     */
 /******************************************************************************/
-static PStringData pEmptyString =
+static inline uint16 HostToUnicode(const char *chr, int8 &len)
 {
-	-1, 0, 0, NULL
-};
+	const uint8 *uchr = (const uint8 *)chr;
+
+	// 0x0000 - 0x007f
+	if (uchr[0] < 0x80)
+	{
+		len = 1;
+		return (uchr[0]);
+	}
+
+	// 0x0080 - 0x07ff
+	if (((uchr[0] & 0xe0) == 0xc0) && (uchr[1] != 0x00))
+	{
+		len = 2;
+		return ((((uint16)(uchr[0] & 0x1f)) << 6) | ((uint16)(uchr[1] & 0x3f)));
+	}
+
+	// 0x0800 - 0xffff
+	if (((uchr[0] & 0xf0) == 0xe0) && (uchr[1] != 0x00) && (uchr[2] != 0x00))
+	{
+		len = 3;
+		return ((((uint16)(uchr[0] & 0x0f)) << 12) | (((uint16)(uchr[1] & 0x3f)) << 6) | ((uint16)(uchr[2] & 0x3f)));
+	}
+
+	// Unknown - Return the '?' character
+	len = 1;
+	return (0x003f);
+}
+
+
+
+/******************************************************************************/
+/* HostFromUnicode() converts an unicode character to the host character set  */
+/*      (UTF-8).                                                              */
+/*                                                                            */
+/* Input:  "chr" is the unicode character.                                    */
+/*         "buffer" is a pointer to where to store the converted character.   */
+/*                                                                            */
+/* Output: The number of bytes stored.                                        */
+/******************************************************************************/
+static inline int8 HostFromUnicode(uint16 chr, char *buffer)
+{
+	// 0x0000 - 0x007f
+	if (chr < 0x0080)
+	{
+		buffer[0] = (char)chr;
+		return (1);
+	}
+
+	// 0x0080 - 0x07ff
+	if (chr < 0x0800)
+	{
+		buffer[0] = 0xc0 | ((chr & 0x07c0) >> 6);
+		buffer[1] = 0x80 | (chr & 0x003f);
+		return (2);
+	}
+
+	// 0x0800 - 0xffff
+	buffer[0] = 0xe0 | ((chr & 0xf000) >> 12);
+	buffer[1] = 0x80 | ((chr & 0x0fc0) >> 6);
+	buffer[2] = 0x80 | (chr & 0x003f);
+	return (3);
+}
 
 
 
@@ -2872,6 +3048,12 @@ PString::PString(const PString &string)
 
 	if (string.IsEmpty())
 		CreateEmptyString();
+	else if (string.stringData == &string.inlineData)
+	{
+		// Short strings are never shared, so copy the characters
+		AllocBuffer(string.stringData->stringLen);
+		memcpy(stringData->string, string.stringData->string, (string.stringData->stringLen + 1) * sizeof(uint16));
+	}
 	else
 	{
 		// The reference counter should at least have one reference
@@ -3062,42 +3244,80 @@ void PString::FreeBuffer(char *buffer) const
 
 
 /******************************************************************************/
-/* SetString() will store the string given into the current object.           */
+/* GetCString() returns the string in the host character set without making   */
+/*      a copy. The conversion is done the first time the string is asked     */
+/*      for and is kept together with the string data, so copies of the       */
+/*      string share it.                                                      */
 /*                                                                            */
-/* Input:  "string" is the string to store in the object.                     */
-/*         "characterSet" is the character set the string is in.              */
+/* Input:  "length" is a pointer where you want the length of the string to   */
+/*         be stored, exclusive the NULL terminator. If NULL, no length will  */
+/*         be given.                                                          */
+/*                                                                            */
+/* Output: A pointer to the NULL terminated string. It is valid until the     */
+/*         object is changed or destroyed. Do not free it.                    */
 /******************************************************************************/
-void PString::SetString(const char *string, PCharacterSet *characterSet)
+const char *PString::GetCString(int32 *length) const
 {
+	PStringData *data = stringData;
+	char *buffer;
 	int32 strLen;
-	PCharacterSet *charSet;
 
-	// If no character set is given, use the host character set
-	if (characterSet == NULL)
+	// Empty strings never have a buffer
+	if (data->string == NULL)
 	{
-		charSet = CreateHostCharacterSet();
-		if (charSet == NULL)
+		if (length != NULL)
+			*length = 0;
+
+		return ("");
+	}
+
+	if (data->hostString == NULL)
+	{
+		// Convert the string
+		buffer = new char[data->stringLen * P_MAX_CHAR_LEN + 1];
+		if (buffer == NULL)
 			throw PMemoryException();
+
+		CreateString(buffer, strLen, NULL);
+		data->hostLen = strLen;
+
+		// Other objects sharing the data could have done the same in
+		// the meantime. If so, use their buffer
+		if (AtomicTestAndSetPointer((void **)&data->hostString, buffer, NULL) != NULL)
+			delete[] buffer;
 	}
-	else
-		charSet = characterSet;
+
+	if (length != NULL)
+		*length = data->hostLen;
+
+	return (data->hostString);
+}
+
+
+
+/******************************************************************************/
+/* SetString() will store the string given into the current object.           */
+/*                                                                            */
+/* Input:  "string" is the string to store in the object.                     */
+/*         "characterSet" is the character set the string is in.              */
+/******************************************************************************/
+void PString::SetString(const char *string, PCharacterSet *characterSet)
+{
+	int32 strLen;
 
 	// Make make sure the current string is released
 	Release();
 
-	// Find the length of the string in bytes
-	strLen = CountStringLength(string, charSet);
+	// Find the length of the string in bytes. If no character set
+	// is given, the host character set is used
+	strLen = CountStringLength(string, characterSet);
 
 	if (strLen != 0)
 	{
 		// Allocate the string buffer
 		AllocBuffer(strLen);
-		CopyString(string, charSet);
+		CopyString(string, characterSet);
 	}
-
-	// If we use the host character set, delete it
-	if (characterSet == NULL)
-		delete charSet;
 }
 
 
@@ -3111,31 +3331,16 @@ void PString::SetString(const char *string, PCharacterSet *characterSet)
 /******************************************************************************/
 void PString::SetString(const char *string, int32 length, PCharacterSet *characterSet)
 {
-	PCharacterSet *charSet;
-
-	// If no character set is given, use the host character set
-	if (characterSet == NULL)
-	{
-		charSet = CreateHostCharacterSet();
-		if (charSet == NULL)
-			throw PMemoryException();
-	}
-	else
-		charSet = characterSet;
-
 	// Make make sure the current string is released
 	Release();
 
 	if (length != 0)
 	{
-		// Allocate the string buffer
+		// Allocate the string buffer. If no character set is given,
+		// the host character set is used
 		AllocBuffer(length);
-		CopyString(string, length, charSet);
+		CopyString(string, length, characterSet);
 	}
-
-	// If we use the host character set, delete it
-	if (characterSet == NULL)
-		delete charSet;
 }
 
 
@@ -3247,6 +3452,8 @@ int32 PString::GetByteLength(PCharacterSet *characterSet) const
 /******************************************************************************/
 PChar PString::GetAt(int32 index) const
 {
+	PCharSet_UTF8 hostCharSet;
+	PCharacterSet *useCharSet;
 	const char *string;
 	int8 len;
 
@@ -3256,8 +3463,9 @@ PChar PString::GetAt(int32 index) const
 
 	// Convert the character from unicode to the current character set
 	// and return it in a PChar object
-	string = charSet->FromUnicode(stringData->string[index], len);
-	return (PChar(string, len, charSet));
+	useCharSet = (charSet != NULL) ? charSet : &hostCharSet;
+	string     = useCharSet->FromUnicode(stringData->string[index], len);
+	return (PChar(string, len, useCharSet));
 }
 
 
@@ -4777,7 +4985,7 @@ void PString::Delete(int32 index, int32 count)
 	CopyBeforeWrite();
 
 	// Remove the part of the string
-	memcpy(&stringData->string[index], &stringData->string[index + count], (stringData->stringLen - index - count) * sizeof(uint16));
+	memmove(&stringData->string[index], &stringData->string[index + count], (stringData->stringLen - index - count) * sizeof(uint16));
 
 	// Adjust the string length
 	stringData->stringLen -= count;
@@ -5137,7 +5345,7 @@ void PString::TrimLeft(void)
 		else
 		{
 			// Move the characters
-			memcpy(&stringData->string[0], &stringData->string[i], (stringData->stringLen + 1) * sizeof(uint16));
+			memmove(&stringData->string[0], &stringData->string[i], (stringData->stringLen + 1) * sizeof(uint16));
 		}
 	}
 }
@@ -5226,6 +5434,34 @@ int32 PString::CompareNoCase(PString string) const
 
 
 
+/******************************************************************************/
+/* GetHashCode() calculates a hash value of the string. Two strings that are  */
+/*      equal will always have the same hash value.                           */
+/*                                                                            */
+/* Output: The hash value.                                                    */
+/******************************************************************************/
+uint32 PString::GetHashCode(void) const
+{
+	const uint16 *str;
+	uint32 hash;
+	int32 i, count;
+
+	// FNV-1a over the unicode characters
+	str   = stringData->string;
+	count = stringData->stringLen;
+	hash  = 2166136261UL;
+
+	for (i = 0; i < count; i++)
+	{
+		hash ^= str[i];
+		hash *= 16777619UL;
+	}
+
+	return (hash);
+}
+
+
+
 /******************************************************************************/
 /* operator = (PString &) will set the string to the string given.            */
 /*                                                                            */
@@ -5247,17 +5483,27 @@ const PString & PString::operator = (const PString &string)
 		// already assigned to the string
 		if (stringData != string.stringData)
 		{
-			// The reference counter should at least have one reference
-			ASSERT(string.stringData->refCount > 0);
+			if (string.stringData == &string.inlineData)
+			{
+				// Short strings are never shared, so copy the characters
+				AllocBeforeWrite(string.stringData->stringLen);
+				memcpy(stringData->string, string.stringData->string, (string.stringData->stringLen + 1) * sizeof(uint16));
+				stringData->stringLen = string.stringData->stringLen;
+			}
+			else
+			{
+				// The reference counter should at least have one reference
+				ASSERT(string.stringData->refCount > 0);
 
-			// Count up reference counter
-			AtomicIncrement(&string.stringData->refCount);
+				// Count up reference counter
+				AtomicIncrement(&string.stringData->refCount);
 
-			// Release old string
-			Release();
+				// Release old string
+				Release();
 
-			// Copy the pointer
-			stringData = string.stringData;
+				// Copy the pointer
+				stringData = string.stringData;
+			}
 		}
 	}
 
@@ -5764,19 +6010,26 @@ void PString::Initialize(void)
 {
 	stringData = NULL;
 	charSet    = NULL;
+
+	// Initialize the buffer used for short strings
+	inlineData.refCount     = 1;
+	inlineData.stringLen    = 0;
+	inlineData.allocatedLen = P_STRING_INLINE_LEN;
+	inlineData.string       = inlineString;
+	inlineData.hostString   = NULL;
+	inlineData.hostLen      = 0;
 }
 
 
 
 /******************************************************************************/
-/* SetToHostCharacterSet() set the string to the host character set.          */
+/* SetToHostCharacterSet() set the string to the host character set. No       */
+/*      character set object is allocated for the host character set, all     */
+/*      conversions check for NULL and use the host conversion directly.      */
 /******************************************************************************/
 void PString::SetToHostCharacterSet(void)
 {
-	// Allocate the character set
-	charSet = CreateHostCharacterSet();
-	if (charSet == NULL)
-		throw PMemoryException();
+	charSet = NULL;
 }
 
 
@@ -5788,7 +6041,7 @@ void PString::SetToHostCharacterSet(void)
 /******************************************************************************/
 void PString::CreateEmptyString(void)
 {
-	stringData = &pEmptyString;
+	stringData = &emptyString;
 }
 
 
@@ -5797,7 +6050,8 @@ void PString::CreateEmptyString(void)
 /* CopyString() will copy the string given into the object.                   */
 /*                                                                            */
 /* Input:  "string" is a pointer to a NULL terminated string to count.        */
-/*         "characterSet" is a pointer to the character set to use.           */
+/*         "characterSet" is a pointer to the character set to use or NULL    */
+/*         for the host character set.                                        */
 /******************************************************************************/
 void PString::CopyString(const char *string, PCharacterSet *characterSet)
 {
@@ -5807,20 +6061,24 @@ void PString::CopyString(const char *string, PCharacterSet *characterSet)
 
 	// Null pointer not allowed
 	ASSERT(string != NULL);
-	ASSERT(characterSet != NULL);
 
 	// Traverse the string
 	for (i = 0; ; i++)
 	{
-		try
-		{
-			// Convert the character
-			chr = characterSet->ToUnicode(string, charLen);
-		}
-		catch(PBoundsException e)
+		if (characterSet == NULL)
+			chr = HostToUnicode(string, charLen);
+		else
 		{
-			chr     = 0x003f;
-			charLen = 1;
+			try
+			{
+				// Convert the character
+				chr = characterSet->ToUnicode(string, charLen);
+			}
+			catch(PBoundsException e)
+			{
+				chr     = 0x003f;
+				charLen = 1;
+			}
 		}
 
 		// Check for out of bounds
@@ -5845,7 +6103,8 @@ void PString::CopyString(const char *string, PCharacterSet *characterSet)
 /*                                                                            */
 /* Input:  "string" is a pointer to a NULL terminated string to count.        */
 /*         "length" is the number of bytes to copy.                           */
-/*         "characterSet" is a pointer to the character set to use.           */
+/*         "characterSet" is a pointer to the character set to use or NULL    */
+/*         for the host character set.                                        */
 /******************************************************************************/
 void PString::CopyString(const char *string, int32 length, PCharacterSet *characterSet)
 {
@@ -5855,20 +6114,33 @@ void PString::CopyString(const char *string, int32 length, PCharacterSet *charac
 
 	// Null pointer not allowed
 	ASSERT(string != NULL);
-	ASSERT(characterSet != NULL);
 
 	// Traverse the string
 	for (i = 0, j = 0; j < length; i++)
 	{
-		try
+		if (characterSet == NULL)
 		{
-			// Convert the character
-			chr = characterSet->ToUnicode(string, charLen);
+			chr = HostToUnicode(string, charLen);
+
+			// Do not read past the end of the buffer
+			if ((j + charLen) > length)
+			{
+				chr     = 0x003f;
+				charLen = 1;
+			}
 		}
-		catch(PBoundsException e)
+		else
 		{
-			chr     = 0x003f;
-			charLen = 1;
+			try
+			{
+				// Convert the character
+				chr = characterSet->ToUnicode(string, charLen);
+			}
+			catch(PBoundsException e)
+			{
+				chr     = 0x003f;
+				charLen = 1;
+			}
 		}
 
 		// Check for out of bounds
@@ -5895,7 +6167,8 @@ void PString::CopyString(const char *string, int32 length, PCharacterSet *charac
 /*                                                                            */
 /* Input:  "buffer" is a pointer to where to store the converted string.      */
 /*         "length" is a reference where the string length will be stored.    */
-/*         "characterSet" is the character set to use.                        */
+/*         "characterSet" is the character set to use or NULL for the host    */
+/*         character set.                                                     */
 /******************************************************************************/
 void PString::CreateString(char *buffer, int32 &length, PCharacterSet *characterSet) const
 {
@@ -5905,13 +6178,23 @@ void PString::CreateString(char *buffer, int32 &length, PCharacterSet *character
 
 	// Null pointer not allowed
 	ASSERT(buffer != NULL);
-	ASSERT(characterSet != NULL);
 
 	// Reset the length
 	length = 0;
 
 	// Get the string length
 	count = stringData->stringLen;
+
+	if (characterSet == NULL)
+	{
+		// Convert directly to the host character set
+		for (i = 0; i < count; i++)
+			length += HostFromUnicode(stringData->string[i], buffer + length);
+
+		buffer[length] = 0x00;
+		return;
+	}
+
 	for (i = 0; i < count; i++)
 	{
 		// Convert the character
@@ -5934,7 +6217,8 @@ void PString::CreateString(char *buffer, int32 &length, PCharacterSet *character
 /* CountStringLength() will count the string length in characters.            */
 /*                                                                            */
 /* Input:  "string" is a pointer to a NULL terminated string to count.        */
-/*         "characterSet" is a pointer to the character set to use.           */
+/*         "characterSet" is a pointer to the character set to use or NULL    */
+/*         for the host character set.                                        */
 /*                                                                            */
 /* Output: The length in characters.                                          */
 /******************************************************************************/
@@ -5943,13 +6227,23 @@ int32 PString::CountStringLength(const char *string, PCharacterSet *characterSet
 	int8 charLen;
 	int32 length = 0;
 
-	// Null pointer not allowed
-	ASSERT(characterSet != NULL);
-
 	// Check for string null pointer
 	if (string == NULL)
 		return (0);
 
+	if (characterSet == NULL)
+	{
+		// Count the characters in the host character set
+		while (*string != 0x00)
+		{
+			HostToUnicode(string, charLen);
+			length++;
+			string += charLen;
+		}
+
+		return (length);
+	}
+
 	// Traverse the string and count the number of characters
 	for (;;)
 	{
@@ -5982,52 +6276,50 @@ void PString::AllocBuffer(int32 length)
 {
 	if (length == 0)
 		CreateEmptyString();	// Makes the string empty
+	else if (length <= P_STRING_INLINE_LEN)
+	{
+		// Short strings are stored inside the object
+		FreeHostString(&inlineData);
+		inlineData.stringLen = length;
+
+		stringData = &inlineData;
+	}
 	else
 	{
 		PStringData *data;
+		int32 allocLen;
+
+		// Allocate bigger chunk of memory to avoid fragmentation
+		if (length <= 64)
+			allocLen = 64;
+		else if (length <= 128)
+			allocLen = 128;
+		else if (length <= 256)
+			allocLen = 256;
+		else if (length <= 512)
+			allocLen = 512;
+		else if (length <= 1024)
+			allocLen = 1024;
+		else if (length <= 2048)
+			allocLen = 2048;
+		else
+			allocLen = length;
 
-		// Allocate the data structure
-		data = new PStringData;
+		// Allocate the data structure and the string in one block
+		data = (PStringData *)new char[sizeof(PStringData) + (allocLen + 1) * sizeof(uint16)];
 		if (data == NULL)
 			throw PMemoryException();
 
-		try
-		{
-			// Fill out the structure
-			data->refCount  = 1;
-			data->stringLen = length;
-
-			// Allocate bigger chunk of memory to avoid fragmentation
-			if (length <= 64)
-				length = 64;
-			else if (length <= 128)
-				length = 128;
-			else if (length <= 256)
-				length = 256;
-			else if (length <= 512)
-				length = 512;
-			else if (length <= 1024)
-				length = 1024;
-			else if (length <= 2048)
-				length = 2048;
-
-			// Store how many characters we have allocated
-			data->allocatedLen = length;
-
-			// Allocate buffer to hold the string
-			data->string = new uint16[length + 1];
-			if (data->string == NULL)
-				throw PMemoryException();
-
-			// Assign the data structure to the string
-			stringData = data;
-		}
-		catch(...)
-		{
-			// Delete the structure again
-			delete data;
-			throw;
-		}
+		// Fill out the structure
+		data->refCount     = 1;
+		data->stringLen    = length;
+		data->allocatedLen = allocLen;
+		data->string       = (uint16 *)(data + 1);
+		data->hostString   = NULL;
+		data->hostLen      = 0;
+
+		// Assign the data structure to the string
+		stringData = data;
 	}
 }
 
@@ -6043,21 +6335,8 @@ void PString::Release(void)
 	// Check for an empty string
 	if (stringData->string != NULL)
 	{
-		int32 result;
-
-		// The reference counter should at least have one reference
-		ASSERT(stringData->refCount > 0);
-
-		// Count down reference counter
-		result = AtomicDecrement(&stringData->refCount);
-
-		// If there isn't any references left, delete the buffer
-		if (result == 0)
-		{
-			// Delete the old string
-			delete[] stringData->string;
-			delete stringData;
-		}
+		// Free the buffer
+		Release(stringData);
 
 		// Set the current object to an empty string
 		CreateEmptyString();
@@ -6074,7 +6353,12 @@ void PString::Release(void)
 /******************************************************************************/
 void PString::Release(PStringData *data)
 {
-	if (data->string != NULL)
+	if (data == &inlineData)
+	{
+		// The inline buffer is never shared, just drop the host string
+		FreeHostString(data);
+	}
+	else if (data->string != NULL)
 	{
 		int32 result;
 
@@ -6088,14 +6372,28 @@ void PString::Release(PStringData *data)
 		if (result == 0)
 		{
 			// Delete the old string
-			delete[] data->string;
-			delete data;
+			delete[] data->hostString;
+			delete[] (char *)data;
 		}
 	}
 }
 
 
 
+/******************************************************************************/
+/* FreeHostString() frees the host character set version of the string. It    */
+/*      has to be called before the string data is changed.                   */
+/*                                                                            */
+/* Input:  "data" is a pointer to the data structure which is not shared.     */
+/******************************************************************************/
+void PString::FreeHostString(PStringData *data)
+{
+	delete[] data->hostString;
+	data->hostString = NULL;
+}
+
+
+
 /******************************************************************************/
 /* CopyBeforeWrite() makes sure that the string buffer has it's own memory    */
 /*      block.                                                                */
@@ -6123,6 +6421,11 @@ void PString::CopyBeforeWrite(void)
 		// Release the reference
 		Release(oldData);
 	}
+	else if (stringData->string != NULL)
+	{
+		// The string will be changed
+		FreeHostString(stringData);
+	}
 }
 
 
@@ -6140,6 +6443,11 @@ void PString::AllocBeforeWrite(int32 length)
 		Release();
 		AllocBuffer(length);
 	}
+	else
+	{
+		// The string will be changed
+		FreeHostString(stringData);
+	}
 }
 
 
@@ -6175,6 +6483,11 @@ void PString::EnlargeBeforeWrite(int32 length)
 		// Release the reference
 		Release(oldData);
 	}
+	else
+	{
+		// The string will be changed
+		FreeHostString(stringData);
+	}
 }
 
 
@@ -6187,21 +6500,10 @@ void PString::EnlargeBeforeWrite(int32 length)
 /******************************************************************************/
 void PString::AssignCopy(const char *string, PCharacterSet *characterSet)
 {
-	PCharacterSet *hostCharSet;
 	int32 strLen;
 
-	// Create the host character set
-	if (characterSet == NULL)
-	{
-		hostCharSet = CreateHostCharacterSet();
-		if (hostCharSet == NULL)
-			throw PMemoryException();
-	}
-	else
-		hostCharSet = characterSet;
-
 	// First find out how many characters the string is
-	strLen = CountStringLength(string, hostCharSet);
+	strLen = CountStringLength(string, characterSet);
 
 	// Well, if it's an empty string, make the string empty
 	if (strLen == 0)
@@ -6212,15 +6514,11 @@ void PString::AssignCopy(const char *string, PCharacterSet *characterSet)
 		AllocBeforeWrite(strLen);
 
 		// Copy the string
-		CopyString(string, hostCharSet);
+		CopyString(string, characterSet);
 
 		// Set the string length
 		stringData->stringLen = strLen;
 	}
-
-	// Delete the host character set
-	if (characterSet == NULL)
-		delete hostCharSet;
 }
 
 
@@ -6280,7 +6578,10 @@ void PString::AllocCopy(PString &dest, int32 startIndex, int32 length) const
 		dest.stringData->string[length] = 0x0000;
 
 		// Make sure the new string use the same character set
-		dest.SwitchCharacterSet(charSet);
+		if (charSet == NULL)
+			dest.SwitchToHostCharacterSet();
+		else
+			dest.SwitchCharacterSet(charSet);
 	}
 }
 
@@ -6307,8 +6608,11 @@ void PString::ConcatInPlace(const PStringData *string)
 	}
 	else
 	{
+		// The string will be changed
+		FreeHostString(stringData);
+
 		// Just append the string, the buffer is big enough
-		memcpy(&stringData->string[stringData->stringLen], string->string, string->stringLen * sizeof(uint16));
+		memmove(&stringData->string[stringData->stringLen], string->string, string->stringLen * sizeof(uint16));
 
 		// Set the new length
 		stringData->stringLen += string->stringLen;
@@ -6344,6 +6648,9 @@ void PString::ConcatInPlace(const PChar &chr)
 		int8 len;
 		uint16 uniChar;
 
+		// The string will be changed
+		FreeHostString(stringData);
+
 		try
 		{
 			// Convert the character to unicode
@@ -6375,17 +6682,22 @@ void PString::ConcatInPlace(const PChar &chr)
 /******************************************************************************/
 void PString::ConcatCopy(const PStringData *sourceString, const PStringData *appendString)
 {
-	int32 newLen;
+	int32 newLen, sourceLen, appendLen;
+
+	// Remember the lengths, the strings can be the inline buffer which
+	// is reused by AllocBuffer()
+	sourceLen = sourceString->stringLen;
+	appendLen = appendString->stringLen;
 
 	// Calculate the new length
-	newLen = sourceString->stringLen + appendString->stringLen;
+	newLen = sourceLen + appendLen;
 
 	if (newLen != 0)
 	{
 		// Allocate new buffer and append the strings
 		AllocBuffer(newLen);
-		memcpy(&stringData->string[0], sourceString->string, sourceString->stringLen * sizeof(uint16));
-		memcpy(&stringData->string[sourceString->stringLen], appendString->string, appendString->stringLen * sizeof(uint16));
+		memmove(&stringData->string[0], sourceString->string, sourceLen * sizeof(uint16));
+		memmove(&stringData->string[sourceLen], appendString->string, appendLen * sizeof(uint16));
 
 		// Null terminate the string
 		stringData->string[newLen] = 0x0000;
@@ -6409,9 +6721,10 @@ void PString::ConcatCopy(const PStringData *sourceString, const PChar &appendCha
 	// Calculate the new length
 	newLen = sourceString->stringLen + 1;
 
-	// Allocate new buffer and append the strings
+	// Allocate new buffer and append the strings. The source can be the
+	// inline buffer which is reused by AllocBuffer()
 	AllocBuffer(newLen);
-	memcpy(&stringData->string[0], sourceString->string, sourceString->stringLen * sizeof(uint16));
+	memmove(&stringData->string[0], sourceString->string, (newLen - 1) * sizeof(uint16));
 
 	try
 	{
@@ -6545,7 +6858,8 @@ void PString::FormatIt(PString formatString, va_list argList)
 
 	// Make sure the type string use the same character set as
 	// the current string
-	typeStr.SwitchCharacterSet(charSet);
+	if (charSet != NULL)
+		typeStr.SwitchCharacterSet(charSet);
 
 	// Make sure we have an unique buffer in the format string
 	formatString.CopyBeforeWrite();
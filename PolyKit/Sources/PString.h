@@ -24,6 +24,7 @@
 /* Defines used in the classes                                                */
 /******************************************************************************/
 #define P_MAX_CHAR_LEN		3		// Max character length in all character sets. If you create a new character set, remember to check/update this
+#define P_STRING_INLINE_LEN	15		// Max number of characters stored inside the PString object itself
 
 
 
@@ -283,6 +284,29 @@ protected:
 
 
 
+/******************************************************************************/
+/* PCharSet_ISO_8859_1 class                                                  */
+/******************************************************************************/
+class _IMPEXP_PKLIB PCharSet_ISO_8859_1 : public PCharacterSet
+{
+public:
+	PCharSet_ISO_8859_1(void);
+	virtual ~PCharSet_ISO_8859_1(void);
+
+	virtual uint16 ToUnicode(const char *chr, int8 &charLen);
+	virtual const char *FromUnicode(uint16 chr, int8 &len);
+
+	virtual int8 GetCharLength(const char *chr);
+	virtual bool IsValid(const char *chr, int8 len);
+
+	virtual PCharacterSet *CreateObject(void) const;
+
+protected:
+	char charBuf;
+};
+
+
+
 /******************************************************************************/
 /* PCharSet_UNICODE class                                                     */
 /******************************************************************************/
@@ -450,6 +474,7 @@ public:
 	char *GetString(int32 *length = NULL) const;
 	char *GetString(PCharacterSet *characterSet, int32 *length = NULL) const;
 	void FreeBuffer(char *buffer) const;
+	const char *GetCString(int32 *length = NULL) const;
 	void SetString(const char *string, PCharacterSet *characterSet = NULL);
 	void SetString(const char *string, int32 length, PCharacterSet *characterSet = NULL);
 
@@ -539,6 +564,7 @@ public:
 
 	int32 Compare(PString string) const;
 	int32 CompareNoCase(PString string) const;
+	uint32 GetHashCode(void) const;
 
 	const PString & operator = (const PString &string);
 	const PString & operator = (const char *string);
@@ -579,7 +605,15 @@ public:
 	_IMPEXP_PKLIB friend bool operator >= (const char *string1, const PString &string2);
 
 protected:
-	struct PStringData;
+	typedef struct PStringData
+	{
+		int32 refCount;				// Number of objects that points to this string
+		int32 stringLen;			// Length of the string in characters
+		int32 allocatedLen;			// Number of characters allocated
+		uint16 *string;				// Pointer to the string which is always stored in unicode
+		char *hostString;			// The string in the host character set or NULL if not created yet
+		int32 hostLen;				// Length of hostString in bytes
+	} PStringData;
 
 	void Initialize(void);
 
@@ -594,6 +628,7 @@ protected:
 	void AllocBuffer(int32 length);
 	void Release(void);
 	void Release(PStringData *data);
+	static void FreeHostString(PStringData *data);
 
 	void CopyBeforeWrite(void);
 	void AllocBeforeWrite(int32 length);
@@ -616,7 +651,12 @@ protected:
 	void ToHex(uint16 *buffer, int32 &length, uint64 number, bool upper);
 
 	PStringData *stringData;
-	PCharacterSet *charSet;
+	PCharacterSet *charSet;			// NULL means the host character set
+
+	static PStringData emptyString;	// Shared by all empty strings
+
+	PStringData inlineData;			// Used instead of an allocated buffer for short strings
+	uint16 inlineString[P_STRING_INLINE_LEN + 1];
 };
 
 
@@ -45,6 +45,85 @@ typedef struct PSyncItem
 static PMutex syncListLock("MultipleObjectWait() list lock", false);
 static PList<PEventItem> syncEventList;
 static PList<PSyncItem> syncWaitList;
+static int32 syncWaitCount = 0;
+
+
+
+#if __p_os == __p_linux
+
+/******************************************************************************/
+/* Linux lock constants                                                       */
+/******************************************************************************/
+#define PMRSW_WRITER				0x40000000
+
+
+
+/******************************************************************************/
+/* GetDeadline() converts a timeout to the time it runs out.                  */
+/*                                                                            */
+/* Input:  "timeout" is the timeout value in milliseconds.                    */
+/*                                                                            */
+/* Output: The deadline in microseconds or -1 for no deadline.                */
+/******************************************************************************/
+static bigtime_t GetDeadline(uint32 timeout)
+{
+	if (timeout == PSYNC_INFINITE)
+		return (-1);
+
+	return (system_time() + (bigtime_t)timeout * 1000);
+}
+
+
+
+/******************************************************************************/
+/* FutexWait() sleeps as long as the word holds the value given. It can       */
+/*      return before the word is changed, so the caller has to check the     */
+/*      state again.                                                          */
+/*                                                                            */
+/* Input:  "word" is a pointer to the word to sleep on.                       */
+/*         "value" is the value the word had when the state was checked.      */
+/*         "deadline" is the time to give up or -1 to wait forever.           */
+/*                                                                            */
+/* Output: pSyncOk if the state should be checked again or pSyncTimeout.      */
+/******************************************************************************/
+static PSyncError FutexWait(vint32 *word, int32 value, bigtime_t deadline)
+{
+	struct timespec spec;
+	bigtime_t timeLeft;
+
+	if (deadline < 0)
+	{
+		syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+		return (pSyncOk);
+	}
+
+	timeLeft = deadline - system_time();
+	if (timeLeft <= 0)
+		return (pSyncTimeout);
+
+	spec.tv_sec  = timeLeft / 1000000;
+	spec.tv_nsec = (timeLeft % 1000000) * 1000;
+
+	if ((syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, value, &spec, NULL, 0) == -1) && (errno == ETIMEDOUT))
+		return (pSyncTimeout);
+
+	return (pSyncOk);
+}
+
+
+
+/******************************************************************************/
+/* FutexWake() wakes threads sleeping on the word.                            */
+/*                                                                            */
+/* Input:  "word" is a pointer to the word the threads sleep on.              */
+/*         "count" is the maximum number of threads to wake.                  */
+/******************************************************************************/
+static void FutexWake(vint32 *word, int32 count)
+{
+	syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+#endif
 
 
 
@@ -63,10 +142,14 @@ static PList<PSyncItem> syncWaitList;
 /******************************************************************************/
 int32 AtomicIncrement(int32 *variable)
 {
+#if __p_os == __p_beos
 	int32 result;
 
 	result = atomic_add(variable, 1);
 	return (result + 1);
+#elif __p_os == __p_linux
+	return (__sync_add_and_fetch(variable, 1));
+#endif
 }
 
 
@@ -82,10 +165,99 @@ int32 AtomicIncrement(int32 *variable)
 /******************************************************************************/
 int32 AtomicDecrement(int32 *variable)
 {
+#if __p_os == __p_beos
 	int32 result;
 
 	result = atomic_add(variable, -1);
 	return (result - 1);
+#elif __p_os == __p_linux
+	return (__sync_sub_and_fetch(variable, 1));
+#endif
+}
+
+
+
+/******************************************************************************/
+/* AtomicTestAndSet() will store a new value in the variable, but only if the */
+/*      variable still holds the value you expect.                            */
+/*                                                                            */
+/* Input:  "variable" is a pointer to the variable you want to change.        */
+/*         "newValue" is the value to store.                                  */
+/*         "testValue" is the value the variable has to hold.                 */
+/*                                                                            */
+/* Output: Is the value the variable held before. If it is not the same as    */
+/*         "testValue", the variable has not been changed.                    */
+/******************************************************************************/
+int32 AtomicTestAndSet(int32 *variable, int32 newValue, int32 testValue)
+{
+#if __p_os == __p_beos
+	return (atomic_test_and_set(variable, newValue, testValue));
+#elif __p_os == __p_linux
+	return (__sync_val_compare_and_swap(variable, testValue, newValue));
+#endif
+}
+
+
+
+/******************************************************************************/
+/* AtomicTestAndSetPointer() will store a new pointer in the variable, but    */
+/*      only if the variable still holds the pointer you expect.              */
+/*                                                                            */
+/* Input:  "variable" is a pointer to the variable you want to change.        */
+/*         "newValue" is the pointer to store.                                */
+/*         "testValue" is the pointer the variable has to hold.               */
+/*                                                                            */
+/* Output: Is the pointer the variable held before. If it is not the same as  */
+/*         "testValue", the variable has not been changed.                    */
+/******************************************************************************/
+void *AtomicTestAndSetPointer(void **variable, void *newValue, void *testValue)
+{
+#if __p_os == __p_beos
+	return (atomic_pointer_test_and_set(variable, newValue, testValue));
+#elif __p_os == __p_linux
+	return (__sync_val_compare_and_swap(variable, testValue, newValue));
+#endif
+}
+
+
+
+/******************************************************************************/
+/* AtomicGet() will read the variable you give. All memory writes done by     */
+/*      other threads before they changed the variable are visible after the  */
+/*      call.                                                                 */
+/*                                                                            */
+/* Input:  "variable" is a pointer to the variable you want to read.          */
+/*                                                                            */
+/* Output: Is the value of the variable.                                      */
+/******************************************************************************/
+int32 AtomicGet(int32 *variable)
+{
+#if __p_os == __p_beos
+	return (atomic_get(variable));
+#elif __p_os == __p_linux
+	// Not an atomic add of 0, because it would write to the cache
+	// line and slow down the other threads using it
+	return (__atomic_load_n(variable, __ATOMIC_SEQ_CST));
+#endif
+}
+
+
+
+/******************************************************************************/
+/* AtomicSet() will store a new value in the variable you give. All memory    */
+/*      writes done before the call are visible to other threads before the   */
+/*      new value is.                                                         */
+/*                                                                            */
+/* Input:  "variable" is a pointer to the variable you want to change.        */
+/*         "newValue" is the value to store.                                  */
+/******************************************************************************/
+void AtomicSet(int32 *variable, int32 newValue)
+{
+#if __p_os == __p_beos
+	atomic_set(variable, newValue);
+#elif __p_os == __p_linux
+	__atomic_store_n(variable, newValue, __ATOMIC_SEQ_CST);
+#endif
 }
 
 
@@ -224,6 +396,9 @@ int32 MultipleObjectsWait(PSync **objects, int32 count, bool waitAll, bigtime_t
 			return (pSyncError);
 		}
 
+		// Tell the unlock functions that someone waits
+		AtomicIncrement(&syncWaitCount);
+
 		// Add the trigger event in the event list
 		syncEventList.AddTail(eventItem);
 
@@ -331,6 +506,7 @@ int32 MultipleObjectsWait(PSync **objects, int32 count, bool waitAll, bigtime_t
 		delete eventItem.event;
 
 		// Unlock the list
+		AtomicDecrement(&syncWaitCount);
 		syncListLock.Unlock();
 
 		// Got an object?
@@ -378,10 +554,21 @@ void PSync::TrigMultiWait(void)
 	PSyncItem syncItem;
 	PEventItem eventItem;
 
-	// If it's called from the sync list lock, just exit
+	// If it's called from the sync list lock or nobody waits
+	// on multiple objects, just exit
 	if (this == &syncListLock)
 		return;
 
+#if __p_os == __p_beos
+	if (atomic_get(&syncWaitCount) == 0)
+		return;
+#elif __p_os == __p_linux
+	// The acquire makes the list changes done before the count
+	// was incremented visible when it is not 0
+	if (__atomic_load_n(&syncWaitCount, __ATOMIC_ACQUIRE) == 0)
+		return;
+#endif
+
 	// Lock the wait list
 	syncListLock.Lock();
 
@@ -470,8 +657,10 @@ PSemaphore::PSemaphore(PString name, uint32 count, bool lockSameThread)
 /******************************************************************************/
 PSemaphore::~PSemaphore(void)
 {
+#if __p_os == __p_beos
 	// Delete the semaphore
 	VERIFY(delete_sem(semID) == B_NO_ERROR);
+#endif
 }
 
 
@@ -488,6 +677,7 @@ PSemaphore::~PSemaphore(void)
 /******************************************************************************/
 void PSemaphore::Initialize(PString name, uint32 count, bool lockSameThread)
 {
+#if __p_os == __p_beos
 	char *nameStr;
 
 	// Create the semaphore
@@ -501,6 +691,16 @@ void PSemaphore::Initialize(PString name, uint32 count, bool lockSameThread)
 	owner      = 0;
 	ownerCount = 0;
 	lockThread = lockSameThread;
+#elif __p_os == __p_linux
+	// Initialize the counters
+	semCount   = count;
+	semWaiters = 0;
+
+	// Initialize owner variables
+	owner      = 0;
+	ownerCount = 0;
+	lockThread = lockSameThread;
+#endif
 }
 
 
@@ -515,6 +715,7 @@ void PSemaphore::Initialize(PString name, uint32 count, bool lockSameThread)
 /******************************************************************************/
 PSyncError PSemaphore::Lock(uint32 timeout)
 {
+#if __p_os == __p_beos
 	status_t err;
 	thread_id callThread;
 
@@ -546,6 +747,9 @@ PSyncError PSemaphore::Lock(uint32 timeout)
 		return (pSyncTimeout);
 
 	return (pSyncError);
+#elif __p_os == __p_linux
+	return (LockWithCount(1, timeout));
+#endif
 }
 
 
@@ -557,6 +761,7 @@ PSyncError PSemaphore::Lock(uint32 timeout)
 /******************************************************************************/
 PSyncError PSemaphore::Unlock(void)
 {
+#if __p_os == __p_beos
 	// Release the semaphore
 	status_t err;
 
@@ -577,6 +782,9 @@ PSyncError PSemaphore::Unlock(void)
 	}
 
 	return (pSyncOk);
+#elif __p_os == __p_linux
+	return (UnlockWithCount(1));
+#endif
 }
 
 
@@ -591,6 +799,7 @@ PSyncError PSemaphore::Unlock(void)
 /******************************************************************************/
 PSyncError PSemaphore::LockWithCount(uint32 count, uint32 timeout)
 {
+#if __p_os == __p_beos
 	status_t err;
 	thread_id callThread;
 
@@ -622,6 +831,54 @@ PSyncError PSemaphore::LockWithCount(uint32 count, uint32 timeout)
 		return (pSyncTimeout);
 
 	return (pSyncError);
+#elif __p_os == __p_linux
+	thread_id callThread;
+	bigtime_t deadline;
+	int32 curCount;
+
+	// Get the current thread id
+	callThread = find_thread(NULL);
+
+	// Check to see if the calling thread already have the semaphore
+	if (!lockThread && (callThread == owner))
+	{
+		ownerCount += count;
+		return (pSyncOk);
+	}
+
+	deadline = GetDeadline(timeout);
+
+	for (;;)
+	{
+		// Take the locks if there are enough left
+		curCount = semCount;
+		if (curCount >= (int32)count)
+		{
+			if (__sync_bool_compare_and_swap(&semCount, curCount, curCount - count))
+				break;
+
+			continue;
+		}
+
+		if (timeout == 0)
+			return (pSyncTimeout);
+
+		// Sleep until the count changes
+		__sync_add_and_fetch(&semWaiters, 1);
+		if (FutexWait(&semCount, curCount, deadline) == pSyncTimeout)
+		{
+			__sync_sub_and_fetch(&semWaiters, 1);
+			return (pSyncTimeout);
+		}
+
+		__sync_sub_and_fetch(&semWaiters, 1);
+	}
+
+	owner      = callThread;
+	ownerCount = count;
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -633,6 +890,7 @@ PSyncError PSemaphore::LockWithCount(uint32 count, uint32 timeout)
 /******************************************************************************/
 PSyncError PSemaphore::UnlockWithCount(uint32 count)
 {
+#if __p_os == __p_beos
 	// Release the semaphore
 	status_t err;
 
@@ -653,6 +911,28 @@ PSyncError PSemaphore::UnlockWithCount(uint32 count)
 	}
 
 	return (pSyncOk);
+#elif __p_os == __p_linux
+	// Decrement the owner counter
+	ownerCount -= count;
+
+	if ((ownerCount <= 0) || (lockThread))
+	{
+		owner      = 0;
+		ownerCount = 0;
+
+		// Give the locks back and only call the kernel if
+		// some threads are sleeping. All of them are woken,
+		// because they may wait for different counts
+		__sync_add_and_fetch(&semCount, count);
+		if (semWaiters > 0)
+			FutexWake(&semCount, INT_MAX);
+
+		// Tell any multi waiting thread about the unlock
+		TrigMultiWait();
+	}
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -699,8 +979,10 @@ PMutex::PMutex(PString name, bool lockSameThread)
 /******************************************************************************/
 PMutex::~PMutex(void)
 {
+#if __p_os == __p_beos
 	// Delete the semaphore
 	VERIFY(delete_sem(semID) == B_NO_ERROR);
+#endif
 }
 
 
@@ -716,6 +998,7 @@ PMutex::~PMutex(void)
 /******************************************************************************/
 void PMutex::Initialize(PString name, bool lockSameThread)
 {
+#if __p_os == __p_beos
 	char *nameStr;
 
 	// Create the semaphore
@@ -729,6 +1012,15 @@ void PMutex::Initialize(PString name, bool lockSameThread)
 	owner      = 0;
 	ownerCount = 0;
 	lockThread = lockSameThread;
+#elif __p_os == __p_linux
+	// Initialize the lock word
+	lockState = 0;
+
+	// Initialize owner variables
+	owner      = 0;
+	ownerCount = 0;
+	lockThread = lockSameThread;
+#endif
 }
 
 
@@ -743,6 +1035,7 @@ void PMutex::Initialize(PString name, bool lockSameThread)
 /******************************************************************************/
 PSyncError PMutex::Lock(uint32 timeout)
 {
+#if __p_os == __p_beos
 	status_t err;
 	thread_id callThread;
 
@@ -774,6 +1067,48 @@ PSyncError PMutex::Lock(uint32 timeout)
 		return (pSyncTimeout);
 
 	return (pSyncError);
+#elif __p_os == __p_linux
+	thread_id callThread;
+	bigtime_t deadline;
+	int32 curState;
+
+	// Get the current thread id
+	callThread = find_thread(NULL);
+
+	// Check to see if the calling thread already have the mutex
+	if (!lockThread && (callThread == owner))
+	{
+		ownerCount++;
+		return (pSyncOk);
+	}
+
+	// Try to take a free mutex without calling the kernel
+	curState = __sync_val_compare_and_swap(&lockState, 0, 1);
+	if (curState != 0)
+	{
+		if (timeout == 0)
+			return (pSyncTimeout);
+
+		deadline = GetDeadline(timeout);
+
+		// Mark the mutex as contended and sleep until it is released
+		if (curState != 2)
+			curState = __sync_lock_test_and_set(&lockState, 2);
+
+		while (curState != 0)
+		{
+			if (FutexWait(&lockState, 2, deadline) == pSyncTimeout)
+				return (pSyncTimeout);
+
+			curState = __sync_lock_test_and_set(&lockState, 2);
+		}
+	}
+
+	owner      = callThread;
+	ownerCount = 1;
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -785,6 +1120,7 @@ PSyncError PMutex::Lock(uint32 timeout)
 /******************************************************************************/
 PSyncError PMutex::Unlock(void)
 {
+#if __p_os == __p_beos
 	status_t err;
 
 	// Decrement the owner counter
@@ -805,6 +1141,29 @@ PSyncError PMutex::Unlock(void)
 	}
 
 	return (pSyncOk);
+#elif __p_os == __p_linux
+	// Decrement the owner counter
+	ownerCount--;
+
+	if ((ownerCount <= 0) || (lockThread))
+	{
+		owner      = 0;
+		ownerCount = 0;
+
+		// Release the mutex and only call the kernel if
+		// another thread sleeps on it
+		if (__sync_fetch_and_sub(&lockState, 1) != 1)
+		{
+			__sync_lock_release(&lockState);
+			FutexWake(&lockState, 1);
+		}
+
+		// Tell any multi waiting thread about the unlock
+		TrigMultiWait();
+	}
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -855,8 +1214,10 @@ PEvent::PEvent(PString name, bool manualReset, bool initialState)
 /******************************************************************************/
 PEvent::~PEvent(void)
 {
+#if __p_os == __p_beos
 	// Delete the semaphore
 	VERIFY(delete_sem(semID) == B_NO_ERROR);
+#endif
 }
 
 
@@ -874,6 +1235,7 @@ PEvent::~PEvent(void)
 /******************************************************************************/
 void PEvent::Initialize(PString name, bool manualReset, bool initialState)
 {
+#if __p_os == __p_beos
 	char *nameStr;
 
 	// Remember the arguments
@@ -891,6 +1253,16 @@ void PEvent::Initialize(PString name, bool manualReset, bool initialState)
 
 	if (semID < B_NO_ERROR)
 		throw PSystemException(PSystem::ConvertOSError(semID));
+#elif __p_os == __p_linux
+	// Remember the arguments
+	state  = initialState;
+	manual = manualReset;
+
+	// Initialize the wait variables
+	eventSequence = 0;
+	eventWaiters  = 0;
+	releaseCount  = 0;
+#endif
 }
 
 
@@ -905,6 +1277,7 @@ void PEvent::Initialize(PString name, bool manualReset, bool initialState)
 /******************************************************************************/
 PSyncError PEvent::Lock(uint32 timeout)
 {
+#if __p_os == __p_beos
 	status_t err;
 	bool releaseMe;
 
@@ -938,6 +1311,51 @@ PSyncError PEvent::Lock(uint32 timeout)
 	while ((!state) && (!releaseMe));
 
 	return (pSyncOk);
+#elif __p_os == __p_linux
+	bigtime_t deadline;
+	int32 sequence, count;
+
+	// First check to see if the event has been set
+	if (state)
+		return (pSyncOk);		// It has, so just return
+
+	deadline = GetDeadline(timeout);
+
+	for (;;)
+	{
+		// Read the sequence before the state, so a set in between
+		// will make the futex return at once
+		sequence = __sync_fetch_and_add(&eventSequence, 0);
+		if (state)
+			return (pSyncOk);
+
+		// Automatic events releases one thread for each set
+		if (!manual)
+		{
+			count = releaseCount;
+			if (count > 0)
+			{
+				if (__sync_bool_compare_and_swap(&releaseCount, count, count - 1))
+					return (pSyncOk);
+
+				continue;
+			}
+		}
+
+		if (timeout == 0)
+			return (pSyncTimeout);
+
+		// Sleep until the event is set
+		__sync_add_and_fetch(&eventWaiters, 1);
+		if (FutexWait(&eventSequence, sequence, deadline) == pSyncTimeout)
+		{
+			__sync_sub_and_fetch(&eventWaiters, 1);
+			return (pSyncTimeout);
+		}
+
+		__sync_sub_and_fetch(&eventWaiters, 1);
+	}
+#endif
 }
 
 
@@ -961,6 +1379,7 @@ PSyncError PEvent::Unlock(void)
 /******************************************************************************/
 PSyncError PEvent::SetEvent(void)
 {
+#if __p_os == __p_beos
 	status_t err;
 
 	// First check to see if the event already is set
@@ -991,6 +1410,37 @@ PSyncError PEvent::SetEvent(void)
 	}
 
 	return (pSyncError);
+#elif __p_os == __p_linux
+	// First check to see if the event already is set
+	if (state)
+		return (pSyncOk);		// It is, so just return
+
+	if (manual)
+	{
+		// Set the event and wake all the sleeping threads
+		state = true;
+		__sync_add_and_fetch(&eventSequence, 1);
+
+		if (eventWaiters > 0)
+			FutexWake(&eventSequence, INT_MAX);
+	}
+	else
+	{
+		// Automatic event, release one waiting thread. As on BeOS, the
+		// set is lost if no thread is waiting
+		if (eventWaiters > 0)
+		{
+			__sync_add_and_fetch(&releaseCount, 1);
+			__sync_add_and_fetch(&eventSequence, 1);
+			FutexWake(&eventSequence, 1);
+		}
+	}
+
+	// Tell any multi waiting thread about the unlock
+	TrigMultiWait();
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -1002,6 +1452,7 @@ PSyncError PEvent::SetEvent(void)
 /******************************************************************************/
 PSyncError PEvent::ResetEvent(void)
 {
+#if __p_os == __p_beos
 	status_t err;
 
 	// First check to see if the event already is cleared
@@ -1017,6 +1468,13 @@ PSyncError PEvent::ResetEvent(void)
 	}
 
 	return (pSyncError);
+#elif __p_os == __p_linux
+	// Clear the event
+	state = false;
+	__sync_synchronize();
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -1062,10 +1520,14 @@ PMRSWLock::PMRSWLock(PString name)
 /******************************************************************************/
 PMRSWLock::~PMRSWLock(void)
 {
+#if __p_os == __p_beos
 	delete writeLockSem;
 	delete writeSem;
 	delete readSem;
 	delete mainLock;
+#elif __p_os == __p_linux
+	pthread_key_delete(readNestKey);
+#endif
 }
 
 
@@ -1081,6 +1543,7 @@ PMRSWLock::~PMRSWLock(void)
 /******************************************************************************/
 PSyncError PMRSWLock::WaitToWrite(uint32 timeout)
 {
+#if __p_os == __p_beos
 	PSyncError locked = pSyncError;
 
 	// Does the current thread already hold the lock for writing?
@@ -1155,6 +1618,62 @@ PSyncError PMRSWLock::WaitToWrite(uint32 timeout)
 	}
 
 	return (locked);
+#elif __p_os == __p_linux
+	bigtime_t deadline;
+	int32 sequence;
+
+	// Does the current thread already hold the lock for writing?
+	if (FindThreadID() == writerThread)
+	{
+		// Yup, just increment the nesting count
+		writerNest++;
+		return (pSyncOk);
+	}
+
+	// Tell the readers that a writer is waiting, so new
+	// readers will wait behind us
+	__sync_add_and_fetch(&writeWaitCount, 1);
+	deadline = GetDeadline(timeout);
+
+	for (;;)
+	{
+		// Take the lock if nobody else has it
+		if (__sync_bool_compare_and_swap(&lockState, 0, PMRSW_WRITER))
+			break;
+
+		// Sleep until the lock state changes
+		if (timeout != 0)
+		{
+			// Check again after reading the sequence, so a release
+			// in between will not be missed
+			sequence = __sync_fetch_and_add(&wakeSequence, 0);
+			if (lockState == 0)
+				continue;
+
+			__sync_add_and_fetch(&sleepCount, 1);
+			if (FutexWait(&wakeSequence, sequence, deadline) == pSyncOk)
+			{
+				__sync_sub_and_fetch(&sleepCount, 1);
+				continue;
+			}
+
+			__sync_sub_and_fetch(&sleepCount, 1);
+		}
+
+		// Timed out. Readers may wait on us, so wake them
+		__sync_sub_and_fetch(&writeWaitCount, 1);
+		WakeWaiters();
+
+		return (pSyncTimeout);
+	}
+
+	__sync_sub_and_fetch(&writeWaitCount, 1);
+
+	// Got the lock, remember the thread id
+	writerThread = FindThreadID();
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -1167,6 +1686,7 @@ PSyncError PMRSWLock::WaitToWrite(uint32 timeout)
 /******************************************************************************/
 PSyncError PMRSWLock::DoneWriting(void)
 {
+#if __p_os == __p_beos
 	PSyncError unlocked = pSyncError;
 	int32 readersWaiting;
 
@@ -1223,6 +1743,26 @@ PSyncError PMRSWLock::DoneWriting(void)
 	}
 
 	return (unlocked);
+#elif __p_os == __p_linux
+	// It has to be the current thread that hold the lock for writing
+	if (FindThreadID() != writerThread)
+		return (pSyncError);
+
+	// If this is a nested lock, just decrement the nest count
+	if (writerNest > 0)
+	{
+		writerNest--;
+		return (pSyncOk);
+	}
+
+	// Writer finally unlocking
+	writerThread = -1;
+	__sync_lock_release(&lockState);
+
+	WakeWaiters();
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -1237,6 +1777,7 @@ PSyncError PMRSWLock::DoneWriting(void)
 /******************************************************************************/
 PSyncError PMRSWLock::WaitToRead(uint32 timeout)
 {
+#if __p_os == __p_beos
 	int32 thread;
 	PSyncError locked = pSyncError;
 
@@ -1319,6 +1860,70 @@ PSyncError PMRSWLock::WaitToRead(uint32 timeout)
 	}
 
 	return (locked);
+#elif __p_os == __p_linux
+	bigtime_t deadline;
+	int32 nest, sequence, curState;
+
+	// Does the current thread hold the lock for writing?
+	if (FindThreadID() == writerThread)
+	{
+		// We just increment the nesting
+		writerNest++;
+		return (pSyncOk);
+	}
+
+	// Does the current thread already have a read lock?
+	nest = (int32)(intptr_t)pthread_getspecific(readNestKey);
+	if (nest == 0)
+	{
+		deadline = GetDeadline(timeout);
+
+		for (;;)
+		{
+			// Add us as a reader if no writer has the lock or waits for it
+			curState = lockState;
+
+			if ((curState != PMRSW_WRITER) && (writeWaitCount == 0))
+			{
+				if (__sync_bool_compare_and_swap(&lockState, curState, curState + 1))
+					break;
+
+				continue;
+			}
+
+			if (timeout == 0)
+				return (pSyncTimeout);
+
+			// Check again after reading the sequence, so a release
+			// in between will not be missed
+			sequence = __sync_fetch_and_add(&wakeSequence, 0);
+			if ((lockState != PMRSW_WRITER) && (writeWaitCount == 0))
+				continue;
+
+			// Sleep until the lock state changes
+			__sync_add_and_fetch(&sleepCount, 1);
+			if (FutexWait(&wakeSequence, sequence, deadline) == pSyncTimeout)
+			{
+				__sync_sub_and_fetch(&sleepCount, 1);
+				return (pSyncTimeout);
+			}
+
+			__sync_sub_and_fetch(&sleepCount, 1);
+		}
+	}
+
+	// Increment the read count for this thread
+	if (pthread_setspecific(readNestKey, (void *)(intptr_t)(nest + 1)) != 0)
+	{
+		// Give the lock back if it was taken above
+		if ((nest == 0) && (__sync_sub_and_fetch(&lockState, 1) == 0))
+			WakeWaiters();
+
+		throw PMemoryException();
+	}
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -1330,6 +1935,7 @@ PSyncError PMRSWLock::WaitToRead(uint32 timeout)
 /******************************************************************************/
 PSyncError PMRSWLock::DoneReading(void)
 {
+#if __p_os == __p_beos
 	int32 thread;
 	PSyncError unlocked = pSyncError;
 
@@ -1388,6 +1994,33 @@ PSyncError PMRSWLock::DoneReading(void)
 	}
 
 	return (unlocked);
+#elif __p_os == __p_linux
+	int32 nest;
+
+	// Does the current thread hold the lock for writing?
+	if (FindThreadID() == writerThread)
+	{
+		// Decrement the nesting count
+		writerNest--;
+		return (pSyncOk);
+	}
+
+	// Decrement the read count for this thread
+	nest = (int32)(intptr_t)pthread_getspecific(readNestKey);
+	if (nest == 0)
+		return (pSyncError);		// Did you unlock one time too much?
+
+	pthread_setspecific(readNestKey, (void *)(intptr_t)(nest - 1));
+
+	// Is this the last read lock?
+	if (nest == 1)
+	{
+		if (__sync_sub_and_fetch(&lockState, 1) == 0)
+			WakeWaiters();
+	}
+
+	return (pSyncOk);
+#endif
 }
 
 
@@ -1401,6 +2034,7 @@ PSyncError PMRSWLock::DoneReading(void)
 /******************************************************************************/
 void PMRSWLock::Initialize(PString name)
 {
+#if __p_os == __p_beos
 	// Initialize member variables
 	mainLock       = NULL;
 	readWaitCount  = 0;
@@ -1445,6 +2079,20 @@ void PMRSWLock::Initialize(PString name)
 		delete mainLock;
 		throw;
 	}
+#elif __p_os == __p_linux
+	// Initialize member variables
+	lockState      = 0;
+	writeWaitCount = 0;
+	wakeSequence   = 0;
+	sleepCount     = 0;
+	writerNest     = 0;
+	writerThread   = -1;
+
+	// Create the key holding the number of read locks each
+	// thread has on this lock
+	if (pthread_key_create(&readNestKey, NULL) != 0)
+		throw PSystemException(P_GEN_ERR_NO_RESOURCES);
+#endif
 }
 
 
@@ -1461,6 +2109,24 @@ int32 PMRSWLock::FindThreadID(void)
 
 
 
+#if __p_os == __p_linux
+
+/******************************************************************************/
+/* WakeWaiters() tells the threads waiting on the lock that the lock state    */
+/*      has changed. The kernel is only called if some threads are sleeping.  */
+/******************************************************************************/
+void PMRSWLock::WakeWaiters(void)
+{
+	__sync_add_and_fetch(&wakeSequence, 1);
+
+	if (sleepCount > 0)
+		FutexWake(&wakeSequence, INT_MAX);
+}
+
+#endif
+
+
+
 
 
 /******************************************************************************/
@@ -12,7 +12,9 @@
 #ifndef __PSynchronize_h
 #define __PSynchronize_h
 
+#if __p_os == __p_beos
 #include <OS.h>
+#endif
 
 // PolyKit headers
 #include "POS.h"
@@ -51,6 +53,10 @@ class PSync;
 
 _IMPEXP_PKLIB int32 AtomicIncrement(int32 *variable);
 _IMPEXP_PKLIB int32 AtomicDecrement(int32 *variable);
+_IMPEXP_PKLIB int32 AtomicTestAndSet(int32 *variable, int32 newValue, int32 testValue);
+_IMPEXP_PKLIB void *AtomicTestAndSetPointer(void **variable, void *newValue, void *testValue);
+_IMPEXP_PKLIB int32 AtomicGet(int32 *variable);
+_IMPEXP_PKLIB void AtomicSet(int32 *variable, int32 newValue);
 
 _IMPEXP_PKLIB int32 MultipleObjectsWait(PSync **objects, int32 count, bool waitAll, bigtime_t timeout = PSYNC_INFINITE);
 
@@ -96,7 +102,12 @@ protected:
 	int32 ownerCount;
 	bool lockThread;
 
+#if __p_os == __p_beos
 	sem_id semID;
+#elif __p_os == __p_linux
+	vint32 semCount;				// Number of locks left to take
+	vint32 semWaiters;				// Number of threads sleeping on semCount
+#endif
 	thread_id owner;
 };
 
@@ -121,7 +132,11 @@ protected:
 	int32 ownerCount;
 	bool lockThread;
 
+#if __p_os == __p_beos
 	sem_id semID;
+#elif __p_os == __p_linux
+	vint32 lockState;				// 0 = free, 1 = locked, 2 = locked with sleeping threads
+#endif
 	thread_id owner;
 };
 
@@ -149,10 +164,16 @@ protected:
 	// MultibleObjectsWait() needs to read the state variable
 	friend int32 MultipleObjectsWait(PSync **objects, int32 count, bool waitAll, bigtime_t timeout);
 
+#if __p_os == __p_beos
 	sem_id semID;
-	bool state;
-	bool manual;
 	bool releaseThread;
+#elif __p_os == __p_linux
+	vint32 eventSequence;			// Changed every time the event is set
+	vint32 eventWaiters;			// Number of threads sleeping on eventSequence
+	vint32 releaseCount;			// Number of threads an automatic event may release
+#endif
+	volatile bool state;
+	bool manual;
 };
 
 
@@ -174,15 +195,16 @@ public:
 	PSyncError DoneReading(void);
 
 protected:
+	void Initialize(PString name);
+	int32 FindThreadID(void);
+
+#if __p_os == __p_beos
 	typedef struct PReadLockInfo
 	{
 		int32 thread;				// Holds the thread id that have locked
 		int32 count;				// Holds the number of read locks the specific thread have
 	} PReadLockInfo;
 
-	void Initialize(PString name);
-	int32 FindThreadID(void);
-
 	PMutex *mainLock;				// Mutex to lock the counter variables
 
 	PList<PReadLockInfo> readList;	// Holds all the read locks
@@ -193,6 +215,15 @@ protected:
 	int32 writeWaitCount;			// Number of write locks waiting on another write lock
 	PSemaphore *writeSem;			// Will be trigged if a write lock wait for a read lock to finish
 	PSemaphore *writeLockSem;		// Will be trigged if a write lock wait for another write lock to finish
+#elif __p_os == __p_linux
+	void WakeWaiters(void);
+
+	vint32 lockState;				// Number of readers or PMRSW_WRITER if a writer has the lock
+	vint32 writeWaitCount;			// Number of write locks waiting to gain access
+	vint32 wakeSequence;			// Changed every time the lock state changes
+	vint32 sleepCount;				// Number of threads sleeping on wakeSequence
+	pthread_key_t readNestKey;		// Holds the number of read locks the calling thread has
+#endif
 
 	int32 writerNest;				// A counter used for nested calls by the same thread
 	int32 writerThread;				// The thread id to the thread that holds the lock with write access
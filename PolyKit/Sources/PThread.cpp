@@ -17,10 +17,33 @@
 #include "PThread.h"
 #include "PSystem.h"
 
+#if __p_os == __p_linux
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif
+
+
+#if __p_os == __p_linux
+
+/******************************************************************************/
+/* Linux scheduling constants                                                 */
+/******************************************************************************/
+#define PTHREAD_AUDIO_RT_PRIORITY		70		// SCHED_FIFO priority for pAudio
+#define PTHREAD_REALTIME_RT_PRIORITY	80		// SCHED_FIFO priority for pRealTime
+#define PTHREAD_NAME_LEN				16		// Max thread name length incl. the terminator
+
+#endif
+
+
 
 /******************************************************************************/
 /* PThread class                                                              */
 /******************************************************************************/
+bool PThread::memoryLocked = false;
+
+
+
 
 /******************************************************************************/
 /* Constructor                                                                */
@@ -30,6 +53,7 @@ PThread::PThread(void)
 	// Initialize member variables
 	threadRunning = false;
 	threadPri     = pNormal;
+	threadCPU     = -1;
 	threadName    = "Some PThread";
 	threadFunc    = NULL;
 
@@ -44,6 +68,10 @@ PThread::PThread(void)
 		throw PMemoryException();
 
 	suspendCounter = 0;
+
+#if __p_os == __p_linux
+	threadJoinable = false;
+#endif
 }
 
 
@@ -55,6 +83,12 @@ PThread::~PThread(void)
 {
 	ASSERT(threadRunning == false);
 
+#if __p_os == __p_linux
+	// Release the thread resources if nobody waited on it
+	if (threadJoinable)
+		pthread_detach(threadHandle);
+#endif
+
 	// Delete the suspend signal
 	delete suspendSignal;
 	delete threadStart;
@@ -74,6 +108,7 @@ void PThread::StartThread(void)
 	ASSERT(threadRunning == false);
 	ASSERT(threadFunc != NULL);
 
+#if __p_os == __p_beos
 	// Spawn the thread
 	tid = spawn_thread(ThreadFunc, (nameStr = threadName.GetString()), ConvertPriority(), this);
 	threadName.FreeBuffer(nameStr);
@@ -83,6 +118,29 @@ void PThread::StartThread(void)
 
 	// Start the thread
 	resume_thread(tid);
+#elif __p_os == __p_linux
+	char shortName[PTHREAD_NAME_LEN];
+
+	// Release the resources of a previous run nobody waited on
+	if (threadJoinable)
+	{
+		pthread_detach(threadHandle);
+		threadJoinable = false;
+	}
+
+	// Create the thread. It sets its own priority and affinity
+	if (pthread_create(&threadHandle, NULL, LinuxThreadFunc, this) != 0)
+		throw PSystemException(P_GEN_ERR_NO_RESOURCES);
+
+	threadJoinable = true;
+
+	// Linux only keeps the first 15 characters of the name
+	strncpy(shortName, (nameStr = threadName.GetString()), PTHREAD_NAME_LEN - 1);
+	shortName[PTHREAD_NAME_LEN - 1] = 0x00;
+	threadName.FreeBuffer(nameStr);
+
+	pthread_setname_np(threadHandle, shortName);
+#endif
 
 	// Wait until the thread have started running
 	threadStart->Lock();
@@ -97,6 +155,7 @@ void PThread::StartThread(void)
 /******************************************************************************/
 void PThread::WaitOnThread(void) const
 {
+#if __p_os == __p_beos
 	status_t exitVal, retVal;
 
 	// Exit if the thread is not running
@@ -111,6 +170,17 @@ void PThread::WaitOnThread(void) const
 	retVal = wait_for_thread(tid, &exitVal);
 	if (retVal != B_OK)
 		throw PSystemException(PSystem::ConvertOSError(retVal));
+#elif __p_os == __p_linux
+	// Exit if the thread has already been waited on. A thread that has
+	// stopped running still has to be joined to release its resources
+	if (!threadJoinable)
+		return;
+
+	if (pthread_join(threadHandle, NULL) != 0)
+		throw PSystemException(P_ERR_ANY);
+
+	threadJoinable = false;
+#endif
 }
 
 
@@ -136,10 +206,11 @@ int32 PThread::GetExitCode(void) const
 /******************************************************************************/
 void PThread::Resume(void)
 {
-	status_t retVal;
-
 	ASSERT(threadRunning == true);
 
+#if __p_os == __p_beos
+	status_t retVal;
+
 	// Decrement the suspend counter
 	if (AtomicDecrement(&suspendCounter) == 0)
 	{
@@ -152,6 +223,10 @@ void PThread::Resume(void)
 		if (retVal != B_OK)
 			throw PSystemException(PSystem::ConvertOSError(retVal));
 	}
+#elif __p_os == __p_linux
+	// POSIX threads can't be suspended or resumed by another thread
+	throw PSystemException(P_GEN_ERR_CANT_PERFORM);
+#endif
 }
 
 
@@ -163,10 +238,11 @@ void PThread::Resume(void)
 /******************************************************************************/
 void PThread::Suspend(void)
 {
-	status_t retVal;
-
 	ASSERT(threadRunning == true);
 
+#if __p_os == __p_beos
+	status_t retVal;
+
 	// Increment the suspend counter
 	if (AtomicIncrement(&suspendCounter) == 1)
 	{
@@ -179,6 +255,10 @@ void PThread::Suspend(void)
 		if (retVal != B_OK)
 			throw PSystemException(PSystem::ConvertOSError(retVal));
 	}
+#elif __p_os == __p_linux
+	// POSIX threads can't be suspended or resumed by another thread
+	throw PSystemException(P_GEN_ERR_CANT_PERFORM);
+#endif
 }
 
 
@@ -190,14 +270,23 @@ void PThread::Suspend(void)
 /******************************************************************************/
 void PThread::Kill(void)
 {
-	status_t retVal;
-
 	ASSERT(threadRunning == true);
 
+#if __p_os == __p_beos
+	status_t retVal;
+
 	// Kill the thread
 	retVal = kill_thread(tid);
 	if (retVal != B_OK)
 		throw PSystemException(PSystem::ConvertOSError(retVal));
+#elif __p_os == __p_linux
+	// Cancel the thread. It will stop at the next cancellation point
+	if (pthread_cancel(threadHandle) != 0)
+		throw PSystemException(P_ERR_ANY);
+
+	pthread_detach(threadHandle);
+	threadJoinable = false;
+#endif
 
 	// Clear the suspend counter
 	suspendCounter = 0;
@@ -265,11 +354,15 @@ void PThread::SetPriority(PPriority pri)
 	// Set the thread priority if the thread is running
 	if (threadRunning)
 	{
+#if __p_os == __p_beos
 		status_t retVal;
 
 		retVal = set_thread_priority(tid, ConvertPriority());
 		if (retVal != B_OK)
 			throw PSystemException(PSystem::ConvertOSError(retVal));
+#elif __p_os == __p_linux
+		ApplyPriority();
+#endif
 	}
 }
 
@@ -287,6 +380,185 @@ PThread::PPriority PThread::GetPriority(void) const
 
 
 
+/******************************************************************************/
+/* SetAffinity() will pin the thread to a single CPU. If the thread is        */
+/*      running, it will be moved immediately. The pinning is only a hint,    */
+/*      use GetStats() to see if the thread got it. BeOS has no way to pin a  */
+/*      thread, so there the value is only remembered.                        */
+/*                                                                            */
+/* Input:  "cpu" is the CPU number starting from 0 or -1 to run on all CPUs.  */
+/******************************************************************************/
+void PThread::SetAffinity(int32 cpu)
+{
+	// Remember the CPU
+	threadCPU = cpu;
+
+#if __p_os == __p_linux
+	// Move the thread if it is running
+	if (threadRunning)
+		ApplyAffinity();
+#endif
+}
+
+
+
+/******************************************************************************/
+/* GetAffinity() will return the CPU the thread should be pinned to.          */
+/*                                                                            */
+/* Output: Is the CPU number or -1 if the thread can run on all CPUs.         */
+/******************************************************************************/
+int32 PThread::GetAffinity(void) const
+{
+	return (threadCPU);
+}
+
+
+
+/******************************************************************************/
+/* GetStats() will tell how the OS actually schedules the thread. The         */
+/*      priority and affinity are hints that are silently degraded when the   */
+/*      user is not allowed to use them, so this is the way to verify e.g.    */
+/*      that an audio thread got real-time scheduling.                        */
+/*                                                                            */
+/* Input:  "stats" is a reference to the structure to fill out.               */
+/*                                                                            */
+/* Output: True if the statistics are filled, false if the thread is not      */
+/*         running.                                                           */
+/******************************************************************************/
+bool PThread::GetStats(PThreadStats &stats) const
+{
+#if __p_os == __p_beos
+	thread_info info;
+#elif __p_os == __p_linux
+	struct sched_param param;
+	cpu_set_t cpuSet;
+	int32 policy, i;
+#endif
+
+	if (!threadRunning)
+		return (false);
+
+	stats.priority     = threadPri;
+	stats.memoryLocked = memoryLocked;
+
+#if __p_os == __p_beos
+	if (get_thread_info(tid, &info) != B_OK)
+		return (false);
+
+	// BeOS threads are never pinned and real-time threads are never
+	// time sliced
+	stats.osPriority = info.priority;
+	stats.realTime   = (info.priority >= B_REAL_TIME_DISPLAY_PRIORITY);
+	stats.policy     = stats.realTime ? pSchedFifo : pSchedNormal;
+	stats.cpu        = -1;
+#elif __p_os == __p_linux
+	policy = sched_getscheduler(tid);
+	if (policy == -1)
+		return (false);
+
+	switch (policy & ~SCHED_RESET_ON_FORK)
+	{
+		case SCHED_FIFO:
+		{
+			stats.policy = pSchedFifo;
+			break;
+		}
+
+		case SCHED_RR:
+		{
+			stats.policy = pSchedRoundRobin;
+			break;
+		}
+
+		case SCHED_IDLE:
+		{
+			stats.policy = pSchedIdle;
+			break;
+		}
+
+		default:
+		{
+			stats.policy = pSchedNormal;
+			break;
+		}
+	}
+
+	stats.realTime = ((stats.policy == pSchedFifo) || (stats.policy == pSchedRoundRobin));
+
+	// Real-time threads have a real-time priority, the others a nice value
+	if (stats.realTime)
+	{
+		sched_getparam(tid, &param);
+		stats.osPriority = param.sched_priority;
+	}
+	else
+		stats.osPriority = getpriority(PRIO_PROCESS, tid);
+
+	// Find the CPU if the thread can only run on one
+	stats.cpu = -1;
+
+	if ((sched_getaffinity(tid, sizeof(cpuSet), &cpuSet) == 0) && (CPU_COUNT(&cpuSet) == 1))
+	{
+		for (i = 0; i < CPU_SETSIZE; i++)
+		{
+			if (CPU_ISSET(i, &cpuSet))
+			{
+				stats.cpu = i;
+				break;
+			}
+		}
+	}
+#endif
+
+	return (true);
+}
+
+
+
+/******************************************************************************/
+/* LockMemory() will lock the memory of the application in RAM, so the audio  */
+/*      path is never paged out. On Linux, future allocations are only locked */
+/*      when there is no lock limit, else allocations would start to fail     */
+/*      once the limit is reached. BeOS can't lock the whole application.     */
+/*                                                                            */
+/* Output: True if the memory is locked, false if not.                        */
+/******************************************************************************/
+bool PThread::LockMemory(void)
+{
+#if __p_os == __p_beos
+	return (false);
+#elif __p_os == __p_linux
+	struct rlimit limit;
+	int flags = MCL_CURRENT;
+
+	if ((getrlimit(RLIMIT_MEMLOCK, &limit) == 0) && (limit.rlim_cur == RLIM_INFINITY))
+		flags |= MCL_FUTURE;
+
+	if (mlockall(flags) != 0)
+		return (false);
+
+	memoryLocked = true;
+	return (true);
+#endif
+}
+
+
+
+/******************************************************************************/
+/* UnlockMemory() will unlock the memory locked by LockMemory().              */
+/******************************************************************************/
+void PThread::UnlockMemory(void)
+{
+#if __p_os == __p_linux
+	if (memoryLocked)
+		munlockall();
+#endif
+
+	memoryLocked = false;
+}
+
+
+
 /******************************************************************************/
 /* ThreadFunc() is the thread function that will be started. It will call the */
 /*      user function and remember the exit code.                             */
@@ -308,15 +580,120 @@ int32 PThread::ThreadFunc(void *object)
 
 
 
+#if __p_os == __p_linux
+
+/******************************************************************************/
+/* LinuxThreadFunc() is the function given to pthread_create(). It sets the   */
+/*      scheduling from inside the new thread before the user function runs,  */
+/*      so the thread never inherits the scheduling of its creator.           */
+/*                                                                            */
+/* Input:  "object" is a pointer to the current PThread object.               */
+/******************************************************************************/
+void *PThread::LinuxThreadFunc(void *object)
+{
+	PThread *obj = (PThread *)object;
+
+	obj->tid = find_thread(NULL);
+	obj->ApplyPriority();
+	obj->ApplyAffinity();
+
+	ThreadFunc(object);
+	return (NULL);
+}
+
+
+
+/******************************************************************************/
+/* ApplyPriority() will give the thread the scheduling for its priority.      */
+/*      pAudio and pRealTime ask for SCHED_FIFO. If the user is not allowed   */
+/*      that, the highest real-time priority RLIMIT_RTPRIO allows is used and */
+/*      if there is none, the thread falls back to a negative nice value, as  */
+/*      far as RLIMIT_NICE allows. Failures are never reported, use           */
+/*      GetStats() to check.                                                  */
+/******************************************************************************/
+void PThread::ApplyPriority(void)
+{
+	struct sched_param param;
+	struct rlimit limit;
+	int32 rtPri, nice;
+
+	memset(&param, 0, sizeof(param));
+
+	if ((threadPri == pAudio) || (threadPri == pRealTime))
+	{
+		rtPri = (threadPri == pAudio) ? PTHREAD_AUDIO_RT_PRIORITY : PTHREAD_REALTIME_RT_PRIORITY;
+		if (rtPri > sched_get_priority_max(SCHED_FIFO))
+			rtPri = sched_get_priority_max(SCHED_FIFO);
+
+		// Processes forked by a real-time thread do not inherit the policy
+		param.sched_priority = rtPri;
+		if (sched_setscheduler(tid, SCHED_FIFO | SCHED_RESET_ON_FORK, &param) == 0)
+			return;
+
+		// Unprivileged users may still have a real-time priority limit
+		if ((errno == EPERM) && (getrlimit(RLIMIT_RTPRIO, &limit) == 0) && (limit.rlim_cur > 0))
+		{
+			if (limit.rlim_cur < (rlim_t)rtPri)
+				param.sched_priority = limit.rlim_cur;
+
+			if (sched_setscheduler(tid, SCHED_FIFO | SCHED_RESET_ON_FORK, &param) == 0)
+				return;
+		}
+
+		param.sched_priority = 0;
+	}
+
+	// Use the normal or idle policy and set the nice value
+	sched_setscheduler(tid, (threadPri == pIdle ? SCHED_IDLE : SCHED_OTHER) | SCHED_RESET_ON_FORK, &param);
+
+	nice = ConvertPriority();
+	if ((setpriority(PRIO_PROCESS, tid, nice) != 0) && (getrlimit(RLIMIT_NICE, &limit) == 0) && (limit.rlim_cur <= 40))
+	{
+		// Get as close as RLIMIT_NICE allows, but never lower the priority
+		nice = 20 - (int32)limit.rlim_cur;
+		if (nice < getpriority(PRIO_PROCESS, tid))
+			setpriority(PRIO_PROCESS, tid, nice);
+	}
+}
+
+
+
+/******************************************************************************/
+/* ApplyAffinity() will pin the thread to the CPU remembered or let it run on */
+/*      all CPUs. Failures are never reported, use GetStats() to check.       */
+/******************************************************************************/
+void PThread::ApplyAffinity(void)
+{
+	cpu_set_t cpuSet;
+	int32 i;
+
+	CPU_ZERO(&cpuSet);
+
+	if ((threadCPU >= 0) && (threadCPU < CPU_SETSIZE))
+		CPU_SET(threadCPU, &cpuSet);
+	else
+	{
+		for (i = 0; i < CPU_SETSIZE; i++)
+			CPU_SET(i, &cpuSet);
+	}
+
+	sched_setaffinity(tid, sizeof(cpuSet), &cpuSet);
+}
+
+#endif
+
+
+
 /******************************************************************************/
 /* ConvertPriority() will convert a PolyKit priority to an OS priority.       */
 /*                                                                            */
-/* Output: Is the OS priority.                                                */
+/* Output: Is the OS priority. On Linux it is the nice value.                 */
 /******************************************************************************/
 int32 PThread::ConvertPriority(void) const
 {
 	int32 pri;
 
+#if __p_os == __p_beos
 	switch (threadPri)
 	{
 		case pIdle:
@@ -349,6 +726,12 @@ int32 PThread::ConvertPriority(void) const
 			break;
 		}
 
+		case pAudio:
+		{
+			pri = B_URGENT_DISPLAY_PRIORITY;
+			break;
+		}
+
 		case pRealTime:
 		{
 			pri = B_REAL_TIME_PRIORITY;
@@ -361,6 +744,55 @@ int32 PThread::ConvertPriority(void) const
 			break;
 		}
 	}
+#elif __p_os == __p_linux
+	// Linux uses nice values, where lower means higher priority. pAudio and
+	// pRealTime only get these when real-time scheduling is not allowed
+	switch (threadPri)
+	{
+		case pIdle:
+		{
+			pri = 19;
+			break;
+		}
+
+		case pLow:
+		{
+			pri = 10;
+			break;
+		}
+
+		case pBelowNormal:
+		{
+			pri = 5;
+			break;
+		}
+
+		case pAboveNormal:
+		{
+			pri = -5;
+			break;
+		}
+
+		case pHigh:
+		{
+			pri = -10;
+			break;
+		}
+
+		case pAudio:
+		case pRealTime:
+		{
+			pri = -15;
+			break;
+		}
+
+		default:
+		{
+			pri = 0;
+			break;
+		}
+	}
+#endif
 
 	return (pri);
 }
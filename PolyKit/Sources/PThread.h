@@ -31,7 +31,18 @@ typedef int32 (*PThreadFunc)(void *);
 class _IMPEXP_PKLIB PThread
 {
 public:
-	enum PPriority { pIdle, pLow, pBelowNormal, pNormal, pAboveNormal, pHigh, pRealTime };
+	enum PPriority { pIdle, pLow, pBelowNormal, pNormal, pAboveNormal, pHigh, pAudio, pRealTime };
+	enum PSchedPolicy { pSchedNormal, pSchedIdle, pSchedRoundRobin, pSchedFifo };
+
+	typedef struct PThreadStats
+	{
+		PPriority priority;			// The priority asked for
+		PSchedPolicy policy;		// The scheduling policy the thread got
+		int32 osPriority;			// The OS priority (nice value on Linux when not real-time)
+		int32 cpu;					// The CPU the thread is pinned to or -1
+		bool realTime;				// True if the thread got real-time scheduling
+		bool memoryLocked;			// True if the application memory is locked
+	} PThreadStats;
 
 	PThread(void);
 	virtual ~PThread(void);
@@ -50,11 +61,26 @@ public:
 	void SetName(PString name);
 	void SetPriority(PPriority pri);
 	PPriority GetPriority(void) const;
+	void SetAffinity(int32 cpu);
+	int32 GetAffinity(void) const;
+
+	bool GetStats(PThreadStats &stats) const;
+
+	static bool LockMemory(void);
+	static void UnlockMemory(void);
 
 protected:
 	static int32 ThreadFunc(void *object);
 	int32 ConvertPriority(void) const;
 
+#if __p_os == __p_linux
+	static void *LinuxThreadFunc(void *object);
+	void ApplyPriority(void);
+	void ApplyAffinity(void);
+
+	pthread_t threadHandle;
+	mutable bool threadJoinable;	// True until the thread has been joined or detached
+#endif
 	thread_id tid;
 	PEvent *suspendSignal;
 	int32 suspendCounter;
@@ -62,10 +88,13 @@ protected:
 	bool threadRunning;
 	PEvent *threadStart;
 	PPriority threadPri;
+	int32 threadCPU;
 	PString threadName;
 	PThreadFunc threadFunc;
 	void *threadData;
 	int32 exitCode;
+
+	static bool memoryLocked;
 };
 
 #if __p_os == __p_beos && __POWERPC__
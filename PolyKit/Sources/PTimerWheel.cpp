@@ -0,0 +1,370 @@
+/******************************************************************************/
+/* PTimerWheel implementation file.                                           */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#define _BUILDING_POLYKIT_LIBRARY_
+
+// PolyKit headers
+#include "POS.h"
+#include "PTimerWheel.h"
+
+
+/******************************************************************************/
+/* Wheel constants                                                            */
+/******************************************************************************/
+#define P_WHEEL_MASK				(P_WHEEL_SLOTS - 1)
+
+
+
+/******************************************************************************/
+/* PWheelTimer class                                                          */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/*                                                                            */
+/* Input:  "id" is the timer id.                                              */
+/*         "userData" is free for the owner to use.                           */
+/******************************************************************************/
+PWheelTimer::PWheelTimer(uint32 id, void *userData)
+{
+	// Initialize member variables
+	this->id       = id;
+	this->userData = userData;
+
+	next    = NULL;
+	prev    = NULL;
+	expires = 0;
+	period  = 0;
+	level   = -1;
+	slot    = 0;
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PWheelTimer::~PWheelTimer(void)
+{
+	// The timer has to be removed from the wheel before it is destroyed
+	ASSERT(level == -1);
+}
+
+
+
+/******************************************************************************/
+/* IsActive() tells if the timer has been added to a wheel and has not        */
+/*      elapsed yet.                                                          */
+/*                                                                            */
+/* Output: True if the timer is active, false if not.                         */
+/******************************************************************************/
+bool PWheelTimer::IsActive(void) const
+{
+	return (level != -1);
+}
+
+
+
+
+
+/******************************************************************************/
+/* PTimerWheel class                                                          */
+/*                                                                            */
+/* Every level has 64 slots. Level 0 holds the timers which elapse within the */
+/* next 64 ticks, one slot per tick. Level 1 holds the timers within the next */
+/* 64 * 64 ticks, one slot per 64 ticks and so on. Every time level 0 has     */
+/* gone all the way round, the next slot in level 1 is emptied and its timers */
+/* are put into level 0 again, which is called a cascade.                     */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Constructor                                                                */
+/*                                                                            */
+/* Input:  "func" is the function to call when a timer elapses.               */
+/*         "userData" is given to the function.                               */
+/*         "tickTime" is the resolution of the wheel in microseconds.         */
+/******************************************************************************/
+PTimerWheel::PTimerWheel(PTimerWheelFunc func, void *userData, uint32 tickTime)
+{
+	// Initialize member variables
+	timerFunc      = func;
+	timerData      = userData;
+	this->tickTime = tickTime;
+	startTime      = system_time();
+	currentTick    = 0;
+	timerCount     = 0;
+
+	memset(slots, 0, sizeof(slots));
+}
+
+
+
+/******************************************************************************/
+/* Destructor                                                                 */
+/******************************************************************************/
+PTimerWheel::~PTimerWheel(void)
+{
+	int32 i, j;
+
+	// Mark all the timers still in the wheel as inactive
+	for (i = 0; i < P_WHEEL_LEVELS; i++)
+	{
+		for (j = 0; j < P_WHEEL_SLOTS; j++)
+		{
+			while (slots[i][j] != NULL)
+				Unlink(slots[i][j]);
+		}
+	}
+}
+
+
+
+/******************************************************************************/
+/* AddTimer() will start a timer. If the timer is already running, it is      */
+/*      started again with the new values.                                    */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer to start.                        */
+/*         "delay" is the time in microseconds before it elapses.             */
+/*         "period" is the time in microseconds between each elapse after     */
+/*         the first one or 0 to elapse only once.                            */
+/******************************************************************************/
+void PTimerWheel::AddTimer(PWheelTimer *timer, bigtime_t delay, bigtime_t period)
+{
+	bigtime_t now;
+	uint64 nowTick;
+
+	if (timer->level != -1)
+		Unlink(timer);
+	else
+		timerCount++;
+
+	// If the wheel has been empty, Advance() may not have been
+	// called for a while, so catch up with the time first
+	now     = system_time() - startTime;
+	nowTick = now / tickTime;
+	if ((timerCount == 1) && (nowTick > currentTick))
+		currentTick = nowTick;
+
+	// Round up, so the timer never elapses too early
+	timer->expires = (now + max(delay, 0) + tickTime - 1) / tickTime;
+	if (timer->expires <= currentTick)
+		timer->expires = currentTick + 1;
+
+	timer->period = 0;
+	if (period > 0)
+		timer->period = max((period + tickTime / 2) / tickTime, 1);
+
+	Insert(timer);
+}
+
+
+
+/******************************************************************************/
+/* RemoveTimer() will stop a timer.                                           */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer to stop.                         */
+/******************************************************************************/
+void PTimerWheel::RemoveTimer(PWheelTimer *timer)
+{
+	if (timer->level != -1)
+	{
+		Unlink(timer);
+		timerCount--;
+	}
+}
+
+
+
+/******************************************************************************/
+/* Advance() will move the wheel forward to the time given and call the timer */
+/*      function for all the timers which have elapsed. The timer function    */
+/*      may start and stop timers itself.                                     */
+/*                                                                            */
+/* Input:  "now" is the current system time.                                  */
+/******************************************************************************/
+void PTimerWheel::Advance(bigtime_t now)
+{
+	PWheelTimer *timer;
+	uint64 targetTick;
+	int32 index, level, slot;
+
+	targetTick = (now - startTime) / tickTime;
+
+	while (currentTick < targetTick)
+	{
+		// Nothing to do if the wheel is empty
+		if (timerCount == 0)
+		{
+			currentTick = targetTick;
+			break;
+		}
+
+		currentTick++;
+		index = currentTick & P_WHEEL_MASK;
+
+		// Has level 0 gone all the way round?
+		if (index == 0)
+		{
+			for (level = 1; level < P_WHEEL_LEVELS; level++)
+			{
+				slot = (currentTick >> (level * P_WHEEL_BITS)) & P_WHEEL_MASK;
+				Cascade(level, slot);
+
+				if (slot != 0)
+					break;
+			}
+		}
+
+		// Call all the timers in the current slot
+		while ((timer = slots[0][index]) != NULL)
+		{
+			Unlink(timer);
+
+			if (timer->period != 0)
+			{
+				// Restart periodic timers before they are called, so the
+				// timer function can stop them again
+				timer->expires += timer->period;
+				if (timer->expires <= currentTick)
+					timer->expires = currentTick + timer->period - ((currentTick - timer->expires) % timer->period);
+
+				Insert(timer);
+			}
+			else
+				timerCount--;
+
+			timerFunc(timer, timerData);
+		}
+	}
+}
+
+
+
+/******************************************************************************/
+/* GetTimeToNext() returns the time until Advance() has to be called again.   */
+/*      It is either the time the next timer elapses or the time of the next  */
+/*      cascade, whatever comes first.                                        */
+/*                                                                            */
+/* Input:  "now" is the current system time.                                  */
+/*                                                                            */
+/* Output: The time in microseconds or -1 if there are no timers.             */
+/******************************************************************************/
+bigtime_t PTimerWheel::GetTimeToNext(bigtime_t now) const
+{
+	bigtime_t timeLeft;
+	uint64 tick;
+
+	if (timerCount == 0)
+		return (-1);
+
+	// Find the next slot in level 0 with timers, but stop at the
+	// end of the wheel, because timers will be cascaded there
+	for (tick = currentTick + 1; ; tick++)
+	{
+		if (((tick & P_WHEEL_MASK) == 0) || (slots[0][tick & P_WHEEL_MASK] != NULL))
+			break;
+	}
+
+	timeLeft = startTime + (bigtime_t)tick * tickTime - now;
+	return (max(timeLeft, 0));
+}
+
+
+
+/******************************************************************************/
+/* Insert() will link the timer into the slot that matches its expire tick.   */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer to insert.                       */
+/******************************************************************************/
+void PTimerWheel::Insert(PWheelTimer *timer)
+{
+	uint64 delta;
+	int32 level, slot;
+
+	// Timers which have already elapsed go into the current slot, so
+	// they are called right away when cascaded
+	if (timer->expires <= currentTick)
+	{
+		level = 0;
+		slot  = currentTick & P_WHEEL_MASK;
+	}
+	else
+	{
+		// Find the level which covers the time until it elapses. Timers
+		// too far away are put into the last level and will be cascaded
+		// into it again until they are close enough
+		delta = timer->expires - currentTick;
+
+		for (level = 0; level < (P_WHEEL_LEVELS - 1); level++)
+		{
+			if (delta < ((uint64)1 << ((level + 1) * P_WHEEL_BITS)))
+				break;
+		}
+
+		slot = (timer->expires >> (level * P_WHEEL_BITS)) & P_WHEEL_MASK;
+	}
+
+	// Link it in at the head of the slot
+	timer->level = level;
+	timer->slot  = slot;
+	timer->prev  = NULL;
+	timer->next  = slots[level][slot];
+
+	if (timer->next != NULL)
+		timer->next->prev = timer;
+
+	slots[level][slot] = timer;
+}
+
+
+
+/******************************************************************************/
+/* Unlink() will take the timer out of its slot.                              */
+/*                                                                            */
+/* Input:  "timer" is a pointer to the timer to unlink.                       */
+/******************************************************************************/
+void PTimerWheel::Unlink(PWheelTimer *timer)
+{
+	if (timer->prev != NULL)
+		timer->prev->next = timer->next;
+	else
+		slots[timer->level][timer->slot] = timer->next;
+
+	if (timer->next != NULL)
+		timer->next->prev = timer->prev;
+
+	timer->next  = NULL;
+	timer->prev  = NULL;
+	timer->level = -1;
+}
+
+
+
+/******************************************************************************/
+/* Cascade() will move all the timers in a slot down to the lower levels.     */
+/*                                                                            */
+/* Input:  "level" is the level to take the timers from.                      */
+/*         "slot" is the slot to empty.                                       */
+/******************************************************************************/
+void PTimerWheel::Cascade(int32 level, int32 slot)
+{
+	PWheelTimer *timer, *next;
+
+	timer = slots[level][slot];
+	slots[level][slot] = NULL;
+
+	while (timer != NULL)
+	{
+		next = timer->next;
+		Insert(timer);
+		timer = next;
+	}
+}
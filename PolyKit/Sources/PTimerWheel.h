@@ -0,0 +1,104 @@
+/******************************************************************************/
+/* PTimerWheel header file.                                                   */
+/******************************************************************************/
+/* This source, or parts thereof, may be used in any software as long the     */
+/* license of PolyKit is keep. See the LICENSE file for more information.     */
+/*                                                                            */
+/* Copyright (C) 1998-2002 by Polycode.                                       */
+/* All rights reserved.                                                       */
+/******************************************************************************/
+
+
+#ifndef __PTimerWheel_h
+#define __PTimerWheel_h
+
+// PolyKit headers
+#include "POS.h"
+#include "ImportExport.h"
+
+
+/******************************************************************************/
+/* Wheel sizes                                                                */
+/******************************************************************************/
+#define P_WHEEL_BITS				6
+#define P_WHEEL_SLOTS				(1 << P_WHEEL_BITS)
+#define P_WHEEL_LEVELS				4
+
+
+
+/******************************************************************************/
+/* PWheelTimer class                                                          */
+/*                                                                            */
+/* The timer is owned by the caller and linked directly into the wheel, so    */
+/* starting and stopping timers never allocates memory.                       */
+/******************************************************************************/
+#if __p_os == __p_beos && __POWERPC__
+#pragma export on
+#endif
+
+class _IMPEXP_PKLIB PWheelTimer
+{
+public:
+	PWheelTimer(uint32 id = 0, void *userData = NULL);
+	virtual ~PWheelTimer(void);
+
+	bool IsActive(void) const;
+
+	uint32 id;						// The timer id, free for the owner to use
+	void *userData;					// Free for the owner to use
+
+protected:
+	friend class PTimerWheel;
+
+	PWheelTimer *next;
+	PWheelTimer *prev;
+	uint64 expires;					// The tick the timer elapses at
+	uint32 period;					// Number of ticks between each elapse or 0 for a one shot timer
+	int16 level;					// The wheel the timer is linked into or -1 if not active
+	int16 slot;
+};
+
+
+
+/******************************************************************************/
+/* PTimerWheel class                                                          */
+/*                                                                            */
+/* A hierarchical timer wheel. Starting and stopping a timer takes the same   */
+/* time no matter how many timers there are. The wheel is not thread safe, so */
+/* it should be owned by a single thread, e.g. by using PEventLoop.           */
+/******************************************************************************/
+typedef void (*PTimerWheelFunc)(PWheelTimer *timer, void *userData);
+
+class _IMPEXP_PKLIB PTimerWheel
+{
+public:
+	PTimerWheel(PTimerWheelFunc func, void *userData = NULL, uint32 tickTime = 1000);
+	virtual ~PTimerWheel(void);
+
+	void AddTimer(PWheelTimer *timer, bigtime_t delay, bigtime_t period = 0);
+	void RemoveTimer(PWheelTimer *timer);
+
+	void Advance(bigtime_t now);
+	bigtime_t GetTimeToNext(bigtime_t now) const;
+
+protected:
+	void Insert(PWheelTimer *timer);
+	void Unlink(PWheelTimer *timer);
+	void Cascade(int32 level, int32 slot);
+
+	PWheelTimer *slots[P_WHEEL_LEVELS][P_WHEEL_SLOTS];
+
+	PTimerWheelFunc timerFunc;
+	void *timerData;
+
+	bigtime_t startTime;
+	uint32 tickTime;				// Length of a tick in microseconds
+	uint64 currentTick;				// The last tick handled
+	int32 timerCount;
+};
+
+#if __p_os == __p_beos && __POWERPC__
+#pragma export off
+#endif
+
+#endif